@@ -97,6 +97,7 @@ target_link_libraries(fboss_types
 )
 
 add_library(core
+  fboss/agent/AclPriorityAllocator.cpp
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
   fboss/agent/ArpHandler.cpp
@@ -124,6 +125,7 @@ add_library(core
   fboss/agent/MirrorManagerImpl.cpp
   fboss/agent/MPLSHandler.cpp
   fboss/agent/NdpCache.cpp
+  fboss/agent/NeighborCacheScheduler.cpp
   fboss/agent/NeighborUpdater.cpp
   fboss/agent/NeighborUpdaterImpl.cpp
   fboss/agent/PortUpdateHandler.cpp
@@ -134,14 +136,18 @@ add_library(core
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
   fboss/agent/RouteUpdateWrapper.cpp
+  fboss/agent/RxPacketDispatcher.cpp
   fboss/agent/StaticL2ForNeighborObserver.cpp
   fboss/agent/StaticL2ForNeighborUpdater.cpp
   fboss/agent/StaticL2ForNeighborSwSwitchUpdater.cpp
+  fboss/agent/StateUpdateTracer.cpp
   fboss/agent/SwSwitch.cpp
   fboss/agent/SwSwitchRouteUpdateWrapper.cpp
   fboss/agent/ThreadHeartbeat.cpp
   fboss/agent/TunIntf.cpp
   fboss/agent/TunManager.cpp
+  fboss/agent/UpdateStreamRecorder.cpp
+  fboss/agent/UpdateStreamReplayer.cpp
   fboss/agent/ndp/IPv6RouteAdvertiser.cpp
   fboss/agent/oss/RouteUpdateLogger.cpp
   fboss/agent/oss/SwSwitch.cpp
@@ -157,6 +163,7 @@ target_link_libraries(core
   hardware_stats_cpp2
   switch_asics
   ctrl_cpp2
+  update_stream_cpp2
   fboss_cpp2
   lldp
   packet
@@ -194,6 +201,7 @@ add_library(handler
 )
 
 target_link_libraries(handler
+  buffer_stats
   core
   pkt
   fb303::fb303
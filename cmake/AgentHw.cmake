@@ -49,6 +49,7 @@ add_library(hw_switch_warmboot_helper
 
 add_library(buffer_stats
   fboss/agent/hw/BufferStatsLogger.cpp
+  fboss/agent/hw/BufferWatermarkSampler.cpp
 )
 
 add_library(hw_resource_stats_publisher
@@ -99,6 +100,8 @@ target_link_libraries(hw_trunk_counters
 )
 
 target_link_libraries(buffer_stats
+  error
+  fboss_types
   Folly::folly
 )
 
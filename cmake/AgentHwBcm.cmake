@@ -73,6 +73,7 @@ add_library(bcm
   fboss/agent/hw/bcm/BcmTrunkStats.cpp
   fboss/agent/hw/bcm/BcmTrunkTable.cpp
   fboss/agent/hw/bcm/BcmTxPacket.cpp
+  fboss/agent/hw/bcm/BcmTxPacketPool.cpp
   fboss/agent/hw/bcm/BcmQosUtils.cpp
   fboss/agent/hw/bcm/BcmUnit.cpp
   fboss/agent/hw/bcm/BcmWarmBootCache.cpp
@@ -177,6 +178,16 @@ target_link_libraries(bcm_cinter
   ${OPENNSA}
 )
 
+add_executable(bcm_cinter_convert
+  fboss/agent/hw/bcm/BcmCinterConvert.cpp
+)
+
+target_link_libraries(bcm_cinter_convert
+  bcm_cinter
+  fboss_error
+  Folly::folly
+)
+
 set_target_properties(bcm_cinter PROPERTIES COMPILE_FLAGS
   "-DINCLUDE_L3 -DBCM_ESW_SUPPORT"
 )
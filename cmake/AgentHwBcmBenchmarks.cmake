@@ -184,6 +184,15 @@ target_link_libraries(bcm_stats_collection_speed
   -Wl,--no-whole-archive
 )
 
+add_executable(bcm_acl_insert_speed /dev/null)
+
+target_link_libraries(bcm_acl_insert_speed
+  -Wl,--whole-archive
+  bcm_switch_ensemble
+  hw_acl_insert_speed
+  -Wl,--no-whole-archive
+)
+
 add_executable(bcm_tx_slow_path_rate /dev/null)
 
 target_link_libraries(bcm_tx_slow_path_rate
@@ -315,6 +324,7 @@ if (BENCHMARK_INSTALL)
   install(TARGETS bcm_hgrid_uu_scale_route_add_speed)
   install(TARGETS bcm_hgrid_uu_scale_route_del_speed)
   install(TARGETS bcm_stats_collection_speed)
+  install(TARGETS bcm_acl_insert_speed)
   install(TARGETS bcm_tx_slow_path_rate)
   install(TARGETS bcm_warm_boot_exit_speed)
   install(TARGETS bcm_rx_slow_path_rate)
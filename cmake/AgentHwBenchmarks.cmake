@@ -38,6 +38,19 @@ target_link_libraries(hw_stats_collection_speed
   Folly::follybenchmark
 )
 
+add_library(hw_acl_insert_speed
+  fboss/agent/hw/benchmarks/HwAclInsertBenchmark.cpp
+)
+
+target_link_libraries(hw_acl_insert_speed
+  config_factory
+  hw_switch_ensemble
+  hw_benchmark_main
+  state
+  Folly::folly
+  Folly::follybenchmark
+)
+
 add_library(hw_fsw_scale_route_add_speed
   fboss/agent/hw/benchmarks/HwFswScaleRouteAddBenchmark.cpp
 )
@@ -43,6 +43,7 @@ set(SAI_API_SRC
   fboss/agent/hw/sai/api/QosMapApi.cpp
   fboss/agent/hw/sai/api/RouteApi.cpp
   fboss/agent/hw/sai/api/SaiApiLock.cpp
+  fboss/agent/hw/sai/api/SaiApiStats.cpp
   fboss/agent/hw/sai/api/SaiApiTable.cpp
   fboss/agent/hw/sai/api/SwitchApi.cpp
   fboss/agent/hw/sai/api/Types.cpp
@@ -10,6 +10,7 @@ set(SAI_SWITCH_SRC
   fboss/agent/hw/sai/switch/SaiBridgeManager.cpp
   fboss/agent/hw/sai/switch/SaiBufferManager.cpp
   fboss/agent/hw/sai/switch/SaiDebugCounterManager.cpp
+  fboss/agent/hw/sai/switch/SaiDeltaExecutor.cpp
   fboss/agent/hw/sai/switch/SaiFdbManager.cpp
   fboss/agent/hw/sai/switch/SaiHashManager.cpp
   fboss/agent/hw/sai/switch/SaiHostifManager.cpp
@@ -32,6 +33,7 @@ set(SAI_SWITCH_SRC
   fboss/agent/hw/sai/switch/SaiSchedulerManager.cpp
   fboss/agent/hw/sai/switch/SaiSwitch.cpp
   fboss/agent/hw/sai/switch/SaiSwitchManager.cpp
+  fboss/agent/hw/sai/switch/SaiTxQueue.cpp
   fboss/agent/hw/sai/switch/SaiVlanManager.cpp
   fboss/agent/hw/sai/switch/SaiVirtualRouterManager.cpp
   fboss/agent/hw/sai/switch/SaiWredManager.cpp
@@ -63,6 +65,7 @@ target_link_libraries(sai_switch
   # implementation for sai_api would be provided by lib that links later. Thus,
   # allow unresolved-symbols here.
   -Wl,--unresolved-symbols=ignore-all
+  buffer_stats
   core
   hw_switch_stats
   hw_trunk_counters
@@ -0,0 +1,44 @@
+# CMake to build libraries and binaries in fboss/agent/hw/sai/switch/tests
+
+# In general, libraries and binaries in fboss/foo/bar are built by
+# cmake/FooBar.cmake
+
+# Manager tests need the fake platform, only tests of standalone helpers
+# are built here
+add_executable(sai_switch_test
+    fboss/agent/test/oss/Main.cpp
+    fboss/agent/hw/sai/switch/tests/SaiDeltaExecutorTest.cpp
+    fboss/agent/hw/sai/switch/tests/SaiTxQueueTest.cpp
+)
+
+target_link_libraries(sai_switch_test
+    sai_switch
+    fake_sai
+    ${GTEST}
+    ${LIBGMOCK_LIBRARIES}
+)
+
+set_target_properties(sai_switch_test PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
+
+gtest_discover_tests(sai_switch_test)
+
+add_executable(sai_delta_executor_benchmark
+    fboss/agent/hw/sai/switch/tests/SaiDeltaExecutorBenchmark.cpp
+)
+
+target_link_libraries(sai_delta_executor_benchmark
+    sai_switch
+    fake_sai
+    Folly::folly
+    Folly::follybenchmark
+)
+
+set_target_properties(sai_delta_executor_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
@@ -13,9 +13,52 @@ target_link_libraries(product_info
   Folly::folly
 )
 
+add_executable(platform_mapping_compiler
+  fboss/agent/platforms/common/PlatformMappingCompiler.cpp
+)
+
+target_link_libraries(platform_mapping_compiler
+  platform_config_cpp2
+  Folly::folly
+  FBThrift::thriftcpp2
+)
+
+# Platform mapping sources whose embedded json is precompiled to thrift
+# compact at build time, see PrecompiledPlatformMappings.h
+set(PLATFORM_MAPPING_JSON_SRCS
+  fboss/agent/platforms/common/cloud_ripper/CloudRipperPlatformMapping.cpp
+  fboss/agent/platforms/common/ebb_lab/Wedge400CEbbLabPlatformMapping.cpp
+  fboss/agent/platforms/common/elbert/Elbert16QPimPlatformMapping.cpp
+  fboss/agent/platforms/common/galaxy/GalaxyFCPlatformMappingCommon.cpp
+  fboss/agent/platforms/common/galaxy/GalaxyLCPlatformMappingCommon.cpp
+  fboss/agent/platforms/common/minipack/Minipack16QPimPlatformMapping.cpp
+  fboss/agent/platforms/common/wedge100/Wedge100PlatformMapping.cpp
+  fboss/agent/platforms/common/wedge40/Wedge40PlatformMapping.cpp
+  fboss/agent/platforms/common/wedge400/Wedge400PlatformMapping.cpp
+  fboss/agent/platforms/common/wedge400c/Wedge400CPlatformMapping.cpp
+  fboss/agent/platforms/common/yamp/Yamp16QPimPlatformMapping.cpp
+  fboss/agent/platforms/wedge/fuji/Fuji16QPimPlatformMapping.cpp
+)
+
+set(PRECOMPILED_PLATFORM_MAPPINGS_DATA
+  ${CMAKE_CURRENT_BINARY_DIR}/fboss/agent/platforms/common/PrecompiledPlatformMappingsData.cpp
+)
+
+add_custom_command(
+  OUTPUT ${PRECOMPILED_PLATFORM_MAPPINGS_DATA}
+  COMMAND platform_mapping_compiler
+    --output=${PRECOMPILED_PLATFORM_MAPPINGS_DATA}
+    ${PLATFORM_MAPPING_JSON_SRCS}
+  DEPENDS platform_mapping_compiler ${PLATFORM_MAPPING_JSON_SRCS}
+  WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
+  COMMENT "Precompiling platform mappings"
+)
+
 add_library(platform_mapping
   fboss/agent/platforms/common/MultiPimPlatformMapping.cpp
   fboss/agent/platforms/common/PlatformMapping.cpp
+  fboss/agent/platforms/common/PrecompiledPlatformMappings.cpp
+  ${PRECOMPILED_PLATFORM_MAPPINGS_DATA}
 )
 
 target_link_libraries(platform_mapping
@@ -29,10 +29,21 @@ target_link_libraries(alert_logger
   Folly::folly
 )
 
+add_library(slab_allocator
+  fboss/lib/SlabAllocator.h
+)
+
+set_target_properties(slab_allocator PROPERTIES LINKER_LANGUAGE CXX)
+
 add_library(ref_map
   fboss/lib/RefMap.h
 )
 
+target_link_libraries(ref_map
+  slab_allocator
+  Folly::folly
+)
+
 set_target_properties(ref_map PROPERTIES LINKER_LANGUAGE CXX)
 
 add_library(tuple_utils
@@ -0,0 +1,157 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+AclPriorityAllocator::AclPriorityAllocator(
+    int minPriority,
+    int maxPriority,
+    int startPriority,
+    int gap)
+    : minPriority_(minPriority),
+      maxPriority_(maxPriority),
+      startPriority_(std::clamp(startPriority, minPriority, maxPriority)),
+      gap_(std::max(gap, 1)) {
+  if (minPriority_ > maxPriority_) {
+    throw FbossError(
+        "Invalid acl priority range: [", minPriority_, ", ", maxPriority_, "]");
+  }
+}
+
+std::vector<int> AclPriorityAllocator::allocate(
+    const std::vector<std::optional<int>>& existingPriorities) const {
+  auto numAcls = static_cast<int64_t>(existingPriorities.size());
+  if (numAcls > int64_t(maxPriority_) - minPriority_ + 1) {
+    throw FbossError(
+        "Unable to fit ",
+        numAcls,
+        " acls in priority range [",
+        minPriority_,
+        ", ",
+        maxPriority_,
+        "]");
+  }
+  std::vector<int> priorities(numAcls);
+  if (numAcls == 0) {
+    return priorities;
+  }
+  auto anchors = findAnchors(existingPriorities);
+  if (anchors.empty()) {
+    allocateFresh(&priorities);
+    return priorities;
+  }
+  for (auto anchor : anchors) {
+    priorities[anchor] = *existingPriorities[anchor];
+  }
+
+  // ACLs ahead of the first anchor count down from it, gap apart if the
+  // range allows
+  int64_t first = anchors.front();
+  if (first > 0) {
+    auto step =
+        std::min<int64_t>(gap_, (priorities[first] - minPriority_) / first);
+    for (int64_t i = 0; i < first; ++i) {
+      priorities[i] = priorities[first] - step * (first - i);
+    }
+  }
+  // ACLs between two anchors are spread evenly, so that the most room is
+  // left on either side for later insertions
+  for (size_t a = 0; a + 1 < anchors.size(); ++a) {
+    int64_t low = anchors[a];
+    int64_t high = anchors[a + 1];
+    auto step = (int64_t(priorities[high]) - priorities[low]) / (high - low);
+    for (auto i = low + 1; i < high; ++i) {
+      priorities[i] = priorities[low] + step * (i - low);
+    }
+  }
+  // ACLs after the last anchor count up from it
+  int64_t last = anchors.back();
+  if (last + 1 < numAcls) {
+    auto step = std::min<int64_t>(
+        gap_,
+        (int64_t(maxPriority_) - priorities[last]) / (numAcls - 1 - last));
+    for (auto i = last + 1; i < numAcls; ++i) {
+      priorities[i] = priorities[last] + step * (i - last);
+    }
+  }
+  return priorities;
+}
+
+std::vector<size_t> AclPriorityAllocator::findAnchors(
+    const std::vector<std::optional<int>>& existingPriorities) const {
+  /*
+   * ACLs i < j can both keep their priorities p(i), p(j) iff the j - i - 1
+   * ACLs in between fit, i.e. p(j) - p(i) >= j - i, or equivalently
+   * p(i) - i <= p(j) - j. So the anchors are a longest non decreasing
+   * subsequence of p(i) - i, restricted to ACLs that also leave room for
+   * every ACL before them above minPriority and after them below
+   * maxPriority.
+   */
+  auto numAcls = static_cast<int64_t>(existingPriorities.size());
+  std::vector<int64_t> tailKeys;
+  std::vector<size_t> tailIndices;
+  std::vector<std::optional<size_t>> predecessor(existingPriorities.size());
+  for (size_t i = 0; i < existingPriorities.size(); ++i) {
+    if (!existingPriorities[i]) {
+      continue;
+    }
+    int64_t priority = *existingPriorities[i];
+    int64_t key = priority - int64_t(i);
+    if (key < minPriority_ ||
+        priority + (numAcls - 1 - int64_t(i)) > maxPriority_) {
+      continue;
+    }
+    size_t pos = std::upper_bound(tailKeys.begin(), tailKeys.end(), key) -
+        tailKeys.begin();
+    if (pos > 0) {
+      predecessor[i] = tailIndices[pos - 1];
+    }
+    if (pos == tailKeys.size()) {
+      tailKeys.push_back(key);
+      tailIndices.push_back(i);
+    } else {
+      tailKeys[pos] = key;
+      tailIndices[pos] = i;
+    }
+  }
+  std::vector<size_t> anchors;
+  if (tailIndices.empty()) {
+    return anchors;
+  }
+  for (std::optional<size_t> i = tailIndices.back(); i; i = predecessor[*i]) {
+    anchors.push_back(*i);
+  }
+  std::reverse(anchors.begin(), anchors.end());
+  return anchors;
+}
+
+void AclPriorityAllocator::allocateFresh(std::vector<int>* priorities) const {
+  auto numAcls = static_cast<int64_t>(priorities->size());
+  int64_t start = startPriority_;
+  int64_t step = gap_;
+  if (numAcls > 1 && start + step * (numAcls - 1) > maxPriority_) {
+    // Shrink the gap to fit, falling back to the whole range below start
+    step = (int64_t(maxPriority_) - start) / (numAcls - 1);
+    if (step == 0) {
+      start = minPriority_;
+      step = (int64_t(maxPriority_) - start) / (numAcls - 1);
+    }
+  }
+  for (int64_t i = 0; i < numAcls; ++i) {
+    (*priorities)[i] = start + step * i;
+  }
+}
+
+} // namespace facebook::fboss
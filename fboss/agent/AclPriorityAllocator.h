@@ -0,0 +1,61 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * AclPriorityAllocator assigns priorities to an ordered list of ACLs, first
+ * ACL to match getting the smallest priority, out of [minPriority,
+ * maxPriority].
+ *
+ * Fresh ACL lists are laid out gap apart from startPriority, leaving room
+ * for ACLs inserted by later config pushes. When allocating for an updated
+ * list, the allocator keeps the priority every ACL already had, except for
+ * the fewest ACLs that must move to restore ordering or make room for new
+ * ACLs. Only those, and the new ACLs, show up as changed in the resulting
+ * state delta, so hardware reprograms a small local range of the ACL table
+ * instead of every entry following an insertion.
+ */
+class AclPriorityAllocator {
+ public:
+  AclPriorityAllocator(
+      int minPriority,
+      int maxPriority,
+      int startPriority,
+      int gap);
+
+  /*
+   * existingPriorities[i] is the priority the i-th ACL had in the previous
+   * state, if any. Returns strictly increasing priorities, one per ACL.
+   */
+  std::vector<int> allocate(
+      const std::vector<std::optional<int>>& existingPriorities) const;
+
+ private:
+  /*
+   * Indices of the largest set of ACLs that can keep their existing
+   * priority while leaving room for every other ACL in between.
+   */
+  std::vector<size_t> findAnchors(
+      const std::vector<std::optional<int>>& existingPriorities) const;
+
+  void allocateFresh(std::vector<int>* priorities) const;
+
+  const int minPriority_;
+  const int maxPriority_;
+  const int startPriority_;
+  const int gap_;
+};
+
+} // namespace facebook::fboss
@@ -16,6 +16,7 @@
 #include <optional>
 #include <string>
 
+#include "fboss/agent/AclPriorityAllocator.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LoadBalancerConfigApplier.h"
@@ -89,6 +90,17 @@ namespace {
 const uint8_t kV6LinkLocalAddrMask{64};
 // Needed until CoPP is removed from code and put into config
 const int kAclStartPriority = 100000;
+// Acls are allocated priorities kAclPriorityGap apart so that acls added by
+// later config pushes fit in between without renumbering existing ones.
+// CPU acls get priorities below kAclStartPriority / 2. Data plane acls start
+// at kAclStartPriority, with the range below it kept for acls inserted at
+// the top by later pushes.
+const int kAclPriorityGap = 16;
+const int kCpuAclMaxPriority = kAclStartPriority / 2 - 1;
+// Within BCM's range of [0, 1000000]. SAI ASICs report their range at run
+// time. Either way, acls are rejected when programmed with a priority out
+// of the hardware's range.
+const int kAclMaxPriority = 500000;
 
 // Only one buffer pool is supported systemwide. Variable to track the name
 // and validate during a config change.
@@ -268,6 +280,12 @@ class ThriftConfigApplier {
   std::shared_ptr<AclMap> updateAcls(
       std::vector<cfg::AclEntry> configEntries,
       std::optional<std::string> tableName = std::nullopt);
+  std::shared_ptr<AclMap> getOrigAcls(
+      const std::optional<std::string>& tableName) const;
+  std::vector<int> allocateAclPriorities(
+      const AclPriorityAllocator& allocator,
+      const std::vector<std::string>& aclNames,
+      const std::optional<std::string>& tableName) const;
   std::shared_ptr<AclEntry> createAcl(
       const cfg::AclEntry* config,
       int priority,
@@ -1990,8 +2008,58 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
   AclMap::NodeContainer newAcls;
   bool changed = false;
   int numExistingProcessed = 0;
-  int priority = kAclStartPriority;
-  int cpuPriority = 1;
+
+  // Let's get a map of acls to name so we don't have to search the acl list
+  // for every new use
+  flat_map<std::string, const cfg::AclEntry*> aclByName;
+  folly::gen::from(configEntries) |
+      folly::gen::map([](const cfg::AclEntry& acl) {
+        return std::make_pair(*acl.name_ref(), &acl);
+      }) |
+      folly::gen::appendTo(aclByName);
+
+  // Allocate priorities up front, in the order acls are generated below:
+  // DENY acls first, then CPU and data plane traffic policy acls.
+  std::vector<std::string> dataAclNames;
+  std::vector<std::string> cpuAclNames;
+  for (const auto& entry : configEntries) {
+    if (*entry.actionType_ref() == cfg::AclActionType::DENY) {
+      dataAclNames.push_back(*entry.name_ref());
+    }
+  }
+  auto addPolicyAclNames = [&aclByName](
+                               const cfg::TrafficPolicyConfig& policy,
+                               std::vector<std::string>* names) {
+    for (const auto& mta : *policy.matchToAction_ref()) {
+      auto a = aclByName.find(*mta.matcher_ref());
+      if (a != aclByName.end() &&
+          *a->second->actionType_ref() != cfg::AclActionType::DENY) {
+        names->push_back(*mta.matcher_ref());
+      }
+    }
+  };
+  if (cfg_->cpuTrafficPolicy_ref() &&
+      cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref()) {
+    addPolicyAclNames(
+        *cfg_->cpuTrafficPolicy_ref()->trafficPolicy_ref(), &cpuAclNames);
+  }
+  if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy_ref()) {
+    addPolicyAclNames(*dataPlaneTrafficPolicy, &dataAclNames);
+  }
+  auto dataPriorities = allocateAclPriorities(
+      AclPriorityAllocator(
+          kCpuAclMaxPriority + 1,
+          kAclMaxPriority,
+          kAclStartPriority,
+          kAclPriorityGap),
+      dataAclNames,
+      tableName);
+  auto cpuPriorities = allocateAclPriorities(
+      AclPriorityAllocator(1, kCpuAclMaxPriority, 1, kAclPriorityGap),
+      cpuAclNames,
+      tableName);
+  auto priority = dataPriorities.begin();
+  auto cpuPriority = cpuPriorities.begin();
 
   // Start with the DROP acls, these should have highest priority
   auto acls =
@@ -2001,20 +2069,11 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
       }) |
       folly::gen::map([&](const cfg::AclEntry& entry) {
         auto acl = updateAcl(
-            entry, priority++, &numExistingProcessed, &changed, tableName);
+            entry, *priority++, &numExistingProcessed, &changed, tableName);
         return std::make_pair(acl->getID(), acl);
       }) |
       folly::gen::appendTo(newAcls);
 
-  // Let's get a map of acls to name so we don't have to search the acl list
-  // for every new use
-  flat_map<std::string, const cfg::AclEntry*> aclByName;
-  folly::gen::from(configEntries) |
-      folly::gen::map([](const cfg::AclEntry& acl) {
-        return std::make_pair(*acl.name_ref(), &acl);
-      }) |
-      folly::gen::appendTo(aclByName);
-
   flat_map<std::string, const cfg::TrafficCounter*> counterByName;
   folly::gen::from(*cfg_->trafficCounters_ref()) |
       folly::gen::map([](const cfg::TrafficCounter& counter) {
@@ -2067,7 +2126,7 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
 
         auto acl = updateAcl(
             aclCfg,
-            isCoppAcl ? cpuPriority++ : priority++,
+            isCoppAcl ? *cpuPriority++ : *priority++,
             &numExistingProcessed,
             &changed,
             tableName,
@@ -2143,6 +2202,34 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
   return orig_->getAcls()->clone(std::move(newAcls));
 }
 
+std::shared_ptr<AclMap> ThriftConfigApplier::getOrigAcls(
+    const std::optional<std::string>& tableName) const {
+  if (!FLAGS_enable_acl_table_group) {
+    return orig_->getAcls();
+  }
+  if (!orig_->getAclTableGroup()) {
+    return nullptr;
+  }
+  auto origTable =
+      orig_->getAclTableGroup()->getAclTableMap()->getTableIf(*tableName);
+  return origTable ? origTable->getAclMap() : nullptr;
+}
+
+std::vector<int> ThriftConfigApplier::allocateAclPriorities(
+    const AclPriorityAllocator& allocator,
+    const std::vector<std::string>& aclNames,
+    const std::optional<std::string>& tableName) const {
+  auto origAcls = getOrigAcls(tableName);
+  std::vector<std::optional<int>> existingPriorities;
+  existingPriorities.reserve(aclNames.size());
+  for (const auto& name : aclNames) {
+    auto origAcl = origAcls ? origAcls->getEntryIf(name) : nullptr;
+    existingPriorities.push_back(
+        origAcl ? std::make_optional(origAcl->getPriority()) : std::nullopt);
+  }
+  return allocator.allocate(existingPriorities);
+}
+
 std::shared_ptr<AclEntry> ThriftConfigApplier::updateAcl(
     const cfg::AclEntry& acl,
     int priority,
@@ -21,6 +21,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
 #include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/state/ArpEntry.h"
@@ -145,6 +146,15 @@ void ArpHandler::handlePacket(
 
   // This ARP packet is destined to us.
   // Update the sender IP --> sender MAC entry in the ARP table.
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordNeighborLearnt(
+        vlan->getID(),
+        senderIP,
+        senderMac,
+        PortDescriptor::fromRxPacket(*pkt.get()),
+        op,
+        0);
+  }
   updater->receivedArpMine(
       vlan->getID(),
       senderIP,
@@ -152,6 +152,14 @@ bool DHCPv4Handler::isDHCPv4Packet(const UDPHeader& udpHdr) {
       (dstPort == kBootPCPort || dstPort == kBootPSPort);
 }
 
+bool DHCPv4Handler::isDHCPv4Packet(const PktMetadata& metadata) {
+  if (!metadata.hasL4Ports() ||
+      metadata.ipProtocol != static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP)) {
+    return false;
+  }
+  return isDHCPv4Packet(UDPHeader(metadata.l4SrcPort, metadata.l4DstPort, 0));
+}
+
 void DHCPv4Handler::handlePacket(
     SwSwitch* sw,
     std::unique_ptr<RxPacket> pkt,
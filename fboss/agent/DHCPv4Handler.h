@@ -20,6 +20,7 @@ namespace facebook::fboss {
 class SwSwitch;
 class RxPacket;
 class UDPHeader;
+struct PktMetadata;
 class DHCPv4Packet;
 class TxPacket;
 class IPv4Hdr;
@@ -38,6 +39,8 @@ class DHCPv4Handler {
   static constexpr uint16_t kBootPSPort = 67;
   static constexpr uint16_t kBootPCPort = 68;
   static bool isDHCPv4Packet(const UDPHeader& udpHdr);
+  // From the UDP ports of a packet's metadata, without parsing its headers
+  static bool isDHCPv4Packet(const PktMetadata& metadata);
   static void handlePacket(
       SwSwitch* sw,
       std::unique_ptr<RxPacket> pkt,
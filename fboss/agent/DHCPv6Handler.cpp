@@ -124,6 +124,14 @@ bool DHCPv6Handler::isForDHCPv6RelayOrServer(const UDPHeader& udpHdr) {
   return (udpHdr.dstPort == DHCPv6Packet::DHCP6_SERVERAGENT_UDPPORT);
 }
 
+bool DHCPv6Handler::isForDHCPv6RelayOrServer(const PktMetadata& metadata) {
+  if (!metadata.hasL4Ports() ||
+      metadata.ipProtocol != static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP)) {
+    return false;
+  }
+  return metadata.l4DstPort == DHCPv6Packet::DHCP6_SERVERAGENT_UDPPORT;
+}
+
 void DHCPv6Handler::handlePacket(
     SwSwitch* sw,
     std::unique_ptr<RxPacket> pkt,
@@ -21,6 +21,7 @@ namespace facebook::fboss {
 class SwSwitch;
 class RxPacket;
 class UDPHeader;
+struct PktMetadata;
 class DHCPv6Packet;
 class TxPacket;
 class IPv6Hdr;
@@ -30,6 +31,8 @@ class DHCPv6Handler {
   enum { MAX_RELAY_HOPCOUNT = 10 };
 
   static bool isForDHCPv6RelayOrServer(const UDPHeader& udpHdr);
+  // From the UDP ports of a packet's metadata, without parsing its headers
+  static bool isForDHCPv6RelayOrServer(const PktMetadata& metadata);
 
   static void handlePacket(
       SwSwitch* sw,
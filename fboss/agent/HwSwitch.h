@@ -35,6 +35,7 @@ class RxPacket;
 class TxPacket;
 class L2Entry;
 class HwSwitchStats;
+class BufferWatermarkSampler;
 
 enum class L2EntryUpdateType : uint8_t;
 
@@ -228,6 +229,13 @@ class HwSwitch {
    * Get latest device watermark bytes
    */
   virtual uint64_t getDeviceWatermarkBytes() const = 0;
+  /*
+   * Sampler of queue watermarks at sub-second intervals, nullptr if the
+   * hardware doesn't support it
+   */
+  virtual BufferWatermarkSampler* getBufferWatermarkSampler() const {
+    return nullptr;
+  }
   /*
    * Allow hardware to perform any warm boot related cleanup
    * before we exit the application.
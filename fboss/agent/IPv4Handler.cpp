@@ -14,6 +14,7 @@
 #include <folly/MacAddress.h>
 #include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
+#include <optional>
 #include "fboss/agent/ArpHandler.h"
 #include "fboss/agent/DHCPv4Handler.h"
 #include "fboss/agent/FbossError.h"
@@ -29,6 +30,7 @@
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/packet/ICMPHdr.h"
 #include "fboss/agent/packet/IPv4Hdr.h"
+#include "fboss/agent/packet/PktUtil.h"
 #include "fboss/agent/packet/UDPHeader.h"
 #include "fboss/agent/state/ArpResponseTable.h"
 #include "fboss/agent/state/ArpTable.h"
@@ -47,6 +49,10 @@ using folly::io::Cursor;
 using folly::io::RWPrivateCursor;
 using std::unique_ptr;
 
+namespace {
+constexpr size_t kIPv4DstAddrOffset = 16;
+} // namespace
+
 namespace facebook::fboss {
 
 template <typename BodyFn>
@@ -126,16 +132,49 @@ void IPv4Handler::handlePacket(
   SwitchStats* stats = sw_->stats();
   PortID port = pkt->getSrcPort();
 
-  const uint32_t l3Len = pkt->getLength() - (cursor - Cursor(pkt->buf()));
+  const auto& metadata = pkt->getMetadata();
+  const uint32_t l3Len = pkt->getLength() - metadata.l3Offset;
   stats->port(port)->ipv4Rx();
-  IPv4Hdr v4Hdr(cursor);
-  XLOG(DBG4) << "Rx IPv4 packet (" << l3Len << " bytes) " << v4Hdr.srcAddr.str()
-             << " --> " << v4Hdr.dstAddr.str() << " proto: 0x" << std::hex
-             << static_cast<int>(v4Hdr.protocol);
+
+  // For packets it has the L4 header of, the metadata has checked the IP
+  // header the way IPv4Hdr does and has the fields used below. The header
+  // is only parsed in full for other packets (non-first fragments, and
+  // malformed headers, which IPv4Hdr throws on), or for DHCP and TTL
+  // expiry handling, which need all of it.
+  const Cursor l3Cursor(cursor);
+  std::optional<IPv4Hdr> parsedHdr;
+  if (metadata.hasL4()) {
+    cursor.skip(metadata.l4Offset - metadata.l3Offset);
+  } else {
+    parsedHdr.emplace(cursor);
+  }
+  auto getV4Hdr = [&]() -> IPv4Hdr& {
+    if (!parsedHdr) {
+      Cursor hdrCursor(l3Cursor);
+      parsedHdr.emplace(hdrCursor);
+    }
+    return *parsedHdr;
+  };
+  const uint8_t protocol =
+      parsedHdr ? parsedHdr->protocol : metadata.ipProtocol;
+  const uint8_t ttl = parsedHdr ? parsedHdr->ttl : metadata.ttl;
+  const uint32_t payloadLen = parsedHdr
+      ? parsedHdr->payloadSize()
+      : metadata.l3Length - (metadata.l4Offset - metadata.l3Offset);
+  IPAddressV4 dstAddr;
+  if (parsedHdr) {
+    dstAddr = parsedHdr->dstAddr;
+  } else {
+    Cursor addrCursor(l3Cursor);
+    addrCursor.skip(kIPv4DstAddrOffset);
+    dstAddr = PktUtil::readIPv4(&addrCursor);
+  }
+  XLOG(DBG4) << "Rx IPv4 packet (" << l3Len << " bytes) "
+             << getV4Hdr().srcAddr.str() << " --> " << dstAddr.str()
+             << " proto: 0x" << std::hex << static_cast<int>(protocol);
 
   // Additional data (such as FCS) may be appended after the IP payload
-  auto payload =
-      folly::IOBuf::wrapBuffer(cursor.data(), v4Hdr.length - v4Hdr.size());
+  auto payload = folly::IOBuf::wrapBuffer(cursor.data(), payloadLen);
   cursor.reset(payload.get());
 
   // retrieve the current switch state
@@ -148,7 +187,10 @@ void IPv4Handler::handlePacket(
     return;
   }
 
-  if (v4Hdr.protocol == static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP)) {
+  // Only parse the UDP header of DHCP packets. Those whose UDP header is
+  // missing from the metadata still are, to count them if it is too small.
+  if (protocol == static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP) &&
+      (!metadata.hasL4() || DHCPv4Handler::isDHCPv4Packet(metadata))) {
     Cursor udpCursor(cursor);
     UDPHeader udpHdr;
     udpHdr.parse(&udpCursor, sw_->portStats(port));
@@ -156,7 +198,7 @@ void IPv4Handler::handlePacket(
                << " destination port: " << udpHdr.dstPort;
     if (DHCPv4Handler::isDHCPv4Packet(udpHdr)) {
       DHCPv4Handler::handlePacket(
-          sw_, std::move(pkt), src, dst, v4Hdr, udpHdr, udpCursor);
+          sw_, std::move(pkt), src, dst, getV4Hdr(), udpHdr, udpCursor);
       return;
     }
   }
@@ -166,10 +208,10 @@ void IPv4Handler::handlePacket(
   // TODO: assume vrf 0 now
   std::shared_ptr<Interface> intf{nullptr};
   auto interfaceMap = state->getInterfaces();
-  if (v4Hdr.dstAddr.isMulticast()) {
+  if (dstAddr.isMulticast()) {
     // Forward multicast packet directly to corresponding host interface
     intf = interfaceMap->getInterfaceInVlanIf(pkt->getSrcVlan());
-  } else if (v4Hdr.dstAddr.isLinkLocal()) {
+  } else if (dstAddr.isLinkLocal()) {
     // XXX: Ideally we should scope the limit to Link only. However we are
     // using v4 link locals in a special way on Galaxy/6pack which needs because
     // of which we do not limit the scope.
@@ -177,13 +219,13 @@ void IPv4Handler::handlePacket(
     // Forward link-local packet directly to corresponding host interface
     // provided desAddr is assigned to that interface.
     // intf = interfaceMap->getInterfaceInVlanIf(pkt->getSrcVlan());
-    // if (not intf->hasAddress(v4Hdr.dstAddr)) {
+    // if (not intf->hasAddress(dstAddr)) {
     //   intf = nullptr;
     // }
-    intf = interfaceMap->getInterfaceIf(RouterID(0), v4Hdr.dstAddr);
+    intf = interfaceMap->getInterfaceIf(RouterID(0), dstAddr);
   } else {
     // Else loopup host interface based on destAddr
-    intf = interfaceMap->getInterfaceIf(RouterID(0), v4Hdr.dstAddr);
+    intf = interfaceMap->getInterfaceIf(RouterID(0), dstAddr);
   }
 
   if (intf) {
@@ -204,13 +246,14 @@ void IPv4Handler::handlePacket(
   }
 
   // if packet is not for us, check the ttl exceed
-  if (v4Hdr.ttl <= 1) {
+  if (ttl <= 1) {
     XLOG(DBG4) << "Rx IPv4 Packet with TTL expired";
     stats->port(port)->pktDropped();
     stats->port(port)->ipv4TtlExceeded();
     // Look up cpu mac from platform
     MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-    sendICMPTimeExceeded(pkt->getSrcVlan(), cpuMac, cpuMac, v4Hdr, cursor);
+    sendICMPTimeExceeded(
+        pkt->getSrcVlan(), cpuMac, cpuMac, getV4Hdr(), cursor);
     return;
   }
 
@@ -218,7 +261,7 @@ void IPv4Handler::handlePacket(
   // TODO: Also check to see if this is the broadcast address for one of the
   // interfaces on this VLAN. We should probably build up a more efficient
   // data structure to look up this information.
-  if (v4Hdr.dstAddr.isLinkLocalBroadcast()) {
+  if (dstAddr.isLinkLocalBroadcast()) {
     stats->port(port)->pktDropped();
     return;
   }
@@ -228,10 +271,10 @@ void IPv4Handler::handlePacket(
   // We will need to manage the rate somehow. Either from HW
   // or a SW control here
   stats->port(port)->ipv4Nexthop();
-  if (!resolveMac(state, port, v4Hdr.dstAddr, pkt->getSrcVlan())) {
+  if (!resolveMac(state, port, dstAddr, pkt->getSrcVlan())) {
     stats->port(port)->ipv4NoArp();
     XLOG(DBG4) << "Cannot find the interface to send out ARP request for "
-               << v4Hdr.dstAddr.str();
+               << dstAddr.str();
   }
   // TODO: ideally, we need to store this packet until the ARP is done and
   // then send this pkt out. For now, just drop it.
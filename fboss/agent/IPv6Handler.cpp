@@ -12,6 +12,7 @@
 #include <folly/Format.h>
 #include <folly/MacAddress.h>
 #include <folly/logging/xlog.h>
+#include <optional>
 #include "fboss/agent/DHCPv6Handler.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/NeighborUpdater.h"
@@ -20,6 +21,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/packet/ICMPHdr.h"
 #include "fboss/agent/packet/IPv6Hdr.h"
@@ -45,6 +47,10 @@ using folly::io::RWPrivateCursor;
 using std::shared_ptr;
 using std::unique_ptr;
 
+namespace {
+constexpr size_t kIPv6DstAddrOffset = 24;
+} // namespace
+
 namespace facebook::fboss {
 
 template <typename BodyFn>
@@ -129,18 +135,54 @@ void IPv6Handler::handlePacket(
     MacAddress dst,
     MacAddress src,
     Cursor cursor) {
-  const uint32_t l3Len = pkt->getLength() - (cursor - Cursor(pkt->buf()));
-  IPv6Hdr ipv6(cursor); // note: advances our cursor object
+  const auto& metadata = pkt->getMetadata();
+  const uint32_t l3Len = pkt->getLength() - metadata.l3Offset;
+
+  // For packets it has the L4 header right after the fixed header of, the
+  // metadata has checked the IP header the way IPv6Hdr does and has the
+  // fields used below. The header is only parsed in full for other packets
+  // (those with extension headers, and malformed ones, which IPv6Hdr throws
+  // on), or for the handlers further down that need all of it.
+  const Cursor l3Cursor(cursor);
+  std::optional<IPv6Hdr> parsedHdr;
+  constexpr uint8_t kExtHeaders =
+      PktMetadata::IP_OPTIONS | PktMetadata::IP_FRAGMENT;
+  if (metadata.hasL4() && !(metadata.flags & kExtHeaders)) {
+    cursor.skip(IPv6Hdr::SIZE);
+  } else {
+    parsedHdr.emplace(cursor); // note: advances our cursor object
+  }
+  auto getIPv6Hdr = [&]() -> IPv6Hdr& {
+    if (!parsedHdr) {
+      Cursor hdrCursor(l3Cursor);
+      parsedHdr.emplace(hdrCursor);
+    }
+    return *parsedHdr;
+  };
+  const uint8_t nextHeader =
+      parsedHdr ? parsedHdr->nextHeader : metadata.ipProtocol;
+  const uint8_t hopLimit = parsedHdr ? parsedHdr->hopLimit : metadata.ttl;
+  const uint32_t payloadLength = parsedHdr
+      ? parsedHdr->payloadLength
+      : metadata.l3Length - IPv6Hdr::SIZE;
+  IPAddressV6 dstAddr;
+  if (parsedHdr) {
+    dstAddr = parsedHdr->dstAddr;
+  } else {
+    Cursor addrCursor(l3Cursor);
+    addrCursor.skip(kIPv6DstAddrOffset);
+    dstAddr = PktUtil::readIPv6(&addrCursor);
+  }
   XLOG(DBG4) << "IPv6 (" << l3Len
              << " bytes)"
                 " port: "
              << pkt->getSrcPort() << " vlan: " << pkt->getSrcVlan()
-             << " src: " << ipv6.srcAddr.str() << " (" << src << ")"
-             << " dst: " << ipv6.dstAddr.str() << " (" << dst << ")"
-             << " nextHeader: " << static_cast<int>(ipv6.nextHeader);
+             << " src: " << getIPv6Hdr().srcAddr.str() << " (" << src << ")"
+             << " dst: " << dstAddr.str() << " (" << dst << ")"
+             << " nextHeader: " << static_cast<int>(nextHeader);
 
   // Additional data (such as FCS) may be appended after the IP payload
-  auto payload = folly::IOBuf::wrapBuffer(cursor.data(), ipv6.payloadLength);
+  auto payload = folly::IOBuf::wrapBuffer(cursor.data(), payloadLength);
   cursor.reset(payload.get());
 
   // retrieve the current switch state
@@ -149,7 +191,11 @@ void IPv6Handler::handlePacket(
 
   // NOTE: DHCPv6 solicit packet from client has hoplimit set to 1,
   // we need to handle it before send the ICMPv6 TTL exceeded
-  if (ipv6.nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP)) {
+  // Only parse the UDP header of DHCPv6 packets. Those whose UDP header is
+  // missing from the metadata still are, to count them if it is too small.
+  if (nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP) &&
+      (!metadata.hasL4() ||
+       DHCPv6Handler::isForDHCPv6RelayOrServer(metadata))) {
     Cursor udpCursor(cursor);
     UDPHeader udpHdr;
     udpHdr.parse(&udpCursor, sw_->portStats(port));
@@ -157,7 +203,7 @@ void IPv6Handler::handlePacket(
                << " destination port: " << udpHdr.dstPort;
     if (DHCPv6Handler::isForDHCPv6RelayOrServer(udpHdr)) {
       DHCPv6Handler::handlePacket(
-          sw_, std::move(pkt), src, dst, ipv6, udpHdr, udpCursor);
+          sw_, std::move(pkt), src, dst, getIPv6Hdr(), udpHdr, udpCursor);
       return;
     }
   }
@@ -170,34 +216,35 @@ void IPv6Handler::handlePacket(
   //    it now.
   std::shared_ptr<Interface> intf{nullptr};
   auto interfaceMap = state->getInterfaces();
-  if (ipv6.dstAddr.isMulticast()) {
+  if (dstAddr.isMulticast()) {
     // Forward multicast packet directly to corresponding host interface
     // and let Linux handle it. In software we consume ICMPv6 Multicast
     // packets for function of NDP protocol, rest all are forwarded to host.
     intf = interfaceMap->getInterfaceInVlanIf(pkt->getSrcVlan());
-  } else if (ipv6.dstAddr.isLinkLocal()) {
+  } else if (dstAddr.isLinkLocal()) {
     // Forward link-local packet directly to corresponding host interface
     // provided desAddr is assigned to that interface.
     intf = interfaceMap->getInterfaceInVlanIf(pkt->getSrcVlan());
-    if (intf && !(intf->hasAddress(ipv6.dstAddr))) {
+    if (intf && !(intf->hasAddress(dstAddr))) {
       intf = nullptr;
     }
   } else {
     // Else loopup host interface based on destAddr
-    intf = interfaceMap->getInterfaceIf(RouterID(0), ipv6.dstAddr);
+    intf = interfaceMap->getInterfaceIf(RouterID(0), dstAddr);
   }
 
   // If the packet is destined to us, accept packets
   // with a hop limit of 1. Else we need to forward
   // this packet so the hop limit should be at least 1
   auto minHopLimit = intf ? 0 : 1;
-  if (ipv6.hopLimit <= minHopLimit) {
+  if (hopLimit <= minHopLimit) {
     XLOG(DBG4) << "Rx IPv6 Packet with hop limit exceeded";
     sw_->portStats(port)->pktDropped();
     sw_->portStats(port)->ipv6HopExceeded();
     // Look up cpu mac from platform
     MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-    sendICMPv6TimeExceeded(pkt->getSrcVlan(), cpuMac, cpuMac, ipv6, cursor);
+    sendICMPv6TimeExceeded(
+        pkt->getSrcVlan(), cpuMac, cpuMac, getIPv6Hdr(), cursor);
     return;
   }
 
@@ -206,15 +253,21 @@ void IPv6Handler::handlePacket(
     // Anything not handled by the controller, we will forward it to the host,
     // i.e. ping, ssh, bgp...
     PortID portID = pkt->getSrcPort();
-    if (ipv6.payloadLength > intf->getMtu()) {
+    if (payloadLength > intf->getMtu()) {
       // Generate PTB as interface to dst intf has MTU smaller than payload
       sendICMPv6PacketTooBig(
-          portID, pkt->getSrcVlan(), src, dst, ipv6, intf->getMtu(), cursor);
+          portID,
+          pkt->getSrcVlan(),
+          src,
+          dst,
+          getIPv6Hdr(),
+          intf->getMtu(),
+          cursor);
       sw_->portStats(portID)->pktDropped();
       return;
     }
-    if (ipv6.nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP)) {
-      pkt = handleICMPv6Packet(std::move(pkt), dst, src, ipv6, cursor);
+    if (nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP)) {
+      pkt = handleICMPv6Packet(std::move(pkt), dst, src, getIPv6Hdr(), cursor);
       if (pkt == nullptr) {
         // packet has been handled
         return;
@@ -230,12 +283,13 @@ void IPv6Handler::handlePacket(
   }
 
   // Don't send solicitations for multicast or broadcast addresses.
-  if (!ipv6.dstAddr.isMulticast() && !ipv6.dstAddr.isLinkLocalBroadcast()) {
+  if (!dstAddr.isMulticast() && !dstAddr.isLinkLocalBroadcast()) {
     // If IP is not multicast or linklocal broadcast, we need to resolve the IP
     // for this packet.
     // TODO: Add rate limiting so we don't generate too many requests for the
     // same IP.  Following the rules in RFC 4861 should be sufficient.
-    resolveDestAndHandlePacket(ipv6, std::move(pkt), dst, src, cursor);
+    resolveDestAndHandlePacket(
+        getIPv6Hdr(), std::move(pkt), dst, src, cursor);
   }
 }
 
@@ -445,6 +499,15 @@ void IPv6Handler::handleNeighborSolicitation(
       return;
     }
 
+    if (auto recorder = sw_->getUpdateStreamRecorder()) {
+      recorder->recordNeighborLearnt(
+          vlan->getID(),
+          hdr.ipv6->srcAddr,
+          ndpOptions.sourceLinkLayerAddress.value(),
+          srcPortDescriptor,
+          static_cast<int32_t>(type),
+          0);
+    }
     updater->receivedNdpMine(
         vlan->getID(),
         hdr.ipv6->srcAddr,
@@ -526,6 +589,15 @@ void IPv6Handler::handleNeighborAdvertisement(
     return;
   }
 
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordNeighborLearnt(
+        vlan->getID(),
+        targetIP,
+        hdr.src,
+        PortDescriptor::fromRxPacket(*pkt.get()),
+        static_cast<int32_t>(type),
+        flags);
+  }
   updater->receivedNdpMine(
       vlan->getID(),
       targetIP,
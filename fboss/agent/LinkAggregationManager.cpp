@@ -21,16 +21,68 @@
 #include "fboss/agent/state/DeltaFunctions.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <tuple>
 #include <utility>
 
+namespace {
+using facebook::fboss::FunctionStateUpdate;
+using facebook::fboss::StateUpdate;
+using facebook::fboss::SwSwitch;
+
+/*
+ * Programs a batch of member forwarding and partner states, records how
+ * long each member transition waited to be applied and then calls
+ * onDone. onDone is called even if the batch fails, so that the member
+ * transitions queued behind it still get programmed.
+ */
+class ForwardingAndPartnerStatesUpdate : public FunctionStateUpdate {
+ public:
+  ForwardingAndPartnerStatesUpdate(
+      SwSwitch* sw,
+      StateUpdateFn fn,
+      std::vector<std::chrono::steady_clock::time_point> queuedAt,
+      std::function<void()> onDone)
+      : FunctionStateUpdate(
+            "AggregatePort ForwardingAndPartnerState",
+            std::move(fn),
+            static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING)),
+        sw_(sw),
+        queuedAt_(std::move(queuedAt)),
+        onDone_(std::move(onDone)) {}
+
+  void onSuccess() override {
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& queuedAt : queuedAt_) {
+      sw_->stats()->lacpStateUpdateLatency(
+          std::chrono::duration_cast<std::chrono::milliseconds>(now - queuedAt)
+              .count());
+    }
+    onDone_();
+  }
+
+  void onError(const std::exception& ex) noexcept override {
+    XLOG(ERR) << "Failed to program " << queuedAt_.size()
+              << " member forwarding and partner states: "
+              << folly::exceptionStr(ex);
+    onDone_();
+  }
+
+ private:
+  SwSwitch* sw_;
+  std::vector<std::chrono::steady_clock::time_point> queuedAt_;
+  std::function<void()> onDone_;
+};
+} // namespace
+
 namespace facebook::fboss {
 
 void LinkAggregationManager::recordStatistics(
@@ -103,7 +155,8 @@ std::ostream& operator<<(
 LinkAggregationManager::LinkAggregationManager(SwSwitch* sw)
     : AutoRegisterStateObserver(sw, "LinkAggregationManager"),
       portToController_(),
-      sw_(sw) {}
+      sw_(sw),
+      self_(this, [](LinkAggregationManager* /* unused */) {}) {}
 
 void LinkAggregationManager::handlePacket(
     std::unique_ptr<RxPacket> pkt,
@@ -362,8 +415,7 @@ void LinkAggregationManager::enableForwardingAndSetPartnerState(
   auto enableFwdStateFn = ProgramForwardingAndPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::ENABLED, partnerState);
 
-  sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(enableFwdStateFn));
+  queueForwardingAndPartnerState(std::move(enableFwdStateFn), portID);
 }
 
 void LinkAggregationManager::disableForwardingAndSetPartnerState(
@@ -375,8 +427,83 @@ void LinkAggregationManager::disableForwardingAndSetPartnerState(
   auto disableFwdStateFn = ProgramForwardingAndPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::DISABLED, partnerState);
 
-  sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(disableFwdStateFn));
+  queueForwardingAndPartnerState(std::move(disableFwdStateFn), portID);
+}
+
+void LinkAggregationManager::queueForwardingAndPartnerState(
+    ProgramForwardingAndPartnerState programFn,
+    PortID portID) {
+  auto it = pendingForwardingAndPartnerStates_.find(portID);
+  if (it != pendingForwardingAndPartnerStates_.end()) {
+    // The latest transition of a member supersedes the pending one, but the
+    // latency is still measured from the first one.
+    it->second.programFn = std::move(programFn);
+  } else {
+    pendingForwardingAndPartnerStates_.emplace(
+        portID,
+        PendingForwardingAndPartnerState{
+            std::move(programFn), std::chrono::steady_clock::now()});
+  }
+
+  // Otherwise this is programmed along with everything else queued once the
+  // update in flight is applied
+  if (!forwardingAndPartnerStateUpdateInFlight_) {
+    programPendingForwardingAndPartnerStates();
+  }
+}
+
+void LinkAggregationManager::programPendingForwardingAndPartnerStates() {
+  CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
+
+  forwardingAndPartnerStateUpdateInFlight_ = false;
+  if (pendingForwardingAndPartnerStates_.empty()) {
+    return;
+  }
+
+  std::vector<ProgramForwardingAndPartnerState> programFns;
+  std::vector<std::chrono::steady_clock::time_point> queuedAt;
+  programFns.reserve(pendingForwardingAndPartnerStates_.size());
+  queuedAt.reserve(pendingForwardingAndPartnerStates_.size());
+  for (const auto& [portID, pending] : pendingForwardingAndPartnerStates_) {
+    std::ignore = portID;
+    programFns.push_back(pending.programFn);
+    queuedAt.push_back(pending.queuedAt);
+  }
+  pendingForwardingAndPartnerStates_.clear();
+
+  auto updateFn = [programFns = std::move(programFns)](
+                      const std::shared_ptr<SwitchState>& state) mutable {
+    std::shared_ptr<SwitchState> nextState(state);
+    bool changed = false;
+    for (auto& programFn : programFns) {
+      // A member removed from its LAG meanwhile must not keep the others
+      // from being programmed
+      try {
+        if (auto newState = programFn(nextState)) {
+          nextState = newState;
+          changed = true;
+        }
+      } catch (const std::exception& ex) {
+        XLOG(ERR) << "Failed to program member forwarding and partner state: "
+                  << folly::exceptionStr(ex);
+      }
+    }
+    return changed ? nextState : nullptr;
+  };
+
+  // Called on the update thread, by which time this may be gone
+  auto onDone = [evb = sw_->getLacpEvb(),
+                    self = std::weak_ptr<LinkAggregationManager>(self_)]() {
+    evb->runInEventBaseThread([self]() {
+      if (auto manager = self.lock()) {
+        manager->programPendingForwardingAndPartnerStates();
+      }
+    });
+  };
+
+  forwardingAndPartnerStateUpdateInFlight_ =
+      sw_->updateState(std::make_unique<ForwardingAndPartnerStatesUpdate>(
+          sw_, std::move(updateFn), std::move(queuedAt), std::move(onDone)));
 }
 
 void LinkAggregationManager::recordLacpTimeout() {
@@ -415,6 +542,9 @@ LinkAggregationManager::~LinkAggregationManager() {
   for (auto controller : portToController_) {
     controller.second->stopMachines();
   }
+  // Applied updates call back on the LACP EventBase, where self_ is only
+  // dropped once none of them is running
+  sw_->getLacpEvb()->runInEventBaseThreadAndWait([this]() { self_.reset(); });
 }
 
 } // namespace facebook::fboss
@@ -19,6 +19,7 @@
 #include <folly/SharedMutex.h>
 #include <folly/io/Cursor.h>
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -116,6 +117,11 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
 
+  void queueForwardingAndPartnerState(
+      ProgramForwardingAndPartnerState programFn,
+      PortID portID);
+  void programPendingForwardingAndPartnerStates();
+
   // Forbidden copy constructor and assignment operator
   LinkAggregationManager(LinkAggregationManager const&) = delete;
   LinkAggregationManager& operator=(LinkAggregationManager const&) = delete;
@@ -129,6 +135,23 @@ class LinkAggregationManager : public AutoRegisterStateObserver,
   PortIDToController portToController_;
   mutable folly::SharedMutexWritePriority controllersLock_;
   SwSwitch* sw_{nullptr};
+
+  /*
+   * Member forwarding and partner state changes waiting to be programmed.
+   * A change is programmed right away unless an earlier state update for
+   * them is still in flight. Changes queued in the meantime are coalesced,
+   * across all the LAGs, and programmed with a single state update once it
+   * is applied. Only accessed from the LACP EventBase.
+   */
+  struct PendingForwardingAndPartnerState {
+    ProgramForwardingAndPartnerState programFn;
+    std::chrono::steady_clock::time_point queuedAt;
+  };
+  boost::container::flat_map<PortID, PendingForwardingAndPartnerState>
+      pendingForwardingAndPartnerStates_;
+  bool forwardingAndPartnerStateUpdateInFlight_{false};
+  // Does not own this, lets applied state updates check if it is still around
+  std::shared_ptr<LinkAggregationManager> self_;
 };
 
 } // namespace facebook::fboss
@@ -8,6 +8,9 @@
  *
  */
 
+#pragma once
+
+#include <atomic>
 #include <mutex>
 
 namespace facebook::fboss {
@@ -18,19 +21,79 @@ class CoarseGrainedLockPolicy {
   const std::lock_guard<std::mutex>& lock() const {
     return lock_;
   }
+  // The lock is held throughout, so chunks of work never give it up
+  const std::lock_guard<std::mutex>& lockChunk() const {
+    return lock_;
+  }
+  bool shouldYield() const {
+    return false;
+  }
 
  private:
   std::lock_guard<std::mutex> lock_;
 };
 
+/*
+ * Shared by a PriorityLockGuard and the FineGrainedLockPolicy users it
+ * preempts. The gate is held by a PriorityLockGuard for as long as it waits
+ * for the mutex, and taken by lockChunk() before the mutex, so a chunk can
+ * not start in between.
+ */
+struct PriorityLockWaiters {
+  std::mutex gate;
+  std::atomic<int> count{0};
+};
+
 class FineGrainedLockPolicy {
  public:
-  explicit FineGrainedLockPolicy(std::mutex& m) : mutex_(m) {}
+  explicit FineGrainedLockPolicy(
+      std::mutex& m,
+      PriorityLockWaiters* priorityWaiters = nullptr)
+      : mutex_(m), priorityWaiters_(priorityWaiters) {}
   std::lock_guard<std::mutex> lock() const {
     return std::lock_guard<std::mutex>(mutex_);
   }
 
+  /*
+   * Lock for a chunk of work, rather than for a single object. The chunk
+   * should end, giving up the lock, as soon as shouldYield() is true.
+   * Blocks while a PriorityLockGuard is waiting for the mutex, which gets
+   * it first.
+   */
+  std::unique_lock<std::mutex> lockChunk() const {
+    if (!priorityWaiters_) {
+      return std::unique_lock<std::mutex>(mutex_);
+    }
+    std::lock_guard<std::mutex> gate(priorityWaiters_->gate);
+    return std::unique_lock<std::mutex>(mutex_);
+  }
+  bool shouldYield() const {
+    return priorityWaiters_ &&
+        priorityWaiters_->count.load(std::memory_order_acquire) > 0;
+  }
+
  private:
   std::mutex& mutex_;
+  PriorityLockWaiters* priorityWaiters_{nullptr};
+};
+
+/*
+ * Lock a mutex ahead of FineGrainedLockPolicy users sharing the same
+ * waiters, who give it up at the end of their current chunk of work.
+ */
+class PriorityLockGuard {
+ public:
+  PriorityLockGuard(std::mutex& m, PriorityLockWaiters& waiters) {
+    std::lock_guard<std::mutex> gate(waiters.gate);
+    waiters.count.fetch_add(1, std::memory_order_acq_rel);
+    lock_ = std::unique_lock<std::mutex>(m);
+    waiters.count.fetch_sub(1, std::memory_order_acq_rel);
+  }
+  const std::unique_lock<std::mutex>& lock() const {
+    return lock_;
+  }
+
+ private:
+  std::unique_lock<std::mutex> lock_;
 };
 } // namespace facebook::fboss
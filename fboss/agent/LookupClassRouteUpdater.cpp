@@ -30,13 +30,59 @@ namespace facebook::fboss {
 // Helper methods
 
 void LookupClassRouteUpdater::reAddAllRoutes(const StateDelta& stateDelta) {
+  vlan2PrefixesIndex_.clear();
   auto addRoute = [&stateDelta, this](RouterID rid, const auto& route) {
-    if (!route->getClassID().has_value()) {
+    if (route->getClassID().has_value()) {
+      updateRouteIndex(stateDelta, rid, route, true /* add */);
+    } else {
+      processRouteAdded(stateDelta, rid, route);
+      ++numRoutesReAdded_;
+    }
+  };
+  forAllRoutes(stateDelta.newState(), addRoute);
+  routeIndexValid_ = true;
+}
+
+void LookupClassRouteUpdater::reAddRoutes(
+    const StateDelta& stateDelta,
+    const std::set<VlanID>& vlans) {
+  if (vlans.empty() || vlan2SubnetsCache_.empty()) {
+    return;
+  }
+
+  /*
+   * When a new subnet is added to the cache, the nextHops of existing
+   * routes may become eligible for caching in nextHopAndVlan2Prefixes_.
+   * Furthermore, such a nextHop may have classID associated with it, and in
+   * that case, the corresponding route could inherit that classID. Thus,
+   * re-add the routes with nextHops in the vlans of the new subnets.
+   */
+  if (!routeIndexValid_) {
+    reAddAllRoutes(stateDelta);
+    return;
+  }
+
+  auto& newState = stateDelta.newState();
+  auto reAddRoute = [&stateDelta, this](RouterID rid, const auto& route) {
+    if (route && !route->getClassID().has_value()) {
       processRouteAdded(stateDelta, rid, route);
+      ++numRoutesReAdded_;
     }
   };
-  if (!vlan2SubnetsCache_.empty()) {
-    forAllRoutes(stateDelta.newState(), addRoute);
+  for (auto vlanID : vlans) {
+    auto it = vlan2PrefixesIndex_.find(vlanID);
+    if (it == vlan2PrefixesIndex_.end()) {
+      continue;
+    }
+    // processRouteAdded updates the index, iterate over a copy
+    std::vector<RidAndCidr> prefixes(it->second.begin(), it->second.end());
+    for (const auto& [rid, cidr] : prefixes) {
+      if (cidr.first.isV6()) {
+        reAddRoute(rid, findRoute<folly::IPAddressV6>(rid, cidr, newState));
+      } else {
+        reAddRoute(rid, findRoute<folly::IPAddressV4>(rid, cidr, newState));
+      }
+    }
   }
 }
 
@@ -127,13 +173,12 @@ bool LookupClassRouteUpdater::belongsToSubnetInCache(
   return false;
 }
 
-void LookupClassRouteUpdater::updateSubnetsCache(
+std::set<VlanID> LookupClassRouteUpdater::updateSubnetsCache(
     const StateDelta& stateDelta,
-    std::shared_ptr<Port> port,
-    bool reAddAllRoutesEnabled) {
+    std::shared_ptr<Port> port) {
   auto& newState = stateDelta.newState();
 
-  bool subnetCacheUpdated = false;
+  std::set<VlanID> updatedVlans;
   for (const auto& [vlanID, vlanInfo] : port->getVlans()) {
     std::ignore = vlanInfo;
     auto vlan = newState->getVlans()->getVlanIf(vlanID);
@@ -146,28 +191,21 @@ void LookupClassRouteUpdater::updateSubnetsCache(
         newState->getInterfaces()->getInterfaceIf(vlan->getInterfaceID());
     if (interface) {
       for (auto address : interface->getAddresses()) {
-        subnetCacheUpdated = subnetsCache.insert(address).second;
+        if (subnetsCache.insert(address).second) {
+          updatedVlans.insert(vlanID);
+        }
       }
     }
   }
-  if (subnetCacheUpdated && reAddAllRoutesEnabled) {
-    /*
-     * When a new subnet is added to the cache, the nextHops of existing
-     * routes may become eligible for caching in
-     * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
-     * classID associated with it, and in that case, the corresponding
-     * route could inherit that classID. Thus, re-add all the routes.
-     */
-    reAddAllRoutes(stateDelta);
-  }
+
+  return updatedVlans;
 }
 
 // Methods for handling port updates
 
-void LookupClassRouteUpdater::processPortAdded(
+std::set<VlanID> LookupClassRouteUpdater::processPortAdded(
     const StateDelta& stateDelta,
-    const std::shared_ptr<Port>& addedPort,
-    bool reAddAllRoutesEnabled) {
+    const std::shared_ptr<Port>& addedPort) {
   CHECK(addedPort);
 
   if (addedPort->getLookupClassesToDistributeTrafficOn().size() == 0) {
@@ -175,10 +213,10 @@ void LookupClassRouteUpdater::processPortAdded(
      *  Only downlink ports connecting to MH-NIC have lookupClasses
      *  configured. For all the other ports, no-op.
      */
-    return;
+    return {};
   }
 
-  updateSubnetsCache(stateDelta, addedPort, reAddAllRoutesEnabled);
+  return updateSubnetsCache(stateDelta, addedPort);
 }
 
 void LookupClassRouteUpdater::processPortRemovedForVlan(
@@ -239,7 +277,7 @@ void LookupClassRouteUpdater::processPortChanged(
   if (oldPort->getLookupClassesToDistributeTrafficOn().size() == 0 &&
       newPort->getLookupClassesToDistributeTrafficOn().size() != 0) {
     // enable queue-per-host for this port
-    processPortAdded(stateDelta, newPort, true /* re-all all routes */);
+    reAddRoutes(stateDelta, processPortAdded(stateDelta, newPort));
   } else if (
       oldPort->getLookupClassesToDistributeTrafficOn().size() != 0 &&
       newPort->getLookupClassesToDistributeTrafficOn().size() == 0) {
@@ -251,7 +289,7 @@ void LookupClassRouteUpdater::processPortChanged(
     // queue-per-host remains enabled, but port's VLAN membership changed, readd
     if (oldPort->getVlans() != newPort->getVlans()) {
       processPortRemoved(stateDelta, oldPort);
-      processPortAdded(stateDelta, newPort, true /* re-all all routes */);
+      reAddRoutes(stateDelta, processPortAdded(stateDelta, newPort));
     }
   }
 }
@@ -263,9 +301,8 @@ void LookupClassRouteUpdater::processPortUpdates(const StateDelta& stateDelta) {
 
     if (!oldPort && newPort) {
       // processRouteUpdates is invoked after processPortAdd,
-      // thus, we don't need to re-add all the routes.
-      processPortAdded(
-          stateDelta, newPort, false /* don't re-add all routes */);
+      // thus, we don't need to re-add any routes.
+      processPortAdded(stateDelta, newPort);
     } else if (oldPort && !newPort) {
       processPortRemoved(stateDelta, oldPort);
     } else {
@@ -289,14 +326,16 @@ void LookupClassRouteUpdater::processInterfaceAdded(
     return;
   }
 
+  std::set<VlanID> updatedVlans;
   for (auto& [portID, portInfo] : vlan->getPorts()) {
     std::ignore = portInfo;
     auto port = switchState->getPorts()->getPortIf(portID);
     // routes are re-added once outside the for loop
-    processPortAdded(stateDelta, port, false /* don't re-add all routes */);
+    auto portVlans = processPortAdded(stateDelta, port);
+    updatedVlans.insert(portVlans.begin(), portVlans.end());
   }
 
-  reAddAllRoutes(stateDelta);
+  reAddRoutes(stateDelta, updatedVlans);
 }
 
 void LookupClassRouteUpdater::processInterfaceRemoved(
@@ -627,6 +666,8 @@ void LookupClassRouteUpdater::processRouteAdded(
     return;
   }
 
+  updateRouteIndex(stateDelta, rid, addedRoute, true /* add */);
+
   auto ridAndCidr = std::make_pair(
       rid,
       folly::CIDRNetwork{
@@ -655,6 +696,8 @@ void LookupClassRouteUpdater::processRouteRemoved(
     return;
   }
 
+  updateRouteIndex(stateDelta, rid, removedRoute, false /* remove */);
+
   // ClassID is associated with (and refCnt'ed for) MAC and ARP/NDP neighbor.
   // Route simply inherits classID of its nexthop, so we need not release
   // classID here. Furthermore, the route is already removed, so we don't need
@@ -770,22 +813,61 @@ void LookupClassRouteUpdater::processRouteUpdates(
   forEachChangedRoute<AddrT>(stateDelta, changedFn, addedFn, removedFn);
 }
 
+// Methods for dealing with vlan2PrefixesIndex_
+
+template <typename RouteT>
+void LookupClassRouteUpdater::updateRouteIndex(
+    const StateDelta& stateDelta,
+    RouterID rid,
+    const std::shared_ptr<RouteT>& route,
+    bool add) {
+  if (!route->isResolved() || route->isToCPU()) {
+    return;
+  }
+
+  auto ridAndCidr = std::make_pair(
+      rid, folly::CIDRNetwork{route->prefix().network, route->prefix().mask});
+
+  // Removed routes may point to interfaces that are gone in the new state
+  auto& state = add ? stateDelta.newState() : stateDelta.oldState();
+  for (const auto& nextHop : route->getForwardInfo().getNextHopSet()) {
+    auto interface = state->getInterfaces()->getInterfaceIf(nextHop.intf());
+    if (!interface) {
+      continue;
+    }
+    auto vlanID = interface->getVlanID();
+    if (add) {
+      vlan2PrefixesIndex_[vlanID].insert(ridAndCidr);
+      continue;
+    }
+    auto it = vlan2PrefixesIndex_.find(vlanID);
+    if (it != vlan2PrefixesIndex_.end()) {
+      it->second.erase(ridAndCidr);
+      if (it->second.empty()) {
+        vlan2PrefixesIndex_.erase(it);
+      }
+    }
+  }
+}
+
 // Methods for scheduling state updates
 
 void LookupClassRouteUpdater::updateClassIDsForRoutes(
     const std::vector<RouteAndClassID>& routesAndClassIDs) const {
-  std::unordered_map<
-      std::pair<RouterID, std::optional<cfg::AclLookupClass>>,
-      std::vector<folly::CIDRNetwork>>
-      ridClassId2Prefixes;
+  /*
+   * Program all the classIDs of a VRF with a single state update. The order
+   * of routesAndClassIDs is kept, so if a route is updated more than once,
+   * the last classID wins.
+   */
+  std::map<RouterID, std::vector<RoutingInformationBase::PrefixAndClassID>>
+      rid2PrefixesAndClassIDs;
   for (const auto& [ridAndCidr, classID] : routesAndClassIDs) {
     auto& [rid, cidr] = ridAndCidr;
-    ridClassId2Prefixes[std::make_pair(rid, classID)].emplace_back(cidr);
+    rid2PrefixesAndClassIDs[rid].emplace_back(cidr, classID);
   }
   auto updater = sw_->getRouteUpdater();
-  for (const auto& [ridAndClassId, prefixes] : ridClassId2Prefixes) {
-    updater.programClassID(
-        ridAndClassId.first, prefixes, ridAndClassId.second, true /*async*/);
+  for (const auto& [rid, prefixesAndClassIDs] : rid2PrefixesAndClassIDs) {
+    updater.programClassIDs(rid, prefixesAndClassIDs, true /*async*/);
   }
 }
 
@@ -816,9 +898,12 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
   /*
    * Only RSWs connected to MH-NIC (e.g. Yosemite) need queue-per-host fix, and
    * thus have non-empty vlan2SubnetsCache_ (populated by processPortUpdates).
-   * Skip the processing on other setups.
+   * Skip the processing on other setups. Route updates are skipped too, so
+   * vlan2PrefixesIndex_ would go stale, drop it.
    */
   if (vlan2SubnetsCache_.empty()) {
+    vlan2PrefixesIndex_.clear();
+    routeIndexValid_ = false;
     return;
   }
 
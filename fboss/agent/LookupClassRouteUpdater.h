@@ -25,9 +25,26 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
 
   void stateUpdated(const StateDelta& stateDelta) override;
 
+  /* For testing purpose, only call from the update thread */
+  std::set<std::pair<RouterID, folly::CIDRNetwork>> getIndexedPrefixes(
+      VlanID vlanID) const {
+    auto it = vlan2PrefixesIndex_.find(vlanID);
+    if (it == vlan2PrefixesIndex_.end()) {
+      return {};
+    }
+    return it->second;
+  }
+  bool isRouteIndexValid() const {
+    return routeIndexValid_;
+  }
+  uint64_t getNumRoutesReAdded() const {
+    return numRoutesReAdded_;
+  }
+
  private:
   // Helper methods
   void reAddAllRoutes(const StateDelta& stateDelta);
+  void reAddRoutes(const StateDelta& stateDelta, const std::set<VlanID>& vlans);
 
   bool vlanHasOtherPortsWithClassIDs(
       const std::shared_ptr<SwitchState>& switchState,
@@ -44,10 +61,10 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
       VlanID vlanID,
       const folly::IPAddress& ipToSearch);
 
-  void updateSubnetsCache(
+  // Returns the vlans that got new subnets
+  std::set<VlanID> updateSubnetsCache(
       const StateDelta& stateDelta,
-      std::shared_ptr<Port> port,
-      bool reAddAllRoutesEnabled);
+      std::shared_ptr<Port> port);
 
   std::optional<cfg::AclLookupClass> getClassIDForNeighbor(
       const std::shared_ptr<SwitchState>& switchState,
@@ -55,10 +72,9 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
       const folly::IPAddress& ipAddress);
 
   // Methods for handling port updates
-  void processPortAdded(
+  std::set<VlanID> processPortAdded(
       const StateDelta& stateDelta,
-      const std::shared_ptr<Port>& addedPort,
-      bool reAddAllRoutesEnabled);
+      const std::shared_ptr<Port>& addedPort);
   void processPortRemovedForVlan(
       const StateDelta& stateDelta,
       const std::shared_ptr<Port>& removedPort,
@@ -136,6 +152,14 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
   template <typename AddrT>
   void processRouteUpdates(const StateDelta& stateDelta);
 
+  // Methods for dealing with vlan2PrefixesIndex_
+  template <typename RouteT>
+  void updateRouteIndex(
+      const StateDelta& stateDelta,
+      RouterID rid,
+      const std::shared_ptr<RouteT>& route,
+      bool add);
+
   using RidAndCidr = std::pair<RouterID, folly::CIDRNetwork>;
   using NextHopAndVlan = std::pair<folly::IPAddress, VlanID>;
   using WithAndWithoutClassIDPrefixes =
@@ -246,6 +270,23 @@ class LookupClassRouteUpdater : public AutoRegisterStateObserver {
    */
   std::set<RidAndCidr> allPrefixesWithClassID_;
 
+  /*
+   * Vlan to prefixes of all the resolved routes with a nexthop in that vlan,
+   * whether or not the nexthop is in a cached subnet.
+   *
+   * When a subnet is added to vlan2SubnetsCache_, the routes with nexthops in
+   * that subnet may now inherit a classID. Only the routes indexed under the
+   * subnet's vlan need to be re-evaluated, rather than every route in the FIB.
+   *
+   * Routes are not processed while vlan2SubnetsCache_ is empty, so the index
+   * is dropped then, and rebuilt with one walk of the FIB the next time it is
+   * needed.
+   */
+  boost::container::flat_map<VlanID, std::set<RidAndCidr>> vlan2PrefixesIndex_;
+  bool routeIndexValid_{false};
+  // Routes re-added for new subnets so far
+  uint64_t numRoutesReAdded_{0};
+
   // pending routes with classID to be updated
   std::vector<RouteAndClassID> toUpdateRoutesAndClassIDs_;
 
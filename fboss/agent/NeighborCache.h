@@ -11,6 +11,7 @@
 
 #include "fboss/agent/NeighborCacheEntry.h"
 #include "fboss/agent/NeighborCacheImpl-defs.h"
+#include "fboss/agent/NeighborCacheScheduler.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/PortDescriptor.h"
 
@@ -22,6 +23,7 @@
 #include <chrono>
 #include <list>
 #include <string>
+#include <unordered_set>
 
 namespace facebook::fboss {
 
@@ -43,7 +45,9 @@ class NeighborCache {
  public:
   typedef typename NTable::Entry::AddressType AddressType;
 
-  virtual ~NeighborCache() {}
+  virtual ~NeighborCache() {
+    sw_->getNeighborCacheScheduler()->cancelProbes(this);
+  }
 
   bool flushEntryBlocking(AddressType ip) {
     std::lock_guard<std::mutex> g(cacheLock_);
@@ -210,6 +214,26 @@ class NeighborCache {
     return impl_->flushEntry(ip);
   }
 
+  folly::HHWheelTimer* getTimer() const {
+    return sw_->getNeighborCacheScheduler()->getTimer();
+  }
+
+  // Called by an entry, with the cache lock held, to queue a probe
+  void scheduleProbe(AddressType ip) {
+    if (!pendingProbes_.insert(ip).second) {
+      // A probe for this entry is still waiting to go out
+      return;
+    }
+    sw_->getNeighborCacheScheduler()->scheduleProbe(
+        this, [this, ip]() { sendProbe(ip); });
+  }
+
+  void sendProbe(AddressType ip) {
+    std::lock_guard<std::mutex> g(cacheLock_);
+    pendingProbes_.erase(ip);
+    impl_->sendProbe(ip);
+  }
+
   void processEntry(AddressType ip) {
     std::lock_guard<std::mutex> g(cacheLock_);
     return impl_->processEntry(ip);
@@ -230,6 +254,8 @@ class NeighborCache {
   std::chrono::seconds staleEntryInterval_;
   std::unique_ptr<NeighborCacheImpl<NTable>> impl_;
   std::mutex cacheLock_;
+  // Entries with a probe queued on the NeighborCacheScheduler
+  std::unordered_set<AddressType> pendingProbes_;
 };
 
 } // namespace facebook::fboss
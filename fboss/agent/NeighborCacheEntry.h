@@ -19,6 +19,7 @@
 #include <folly/IPAddress.h>
 #include <folly/MacAddress.h>
 #include <folly/Random.h>
+#include <folly/io/async/HHWheelTimer.h>
 #include <chrono>
 
 /**
@@ -55,6 +56,8 @@
  * its next update. When that timeout expires, the state machine is run and the
  * next update is scheduled. If the entry ever transitions to the EXPIRED state,
  * we do not schedule another update and the cache will flush the entry.
+ * Timeouts of all entries share the neighbor cache timer wheel, and the probes
+ * entries send are paced by the NeighborCacheScheduler.
  *
  * There is no locking in this class. Instead, the class relies on the
  * synchronization provided by NeighborCache, which should lock around all calls
@@ -78,7 +81,7 @@ template <typename NTable>
 class NeighborCache;
 
 template <typename NTable>
-class NeighborCacheEntry : private folly::AsyncTimeout {
+class NeighborCacheEntry : private folly::HHWheelTimer::Callback {
  public:
   typedef typename NTable::Entry::AddressType AddressType;
   typedef NeighborCache<NTable> Cache;
@@ -89,10 +92,10 @@ class NeighborCacheEntry : private folly::AsyncTimeout {
       folly::EventBase* evb,
       Cache* cache,
       NeighborEntryState state)
-      : AsyncTimeout(evb),
-        fields_(fields),
+      : fields_(fields),
         cache_(cache),
         evb_(evb),
+        timer_(cache_->getTimer()),
         probesLeft_(cache_->getMaxNeighborProbes()) {
     enter(state);
   }
@@ -210,6 +213,21 @@ class NeighborCacheEntry : private folly::AsyncTimeout {
         state_ == NeighborEntryState::INCOMPLETE;
   }
 
+  /*
+   * Send the probe queued by the state machine, once the probe pacer lets
+   * it go out.
+   */
+  void sendProbe() const {
+    DCHECK(isProbing());
+    if (state_ == NeighborEntryState::INCOMPLETE) {
+      /* entry is INCOMPLETE, issue multicast probe */
+      cache_->probeFor(getIP());
+    } else {
+      /* entry is PROBE, issue unicast probe */
+      cache_->checkReachability(getIP(), getMac(), getPort());
+    }
+  }
+
   template <typename NeighborEntryThrift>
   void populateThriftEntry(NeighborEntryThrift& entry) const {
     *entry.ip_ref() = facebook::network::toBinaryAddress(getIP());
@@ -233,6 +251,10 @@ class NeighborCacheEntry : private folly::AsyncTimeout {
     cache_->processEntry(getIP());
   }
 
+  void scheduleTimeout(std::chrono::milliseconds timeout) {
+    timer_->scheduleTimeout(this, timeout);
+  }
+
   /*
    * Schedules an update on the evb_. This is done synchronously so that we
    * can have a destructor guard around both running the state machine and
@@ -322,13 +344,7 @@ class NeighborCacheEntry : private folly::AsyncTimeout {
   void probeIfProbesLeft() {
     DCHECK(isProbing());
     if (hasProbesLeft()) {
-      if (state_ == NeighborEntryState::INCOMPLETE) {
-        /* entry is INCOMPLETE, issue multicast probe */
-        cache_->probeFor(getIP());
-      } else {
-        /* entry is PROBE, issue unicast probe */
-        cache_->checkReachability(getIP(), getMac(), getPort());
-      }
+      cache_->scheduleProbe(getIP());
       --probesLeft_;
     } else {
       state_ = NeighborEntryState::EXPIRED;
@@ -410,6 +426,7 @@ class NeighborCacheEntry : private folly::AsyncTimeout {
   // Additional state kept per cache entry.
   Cache* cache_;
   folly::EventBase* evb_;
+  folly::HHWheelTimer* timer_;
   NeighborEntryState state_{NeighborEntryState::UNINITIALIZED};
   uint8_t probesLeft_{0};
   std::chrono::time_point<std::chrono::steady_clock> expireTime_;
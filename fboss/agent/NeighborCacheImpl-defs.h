@@ -283,6 +283,14 @@ void NeighborCacheImpl<NTable>::processEntry(AddressType ip) {
   }
 }
 
+template <typename NTable>
+void NeighborCacheImpl<NTable>::sendProbe(AddressType ip) {
+  auto entry = getCacheEntry(ip);
+  if (entry && entry->isProbing()) {
+    entry->sendProbe();
+  }
+}
+
 template <typename NTable>
 NeighborCacheEntry<NTable>* NeighborCacheImpl<NTable>::getCacheEntry(
     AddressType ip) const {
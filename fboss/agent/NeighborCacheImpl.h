@@ -133,6 +133,9 @@ class NeighborCacheImpl {
 
   void processEntry(AddressType ip);
 
+  // Send a probe queued by the entry for ip, if it is still probing
+  void sendProbe(AddressType ip);
+
   // Pass in a non-null flushed if you care whether an entry
   // was actually flushed from the switch state
   void flushEntry(AddressType ip, bool* flushed = nullptr);
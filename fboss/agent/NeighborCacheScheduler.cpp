@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborCacheScheduler.h"
+
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+// Bursts are sized to go out about this often at the max probe rate
+constexpr auto kTargetBurstInterval = std::chrono::milliseconds(10);
+} // namespace
+
+namespace facebook::fboss {
+
+NeighborCacheScheduler::NeighborCacheScheduler(
+    folly::EventBase* evb,
+    std::chrono::milliseconds timerTick,
+    uint32_t maxProbesPerSec)
+    : AsyncTimeout(evb),
+      evb_(evb),
+      timer_(folly::HHWheelTimer::newTimer(
+          evb,
+          std::max(timerTick, std::chrono::milliseconds(1)))) {
+  if (maxProbesPerSec == 0) {
+    burstSize_ = std::numeric_limits<size_t>::max();
+  } else {
+    burstSize_ = std::max<size_t>(
+        1, uint64_t(maxProbesPerSec) * kTargetBurstInterval.count() / 1000);
+    // Round the interval up, so that the rate never exceeds the max
+    burstInterval_ = std::chrono::milliseconds(
+        (burstSize_ * 1000 + maxProbesPerSec - 1) / maxProbesPerSec);
+  }
+  XLOG(DBG2) << "Neighbor cache timer tick: "
+             << timer_->getTickInterval().count()
+             << "ms, probe burst size: " << burstSize_
+             << ", burst interval: " << burstInterval_.count() << "ms";
+}
+
+NeighborCacheScheduler::~NeighborCacheScheduler() {
+  cancelTimeout();
+  probes_.clear();
+}
+
+void NeighborCacheScheduler::scheduleProbe(const void* owner, ProbeFn probe) {
+  DCHECK(evb_->isInEventBaseThread());
+  probes_.emplace_back(owner, std::move(probe));
+  if (!isScheduled()) {
+    scheduleNextBurst();
+  }
+}
+
+void NeighborCacheScheduler::cancelProbes(const void* owner) {
+  DCHECK(evb_->isInEventBaseThread());
+  probes_.erase(
+      std::remove_if(
+          probes_.begin(),
+          probes_.end(),
+          [owner](const auto& probe) { return probe.first == owner; }),
+      probes_.end());
+  if (probes_.empty()) {
+    cancelTimeout();
+  }
+}
+
+void NeighborCacheScheduler::scheduleNextBurst() {
+  auto sinceLastBurst = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - lastBurst_);
+  auto delay = std::max(
+      burstInterval_ - sinceLastBurst, std::chrono::milliseconds::zero());
+  scheduleTimeout(delay);
+}
+
+void NeighborCacheScheduler::timeoutExpired() noexcept {
+  lastBurst_ = std::chrono::steady_clock::now();
+  // Probes may be queued, by other owners, while the burst is being sent.
+  // Those wait for the next burst.
+  auto burst = std::min(burstSize_, probes_.size());
+  for (size_t i = 0; i < burst && !probes_.empty(); ++i) {
+    auto probe = std::move(probes_.front().second);
+    probes_.pop_front();
+    probe();
+  }
+  if (!probes_.empty()) {
+    XLOG_EVERY_MS(DBG2, 1000)
+        << "Pacing neighbor probes, " << probes_.size() << " queued";
+    scheduleNextBurst();
+  }
+}
+
+} // namespace facebook::fboss
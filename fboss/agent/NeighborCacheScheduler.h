@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/HHWheelTimer.h>
+
+#include <chrono>
+#include <deque>
+#include <utility>
+
+namespace facebook::fboss {
+
+/*
+ * Timers and probe pacing shared by all ARP and NDP caches.
+ *
+ * Neighbor cache entries schedule their ageing and probing timeouts on a
+ * single hashed hierarchical timer wheel, rather than each holding its own
+ * timeout on the event base, so that tens of thousands of entries cost a
+ * bucket insertion each and entries expiring within the same tick are
+ * processed together.
+ *
+ * Probes (ARP requests, neighbor solicitations) issued by cache entries are
+ * queued here and sent in bursts, at no more than maxProbesPerSec, so that
+ * a mass expiry after e.g. a large L2 domain resolved at once does not turn
+ * into a probe storm.
+ *
+ * All methods must be called from the neighbor cache thread.
+ */
+class NeighborCacheScheduler : private folly::AsyncTimeout {
+ public:
+  using ProbeFn = folly::Function<void()>;
+
+  // maxProbesPerSec of 0 sends every queued probe on the next loop
+  NeighborCacheScheduler(
+      folly::EventBase* evb,
+      std::chrono::milliseconds timerTick,
+      uint32_t maxProbesPerSec);
+  ~NeighborCacheScheduler() override;
+
+  folly::HHWheelTimer* getTimer() const {
+    return timer_.get();
+  }
+
+  /*
+   * Queue a probe on behalf of owner. Owners must cancel their queued
+   * probes with cancelProbes before going away.
+   */
+  void scheduleProbe(const void* owner, ProbeFn probe);
+  void cancelProbes(const void* owner);
+
+  size_t getPendingProbes() const {
+    return probes_.size();
+  }
+
+  // Probes sent per burst and the interval between bursts
+  size_t getBurstSize() const {
+    return burstSize_;
+  }
+  std::chrono::milliseconds getBurstInterval() const {
+    return burstInterval_;
+  }
+
+ private:
+  void timeoutExpired() noexcept override;
+  void scheduleNextBurst();
+
+  // Forbidden copy constructor and assignment operator
+  NeighborCacheScheduler(NeighborCacheScheduler const&) = delete;
+  NeighborCacheScheduler& operator=(NeighborCacheScheduler const&) = delete;
+
+  folly::EventBase* evb_;
+  folly::HHWheelTimer::UniquePtr timer_;
+  size_t burstSize_{0};
+  std::chrono::milliseconds burstInterval_{0};
+  std::chrono::steady_clock::time_point lastBurst_;
+  std::deque<std::pair<const void*, ProbeFn>> probes_;
+};
+
+} // namespace facebook::fboss
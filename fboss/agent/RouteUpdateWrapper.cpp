@@ -118,20 +118,34 @@ void RouteUpdateWrapper::programStandAloneRib(const SyncFibFor& syncFibFor) {
         *fibUpdateFn_,
         fibUpdateCookie_);
   }
-  for (auto [ridClientId, addDelRoutes] : ribRoutesToAddDel_) {
-    auto stats = getRib()->update(
-        ridClientId.first,
-        ridClientId.second,
-        clientIdToAdminDistance(ridClientId.second),
-        addDelRoutes.toAdd,
-        addDelRoutes.toDel,
-        syncFibFor.find(ridClientId) != syncFibFor.end(),
-        "RIB update",
-        *fibUpdateFn_,
-        fibUpdateCookie_);
-    printStats(stats);
-    updateStats(stats);
+  ribUpdatesStarted();
+  try {
+    for (auto [ridClientId, addDelRoutes] : ribRoutesToAddDel_) {
+      auto stats = getRib()->update(
+          ridClientId.first,
+          ridClientId.second,
+          clientIdToAdminDistance(ridClientId.second),
+          addDelRoutes.toAdd,
+          addDelRoutes.toDel,
+          syncFibFor.find(ridClientId) != syncFibFor.end(),
+          "RIB update",
+          *fibUpdateFn_,
+          fibUpdateCookie_);
+      printStats(stats);
+      updateStats(stats);
+    }
+  } catch (const std::exception&) {
+    // Still wait for the updates handed to the RIB before this one failed
+    auto error = std::current_exception();
+    try {
+      ribUpdatesFinished();
+    } catch (const std::exception& finishEx) {
+      XLOG(ERR) << "Earlier FIB update failed: "
+                << folly::exceptionStr(finishEx);
+    }
+    std::rethrow_exception(error);
   }
+  ribUpdatesFinished();
 }
 
 void RouteUpdateWrapper::programClassID(
@@ -148,6 +162,20 @@ void RouteUpdateWrapper::programClassID(
   }
 }
 
+void RouteUpdateWrapper::programClassIDs(
+    RouterID rid,
+    const std::vector<RoutingInformationBase::PrefixAndClassID>&
+        prefixesAndClassIDs,
+    bool async) {
+  if (async) {
+    getRib()->setClassIDsAsync(
+        rid, prefixesAndClassIDs, *fibUpdateFn_, fibUpdateCookie_);
+  } else {
+    getRib()->setClassIDs(
+        rid, prefixesAndClassIDs, *fibUpdateFn_, fibUpdateCookie_);
+  }
+}
+
 void RouteUpdateWrapper::setRoutesToConfig(
     const RouterIDAndNetworkToInterfaceRoutes& _configRouterIDToInterfaceRoutes,
     const std::vector<cfg::StaticRouteWithNextHops>& _staticRoutesWithNextHops,
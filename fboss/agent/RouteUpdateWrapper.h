@@ -77,6 +77,12 @@ class RouteUpdateWrapper {
       const std::vector<folly::CIDRNetwork>& prefixes,
       std::optional<cfg::AclLookupClass> classId,
       bool async);
+  // Program classIDs of many prefixes with a single update
+  void programClassIDs(
+      RouterID rid,
+      const std::vector<RoutingInformationBase::PrefixAndClassID>&
+          prefixesAndClassIDs,
+      bool async);
 
  private:
   RoutingInformationBase* getRib() {
@@ -86,6 +92,13 @@ class RouteUpdateWrapper {
   void programStandAloneRib(const SyncFibFor& syncFibFor);
   virtual void updateStats(const UpdateStatistics& stats) = 0;
   virtual AdminDistance clientIdToAdminDistance(ClientID clientID) const = 0;
+  /*
+   * Called before and after program() hands its route updates to the RIB.
+   * Lets subclasses schedule the FIB updates of those without waiting for
+   * them to be programmed, and wait for all of them at the end.
+   */
+  virtual void ribUpdatesStarted() {}
+  virtual void ribUpdatesFinished() {}
 
  protected:
   RouteUpdateWrapper(
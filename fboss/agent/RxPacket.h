@@ -10,8 +10,10 @@
 #pragma once
 
 #include "fboss/agent/Packet.h"
+#include "fboss/agent/packet/PktMetadata.h"
 #include "fboss/agent/types.h"
 
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -53,6 +55,20 @@ class RxPacket : public Packet {
   uint32_t getLength() const {
     return len_;
   }
+  /*
+   * Header offsets and protocol fields of the packet, parsed the first time
+   * they are asked for, so the RX path walks the headers only once however
+   * many places look at them.
+   *
+   * Not thread safe, which is fine as long as a packet is only handled by
+   * one thread at a time, including when handed over to another thread.
+   */
+  const PktMetadata& getMetadata() const {
+    if (!metadata_) {
+      metadata_ = PktMetadata::parse(buf());
+    }
+    return *metadata_;
+  }
   /**
    * Get the router ID of the packet
    */
@@ -100,6 +116,9 @@ class RxPacket : public Packet {
   AggregatePortID srcAggregatePort_{0};
   VlanID srcVlan_{0};
   uint32_t len_{0};
+
+ private:
+  mutable std::optional<PktMetadata> metadata_;
 };
 
 } // namespace facebook::fboss
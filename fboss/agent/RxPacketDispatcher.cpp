@@ -0,0 +1,160 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+
+#include <folly/Conv.h>
+#include <glog/logging.h>
+
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/IPProto.h"
+
+namespace {
+using facebook::fboss::IP_PROTO;
+using Priority = facebook::fboss::RxPacketDispatcher::Priority;
+
+constexpr uint16_t kBgpPort = 179;
+
+Priority classifyIP(const facebook::fboss::PktMetadata& metadata) {
+  // The metadata has the TCP ports past any IP options or extension headers
+  if (metadata.ipProtocol == static_cast<uint8_t>(IP_PROTO::IP_PROTO_TCP) &&
+      metadata.hasL4Ports() &&
+      (metadata.l4SrcPort == kBgpPort || metadata.l4DstPort == kBgpPort)) {
+    return Priority::HIGH;
+  }
+  return metadata.ttl <= 1 ? Priority::LOW : Priority::MID;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+RxPacketDispatcher::Worker::Worker(uint32_t queueSize) {
+  for (auto& queue : queues) {
+    queue = std::make_unique<folly::MPMCQueue<std::unique_ptr<RxPacket>>>(
+        queueSize);
+  }
+}
+
+RxPacketDispatcher::RxPacketDispatcher(
+    HandlerFn handler,
+    int numThreads,
+    uint32_t queueSize,
+    int highPriCosQueue)
+    : handler_(std::move(handler)), highPriCosQueue_(highPriCosQueue) {
+  CHECK_GT(numThreads, 0);
+  CHECK_GT(queueSize, 0);
+  for (int i = 0; i < numThreads; ++i) {
+    workers_.push_back(std::make_unique<Worker>(queueSize));
+  }
+  // Only start the threads once workers_ is no longer resized
+  for (int i = 0; i < numThreads; ++i) {
+    auto& worker = *workers_[i];
+    worker.thread = std::thread([this, &worker, i] {
+      initThread(folly::to<std::string>("fbossRxDispatch", i));
+      workerLoop(worker);
+    });
+  }
+}
+
+RxPacketDispatcher::~RxPacketDispatcher() {
+  stop();
+}
+
+RxPacketDispatcher::Priority RxPacketDispatcher::classify(
+    const RxPacket& pkt) const {
+  if (highPriCosQueue_ >= 0 && pkt.cosQueue() == highPriCosQueue_) {
+    return Priority::HIGH;
+  }
+  const auto& metadata = pkt.getMetadata();
+  if (!metadata.hasL3()) {
+    // Truncated packet, handlePacket() drops these anyway
+    return Priority::LOW;
+  }
+  switch (static_cast<ETHERTYPE>(metadata.etherType)) {
+    case ETHERTYPE::ETHERTYPE_SLOW_PROTOCOLS:
+    case ETHERTYPE::ETHERTYPE_LLDP:
+    case ETHERTYPE::ETHERRTPE_EAPOL:
+      return Priority::HIGH;
+    case ETHERTYPE::ETHERTYPE_IPV4:
+    case ETHERTYPE::ETHERTYPE_IPV6:
+      return metadata.isTruncated() ? Priority::LOW : classifyIP(metadata);
+    default:
+      return Priority::MID;
+  }
+}
+
+RxPacketDispatcher::Worker& RxPacketDispatcher::pickWorker(
+    const RxPacket& pkt,
+    Priority priority) {
+  // Spread the classes of a port over different workers, so one port
+  // flooding a class does not put its other classes behind the flood
+  auto flow = static_cast<size_t>(pkt.getSrcPort()) * kNumPriorities +
+      static_cast<size_t>(priority);
+  return *workers_[flow % workers_.size()];
+}
+
+bool RxPacketDispatcher::enqueue(
+    std::unique_ptr<RxPacket> pkt,
+    Priority priority) {
+  auto idx = static_cast<int>(priority);
+  if (stopping_.load(std::memory_order_acquire)) {
+    drops_[idx].fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  auto& worker = pickWorker(*pkt, priority);
+  if (!worker.queues[idx]->write(std::move(pkt))) {
+    drops_[idx].fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  worker.pending.post();
+  return true;
+}
+
+void RxPacketDispatcher::stop() {
+  if (stopping_.exchange(true, std::memory_order_acq_rel)) {
+    return;
+  }
+  for (auto& worker : workers_) {
+    worker->pending.post();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+void RxPacketDispatcher::workerLoop(Worker& worker) {
+  while (true) {
+    worker.pending.wait();
+    if (stopping_.load(std::memory_order_acquire)) {
+      return;
+    }
+    if (auto pkt = dequeue(worker)) {
+      handler_(std::move(pkt));
+    }
+  }
+}
+
+std::unique_ptr<RxPacket> RxPacketDispatcher::dequeue(Worker& worker) {
+  std::unique_ptr<RxPacket> pkt;
+  while (!stopping_.load(std::memory_order_acquire)) {
+    for (auto& queue : worker.queues) {
+      if (queue->readIfNotEmpty(pkt)) {
+        return pkt;
+      }
+    }
+    // A packet was posted for us, but another writer to the same queue
+    // that got ahead of it may still be completing its write
+    std::this_thread::yield();
+  }
+  return nullptr;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/MPMCQueue.h>
+#include <folly/synchronization/LifoSem.h>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+class RxPacket;
+
+/*
+ * Takes trapped packets off the HW RX callback thread, and hands them to
+ * a small pool of worker threads in strict priority order.
+ *
+ * Packets are classified on arrival into
+ *   HIGH: control protocols whose loss or delay flaps adjacencies (LACP,
+ *         LLDP, EAPOL, BGP, and anything on highPriCosQueue)
+ *   MID:  everything not in the other two classes (ARP, NDP, DHCP, packets
+ *         to the host)
+ *   LOW:  packets trapped because their TTL/hop limit expired
+ * and queued in a bounded queue per class. Workers always drain the HIGH
+ * queue before looking at MID, and MID before LOW, so an ARP/NDP or TTL
+ * expiry storm can fill its own queue and be dropped from it, but does not
+ * delay LACP or BGP. Packets that do not fit in their queue are dropped
+ * and counted.
+ *
+ * Every worker has queues of its own, and all packets of a class trapped
+ * on the same port go to the same worker. So packets of a flow, such as
+ * LACP on a LAG member or a BGP session, are handled in the order they
+ * were trapped, and a flow never has packets handled concurrently.
+ */
+class RxPacketDispatcher {
+ public:
+  enum class Priority : int {
+    HIGH = 0,
+    MID = 1,
+    LOW = 2,
+  };
+  static constexpr int kNumPriorities = 3;
+
+  using HandlerFn = std::function<void(std::unique_ptr<RxPacket>)>;
+
+  /*
+   * handler is called concurrently from numThreads worker threads, each
+   * with up to queueSize packets of every class waiting for it.
+   * highPriCosQueue < 0 classifies without looking at the CPU queue.
+   */
+  RxPacketDispatcher(
+      HandlerFn handler,
+      int numThreads,
+      uint32_t queueSize,
+      int highPriCosQueue = -1);
+  ~RxPacketDispatcher();
+
+  Priority classify(const RxPacket& pkt) const;
+
+  /*
+   * Queue pkt for the workers. Returns false, and drops pkt, if its queue
+   * is full or the dispatcher is stopping.
+   */
+  bool enqueue(std::unique_ptr<RxPacket> pkt, Priority priority);
+
+  uint64_t getDropCount(Priority priority) const {
+    return drops_[static_cast<int>(priority)].load(std::memory_order_relaxed);
+  }
+
+  // Stops the workers, packets still queued are dropped
+  void stop();
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  RxPacketDispatcher(RxPacketDispatcher const&) = delete;
+  RxPacketDispatcher& operator=(RxPacketDispatcher const&) = delete;
+
+  struct Worker {
+    explicit Worker(uint32_t queueSize);
+
+    std::array<
+        std::unique_ptr<folly::MPMCQueue<std::unique_ptr<RxPacket>>>,
+        kNumPriorities>
+        queues;
+    // Posted once for every packet queued to this worker, and once on stop
+    folly::LifoSem pending;
+    std::thread thread;
+  };
+
+  Worker& pickWorker(const RxPacket& pkt, Priority priority);
+  void workerLoop(Worker& worker);
+  std::unique_ptr<RxPacket> dequeue(Worker& worker);
+
+  const HandlerFn handler_;
+  const int highPriCosQueue_;
+  std::array<std::atomic<uint64_t>, kNumPriorities> drops_{};
+  std::atomic<bool> stopping_{false};
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/StateUpdateTracer.h"
+
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <folly/system/ThreadId.h>
+#include <folly/system/ThreadName.h>
+
+namespace {
+
+double toUsecs(facebook::fboss::StateUpdateTracer::Clock::time_point time) {
+  return std::chrono::duration<double, std::micro>(time.time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+namespace facebook::fboss {
+
+StateUpdateTracer::ScopedTrace::ScopedTrace(Trace* trace)
+    : prevTrace_(currentTrace()) {
+  currentTrace() = trace;
+  if (trace) {
+    auto threadId = folly::getOSThreadID();
+    if (trace->threadNames.find(threadId) == trace->threadNames.end()) {
+      trace->threadNames.emplace(
+          threadId, folly::getCurrentThreadName().value_or(""));
+    }
+  }
+}
+
+StateUpdateTracer::ScopedTrace::~ScopedTrace() {
+  currentTrace() = prevTrace_;
+}
+
+StateUpdateTracer::ScopedSpan::ScopedSpan(
+    folly::StringPiece category,
+    folly::StringPiece name)
+    : trace_(currentTrace()) {
+  if (trace_) {
+    category_ = category;
+    name_ = name.str();
+    start_ = Clock::now();
+  }
+}
+
+StateUpdateTracer::ScopedSpan::~ScopedSpan() {
+  if (trace_) {
+    trace_->spans.push_back(Span{
+        category_,
+        std::move(name_),
+        start_,
+        Clock::now(),
+        folly::getOSThreadID()});
+  }
+}
+
+StateUpdateTracer::StateUpdateTracer(size_t maxTraces)
+    : maxTraces_(maxTraces) {}
+
+// static
+StateUpdateTracer::Trace*& StateUpdateTracer::currentTrace() {
+  static thread_local Trace* trace{nullptr};
+  return trace;
+}
+
+std::unique_ptr<StateUpdateTracer::Trace> StateUpdateTracer::startTrace()
+    const {
+  if (!maxTraces_) {
+    return nullptr;
+  }
+  return std::make_unique<Trace>();
+}
+
+void StateUpdateTracer::record(std::unique_ptr<Trace> trace) {
+  if (!trace || !maxTraces_) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(lock_);
+  if (traces_.size() == maxTraces_) {
+    traces_.pop_front();
+  }
+  traces_.push_back(std::move(trace));
+}
+
+// static
+void StateUpdateTracer::addSpan(
+    folly::StringPiece category,
+    folly::StringPiece name,
+    Clock::time_point start,
+    Clock::time_point end) {
+  auto trace = currentTrace();
+  if (trace) {
+    trace->spans.push_back(
+        Span{category, name.str(), start, end, folly::getOSThreadID()});
+  }
+}
+
+size_t StateUpdateTracer::size() const {
+  std::lock_guard<std::mutex> guard(lock_);
+  return traces_.size();
+}
+
+std::string StateUpdateTracer::getChromeTrace() const {
+  folly::dynamic events = folly::dynamic::array;
+  std::map<uint64_t, std::string> threadNames;
+  uint64_t asyncId = 0;
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    for (const auto& trace : traces_) {
+      threadNames.insert(trace->threadNames.begin(), trace->threadNames.end());
+      for (const auto& span : trace->spans) {
+        folly::dynamic event = folly::dynamic::object("name", span.name)(
+            "cat", span.category)("pid", 0)("tid", span.threadId)(
+            "args",
+            folly::dynamic::object("generation", trace->generation)(
+                "old_generation", trace->oldGeneration));
+        if (span.category == kQueueCategory) {
+          // Queued updates overlap each other and whatever the update thread
+          // is busy with, so show them as async events on their own track.
+          event["id"] = asyncId++;
+          auto end = event;
+          event["ph"] = "b";
+          event["ts"] = toUsecs(span.start);
+          end["ph"] = "e";
+          end["ts"] = toUsecs(span.end);
+          events.push_back(std::move(event));
+          events.push_back(std::move(end));
+        } else {
+          event["ph"] = "X";
+          event["ts"] = toUsecs(span.start);
+          event["dur"] = toUsecs(span.end) - toUsecs(span.start);
+          events.push_back(std::move(event));
+        }
+      }
+    }
+  }
+  for (const auto& [threadId, threadName] : threadNames) {
+    events.push_back(folly::dynamic::object("name", "thread_name")("ph", "M")(
+        "pid", 0)("tid", threadId)(
+        "args", folly::dynamic::object("name", threadName)));
+  }
+  return folly::toJson(folly::dynamic::object("traceEvents", std::move(events))(
+      "displayTimeUnit", "ms"));
+}
+
+} // namespace facebook::fboss
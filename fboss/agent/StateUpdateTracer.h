@@ -0,0 +1,130 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Timeline of the most recent state updates, to find out after the fact
+ * where a slow update spent its time: queued, running update functions,
+ * programming each section of the delta in hardware, or notifying each
+ * state observer.
+ *
+ * Spans are added to the trace made current on the calling thread by a
+ * ScopedTrace, so code deep down the update path (e.g. the HwSwitch) can
+ * add spans without having the trace passed to it. With no current trace,
+ * spans cost a thread local lookup.
+ */
+class StateUpdateTracer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr folly::StringPiece kQueueCategory{"queue"};
+  static constexpr folly::StringPiece kUpdateCategory{"update"};
+  static constexpr folly::StringPiece kHwCategory{"hw"};
+  static constexpr folly::StringPiece kObserverCategory{"observer"};
+
+  struct Span {
+    folly::StringPiece category;
+    std::string name;
+    Clock::time_point start;
+    Clock::time_point end;
+    uint64_t threadId;
+  };
+
+  // Spans of one batch of state updates
+  struct Trace {
+    int64_t oldGeneration{0};
+    int64_t generation{0};
+    std::vector<Span> spans;
+    std::map<uint64_t, std::string> threadNames;
+  };
+
+  /*
+   * Makes trace the one spans are added to on this thread, for the lifetime
+   * of the ScopedTrace. trace may be null, to trace nothing.
+   */
+  class ScopedTrace {
+   public:
+    explicit ScopedTrace(Trace* trace);
+    ~ScopedTrace();
+
+   private:
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+    Trace* prevTrace_;
+  };
+
+  // Adds a span covering its own lifetime to the current trace, if any
+  class ScopedSpan {
+   public:
+    ScopedSpan(folly::StringPiece category, folly::StringPiece name);
+    ~ScopedSpan();
+
+   private:
+    ScopedSpan(const ScopedSpan&) = delete;
+    ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+    Trace* trace_;
+    folly::StringPiece category_;
+    std::string name_;
+    Clock::time_point start_;
+  };
+
+  explicit StateUpdateTracer(size_t maxTraces);
+
+  /*
+   * Returns a new trace for the next batch of updates, or null if tracing
+   * is disabled.
+   */
+  std::unique_ptr<Trace> startTrace() const;
+
+  // Keeps trace, evicting the oldest one if maxTraces are already kept
+  void record(std::unique_ptr<Trace> trace);
+
+  /*
+   * Adds a span that already ended to the current trace, if any. Used for
+   * spans starting on another thread, like the time an update was queued.
+   */
+  static void addSpan(
+      folly::StringPiece category,
+      folly::StringPiece name,
+      Clock::time_point start,
+      Clock::time_point end);
+
+  size_t size() const;
+
+  /*
+   * The kept traces, oldest first, in the Chrome trace event format
+   * (viewable in chrome://tracing or Perfetto).
+   */
+  std::string getChromeTrace() const;
+
+ private:
+  static Trace*& currentTrace();
+
+  const size_t maxTraces_;
+  mutable std::mutex lock_;
+  std::deque<std::unique_ptr<Trace>> traces_;
+};
+
+} // namespace facebook::fboss
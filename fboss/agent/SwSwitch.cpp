@@ -33,6 +33,7 @@
 #include "fboss/agent/MPLSHandler.h"
 #include "fboss/agent/MacTableManager.h"
 #include "fboss/agent/MirrorManager.h"
+#include "fboss/agent/NeighborCacheScheduler.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -42,12 +43,14 @@
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketDispatcher.h"
 #include "fboss/agent/StaticL2ForNeighborObserver.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PcapPkt.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
@@ -69,6 +72,7 @@
 #include <folly/GLog.h>
 #include <folly/MacAddress.h>
 #include <folly/MapUtil.h>
+#include <folly/ScopeGuard.h>
 #include <folly/SocketAddress.h>
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
@@ -117,6 +121,60 @@ DEFINE_bool(
     false,
     "Flag to turn on logging of all updates to the FIB");
 
+DEFINE_bool(
+    enable_state_update_pipelining,
+    false,
+    "Compute the next batch of state updates while the previous batch is "
+    "being programmed in HW");
+
+DEFINE_int32(
+    state_update_pipeline_depth,
+    1,
+    "Max number of computed state update batches waiting to be programmed "
+    "in HW, when state update pipelining is enabled");
+
+DEFINE_int32(
+    neighbor_cache_timer_tick_ms,
+    100,
+    "Granularity (ms) of the timer wheel driving ARP/NDP entry ageing "
+    "and probing");
+
+DEFINE_int32(
+    max_neighbor_probes_per_sec,
+    2000,
+    "Max rate at which ARP requests and neighbor solicitations are sent "
+    "for aging or unresolved entries, 0 for no limit");
+
+DEFINE_int32(
+    rx_dispatch_threads,
+    0,
+    "Number of threads handling trapped packets in priority order, "
+    "0 to handle them inline on the HW RX thread");
+
+DEFINE_int32(
+    rx_dispatch_queue_size,
+    1024,
+    "Max number of trapped packets queued per RX dispatch thread and "
+    "priority, when rx_dispatch_threads is set");
+
+DEFINE_int32(
+    rx_dispatch_high_pri_cos_queue,
+    -1,
+    "CPU queue whose packets are always dispatched at high priority, "
+    "-1 to classify by packet contents only");
+
+DEFINE_int32(
+    state_update_trace_size,
+    64,
+    "Number of most recent state update batches whose timeline is kept "
+    "for getStateUpdateTrace(), 0 to disable tracing");
+
+DEFINE_string(
+    update_stream_record_file,
+    "",
+    "File to record route updates, config applications, link state changes "
+    "and neighbor learns to, for replaying them later");
+
 DEFINE_int32(
     minimum_ethernet_packet_length,
     64,
@@ -165,6 +223,8 @@ facebook::fboss::PortStatus fillInPortStatus(
 }
 
 auto constexpr kHwUpdateFailures = "hw_update_failures";
+auto constexpr kStateUpdatePipelineRecomputes =
+    "state_update_pipeline_recomputes";
 
 } // anonymous namespace
 
@@ -173,6 +233,10 @@ namespace facebook::fboss {
 SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
     : hw_(platform->getHwSwitch()),
       platform_(std::move(platform)),
+      neighborCacheScheduler_(new NeighborCacheScheduler(
+          &neighborCacheEventBase_,
+          std::chrono::milliseconds(FLAGS_neighbor_cache_timer_tick_ms),
+          FLAGS_max_neighbor_probes_per_sec)),
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
@@ -187,11 +251,18 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
       lookupClassUpdater_(new LookupClassUpdater(this)),
       lookupClassRouteUpdater_(new LookupClassRouteUpdater(this)),
       staticL2ForNeighborObserver_(new StaticL2ForNeighborObserver(this)),
-      macTableManager_(new MacTableManager(this)) {
+      macTableManager_(new MacTableManager(this)),
+      stateUpdateTracer_(new StateUpdateTracer(
+          std::max(FLAGS_state_update_trace_size, 0))) {
+  if (!FLAGS_update_stream_record_file.empty()) {
+    updateStreamRecorder_ = std::make_unique<UpdateStreamRecorder>(
+        FLAGS_update_stream_record_file);
+  }
   // Create the platform-specific state directories if they
   // don't exist already.
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+  pipelineStateUpdates_ = FLAGS_enable_state_update_pipelining;
 }
 
 SwSwitch::~SwSwitch() {
@@ -212,6 +283,8 @@ void SwSwitch::stop() {
   // After this we should no longer receive packets or link state changed events
   // while we are destroying ourselves
   hw_->unregisterCallbacks();
+  // Packets already queued for the RX dispatch threads are dropped
+  rxDispatcher_.reset();
 
   // Stop tunMgr so we don't get any packets to process
   // in software that were sent to the switch ip or were
@@ -457,6 +530,7 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   bootType_ = hwInitRet.bootType;
   rib_ = std::move(hwInitRet.rib);
   fb303::fbData->setCounter(kHwUpdateFailures, 0);
+  fb303::fbData->setCounter(kStateUpdatePipelineRecomputes, 0);
 
   XLOG(DBG0) << "hardware initialized in " << hwInitRet.bootTime
              << " seconds; applying initial config";
@@ -568,7 +642,7 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       });
 
   setSwitchRunState(SwitchRunState::INITIALIZED);
-  SwSwitchRouteUpdateWrapper(this, rib_.get()).programMinAlpmState();
+  getRouteUpdater().programMinAlpmState();
   if (FLAGS_log_all_fib_updates) {
     constexpr auto kAllFibUpdates = "all_fib_updates";
     logRouteUpdates("::", 0, kAllFibUpdates);
@@ -671,6 +745,8 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
   for (auto observerName : stateObservers_) {
     try {
       auto observer = observerName.first;
+      StateUpdateTracer::ScopedSpan span(
+          StateUpdateTracer::kObserverCategory, observerName.second);
       observer->stateUpdated(delta);
     } catch (const std::exception& ex) {
       // TODO: Figure out the best way to handle errors here.
@@ -688,13 +764,19 @@ bool SwSwitch::updateState(unique_ptr<StateUpdate> update) {
   }
   {
     std::unique_lock guard(pendingUpdatesLock_);
+    update->queuedTime_ = std::chrono::steady_clock::now();
     pendingUpdates_.push_back(*update.release());
   }
 
   // Signal the update thread that updates are pending.
   // We call runInEventBaseThread() with a static function pointer since this
   // is more efficient than having to allocate a new bound function object.
-  updateEventBase_.runInEventBaseThread(handlePendingUpdatesHelper, this);
+  if (pipelineStateUpdates_) {
+    stateComputeEventBase_.runInEventBaseThread(
+        computePendingUpdatesHelper, this);
+  } else {
+    updateEventBase_.runInEventBaseThread(handlePendingUpdatesHelper, this);
+  }
   return true;
 }
 
@@ -726,6 +808,23 @@ void SwSwitch::updateStateWithHwFailureProtection(
   updateStateBlockingImpl(name, fn, stateUpdateBehavior);
 }
 
+std::shared_ptr<BlockingUpdateResult>
+SwSwitch::updateStateWithHwFailureProtectionAsync(
+    folly::StringPiece name,
+    StateUpdateFn fn) {
+  int stateUpdateBehavior =
+      static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING) |
+      static_cast<int>(StateUpdate::BehaviorFlags::HW_FAILURE_PROTECTION);
+
+  auto result = std::make_shared<BlockingUpdateResult>();
+  auto update = make_unique<BlockingStateUpdate>(
+      name, std::move(fn), result, stateUpdateBehavior);
+  if (!updateState(std::move(update))) {
+    return nullptr;
+  }
+  return result;
+}
+
 void SwSwitch::updateStateBlockingImpl(
     folly::StringPiece name,
     StateUpdateFn fn,
@@ -743,6 +842,28 @@ void SwSwitch::handlePendingUpdatesHelper(SwSwitch* sw) {
 }
 
 void SwSwitch::handlePendingUpdates() {
+  auto updates = getUpdatesToApply();
+  // handlePendingUpdates() is invoked once for each update, but a previous
+  // call might have already processed everything.  If we don't have anything
+  // to do just return early.
+  if (updates.empty()) {
+    return;
+  }
+
+  // This function should never be called with valid updates while we are
+  // not initialized yet
+  DCHECK(isInitialized());
+
+  auto trace = stateUpdateTracer_->startTrace();
+  StateUpdateTracer::ScopedTrace scopedTrace(trace.get());
+  // Call all of the update functions to prepare the new SwitchState
+  auto oldAppliedState = getState();
+  auto newDesiredState = applyUpdateFunctions(oldAppliedState, &updates);
+  applyDesiredState(oldAppliedState, newDesiredState, &updates);
+  recordStateUpdateTrace(std::move(trace), oldAppliedState);
+}
+
+SwSwitch::StateUpdateList SwSwitch::getUpdatesToApply() {
   // Get the list of updates to run.
   //
   // We might pull multiple updates off the list at once if several updates
@@ -775,12 +896,8 @@ void SwSwitch::handlePendingUpdates() {
     updates.splice(
         updates.begin(), pendingUpdates_, pendingUpdates_.begin(), iter);
   }
-
-  // handlePendingUpdates() is invoked once for each update, but a previous
-  // call might have already processed everything.  If we don't have anything
-  // to do just return early.
   if (updates.empty()) {
-    return;
+    return updates;
   }
 
   // Non coalescing updates should be applied individually
@@ -793,23 +910,29 @@ void SwSwitch::handlePendingUpdates() {
     CHECK(isNonCoalescing)
         << " Hw Failure protected updates should be non coalescing";
   }
+  return updates;
+}
 
-  // This function should never be called with valid updates while we are
-  // not initialized yet
-  DCHECK(isInitialized());
-
-  // Call all of the update functions to prepare the new SwitchState
-  auto oldAppliedState = getState();
-  // We start with the old state, and apply state updates one at a time.
-  auto newDesiredState = oldAppliedState;
-  auto iter = updates.begin();
-  while (iter != updates.end()) {
+std::shared_ptr<SwitchState> SwSwitch::applyUpdateFunctions(
+    const std::shared_ptr<SwitchState>& origState,
+    StateUpdateList* updates) {
+  // We start with the original state, and apply state updates one at a time.
+  auto newDesiredState = origState;
+  auto iter = updates->begin();
+  while (iter != updates->end()) {
     StateUpdate* update = &(*iter);
     ++iter;
 
     shared_ptr<SwitchState> intermediateState;
     XLOG(INFO) << "preparing state update " << update->getName();
+    StateUpdateTracer::addSpan(
+        StateUpdateTracer::kQueueCategory,
+        update->getName(),
+        update->queuedTime_,
+        std::chrono::steady_clock::now());
     try {
+      StateUpdateTracer::ScopedSpan span(
+          StateUpdateTracer::kUpdateCategory, update->getName());
       intermediateState = update->applyUpdate(newDesiredState);
     } catch (const std::exception& ex) {
       // Call the update's onError() function, and then immediately delete
@@ -830,12 +953,19 @@ void SwSwitch::handlePendingUpdates() {
       newDesiredState = intermediateState;
     }
   }
+  return newDesiredState;
+}
+
+void SwSwitch::applyDesiredState(
+    const std::shared_ptr<SwitchState>& oldAppliedState,
+    const std::shared_ptr<SwitchState>& newDesiredState,
+    StateUpdateList* updates) {
   // Start newAppliedState as equal to newDesiredState unless
   // we learn otherwise
   auto newAppliedState = newDesiredState;
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
-    auto isTransaction = updates.begin()->hwFailureProtected() &&
+    auto isTransaction = updates->begin()->hwFailureProtected() &&
         getHw()->transactionsSupported();
     // There was some change during these state updates
     newAppliedState =
@@ -859,9 +989,10 @@ void SwSwitch::handlePendingUpdates() {
          */
         XLOG(INFO) << " Failed to apply updates to HW since SwSwtich already "
                       "started exit";
-      } else if (updates.size() == 1 && updates.begin()->hwFailureProtected()) {
+      } else if (
+          updates->size() == 1 && updates->begin()->hwFailureProtected()) {
         fb303::fbData->incrementCounter(kHwUpdateFailures);
-        unique_ptr<StateUpdate> update(&updates.front());
+        unique_ptr<StateUpdate> update(&updates->front());
         try {
           throw FbossHwUpdateError(
               newDesiredState,
@@ -883,13 +1014,104 @@ void SwSwitch::handlePendingUpdates() {
   }
 
   // Notify all of the updates of success and delete them.
-  while (!updates.empty()) {
-    unique_ptr<StateUpdate> update(&updates.front());
-    updates.pop_front();
+  while (!updates->empty()) {
+    unique_ptr<StateUpdate> update(&updates->front());
+    updates->pop_front();
     update->onSuccess();
   }
 }
 
+void SwSwitch::recordStateUpdateTrace(
+    std::unique_ptr<StateUpdateTracer::Trace> trace,
+    const std::shared_ptr<SwitchState>& oldAppliedState) {
+  if (!trace) {
+    return;
+  }
+  trace->oldGeneration = oldAppliedState->getGeneration();
+  trace->generation = getAppliedState()->getGeneration();
+  stateUpdateTracer_->record(std::move(trace));
+}
+
+void SwSwitch::computePendingUpdatesHelper(SwSwitch* sw) {
+  sw->computePendingUpdates();
+}
+
+void SwSwitch::computePendingUpdates() {
+  DCHECK(stateComputeEventBase_.isInEventBaseThread());
+  auto updates = getUpdatesToApply();
+  if (updates.empty()) {
+    return;
+  }
+  DCHECK(isInitialized());
+
+  bool pipelineEmpty;
+  {
+    std::lock_guard<std::mutex> guard(pipelineLock_);
+    pipelineEmpty = pipelineInFlight_ == 0;
+  }
+  // Build on top of the last computed state, unless that state is already
+  // applied (or will never be), in which case start from the applied state.
+  if (pipelineEmpty || pipelineRebase_.exchange(false) ||
+      !pipelineTailState_) {
+    pipelineTailState_ = getAppliedState();
+  }
+  auto computed = std::make_unique<ComputedStateUpdate>();
+  computed->trace = stateUpdateTracer_->startTrace();
+  computed->oldState = pipelineTailState_;
+  {
+    StateUpdateTracer::ScopedTrace scopedTrace(computed->trace.get());
+    computed->newDesiredState =
+        applyUpdateFunctions(computed->oldState, &updates);
+  }
+  computed->updates.swap(updates);
+  pipelineTailState_ = computed->newDesiredState;
+
+  {
+    // Bound the number of batches waiting on HW programming. Updates
+    // scheduled in the meantime then get coalesced into the next batch,
+    // rather than each becoming a batch of its own.
+    std::unique_lock<std::mutex> guard(pipelineLock_);
+    pipelineCv_.wait(guard, [this] {
+      return pipelineInFlight_ < FLAGS_state_update_pipeline_depth;
+    });
+    ++pipelineInFlight_;
+  }
+  updateEventBase_.runInEventBaseThread(
+      [this, computed = std::move(computed)]() mutable {
+        applyComputedUpdates(std::move(computed));
+      });
+}
+
+void SwSwitch::applyComputedUpdates(
+    std::unique_ptr<ComputedStateUpdate> computed) {
+  DCHECK(updateEventBase_.isInEventBaseThread());
+  SCOPE_EXIT {
+    {
+      std::lock_guard<std::mutex> guard(pipelineLock_);
+      --pipelineInFlight_;
+    }
+    pipelineCv_.notify_one();
+  };
+  StateUpdateTracer::ScopedTrace scopedTrace(computed->trace.get());
+  auto oldAppliedState = getAppliedState();
+  auto newDesiredState = computed->newDesiredState;
+  if (computed->oldState != oldAppliedState) {
+    // A batch ahead of this one failed to apply to HW, so this batch was
+    // computed on top of a state that will never be applied. Run the update
+    // functions again, this time on top of what was actually applied.
+    XLOG(DBG2) << "Recomputing pipelined state update on top of applied "
+               << "generation " << oldAppliedState->getGeneration();
+    fb303::fbData->incrementCounter(kStateUpdatePipelineRecomputes);
+    pipelineRebase_ = true;
+    newDesiredState = applyUpdateFunctions(oldAppliedState, &computed->updates);
+  }
+  applyDesiredState(oldAppliedState, newDesiredState, &computed->updates);
+  if (getAppliedState() != newDesiredState) {
+    pipelineRebase_ = true;
+  }
+  recordStateUpdateTrace(std::move(computed->trace), oldAppliedState);
+}
+
 void SwSwitch::setStateInternal(std::shared_ptr<SwitchState> newAppliedState) {
   // This is one of the only two places that should ever directly access
   // stateDontUseDirectly_.  (getState() being the other one.)
@@ -934,6 +1156,9 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   // undesirable.  So far I don't think this brief discrepancy should cause
   // major issues.
   try {
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kHwCategory,
+        isTransaction ? "stateChangedTransaction" : "stateChanged");
     newAppliedState = isTransaction ? hw_->stateChangedTransaction(delta)
                                     : hw_->stateChanged(delta);
   } catch (const std::exception& ex) {
@@ -1034,6 +1259,28 @@ void SwSwitch::setPortStatusCounter(PortID port, bool up) {
 }
 
 void SwSwitch::packetReceived(std::unique_ptr<RxPacket> pkt) noexcept {
+  if (!rxDispatcher_) {
+    handlePacketNoExcept(std::move(pkt));
+    return;
+  }
+  auto priority = rxDispatcher_->classify(*pkt);
+  if (rxDispatcher_->enqueue(std::move(pkt), priority)) {
+    return;
+  }
+  switch (priority) {
+    case RxPacketDispatcher::Priority::HIGH:
+      stats()->rxDispatchHighPriDrop();
+      break;
+    case RxPacketDispatcher::Priority::MID:
+      stats()->rxDispatchMidPriDrop();
+      break;
+    case RxPacketDispatcher::Priority::LOW:
+      stats()->rxDispatchLowPriDrop();
+      break;
+  }
+}
+
+void SwSwitch::handlePacketNoExcept(std::unique_ptr<RxPacket> pkt) noexcept {
   PortID port = pkt->getSrcPort();
   try {
     handlePacket(std::move(pkt));
@@ -1081,16 +1328,18 @@ void SwSwitch::handlePacket(std::unique_ptr<RxPacket> pkt) {
     return;
   }
 
-  // Parse the source and destination MAC, as well as the ethertype.
-  Cursor c(pkt->buf());
-  auto dstMac = PktUtil::readMac(&c);
-  auto srcMac = PktUtil::readMac(&c);
-  auto ethertype = c.readBE<uint16_t>();
-  if (ethertype == 0x8100) {
-    // 802.1Q
-    c += 2; // Advance over the VLAN tag.  We ignore it for now
-    ethertype = c.readBE<uint16_t>();
+  // The source and destination MAC, as well as the ethertype, after any
+  // VLAN tag. We ignore the tag itself for now.
+  const auto& metadata = pkt->getMetadata();
+  if (!metadata.hasL3()) {
+    portStats(port)->pktBogus();
+    return;
   }
+  auto dstMac = metadata.dstMac;
+  auto srcMac = metadata.srcMac;
+  auto ethertype = metadata.etherType;
+  Cursor c(pkt->buf());
+  c += metadata.l3Offset;
 
   std::stringstream ss;
   ss << "trapped packet: src_port=" << pkt->getSrcPort() << " srcAggPort="
@@ -1189,6 +1438,9 @@ void SwSwitch::linkStateChanged(PortID portId, bool up) {
         << "Ignore link state change event before we are fully initialized...";
     return;
   }
+  if (updateStreamRecorder_) {
+    updateStreamRecorder_->recordLinkStateChanged(portId, up);
+  }
 
   // Schedule an update for port's operational status
   auto updateOperStateFn = [=](const std::shared_ptr<SwitchState>& state) {
@@ -1220,6 +1472,11 @@ void SwSwitch::startThreads() {
       [=] { this->threadLoop("fbossBgThread", &backgroundEventBase_); }));
   updateThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossUpdateThread", &updateEventBase_); }));
+  if (pipelineStateUpdates_) {
+    stateComputeThread_.reset(new std::thread([=] {
+      this->threadLoop("fbossStateComputeThread", &stateComputeEventBase_);
+    }));
+  }
   packetTxThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossPktTxThread", &packetTxEventBase_); }));
   pcapDistributionThread_.reset(new std::thread([=] {
@@ -1229,6 +1486,15 @@ void SwSwitch::startThreads() {
   neighborCacheThread_.reset(new std::thread([=] {
     this->threadLoop("fbossNeighborCacheThread", &neighborCacheEventBase_);
   }));
+  if (FLAGS_rx_dispatch_threads > 0) {
+    rxDispatcher_ = std::make_unique<RxPacketDispatcher>(
+        [this](std::unique_ptr<RxPacket> pkt) {
+          handlePacketNoExcept(std::move(pkt));
+        },
+        FLAGS_rx_dispatch_threads,
+        FLAGS_rx_dispatch_queue_size,
+        FLAGS_rx_dispatch_high_pri_cos_queue);
+  }
 }
 
 void SwSwitch::stopThreads() {
@@ -1238,6 +1504,15 @@ void SwSwitch::stopThreads() {
   //
   // Alternatively, it would be nicer to update EventBase so it can notify
   // callbacks when the event loop is being stopped.
+  //
+  // The state compute thread is stopped first, so that batches it already
+  // computed are still handed to (and rejected by, since we are exiting)
+  // the update thread.
+  if (stateComputeThread_) {
+    stateComputeEventBase_.runInEventBaseThread(
+        [this] { stateComputeEventBase_.terminateLoopSoon(); });
+    stateComputeThread_->join();
+  }
   if (backgroundThread_) {
     backgroundEventBase_.runInEventBaseThread(
         [this] { backgroundEventBase_.terminateLoopSoon(); });
@@ -1596,6 +1871,9 @@ void SwSwitch::applyConfig(const std::string& reason, bool reload) {
 void SwSwitch::applyConfig(
     const std::string& reason,
     const cfg::SwitchConfig& newConfig) {
+  if (updateStreamRecorder_) {
+    updateStreamRecorder_->recordConfigApplied(newConfig);
+  }
   // We don't need to hold a lock here. updateStateBlocking() does that for us.
   auto routeUpdater = getRouteUpdater();
   updateStateBlocking(
@@ -11,6 +11,7 @@
 
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/RestartTimeTracker.h"
+#include "fboss/agent/StateUpdateTracer.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/ThreadHeartbeat.h"
 #include "fboss/agent/Utils.h"
@@ -28,6 +29,7 @@
 #include <optional>
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -36,6 +38,7 @@
 namespace facebook::fboss {
 
 class ArpHandler;
+class BlockingUpdateResult;
 class IPv4Handler;
 class IPv6Handler;
 class LinkAggregationManager;
@@ -48,10 +51,12 @@ class PortDescriptor;
 class PortStats;
 class PortUpdateHandler;
 class RxPacket;
+class RxPacketDispatcher;
 class SwitchState;
 class SwitchStats;
 class StateDelta;
 class NeighborUpdater;
+class NeighborCacheScheduler;
 class RouteUpdateLogger;
 class StateObserver;
 class TunManager;
@@ -63,6 +68,7 @@ class ResolvedNexthopMonitor;
 class ResolvedNexthopProbeScheduler;
 class StaticL2ForNeighborObserver;
 class MKAServiceManager;
+class UpdateStreamRecorder;
 template <typename AddressT>
 class Route;
 
@@ -278,6 +284,24 @@ class SwSwitch : public HwSwitch::Callback {
       folly::StringPiece name,
       StateUpdateFn fn);
 
+  /*
+   * Like updateStateWithHwFailureProtection(), but returns once the update
+   * is scheduled. Waiting on the returned result throws FbossHwUpdateError
+   * if the update could not be applied to Hw. Returns null if the update was
+   * not scheduled, because we are exiting.
+   */
+  std::shared_ptr<BlockingUpdateResult> updateStateWithHwFailureProtectionAsync(
+      folly::StringPiece name,
+      StateUpdateFn fn);
+
+  /*
+   * Whether the next batch of state updates is computed while the previous
+   * one is programmed in Hw (--enable_state_update_pipelining)
+   */
+  bool isStateUpdatePipeliningEnabled() const {
+    return pipelineStateUpdates_;
+  }
+
   /**
    * Apply config from the config file (specified in 'config' flag).
    *
@@ -430,6 +454,14 @@ class SwSwitch : public HwSwitch::Callback {
     return &neighborCacheEventBase_;
   }
 
+  /*
+   * Get the timer wheel and probe pacer for Arp/Ndp Cache entries, only to
+   * be used from the neighbor cache thread
+   */
+  NeighborCacheScheduler* getNeighborCacheScheduler() {
+    return neighborCacheScheduler_.get();
+  }
+
   /**
    * Do the packet received callback, and throw exception if there is an error
    * in the handling of packet.
@@ -584,6 +616,21 @@ class SwSwitch : public HwSwitch::Callback {
     return routeUpdateLogger_.get();
   }
 
+  /*
+   * Get the timeline of the most recent state updates
+   */
+  const StateUpdateTracer* getStateUpdateTracer() const {
+    return stateUpdateTracer_.get();
+  }
+
+  /*
+   * Get the recorder of external inputs to the agent, null unless
+   * --update_stream_record_file is set
+   */
+  UpdateStreamRecorder* getUpdateStreamRecorder() {
+    return updateStreamRecorder_.get();
+  }
+
   LinkAggregationManager* getLagManager() {
     return lagManager_.get();
   }
@@ -612,7 +659,7 @@ class SwSwitch : public HwSwitch::Callback {
   }
 
   SwSwitchRouteUpdateWrapper getRouteUpdater() {
-    return SwSwitchRouteUpdateWrapper(this, rib_.get());
+    return SwSwitchRouteUpdateWrapper(this, rib_.get(), sharedFibUpdates_);
   }
 
   /*
@@ -737,14 +784,47 @@ class SwSwitch : public HwSwitch::Callback {
   void setSwitchRunState(SwitchRunState desiredState);
   SwitchStats* createSwitchStats();
   void handlePacket(std::unique_ptr<RxPacket> pkt);
+  void handlePacketNoExcept(std::unique_ptr<RxPacket> pkt) noexcept;
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
+  StateUpdateList getUpdatesToApply();
+  std::shared_ptr<SwitchState> applyUpdateFunctions(
+      const std::shared_ptr<SwitchState>& origState,
+      StateUpdateList* updates);
+  void applyDesiredState(
+      const std::shared_ptr<SwitchState>& oldAppliedState,
+      const std::shared_ptr<SwitchState>& newDesiredState,
+      StateUpdateList* updates);
+  void recordStateUpdateTrace(
+      std::unique_ptr<StateUpdateTracer::Trace> trace,
+      const std::shared_ptr<SwitchState>& oldAppliedState);
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState,
       bool isTransaction);
 
+  /*
+   * Pipelined state updates (--enable_state_update_pipelining).
+   *
+   * Update functions run on the state compute thread, on top of the last
+   * state handed to the update thread rather than the applied state, so the
+   * next batch of updates is computed while the previous one is programmed
+   * in HW. The update thread still programs HW, publishes the applied state
+   * and notifies observers, strictly in the order batches were computed.
+   * FIB updates from the RIB don't wait for HW either, see
+   * SwSwitchRouteUpdateWrapper.
+   */
+  struct ComputedStateUpdate {
+    std::shared_ptr<SwitchState> oldState;
+    std::shared_ptr<SwitchState> newDesiredState;
+    StateUpdateList updates;
+    std::unique_ptr<StateUpdateTracer::Trace> trace;
+  };
+  static void computePendingUpdatesHelper(SwSwitch* sw);
+  void computePendingUpdates();
+  void applyComputedUpdates(std::unique_ptr<ComputedStateUpdate> computed);
+
   void startThreads();
   void stopThreads();
   void threadLoop(folly::StringPiece name, folly::EventBase* eventBase);
@@ -849,6 +929,23 @@ class SwSwitch : public HwSwitch::Callback {
   folly::EventBase updateEventBase_;
   std::unique_ptr<ThreadHeartbeat> updThreadHeartbeat_;
 
+  /*
+   * A thread for computing SwitchState updates ahead of the update thread,
+   * only started when state updates are pipelined.
+   */
+  bool pipelineStateUpdates_{false};
+  std::unique_ptr<std::thread> stateComputeThread_;
+  folly::EventBase stateComputeEventBase_;
+  // Last desired state handed to the update thread. Only accessed from
+  // the state compute thread.
+  std::shared_ptr<SwitchState> pipelineTailState_;
+  // Set by the update thread when pipelineTailState_ will never be applied
+  std::atomic<bool> pipelineRebase_{false};
+  // Computed batches handed to, but not yet applied by, the update thread
+  std::mutex pipelineLock_;
+  std::condition_variable pipelineCv_;
+  int pipelineInFlight_{0};
+
   /*
    * A thread dedicated to LACP processing.
    */
@@ -862,6 +959,13 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<std::thread> neighborCacheThread_;
   folly::EventBase neighborCacheEventBase_;
   std::unique_ptr<ThreadHeartbeat> neighborCacheThreadHeartbeat_;
+  std::unique_ptr<NeighborCacheScheduler> neighborCacheScheduler_;
+
+  /*
+   * Worker threads handling trapped packets in priority order, when
+   * packets aren't handled inline on the HW RX thread.
+   */
+  std::unique_ptr<RxPacketDispatcher> rxDispatcher_;
 
   /*
    * A callback for listening to neighbors coming and going.
@@ -891,6 +995,10 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<ResolvedNexthopMonitor> resolvedNexthopMonitor_;
   std::unique_ptr<ResolvedNexthopProbeScheduler> resolvedNexthopProbeScheduler_;
   std::unique_ptr<RoutingInformationBase> rib_{nullptr};
+  // Pipelined FIB updates of all route updaters
+  std::shared_ptr<SwSwitchRouteUpdateWrapper::SharedFibUpdates>
+      sharedFibUpdates_{
+          std::make_shared<SwSwitchRouteUpdateWrapper::SharedFibUpdates>()};
 
   BootType bootType_{BootType::UNINITIALIZED};
   std::unique_ptr<LldpManager> lldpManager_;
@@ -901,6 +1009,8 @@ class SwSwitch : public HwSwitch::Callback {
   std::unique_ptr<LookupClassRouteUpdater> lookupClassRouteUpdater_;
   std::unique_ptr<StaticL2ForNeighborObserver> staticL2ForNeighborObserver_;
   std::unique_ptr<MacTableManager> macTableManager_;
+  std::unique_ptr<StateUpdateTracer> stateUpdateTracer_;
+  std::unique_ptr<UpdateStreamRecorder> updateStreamRecorder_;
 #if FOLLY_HAS_COROUTINES
   std::unique_ptr<MKAServiceManager> mkaServiceManager_;
 #endif
@@ -10,14 +10,26 @@
 
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 
+#include "fboss/agent/FbossHwUpdateError.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <gflags/gflags.h>
+
 #include <memory>
+#include <set>
+
+DEFINE_bool(
+    ack_route_updates_on_schedule,
+    false,
+    "With --enable_state_update_pipelining, return from route updates once "
+    "their FIB updates are scheduled, and report HW failures of a client's "
+    "route update on its next route update");
 
 namespace facebook::fboss {
 
@@ -36,12 +48,149 @@ std::shared_ptr<SwitchState> swSwitchFibUpdate(
 
 SwSwitchRouteUpdateWrapper::SwSwitchRouteUpdateWrapper(
     SwSwitch* sw,
-    RoutingInformationBase* rib)
+    RoutingInformationBase* rib,
+    std::shared_ptr<SharedFibUpdates> sharedFibUpdates)
+    : SwSwitchRouteUpdateWrapper(
+          sw,
+          rib,
+          std::make_shared<PipelinedFibUpdates>(std::move(sharedFibUpdates))) {
+}
+
+SwSwitchRouteUpdateWrapper::SwSwitchRouteUpdateWrapper(
+    SwSwitch* sw,
+    RoutingInformationBase* rib,
+    std::shared_ptr<PipelinedFibUpdates> pipelinedFibUpdates)
     : RouteUpdateWrapper(
           rib,
-          rib ? swSwitchFibUpdate : std::optional<FibUpdateFunction>(),
+          rib ? makeFibUpdateFunction(pipelinedFibUpdates)
+              : std::optional<FibUpdateFunction>(),
           rib ? sw : nullptr),
-      sw_(sw) {}
+      sw_(sw),
+      pipelinedFibUpdates_(std::move(pipelinedFibUpdates)) {}
+
+FibUpdateFunction SwSwitchRouteUpdateWrapper::makeFibUpdateFunction(
+    std::shared_ptr<PipelinedFibUpdates> pipelinedFibUpdates) {
+  return [pipelinedFibUpdates](
+             RouterID vrf,
+             const IPv4NetworkToRouteMap& v4NetworkToRoute,
+             const IPv6NetworkToRouteMap& v6NetworkToRoute,
+             void* cookie) {
+    if (!pipelinedFibUpdates->enabled) {
+      return swSwitchFibUpdate(vrf, v4NetworkToRoute, v6NetworkToRoute, cookie);
+    }
+    // The RIB changes again as soon as we return, so compute the FIB from a
+    // copy of it. Routes are copied on write by the RIB, so only the trees
+    // need copying.
+    SharedFibUpdates::RibCopy rib{
+        std::make_shared<IPv4NetworkToRouteMap>(v4NetworkToRoute.clone()),
+        std::make_shared<IPv6NetworkToRouteMap>(v6NetworkToRoute.clone())};
+    auto& lastScheduledRib = pipelinedFibUpdates->shared->lastScheduledRib;
+    auto previousRib = lastScheduledRib.find(vrf);
+    SwSwitch::StateUpdateFn fibUpdate;
+    if (previousRib == lastScheduledRib.end()) {
+      fibUpdate = [vrf, rib](const std::shared_ptr<SwitchState>& state) {
+        ForwardingInformationBaseUpdater fibUpdater(
+            vrf, *rib.v4NetworkToRoute, *rib.v6NetworkToRoute);
+        return fibUpdater(state);
+      };
+    } else {
+      // Only apply what this RIB update changed. Earlier FIB updates may
+      // still fail, and their routes must then stay out of the FIB until
+      // the RIB is rolled back.
+      fibUpdate = [vrf, rib, previous = previousRib->second](
+                      const std::shared_ptr<SwitchState>& state) {
+        ForwardingInformationBaseUpdater fibUpdater(
+            vrf,
+            *rib.v4NetworkToRoute,
+            *rib.v6NetworkToRoute,
+            *previous.v4NetworkToRoute,
+            *previous.v6NetworkToRoute);
+        return fibUpdater(state);
+      };
+    }
+    lastScheduledRib[vrf] = rib;
+    auto sw = static_cast<SwSwitch*>(cookie);
+    auto result = sw->updateStateWithHwFailureProtectionAsync(
+        "pipelined FIB update", std::move(fibUpdate));
+    if (result) {
+      pipelinedFibUpdates->scheduled.emplace_back(vrf, std::move(result));
+    }
+    return sw->getState();
+  };
+}
+
+void SwSwitchRouteUpdateWrapper::ribUpdatesStarted() {
+  pipelinedFibUpdates_->enabled = sw_->isStateUpdatePipeliningEnabled();
+}
+
+void SwSwitchRouteUpdateWrapper::ribUpdatesFinished() {
+  pipelinedFibUpdates_->enabled = false;
+  auto scheduled = std::move(pipelinedFibUpdates_->scheduled);
+  pipelinedFibUpdates_->scheduled.clear();
+  if (FLAGS_ack_route_updates_on_schedule) {
+    // By now, most of the previous route updates of our clients got
+    // programmed while the RIB was handling this one
+    scheduled = swapUnackedFibUpdates(std::move(scheduled));
+  }
+
+  std::exception_ptr firstError;
+  std::set<RouterID> failedVrfs;
+  for (const auto& [vrf, result] : scheduled) {
+    try {
+      result->wait();
+    } catch (const FbossHwUpdateError&) {
+      failedVrfs.insert(vrf);
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    } catch (const std::exception&) {
+      if (!firstError) {
+        firstError = std::current_exception();
+      }
+    }
+  }
+  for (auto vrf : failedVrfs) {
+    rib_->reconstructFromFib(vrf, [this]() {
+      // Updates are applied in the order they are scheduled, so once this
+      // one is done, so are the FIB updates scheduled before it
+      sw_->updateStateBlocking(
+          "wait for FIB updates before RIB rollback",
+          [](const std::shared_ptr<SwitchState>& /*state*/) {
+            return std::shared_ptr<SwitchState>();
+          });
+      return sw_->getState();
+    });
+  }
+  if (firstError) {
+    std::rethrow_exception(firstError);
+  }
+}
+
+SwSwitchRouteUpdateWrapper::ScheduledFibUpdates
+SwSwitchRouteUpdateWrapper::swapUnackedFibUpdates(
+    ScheduledFibUpdates scheduled) {
+  std::set<ClientID> clients;
+  for (const auto& entry : ribRoutesToAddDel_) {
+    clients.insert(entry.first.second);
+  }
+  // A program() with several clients reports its failures to each of them
+  ScheduledFibUpdates previous;
+  auto unacked = pipelinedFibUpdates_->shared->unacked.wlock();
+  for (auto client : clients) {
+    auto clientUnacked = unacked->find(client);
+    if (clientUnacked != unacked->end()) {
+      previous.insert(
+          previous.end(),
+          clientUnacked->second.begin(),
+          clientUnacked->second.end());
+      unacked->erase(clientUnacked);
+    }
+    if (!scheduled.empty()) {
+      unacked->emplace(client, scheduled);
+    }
+  }
+  return previous;
+}
 
 void SwSwitchRouteUpdateWrapper::updateStats(
     const RoutingInformationBase::UpdateStatistics& stats) {
@@ -13,7 +13,15 @@
 #include "fboss/agent/RouteUpdateWrapper.h"
 #include "fboss/agent/rib/RoutingInformationBase.h"
 
+#include <folly/Synchronized.h>
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
+class BlockingUpdateResult;
 class SwSwitch;
 
 std::shared_ptr<SwitchState> swSwitchFibUpdate(
@@ -22,16 +30,79 @@ std::shared_ptr<SwitchState> swSwitchFibUpdate(
     const facebook::fboss::IPv6NetworkToRouteMap& v6NetworkToRoute,
     void* cookie);
 
+/*
+ * With --enable_state_update_pipelining, the FIB updates of program() are
+ * scheduled without waiting for them to be programmed in HW, so the RIB
+ * thread resolves the next route update while the previous one is being
+ * programmed. Each FIB update only carries the routes its RIB update changed,
+ * so a FIB update that fails in HW is not retried by the updates scheduled
+ * after it, be they from the same route updater or another one. program()
+ * waits for all of them before returning, and rolls back the RIB of VRFs
+ * whose FIB update failed, as the RIB thread does when it waits itself.
+ *
+ * With --ack_route_updates_on_schedule as well, program() returns as soon
+ * as its FIB updates are scheduled, and instead waits for the ones of the
+ * previous program() of the same clients. So back to back route updates of
+ * a client overlap with HW programming, and a HW failure is reported, and
+ * the RIB rolled back, on the next route update of the client that failed.
+ */
 class SwSwitchRouteUpdateWrapper : public RouteUpdateWrapper {
  public:
-  explicit SwSwitchRouteUpdateWrapper(
+  using ScheduledFibUpdates =
+      std::vector<std::pair<RouterID, std::shared_ptr<BlockingUpdateResult>>>;
+
+  /*
+   * Pipelined FIB updates state shared by all route updaters of a SwSwitch
+   */
+  struct SharedFibUpdates {
+    struct RibCopy {
+      std::shared_ptr<IPv4NetworkToRouteMap> v4NetworkToRoute;
+      std::shared_ptr<IPv6NetworkToRouteMap> v6NetworkToRoute;
+    };
+    // The RIB each VRF's last scheduled FIB update was computed from. Only
+    // accessed on the RIB thread, which schedules FIB updates.
+    std::map<RouterID, RibCopy> lastScheduledRib;
+    // FIB updates of program() calls that returned before they were
+    // programmed, by client
+    folly::Synchronized<std::map<ClientID, ScheduledFibUpdates>> unacked;
+  };
+
+  SwSwitchRouteUpdateWrapper(
       SwSwitch* sw,
-      RoutingInformationBase* rib);
+      RoutingInformationBase* rib,
+      std::shared_ptr<SharedFibUpdates> sharedFibUpdates);
 
  private:
+  struct PipelinedFibUpdates {
+    explicit PipelinedFibUpdates(std::shared_ptr<SharedFibUpdates> shared)
+        : shared(std::move(shared)) {}
+    // Set while program() hands route updates to the RIB
+    bool enabled{false};
+    ScheduledFibUpdates scheduled;
+    std::shared_ptr<SharedFibUpdates> shared;
+  };
+
+  SwSwitchRouteUpdateWrapper(
+      SwSwitch* sw,
+      RoutingInformationBase* rib,
+      std::shared_ptr<PipelinedFibUpdates> pipelinedFibUpdates);
+
+  static FibUpdateFunction makeFibUpdateFunction(
+      std::shared_ptr<PipelinedFibUpdates> pipelinedFibUpdates);
+
   AdminDistance clientIdToAdminDistance(ClientID clientID) const override;
   void updateStats(
       const RoutingInformationBase::UpdateStatistics& stats) override;
+  void ribUpdatesStarted() override;
+  void ribUpdatesFinished() override;
+  /*
+   * Make the FIB updates scheduled by this program() the unacknowledged ones
+   * of its clients, and return the ones they replace
+   */
+  ScheduledFibUpdates swapUnackedFibUpdates(ScheduledFibUpdates scheduled);
+
   SwSwitch* sw_;
+  // Shared with the FIB update function, which runs on the RIB thread
+  std::shared_ptr<PipelinedFibUpdates> pipelinedFibUpdates_;
 };
 } // namespace facebook::fboss
@@ -13,6 +13,7 @@
 #include "fboss/agent/PortStats.h"
 
 using facebook::fb303::AVG;
+using facebook::fb303::COUNT;
 using facebook::fb303::RATE;
 using facebook::fb303::SUM;
 
@@ -177,6 +178,21 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           kCounterPrefix + "update_stats_exceptions",
           SUM),
       trapPktTooBig_(map, kCounterPrefix + "trapped.packet_too_big", SUM, RATE),
+      rxDispatchHighPriDrops_(
+          map,
+          kCounterPrefix + "trapped.dispatch_drops.high",
+          SUM,
+          RATE),
+      rxDispatchMidPriDrops_(
+          map,
+          kCounterPrefix + "trapped.dispatch_drops.mid",
+          SUM,
+          RATE),
+      rxDispatchLowPriDrops_(
+          map,
+          kCounterPrefix + "trapped.dispatch_drops.low",
+          SUM,
+          RATE),
       LldpRecvdPkt_(map, kCounterPrefix + "lldp.recvd", SUM, RATE),
       LldpBadPkt_(map, kCounterPrefix + "lldp.recv_bad", SUM, RATE),
       LldpValidateMisMatch_(
@@ -190,6 +206,16 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           map,
           kCounterPrefix + "lacp.mismatched_pdu_teardown",
           SUM),
+      lacpStateUpdateLatency_(
+          map,
+          kCounterPrefix + "lacp.state_update_latency.ms",
+          10,
+          0,
+          5000,
+          AVG,
+          COUNT,
+          50,
+          100),
       MkPduRecvdPkts_(map, kCounterPrefix + "mkpdu.recvd", SUM, RATE),
       MkPduSendPkts_(map, kCounterPrefix + "mkpdu.send", SUM, RATE),
       MkPduSendFailure_(
@@ -290,6 +290,19 @@ class SwitchStats : public boost::noncopyable {
     trapPktTooBig_.addValue(1);
   }
 
+  void rxDispatchHighPriDrop() {
+    rxDispatchHighPriDrops_.addValue(1);
+    trapPktDrops_.addValue(1);
+  }
+  void rxDispatchMidPriDrop() {
+    rxDispatchMidPriDrops_.addValue(1);
+    trapPktDrops_.addValue(1);
+  }
+  void rxDispatchLowPriDrop() {
+    rxDispatchLowPriDrops_.addValue(1);
+    trapPktDrops_.addValue(1);
+  }
+
   void LldpRecvdPkt() {
     LldpRecvdPkt_.addValue(1);
   }
@@ -308,6 +321,9 @@ class SwitchStats : public boost::noncopyable {
   void LacpMismatchPduTeardown() {
     LacpMismatchPduTeardown_.addValue(1);
   }
+  void lacpStateUpdateLatency(int value) {
+    lacpStateUpdateLatency_.addValue(value);
+  }
 
   void MkPduRecvdPkt() {
     MkPduRecvdPkts_.addValue(1);
@@ -514,6 +530,12 @@ class SwitchStats : public boost::noncopyable {
   // Number of packet too big ICMPv6 triggered
   TLTimeseries trapPktTooBig_;
 
+  // Number of trapped packets dropped because their RX dispatch queue
+  // was full, per priority class
+  TLTimeseries rxDispatchHighPriDrops_;
+  TLTimeseries rxDispatchMidPriDrops_;
+  TLTimeseries rxDispatchLowPriDrops_;
+
   // Number of LLDP packets.
   TLTimeseries LldpRecvdPkt_;
   // Number of bad LLDP packets.
@@ -527,6 +549,8 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseries LacpRxTimeouts_;
   // Number of LACP session teardown due to mismatching PDUs
   TLTimeseries LacpMismatchPduTeardown_;
+  // Time from a LACP member transition to its state update being applied
+  TLHistogram lacpStateUpdateLatency_;
   // Number of MkPdu Received.
   TLTimeseries MkPduRecvdPkts_;
   // Number of MkPdu Send.
@@ -24,9 +24,11 @@
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/TxPacket.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PktCapture.h"
 #include "fboss/agent/capture/PktCaptureManager.h"
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 #include "fboss/agent/if/gen-cpp2/NeighborListenerClient.h"
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
@@ -58,6 +60,8 @@
 #include <folly/IPAddressV6.h>
 #include <folly/MoveWrapper.h>
 #include <folly/Range.h>
+#include <folly/ScopeGuard.h>
+#include <folly/Synchronized.h>
 #include <folly/container/F14Map.h>
 #include <folly/functional/Partial.h>
 #include <folly/io/Cursor.h>
@@ -67,7 +71,16 @@
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <thrift/lib/cpp2/async/DuplexChannel.h>
 
+#if FOLLY_HAS_COROUTINES
+#include <folly/experimental/coro/AsyncGenerator.h>
+#include <folly/experimental/coro/Baton.h>
+#endif
+
+#include <atomic>
+#include <deque>
 #include <limits>
+#include <mutex>
+#include <optional>
 
 using apache::thrift::ClientReceiveState;
 using apache::thrift::server::TConnectionContext;
@@ -513,6 +526,135 @@ void translateToFibError(const FbossHwUpdateError& updError) {
       });
   throw fibError;
 }
+
+BufferWatermarkSampler* getBufferWatermarkSampler(const SwSwitch* sw) {
+  auto sampler = sw->getHw()->getBufferWatermarkSampler();
+  if (!sampler) {
+    throw FbossError("Buffer watermark sampling is not supported");
+  }
+  return sampler;
+}
+
+// Sampling faster than this spends more time reading the hardware than
+// it gains in resolution
+constexpr int32_t kMinBufferWatermarkSamplingIntervalMsecs = 5;
+
+#if FOLLY_HAS_COROUTINES
+BufferWatermarkSamples toThriftSamples(
+    const std::vector<BufferWatermarkSampler::QueueKey>& queues,
+    const BufferWatermarkSampler::Samples& samples) {
+  BufferWatermarkSamples thriftSamples;
+  thriftSamples.timestampUsecs_ref() = samples.timestampUsecs;
+  thriftSamples.deviceBytes_ref() = samples.deviceBytes;
+  for (size_t i = 0; i < queues.size(); ++i) {
+    QueueWatermarkSample queueSample;
+    queueSample.portId_ref() = queues[i].first;
+    queueSample.queueId_ref() = queues[i].second;
+    queueSample.bytes_ref() = samples.queueBytes[i];
+    thriftSamples.queues_ref()->push_back(std::move(queueSample));
+  }
+  return thriftSamples;
+}
+
+/*
+ * Streams buffer watermark samples to a thrift client, until the client
+ * goes away or sampling is stopped.
+ *
+ * The stream pulls samples as the client asks for them. Up to kMaxBacklog
+ * samples wait for a client that falls behind. Past that, new samples are
+ * folded into the newest waiting one, which keeps the peak of every queue
+ * and the latest timestamp, so a slow client costs bounded memory but does
+ * not miss a burst.
+ */
+class BufferWatermarkStreamer : public BufferWatermarkSampler::Subscriber {
+ public:
+  static constexpr size_t kMaxBacklog = 1024;
+
+  bool samplesTaken(
+      const std::vector<BufferWatermarkSampler::QueueKey>& queues,
+      const BufferWatermarkSampler::Samples& samples) override {
+    {
+      auto locked = state_.lock();
+      if (locked->done) {
+        return false;
+      }
+      auto& backlog = locked->backlog;
+      if (backlog.size() < kMaxBacklog) {
+        backlog.push_back({queues, samples});
+      } else if (backlog.back().queues == queues) {
+        coalesce(backlog.back().samples, samples);
+      } else {
+        // Sampling restarted on other queues, whose samples don't fold
+        // into the old ones
+        backlog.pop_front();
+        backlog.push_back({queues, samples});
+      }
+    }
+    pending_.post();
+    return true;
+  }
+
+  void samplingStopped() override {
+    state_.lock()->done = true;
+    pending_.post();
+  }
+
+  static folly::coro::AsyncGenerator<BufferWatermarkSamples&&> stream(
+      std::shared_ptr<BufferWatermarkStreamer> streamer) {
+    // The generator is destroyed when the client cancels the stream, which
+    // unsubscribes us on the next sample
+    SCOPE_EXIT {
+      streamer->state_.lock()->done = true;
+    };
+    while (true) {
+      std::optional<Pending> next;
+      bool done = false;
+      {
+        auto locked = streamer->state_.lock();
+        if (!locked->backlog.empty()) {
+          next = std::move(locked->backlog.front());
+          locked->backlog.pop_front();
+        }
+        done = locked->done;
+      }
+      if (next) {
+        co_yield toThriftSamples(next->queues, next->samples);
+        continue;
+      }
+      if (done) {
+        co_return;
+      }
+      co_await streamer->pending_;
+      streamer->pending_.reset();
+    }
+  }
+
+ private:
+  struct Pending {
+    std::vector<BufferWatermarkSampler::QueueKey> queues;
+    BufferWatermarkSampler::Samples samples;
+  };
+  struct State {
+    std::deque<Pending> backlog;
+    // Sampling stopped, or the client went away
+    bool done{false};
+  };
+
+  static void coalesce(
+      BufferWatermarkSampler::Samples& into,
+      const BufferWatermarkSampler::Samples& samples) {
+    into.timestampUsecs = samples.timestampUsecs;
+    into.deviceBytes = std::max(into.deviceBytes, samples.deviceBytes);
+    for (size_t i = 0; i < into.queueBytes.size(); ++i) {
+      into.queueBytes[i] = std::max(into.queueBytes[i], samples.queueBytes[i]);
+    }
+  }
+
+  folly::Synchronized<State, std::mutex> state_;
+  // Posted on every change to state_
+  folly::coro::Baton pending_;
+};
+#endif
 } // namespace
 
 namespace facebook::fboss {
@@ -664,6 +806,14 @@ void ThriftHandler::deleteUnicastRoutesInVrf(
   auto updater = sw_->getRouteUpdater();
   auto routerID = RouterID(vrf);
   auto clientID = ClientID(client);
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordRouteUpdate(
+        routerID,
+        clientID,
+        update_stream::RouteUpdateType::DELETE,
+        {},
+        *prefixes);
+  }
   for (const auto& prefix : *prefixes) {
     updater.delRoute(routerID, prefix, clientID);
   }
@@ -728,6 +878,14 @@ void ThriftHandler::updateUnicastRoutesImpl(
   auto updater = sw_->getRouteUpdater();
   auto routerID = RouterID(vrf);
   auto clientID = ClientID(client);
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordRouteUpdate(
+        routerID,
+        clientID,
+        sync ? update_stream::RouteUpdateType::SYNC_FIB
+             : update_stream::RouteUpdateType::ADD,
+        *routes);
+  }
   for (const auto& route : *routes) {
     updater.addRoute(routerID, clientID, route);
   }
@@ -1038,6 +1196,11 @@ void ThriftHandler::getCurrentStateJSON(
   ret = folly::json::serialize(*dyn, folly::json::serialization_opts{});
 }
 
+void ThriftHandler::getStateUpdateTrace(std::string& ret) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ret = sw_->getStateUpdateTracer()->getChromeTrace();
+}
+
 void ThriftHandler::patchCurrentStateJSON(
     std::unique_ptr<std::string> jsonPointerStr,
     std::unique_ptr<std::string> jsonPatchStr) {
@@ -1456,6 +1619,97 @@ void ThriftHandler::stopAllPktCaptures() {
   mgr->forgetAllCaptures();
 }
 
+void ThriftHandler::startBufferWatermarkSampling(
+    std::unique_ptr<BufferWatermarkSamplingInfo> info) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  auto* sampler = getBufferWatermarkSampler(sw_);
+  auto state = sw_->getState();
+  std::vector<BufferWatermarkSampler::QueueKey> queues;
+  for (auto portId : *info->portIds_ref()) {
+    auto port = state->getPorts()->getPortIf(PortID(portId));
+    if (!port) {
+      throw FbossError("No such port: ", portId);
+    }
+    if (!info->queueIds_ref()->empty()) {
+      for (auto queueId : *info->queueIds_ref()) {
+        queues.emplace_back(port->getID(), queueId);
+      }
+      continue;
+    }
+    auto numQueues = queues.size();
+    for (const auto& queue : port->getPortQueues()) {
+      if (queue->getStreamType() == cfg::StreamType::UNICAST) {
+        queues.emplace_back(port->getID(), queue->getID());
+      }
+    }
+    if (queues.size() == numQueues) {
+      throw FbossError(
+          "No unicast queues configured on port ",
+          portId,
+          ", pass the queues to sample");
+    }
+  }
+  if (queues.empty()) {
+    throw FbossError("No queues to sample");
+  }
+  if (*info->intervalMsecs_ref() < kMinBufferWatermarkSamplingIntervalMsecs) {
+    throw FbossError(
+        "Buffer watermark sampling interval must be at least ",
+        kMinBufferWatermarkSamplingIntervalMsecs,
+        "ms, got ",
+        *info->intervalMsecs_ref(),
+        "ms");
+  }
+  sampler->start(
+      std::move(queues), std::chrono::milliseconds(*info->intervalMsecs_ref()));
+}
+
+void ThriftHandler::stopBufferWatermarkSampling() {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  getBufferWatermarkSampler(sw_)->stop();
+}
+
+void ThriftHandler::getBufferWatermarkHistograms(
+    std::vector<QueueWatermarkHistogram>& histograms) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  std::vector<int64_t> bucketUpperBytes;
+  for (size_t i = 0; i + 1 < BufferWatermarkSampler::kNumHistogramBuckets;
+       ++i) {
+    bucketUpperBytes.push_back(
+        BufferWatermarkSampler::getHistogramBucketUpperBytes(i));
+  }
+  for (const auto& histogram :
+       getBufferWatermarkSampler(sw_)->getHistograms()) {
+    QueueWatermarkHistogram thriftHistogram;
+    thriftHistogram.portId_ref() = histogram.queue.first;
+    thriftHistogram.queueId_ref() = histogram.queue.second;
+    thriftHistogram.bucketUpperBoundBytes_ref() = bucketUpperBytes;
+    thriftHistogram.bucketCounts_ref() = std::vector<int64_t>(
+        histogram.bucketCounts.begin(), histogram.bucketCounts.end());
+    thriftHistogram.maxBytes_ref() = histogram.maxBytes;
+    thriftHistogram.numSamples_ref() = histogram.numSamples;
+    histograms.push_back(std::move(thriftHistogram));
+  }
+}
+
+apache::thrift::ServerStream<BufferWatermarkSamples>
+ThriftHandler::subscribeToBufferWatermarkSamples() {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  auto* sampler = getBufferWatermarkSampler(sw_);
+#if FOLLY_HAS_COROUTINES
+  auto streamer = std::make_shared<BufferWatermarkStreamer>();
+  sampler->subscribe(streamer);
+  return BufferWatermarkStreamer::stream(std::move(streamer));
+#else
+  // Without coroutines, the only stream is a publisher, whose buffer a
+  // slow client could grow without bound
+  (void)sampler;
+  throw FbossError(
+      "Streaming buffer watermark samples needs coroutine support");
+#endif
+}
+
 void ThriftHandler::startLoggingRouteUpdates(
     std::unique_ptr<RouteUpdateLoggingInfo> info) {
   auto log = LOG_THRIFT_CALL(DBG1);
@@ -1781,6 +2035,10 @@ void ThriftHandler::addMplsRoutes(
   auto clientName = apache::thrift::util::enumNameSafe(ClientID(clientId));
   auto log = LOG_THRIFT_CALL(DBG1, clientName);
   ensureConfigured(__func__);
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordMplsRouteUpdate(
+        ClientID(clientId), update_stream::RouteUpdateType::ADD, *mplsRoutes);
+  }
   auto updateFn = [=, routes = std::move(*mplsRoutes)](
                       const std::shared_ptr<SwitchState>& state) {
     auto newState = state->clone();
@@ -1894,6 +2152,13 @@ void ThriftHandler::deleteMplsRoutes(
   auto clientName = apache::thrift::util::enumNameSafe(ClientID(clientId));
   auto log = LOG_THRIFT_CALL(DBG1, clientName);
   ensureConfigured(__func__);
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordMplsRouteUpdate(
+        ClientID(clientId),
+        update_stream::RouteUpdateType::DELETE,
+        {},
+        *topLabels);
+  }
   auto updateFn = [=, topLabels = std::move(*topLabels)](
                       const std::shared_ptr<SwitchState>& state) {
     auto newState = state->clone();
@@ -1915,6 +2180,12 @@ void ThriftHandler::syncMplsFib(
     std::unique_ptr<std::vector<MplsRoute>> mplsRoutes) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
+  if (auto recorder = sw_->getUpdateStreamRecorder()) {
+    recorder->recordMplsRouteUpdate(
+        ClientID(clientId),
+        update_stream::RouteUpdateType::SYNC_FIB,
+        *mplsRoutes);
+  }
   auto updateFn = [=, routes = std::move(*mplsRoutes)](
                       const std::shared_ptr<SwitchState>& state) {
     auto newState = state->clone();
@@ -214,6 +214,14 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void stopPktCapture(std::unique_ptr<std::string> name) override;
   void stopAllPktCaptures() override;
 
+  void startBufferWatermarkSampling(
+      std::unique_ptr<BufferWatermarkSamplingInfo> info) override;
+  void stopBufferWatermarkSampling() override;
+  void getBufferWatermarkHistograms(
+      std::vector<QueueWatermarkHistogram>& histograms) override;
+  apache::thrift::ServerStream<BufferWatermarkSamples>
+  subscribeToBufferWatermarkSamples() override;
+
   void startLoggingRouteUpdates(
       std::unique_ptr<RouteUpdateLoggingInfo> info) override;
   void stopLoggingRouteUpdates(
@@ -296,6 +304,8 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getCurrentStateJSON(std::string& ret, std::unique_ptr<std::string>)
       override;
 
+  void getStateUpdateTrace(std::string& ret) override;
+
   /**
    * Patch live running switch state at path pointed by jsonPointer using the
    * JSON merge patch supplied in jsonPatch
@@ -0,0 +1,205 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/UpdateStreamRecorder.h"
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FbossError.h"
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/lang/Bits.h>
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <fcntl.h>
+
+namespace facebook::fboss {
+
+UpdateStreamRecorder::UpdateStreamRecorder(
+    const std::string& fileName,
+    size_t maxPendingBytes)
+    : start_(std::chrono::steady_clock::now()),
+      maxPendingBytes_(maxPendingBytes),
+      file_(fileName, O_WRONLY | O_CREAT | O_TRUNC) {
+  writerThread_ = std::thread([this]() {
+    folly::setThreadName("UpdateStreamRecorder");
+    writerLoop();
+  });
+  XLOG(INFO) << "Recording update stream to " << fileName;
+}
+
+UpdateStreamRecorder::~UpdateStreamRecorder() {
+  {
+    std::lock_guard<std::mutex> guard(lock_);
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  writerThread_.join();
+  if (numDropped_) {
+    XLOG(WARN) << "Dropped " << numDropped_
+               << " update stream records the writer couldn't keep up with";
+  }
+}
+
+void UpdateStreamRecorder::recordRouteUpdate(
+    RouterID vrf,
+    ClientID clientId,
+    update_stream::RouteUpdateType type,
+    const std::vector<UnicastRoute>& toAdd,
+    const std::vector<IpPrefix>& toDelete) {
+  update_stream::RouteUpdate update;
+  *update.vrf_ref() = vrf;
+  *update.clientId_ref() = static_cast<int16_t>(clientId);
+  *update.type_ref() = type;
+  *update.toAdd_ref() = toAdd;
+  *update.toDelete_ref() = toDelete;
+  update_stream::UpdateStreamEvent event;
+  event.set_routeUpdate(std::move(update));
+  record(std::move(event));
+}
+
+void UpdateStreamRecorder::recordMplsRouteUpdate(
+    ClientID clientId,
+    update_stream::RouteUpdateType type,
+    const std::vector<MplsRoute>& toAdd,
+    const std::vector<int32_t>& toDelete) {
+  update_stream::MplsRouteUpdate update;
+  *update.clientId_ref() = static_cast<int16_t>(clientId);
+  *update.type_ref() = type;
+  *update.toAdd_ref() = toAdd;
+  *update.toDelete_ref() = toDelete;
+  update_stream::UpdateStreamEvent event;
+  event.set_mplsRouteUpdate(std::move(update));
+  record(std::move(event));
+}
+
+void UpdateStreamRecorder::recordConfigApplied(
+    const cfg::SwitchConfig& config) {
+  update_stream::ConfigApplied configApplied;
+  *configApplied.config_ref() = config;
+  update_stream::UpdateStreamEvent event;
+  event.set_configApplied(std::move(configApplied));
+  record(std::move(event));
+}
+
+void UpdateStreamRecorder::recordLinkStateChanged(PortID port, bool up) {
+  update_stream::LinkStateChanged linkStateChanged;
+  *linkStateChanged.port_ref() = port;
+  *linkStateChanged.up_ref() = up;
+  update_stream::UpdateStreamEvent event;
+  event.set_linkStateChanged(std::move(linkStateChanged));
+  record(std::move(event));
+}
+
+void UpdateStreamRecorder::recordNeighborLearnt(
+    VlanID vlan,
+    const folly::IPAddress& ip,
+    folly::MacAddress mac,
+    PortDescriptor port,
+    int32_t type,
+    int32_t flags) {
+  update_stream::NeighborLearnt neighbor;
+  *neighbor.vlan_ref() = vlan;
+  *neighbor.ip_ref() = network::toBinaryAddress(ip);
+  *neighbor.mac_ref() = mac.toString();
+  *neighbor.isAggregatePort_ref() = port.isAggregatePort();
+  *neighbor.port_ref() = port.isAggregatePort()
+      ? static_cast<int32_t>(port.aggPortID())
+      : static_cast<int32_t>(port.phyPortID());
+  *neighbor.type_ref() = type;
+  *neighbor.flags_ref() = flags;
+  update_stream::UpdateStreamEvent event;
+  event.set_neighborLearnt(std::move(neighbor));
+  record(std::move(event));
+}
+
+void UpdateStreamRecorder::record(update_stream::UpdateStreamEvent event) {
+  update_stream::UpdateStreamRecord record;
+  *record.event_ref() = std::move(event);
+  std::unique_lock<std::mutex> guard(lock_);
+  // Take the timestamp under the lock, so they never go backwards in the file
+  *record.timestampUsecs_ref() =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count();
+  auto serialized =
+      apache::thrift::CompactSerializer::serialize<std::string>(record);
+  if (pending_.size() + serialized.size() > maxPendingBytes_) {
+    ++numDropped_;
+    XLOG_EVERY_MS(WARN, 10000)
+        << "Update stream writer falling behind, dropped " << numDropped_
+        << " records so far";
+    return;
+  }
+  auto length = folly::Endian::big(static_cast<uint32_t>(serialized.size()));
+  pending_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+  pending_.append(serialized);
+  bytesQueued_ += sizeof(length) + serialized.size();
+  guard.unlock();
+  cv_.notify_all();
+}
+
+void UpdateStreamRecorder::writerLoop() {
+  std::string writing;
+  std::unique_lock<std::mutex> guard(lock_);
+  while (true) {
+    cv_.wait(guard, [this]() { return stopping_ || !pending_.empty(); });
+    if (pending_.empty()) {
+      // Stopping with everything written
+      return;
+    }
+    writing.clear();
+    writing.swap(pending_);
+    guard.unlock();
+    if (folly::writeFull(file_.fd(), writing.data(), writing.size()) < 0) {
+      XLOG(ERR) << "Failed to record update stream events: "
+                << folly::errnoStr(errno);
+    }
+    guard.lock();
+    bytesWritten_ += writing.size();
+    cv_.notify_all();
+  }
+}
+
+void UpdateStreamRecorder::flush() {
+  std::unique_lock<std::mutex> guard(lock_);
+  auto target = bytesQueued_;
+  cv_.wait(guard, [this, target]() { return bytesWritten_ >= target; });
+}
+
+// static
+std::vector<update_stream::UpdateStreamRecord>
+UpdateStreamRecorder::readRecords(const std::string& fileName) {
+  std::string contents;
+  if (!folly::readFile(fileName.c_str(), contents)) {
+    throw FbossError("Unable to read update stream from ", fileName);
+  }
+  std::vector<update_stream::UpdateStreamRecord> records;
+  size_t offset = 0;
+  uint32_t length;
+  while (offset + sizeof(length) <= contents.size()) {
+    memcpy(&length, contents.data() + offset, sizeof(length));
+    length = folly::Endian::big(length);
+    offset += sizeof(length);
+    if (offset + length > contents.size()) {
+      XLOG(WARN) << "Ignoring truncated record at the end of " << fileName;
+      break;
+    }
+    records.push_back(apache::thrift::CompactSerializer::deserialize<
+                      update_stream::UpdateStreamRecord>(
+        folly::StringPiece(contents.data() + offset, length)));
+    offset += length;
+  }
+  return records;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/gen-cpp2/update_stream_types.h"
+#include "fboss/agent/state/PortDescriptor.h"
+#include "fboss/agent/types.h"
+
+#include <folly/File.h>
+#include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Records the external inputs the agent receives (unicast and MPLS route
+ * updates, config applications, link state changes and neighbor learns)
+ * along with when they were received, so UpdateStreamReplayer can replay
+ * them later with the same timing.
+ *
+ * The file is a sequence of update_stream::UpdateStreamRecord, each
+ * serialized with the thrift compact protocol and preceded by its length
+ * as a big endian uint32.
+ *
+ * Inputs are recorded from the RX, thrift and link state threads, so records
+ * are only buffered there, and written to the file by a thread of its own.
+ * Records arriving while more than maxPendingBytes are waiting to be written
+ * are dropped rather than blocking those threads.
+ */
+class UpdateStreamRecorder {
+ public:
+  static constexpr size_t kDefaultMaxPendingBytes = 64 * 1024 * 1024;
+
+  explicit UpdateStreamRecorder(
+      const std::string& fileName,
+      size_t maxPendingBytes = kDefaultMaxPendingBytes);
+  // Writes out all the records still pending
+  ~UpdateStreamRecorder();
+
+  void recordRouteUpdate(
+      RouterID vrf,
+      ClientID clientId,
+      update_stream::RouteUpdateType type,
+      const std::vector<UnicastRoute>& toAdd,
+      const std::vector<IpPrefix>& toDelete = {});
+  void recordMplsRouteUpdate(
+      ClientID clientId,
+      update_stream::RouteUpdateType type,
+      const std::vector<MplsRoute>& toAdd,
+      const std::vector<int32_t>& toDelete = {});
+  void recordConfigApplied(const cfg::SwitchConfig& config);
+  void recordLinkStateChanged(PortID port, bool up);
+  void recordNeighborLearnt(
+      VlanID vlan,
+      const folly::IPAddress& ip,
+      folly::MacAddress mac,
+      PortDescriptor port,
+      int32_t type,
+      int32_t flags);
+
+  // Wait for the records so far to be written to the file
+  void flush();
+
+  uint64_t getNumDropped() const {
+    return numDropped_;
+  }
+
+  /*
+   * Reads back all records of a recording. A truncated last record, as left
+   * behind by an agent that crashed while recording, is ignored.
+   */
+  static std::vector<update_stream::UpdateStreamRecord> readRecords(
+      const std::string& fileName);
+
+ private:
+  void record(update_stream::UpdateStreamEvent event);
+  void writerLoop();
+
+  // Forbidden copy constructor and assignment operator
+  UpdateStreamRecorder(UpdateStreamRecorder const&) = delete;
+  UpdateStreamRecorder& operator=(UpdateStreamRecorder const&) = delete;
+
+  const std::chrono::steady_clock::time_point start_;
+  const size_t maxPendingBytes_;
+  folly::File file_;
+
+  // Protects everything below
+  std::mutex lock_;
+  std::condition_variable cv_;
+  std::string pending_;
+  // Number of bytes handed to the writer, and written by it
+  uint64_t bytesQueued_{0};
+  uint64_t bytesWritten_{0};
+  bool stopping_{false};
+  std::atomic<uint64_t> numDropped_{0};
+  std::thread writerThread_;
+};
+
+} // namespace facebook::fboss
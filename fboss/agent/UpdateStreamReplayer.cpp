@@ -0,0 +1,349 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/UpdateStreamReplayer.h"
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborUpdater.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
+#include "fboss/agent/ThriftHandler.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/ForwardingInformationBaseContainer.h"
+#include "fboss/agent/state/ForwardingInformationBaseMap.h"
+#include "fboss/agent/state/LabelForwardingInformationBase.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <folly/Conv.h>
+#include <folly/Format.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <thread>
+
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace {
+
+using facebook::fboss::UpdateStreamReplayer;
+using facebook::fboss::update_stream::UpdateStreamEvent;
+
+std::string getEventName(const UpdateStreamEvent& event) {
+  switch (event.getType()) {
+    case UpdateStreamEvent::Type::routeUpdate:
+      return "routeUpdate";
+    case UpdateStreamEvent::Type::configApplied:
+      return "configApplied";
+    case UpdateStreamEvent::Type::linkStateChanged:
+      return "linkStateChanged";
+    case UpdateStreamEvent::Type::neighborLearnt:
+      return "neighborLearnt";
+    case UpdateStreamEvent::Type::mplsRouteUpdate:
+      return "mplsRouteUpdate";
+    case UpdateStreamEvent::Type::__EMPTY__:
+      break;
+  }
+  return "empty";
+}
+
+UpdateStreamReplayer::LatencyStats getLatencyStats(
+    std::vector<microseconds> latencies) {
+  UpdateStreamReplayer::LatencyStats stats;
+  if (latencies.empty()) {
+    return stats;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+  };
+  stats.count = latencies.size();
+  stats.p50 = percentile(0.5);
+  stats.p99 = percentile(0.99);
+  stats.max = latencies.back();
+  return stats;
+}
+
+template <typename NeighborTableT>
+folly::dynamic getNeighbors(const NeighborTableT& table) {
+  folly::dynamic neighbors = folly::dynamic::object;
+  for (const auto& entry : table) {
+    if (!entry->isPending()) {
+      neighbors[entry->getIP().str()] = folly::to<std::string>(
+          entry->getMac().toString(), "@", entry->getPort().str());
+    }
+  }
+  return neighbors;
+}
+
+template <typename FibT>
+void getRoutes(const FibT& fib, folly::dynamic* routes) {
+  for (const auto& route : fib) {
+    (*routes)[route->prefix().str()] = route->isResolved()
+        ? route->getForwardInfo().str()
+        : std::string("unresolved");
+  }
+}
+
+void diff(
+    const std::string& path,
+    const folly::dynamic& expected,
+    const folly::dynamic& actual,
+    std::vector<std::string>* differences) {
+  if (expected.isObject() && actual.isObject()) {
+    for (const auto& [key, value] : expected.items()) {
+      auto childPath = folly::to<std::string>(path, "/", key.asString());
+      auto it = actual.find(key);
+      if (it == actual.items().end()) {
+        differences->push_back(childPath + ": missing");
+      } else {
+        diff(childPath, value, it->second, differences);
+      }
+    }
+    for (const auto& [key, value] : actual.items()) {
+      if (expected.find(key) == expected.items().end()) {
+        differences->push_back(folly::to<std::string>(
+            path, "/", key.asString(), ": unexpected ", folly::toJson(value)));
+      }
+    }
+  } else if (expected != actual) {
+    differences->push_back(folly::to<std::string>(
+        path,
+        ": expected ",
+        folly::toJson(expected),
+        ", got ",
+        folly::toJson(actual)));
+  }
+}
+
+} // namespace
+
+namespace facebook::fboss {
+
+UpdateStreamReplayer::UpdateStreamReplayer(SwSwitch* sw, double speedup)
+    : sw_(sw), speedup_(speedup) {
+  if (speedup_ < 0) {
+    throw FbossError("Invalid update stream replay speedup: ", speedup_);
+  }
+}
+
+UpdateStreamReplayer::~UpdateStreamReplayer() {}
+
+UpdateStreamReplayer::Result UpdateStreamReplayer::replay(
+    const std::vector<update_stream::UpdateStreamRecord>& records) {
+  Result result;
+  std::map<std::string, std::vector<microseconds>> latencies;
+  auto start = steady_clock::now();
+  for (const auto& record : records) {
+    if (speedup_ > 0) {
+      auto due = start +
+          std::chrono::duration_cast<steady_clock::duration>(
+                     microseconds(*record.timestampUsecs_ref()) / speedup_);
+      auto now = steady_clock::now();
+      if (now < due) {
+        std::this_thread::sleep_until(due);
+      } else {
+        result.maxScheduleLag = std::max(
+            result.maxScheduleLag,
+            std::chrono::duration_cast<microseconds>(now - due));
+      }
+    }
+    const auto& event = *record.event_ref();
+    auto eventStart = steady_clock::now();
+    try {
+      applyEvent(event);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to replay " << getEventName(event) << ": "
+                << ex.what();
+      ++result.errors;
+      continue;
+    }
+    latencies[getEventName(event)].push_back(
+        std::chrono::duration_cast<microseconds>(
+            steady_clock::now() - eventStart));
+  }
+  waitForStateUpdates();
+  result.duration =
+      std::chrono::duration_cast<microseconds>(steady_clock::now() - start);
+  for (auto& [type, typeLatencies] : latencies) {
+    result.latencies[type] = getLatencyStats(std::move(typeLatencies));
+  }
+  return result;
+}
+
+void UpdateStreamReplayer::applyEvent(
+    const update_stream::UpdateStreamEvent& event) {
+  switch (event.getType()) {
+    case update_stream::UpdateStreamEvent::Type::routeUpdate: {
+      const auto& update = event.get_routeUpdate();
+      auto vrf = RouterID(*update.vrf_ref());
+      auto clientId = ClientID(*update.clientId_ref());
+      auto updater = sw_->getRouteUpdater();
+      for (const auto& route : *update.toAdd_ref()) {
+        updater.addRoute(vrf, clientId, route);
+      }
+      for (const auto& prefix : *update.toDelete_ref()) {
+        updater.delRoute(vrf, prefix, clientId);
+      }
+      RouteUpdateWrapper::SyncFibFor syncFibs;
+      if (*update.type_ref() == update_stream::RouteUpdateType::SYNC_FIB) {
+        syncFibs.insert({vrf, clientId});
+      }
+      updater.program(syncFibs);
+      break;
+    }
+    case update_stream::UpdateStreamEvent::Type::mplsRouteUpdate: {
+      const auto& update = event.get_mplsRouteUpdate();
+      if (!thriftHandler_) {
+        thriftHandler_ = std::make_unique<ThriftHandler>(sw_);
+      }
+      auto clientId = *update.clientId_ref();
+      switch (*update.type_ref()) {
+        case update_stream::RouteUpdateType::ADD:
+          thriftHandler_->addMplsRoutes(
+              clientId,
+              std::make_unique<std::vector<MplsRoute>>(*update.toAdd_ref()));
+          break;
+        case update_stream::RouteUpdateType::DELETE:
+          thriftHandler_->deleteMplsRoutes(
+              clientId,
+              std::make_unique<std::vector<int32_t>>(*update.toDelete_ref()));
+          break;
+        case update_stream::RouteUpdateType::SYNC_FIB:
+          thriftHandler_->syncMplsFib(
+              clientId,
+              std::make_unique<std::vector<MplsRoute>>(*update.toAdd_ref()));
+          break;
+      }
+      break;
+    }
+    case update_stream::UpdateStreamEvent::Type::configApplied:
+      sw_->applyConfig(
+          "update stream replay", *event.get_configApplied().config_ref());
+      break;
+    case update_stream::UpdateStreamEvent::Type::linkStateChanged: {
+      const auto& linkState = event.get_linkStateChanged();
+      sw_->linkStateChanged(PortID(*linkState.port_ref()), *linkState.up_ref());
+      waitForStateUpdates();
+      break;
+    }
+    case update_stream::UpdateStreamEvent::Type::neighborLearnt: {
+      const auto& neighbor = event.get_neighborLearnt();
+      auto vlan = VlanID(*neighbor.vlan_ref());
+      auto ip = network::toIPAddress(*neighbor.ip_ref());
+      auto mac = folly::MacAddress(*neighbor.mac_ref());
+      auto port = *neighbor.isAggregatePort_ref()
+          ? PortDescriptor(AggregatePortID(*neighbor.port_ref()))
+          : PortDescriptor(PortID(*neighbor.port_ref()));
+      if (ip.isV4()) {
+        sw_->getNeighborUpdater()
+            ->receivedArpMine(
+                vlan, ip.asV4(), mac, port, ArpOpCode(*neighbor.type_ref()))
+            .get();
+      } else {
+        sw_->getNeighborUpdater()
+            ->receivedNdpMine(
+                vlan,
+                ip.asV6(),
+                mac,
+                port,
+                ICMPv6Type(*neighbor.type_ref()),
+                static_cast<uint32_t>(*neighbor.flags_ref()))
+            .get();
+      }
+      waitForStateUpdates();
+      break;
+    }
+    case update_stream::UpdateStreamEvent::Type::__EMPTY__:
+      throw FbossError("Empty update stream event");
+  }
+}
+
+void UpdateStreamReplayer::waitForStateUpdates() {
+  // Updates are applied in the order they were scheduled, so once a no-op
+  // update scheduled after them is done, all of them are.
+  sw_->getNeighborUpdater()->waitForPendingUpdates();
+  sw_->updateStateBlocking(
+      "update stream replay",
+      [](const std::shared_ptr<SwitchState>& /* state */)
+          -> std::shared_ptr<SwitchState> { return nullptr; });
+}
+
+// static
+std::string UpdateStreamReplayer::formatResult(const Result& result) {
+  std::string formatted = folly::sformat(
+      "Replayed in {} ms, max schedule lag {} ms, {} errors\n",
+      result.duration.count() / 1000.0,
+      result.maxScheduleLag.count() / 1000.0,
+      result.errors);
+  for (const auto& [type, stats] : result.latencies) {
+    formatted += folly::sformat(
+        "{:<20} count {:>8}  p50 {:>10} us  p99 {:>10} us  max {:>10} us\n",
+        type,
+        stats.count,
+        stats.p50.count(),
+        stats.p99.count(),
+        stats.max.count());
+  }
+  return formatted;
+}
+
+// static
+folly::dynamic UpdateStreamReplayer::getReplayedState(
+    const SwitchState& state) {
+  folly::dynamic fibs = folly::dynamic::object;
+  for (const auto& fibContainer : *state.getFibs()) {
+    folly::dynamic routes = folly::dynamic::object;
+    getRoutes(*fibContainer->getFibV4(), &routes);
+    getRoutes(*fibContainer->getFibV6(), &routes);
+    fibs[folly::to<std::string>(fibContainer->getID())] = std::move(routes);
+  }
+  folly::dynamic labels = folly::dynamic::object;
+  for (const auto& entry : *state.getLabelForwardingInformationBase()) {
+    labels[folly::to<std::string>(entry->getID())] =
+        entry->getLabelNextHop().str();
+  }
+  folly::dynamic arp = folly::dynamic::object;
+  folly::dynamic ndp = folly::dynamic::object;
+  for (const auto& vlan : *state.getVlans()) {
+    auto vlanId = folly::to<std::string>(vlan->getID());
+    arp[vlanId] = getNeighbors(*vlan->getArpTable());
+    ndp[vlanId] = getNeighbors(*vlan->getNdpTable());
+  }
+  folly::dynamic ports = folly::dynamic::object;
+  for (const auto& port : *state.getPorts()) {
+    ports[folly::to<std::string>(port->getID())] = port->isUp();
+  }
+  return folly::dynamic::object("fibs", std::move(fibs))(
+      "labels", std::move(labels))("arp", std::move(arp))(
+      "ndp", std::move(ndp))("ports", std::move(ports));
+}
+
+// static
+std::vector<std::string> UpdateStreamReplayer::diffReplayedStates(
+    const folly::dynamic& expected,
+    const folly::dynamic& actual) {
+  std::vector<std::string> differences;
+  diff("", expected, actual, &differences);
+  // Object keys are unordered, sort to make the differences easy to scan
+  std::sort(differences.begin(), differences.end());
+  return differences;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/gen-cpp2/update_stream_types.h"
+
+#include <folly/dynamic.h>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class SwitchState;
+class ThriftHandler;
+
+/*
+ * Replays a stream recorded by UpdateStreamRecorder against a SwSwitch, e.g.
+ * one running on SimSwitch or the fake SAI, to measure how long each update
+ * takes to be applied under a realistic mix of updates.
+ *
+ * Events are replayed one at a time from the calling thread. Route updates
+ * and config applications block until programmed, as the thrift calls they
+ * were recorded from do. Link state changes and neighbor learns are only
+ * queued by the agent, so the replayer waits for their state update to be
+ * applied, making their latency cover the time spent queued as well.
+ */
+class UpdateStreamReplayer {
+ public:
+  struct LatencyStats {
+    uint64_t count{0};
+    std::chrono::microseconds p50{0};
+    std::chrono::microseconds p99{0};
+    std::chrono::microseconds max{0};
+  };
+
+  struct Result {
+    // Keyed by event type, e.g. "routeUpdate"
+    std::map<std::string, LatencyStats> latencies;
+    // Events which threw while being applied
+    uint64_t errors{0};
+    // How far behind its recorded time the most delayed event was replayed,
+    // because the ones before it took longer than in the recording
+    std::chrono::microseconds maxScheduleLag{0};
+    std::chrono::microseconds duration{0};
+  };
+
+  /*
+   * speedup scales the recorded time between events, e.g. 2 replays the
+   * stream twice as fast as it was recorded. 0 replays each event as soon
+   * as the previous one is done.
+   */
+  UpdateStreamReplayer(SwSwitch* sw, double speedup);
+  ~UpdateStreamReplayer();
+
+  Result replay(const std::vector<update_stream::UpdateStreamRecord>& records);
+
+  static std::string formatResult(const Result& result);
+
+  /*
+   * The parts of a state the update stream drives: FIB and label FIB
+   * entries, resolved neighbors and port oper state, as a json friendly object.
+   */
+  static folly::dynamic getReplayedState(const SwitchState& state);
+
+  /*
+   * Differences between two states returned by getReplayedState, one line
+   * each. Empty if they are equivalent.
+   */
+  static std::vector<std::string> diffReplayedStates(
+      const folly::dynamic& expected,
+      const folly::dynamic& actual);
+
+ private:
+  void applyEvent(const update_stream::UpdateStreamEvent& event);
+  void waitForStateUpdates();
+
+  // Forbidden copy constructor and assignment operator
+  UpdateStreamReplayer(UpdateStreamReplayer const&) = delete;
+  UpdateStreamReplayer& operator=(UpdateStreamReplayer const&) = delete;
+
+  SwSwitch* sw_;
+  const double speedup_;
+  // MPLS routes are replayed through the thrift handler, as there is no
+  // route updater for them. Created on the first MPLS route update.
+  std::unique_ptr<ThriftHandler> thriftHandler_;
+};
+
+} // namespace facebook::fboss
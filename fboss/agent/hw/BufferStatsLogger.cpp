@@ -10,6 +10,7 @@
 
 #include "fboss/agent/hw/BufferStatsLogger.h"
 
+#include <folly/Conv.h>
 #include <folly/logging/xlog.h>
 #include <glog/logging.h>
 
@@ -38,4 +39,25 @@ void GlogBufferStatsLogger::logPortBufferStat(
              << " XPEs: " << xpeStr(xpes);
 }
 
+void GlogBufferStatsLogger::logQueueWatermarkHistogram(
+    const std::string& portName,
+    unsigned int cosQ,
+    const std::vector<uint64_t>& bucketUpperBytes,
+    const std::vector<uint64_t>& bucketCounts,
+    uint64_t maxBytes) {
+  std::vector<std::string> buckets;
+  for (size_t i = 0; i < bucketCounts.size(); ++i) {
+    if (!bucketCounts[i]) {
+      continue;
+    }
+    auto upper = i < bucketUpperBytes.size()
+        ? folly::to<std::string>("<=", bucketUpperBytes[i])
+        : std::string("inf");
+    buckets.push_back(folly::to<std::string>(upper, ":", bucketCounts[i]));
+  }
+  XLOG(INFO) << " Port : " << portName << " cosQ: " << cosQ
+             << " sampled watermarks max bytes : " << maxBytes
+             << " histogram: " << folly::join(",", buckets);
+}
+
 } // namespace facebook::fboss
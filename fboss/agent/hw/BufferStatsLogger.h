@@ -29,6 +29,13 @@ class BufferStatsLogger {
       uint64_t bytesUsed,
       uint64_t pktsDropped,
       const XPEs& xpes) = 0;
+  // Histogram of a queue's watermarks, sampled by BufferWatermarkSampler
+  virtual void logQueueWatermarkHistogram(
+      const std::string& /*portName*/,
+      unsigned int /*cosQ*/,
+      const std::vector<uint64_t>& /*bucketUpperBytes*/,
+      const std::vector<uint64_t>& /*bucketCounts*/,
+      uint64_t /*maxBytes*/) {}
   static std::string dirStr(Direction dir) {
     switch (dir) {
       case Direction::Ingress:
@@ -53,6 +60,12 @@ class GlogBufferStatsLogger : public BufferStatsLogger {
       uint64_t bytesUsed,
       uint64_t pktsDropped,
       const XPEs& xpes) override;
+  void logQueueWatermarkHistogram(
+      const std::string& portName,
+      unsigned int cosQ,
+      const std::vector<uint64_t>& bucketUpperBytes,
+      const std::vector<uint64_t>& bucketCounts,
+      uint64_t maxBytes) override;
 };
 
 } // namespace facebook::fboss
@@ -0,0 +1,271 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace facebook::fboss {
+
+namespace {
+
+size_t getHistogramBucket(uint64_t bytes) {
+  size_t bucket = 0;
+  while (bucket < BufferWatermarkSampler::kNumHistogramBuckets - 1 &&
+         bytes > BufferWatermarkSampler::getHistogramBucketUpperBytes(bucket)) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+void updatePeak(std::atomic<uint64_t>& peak, uint64_t bytes) {
+  auto cur = peak.load();
+  while (bytes > cur && !peak.compare_exchange_weak(cur, bytes)) {
+  }
+}
+
+} // namespace
+
+WatermarkRing::WatermarkRing(size_t capacity) : slots_(capacity) {
+  CHECK(capacity && !(capacity & (capacity - 1)))
+      << "Ring capacity must be a power of 2, got " << capacity;
+}
+
+void WatermarkRing::push(uint64_t bytes) {
+  auto head = head_.load(std::memory_order_relaxed);
+  // Readers who see the new value in the slot must see writeBegin_ moved
+  // past the sample it overwrites
+  writeBegin_.store(head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slots_[head & (slots_.size() - 1)].store(bytes, std::memory_order_relaxed);
+  head_.store(head + 1, std::memory_order_release);
+}
+
+std::vector<uint64_t> WatermarkRing::snapshot() const {
+  auto head = head_.load(std::memory_order_acquire);
+  auto first = head > slots_.size() ? head - slots_.size() : 0;
+  std::vector<uint64_t> values;
+  values.reserve(head - first);
+  for (auto i = first; i < head; ++i) {
+    values.push_back(slots_[i & (slots_.size() - 1)].load(
+        std::memory_order_relaxed));
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // Sample i got overwritten once the writer started on i + capacity
+  auto writeBegin = writeBegin_.load(std::memory_order_relaxed);
+  if (writeBegin > first + slots_.size()) {
+    auto overwritten = std::min<uint64_t>(
+        writeBegin - slots_.size() - first, values.size());
+    values.erase(values.begin(), values.begin() + overwritten);
+  }
+  return values;
+}
+
+BufferWatermarkSampler::Selection::Selection(
+    std::vector<QueueKey> sampledQueues,
+    size_t ringSize)
+    : queues(std::move(sampledQueues)), peaks(queues.size()) {
+  rings.reserve(queues.size());
+  for (size_t i = 0; i < queues.size(); ++i) {
+    rings.push_back(std::make_unique<WatermarkRing>(ringSize));
+  }
+}
+
+// static
+uint64_t BufferWatermarkSampler::getHistogramBucketUpperBytes(size_t bucket) {
+  if (bucket == 0) {
+    return 0;
+  }
+  if (bucket >= kNumHistogramBuckets - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  return 1024ULL << (bucket - 1);
+}
+
+BufferWatermarkSampler::BufferWatermarkSampler(
+    std::unique_ptr<Reader> reader,
+    size_t ringSize)
+    : reader_(std::move(reader)),
+      ringSize_(ringSize),
+      selection_(std::make_shared<Selection>(std::vector<QueueKey>{}, 1)) {}
+
+BufferWatermarkSampler::~BufferWatermarkSampler() {
+  stop();
+}
+
+void BufferWatermarkSampler::start(
+    std::vector<QueueKey> queues,
+    std::chrono::milliseconds interval) {
+  if (interval.count() <= 0) {
+    throw FbossError(
+        "Buffer watermark sampling interval must be positive, got ",
+        interval.count(),
+        "ms");
+  }
+  std::lock_guard<std::mutex> g(controlLock_);
+  stopLocked();
+  *selection_.wlock() =
+      std::make_shared<Selection>(std::move(queues), ringSize_);
+  devicePeak_ = 0;
+  running_ = true;
+  thread_ = std::thread([this, interval]() {
+    folly::setThreadName("BufferWatermarkSampler");
+    samplerLoop(interval);
+  });
+  XLOG(INFO) << "Started sampling buffer watermarks of "
+             << getSelection()->queues.size() << " queues every "
+             << interval.count() << "ms";
+}
+
+void BufferWatermarkSampler::stop() {
+  {
+    std::lock_guard<std::mutex> g(controlLock_);
+    stopLocked();
+  }
+  std::vector<std::shared_ptr<Subscriber>> subscribers;
+  subscribers_.wlock()->swap(subscribers);
+  for (const auto& subscriber : subscribers) {
+    subscriber->samplingStopped();
+  }
+}
+
+void BufferWatermarkSampler::stopLocked() {
+  if (!running_) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> l(m_);
+    running_ = false;
+  }
+  cv_.notify_one();
+  thread_.join();
+  XLOG(INFO) << "Stopped sampling buffer watermarks";
+}
+
+void BufferWatermarkSampler::samplerLoop(std::chrono::milliseconds interval) {
+  auto next = std::chrono::steady_clock::now();
+  while (running_) {
+    try {
+      sampleOnce();
+    } catch (const std::exception& ex) {
+      XLOG_EVERY_MS(ERR, 10000)
+          << "Failed to sample buffer watermarks: " << ex.what();
+    }
+    // Keep a steady rate, but don't try to catch up on missed samples
+    next = std::max(next + interval, std::chrono::steady_clock::now());
+    std::unique_lock<std::mutex> l(m_);
+    cv_.wait_until(l, next, [this]() { return !running_; });
+  }
+}
+
+void BufferWatermarkSampler::sampleOnce() {
+  auto selection = getSelection();
+  Samples samples;
+  samples.timestampUsecs =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  {
+    std::lock_guard<std::mutex> g(readLock_);
+    if (!selection->queues.empty()) {
+      samples.queueBytes = reader_->readQueueWatermarks(selection->queues);
+    }
+    samples.deviceBytes = reader_->readDeviceWatermark();
+  }
+  CHECK_EQ(samples.queueBytes.size(), selection->queues.size());
+
+  for (size_t i = 0; i < samples.queueBytes.size(); ++i) {
+    selection->rings[i]->push(samples.queueBytes[i]);
+    updatePeak(selection->peaks[i], samples.queueBytes[i]);
+  }
+  updatePeak(devicePeak_, samples.deviceBytes);
+  ++numSamples_;
+  publish(*selection, samples);
+}
+
+void BufferWatermarkSampler::publish(
+    const Selection& selection,
+    const Samples& samples) {
+  // Subscribers are called without the lock held, and dropped once they
+  // return false
+  auto subscribers = *subscribers_.rlock();
+  std::vector<std::shared_ptr<Subscriber>> done;
+  for (const auto& subscriber : subscribers) {
+    if (!subscriber->samplesTaken(selection.queues, samples)) {
+      done.push_back(subscriber);
+    }
+  }
+  if (!done.empty()) {
+    subscribers_.withWLock([&done](auto& lockedSubscribers) {
+      for (const auto& subscriber : done) {
+        lockedSubscribers.erase(
+            std::remove(
+                lockedSubscribers.begin(), lockedSubscribers.end(), subscriber),
+            lockedSubscribers.end());
+      }
+    });
+  }
+}
+
+void BufferWatermarkSampler::subscribe(std::shared_ptr<Subscriber> subscriber) {
+  subscribers_.wlock()->push_back(std::move(subscriber));
+}
+
+void BufferWatermarkSampler::waitForReads() {
+  std::lock_guard<std::mutex> g(readLock_);
+}
+
+std::vector<BufferWatermarkSampler::QueueKey>
+BufferWatermarkSampler::getSampledQueues() const {
+  return getSelection()->queues;
+}
+
+std::vector<BufferWatermarkSampler::QueueHistogram>
+BufferWatermarkSampler::getHistograms() const {
+  auto selection = getSelection();
+  std::vector<QueueHistogram> histograms;
+  for (size_t i = 0; i < selection->queues.size(); ++i) {
+    QueueHistogram histogram;
+    histogram.queue = selection->queues[i];
+    histogram.bucketCounts.resize(kNumHistogramBuckets);
+    for (auto bytes : selection->rings[i]->snapshot()) {
+      ++histogram.bucketCounts[getHistogramBucket(bytes)];
+      histogram.maxBytes = std::max(histogram.maxBytes, bytes);
+      ++histogram.numSamples;
+    }
+    histograms.push_back(std::move(histogram));
+  }
+  return histograms;
+}
+
+uint64_t BufferWatermarkSampler::collectPeakBytes(PortID port, int queue) {
+  auto selection = getSelection();
+  auto it = std::find(
+      selection->queues.begin(),
+      selection->queues.end(),
+      QueueKey(port, queue));
+  if (it == selection->queues.end()) {
+    return 0;
+  }
+  return selection->peaks[it - selection->queues.begin()].exchange(0);
+}
+
+uint64_t BufferWatermarkSampler::collectDevicePeakBytes() {
+  return devicePeak_.exchange(0);
+}
+
+} // namespace facebook::fboss
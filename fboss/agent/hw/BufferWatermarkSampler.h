@@ -0,0 +1,206 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/Synchronized.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Ring of the most recent samples of a queue. Written by the sampler thread
+ * only, read from any thread without locking: readers drop the samples the
+ * writer overwrote while they were copying them.
+ */
+class WatermarkRing {
+ public:
+  // capacity must be a power of 2
+  explicit WatermarkRing(size_t capacity);
+
+  void push(uint64_t bytes);
+  // Oldest first
+  std::vector<uint64_t> snapshot() const;
+
+  size_t capacity() const {
+    return slots_.size();
+  }
+
+ private:
+  std::vector<std::atomic<uint64_t>> slots_;
+  // Number of samples the writer started writing, and finished writing
+  std::atomic<uint64_t> writeBegin_{0};
+  std::atomic<uint64_t> head_{0};
+};
+
+/*
+ * Samples buffer watermarks of a selected set of queues on its own thread,
+ * at intervals well below the regular stats cycle, so microbursts that fill
+ * and drain a queue between two stats collections still show up.
+ *
+ * Watermarks are cleared on read, so the peaks the sampler reads are folded
+ * back into the regular watermark stats with collectPeakBytes().
+ */
+class BufferWatermarkSampler {
+ public:
+  using QueueKey = std::pair<PortID, int>;
+
+  /*
+   * Reads watermarks from the hardware. Only called from the sampler thread,
+   * and must not hold the switch lock for more than short lookups. Readers
+   * which look queues up without the switch lock rely on waitForReads() to
+   * never read a queue after it is removed.
+   */
+  class Reader {
+   public:
+    virtual ~Reader() {}
+    // Peak bytes of each queue since the previous read, which clears them
+    virtual std::vector<uint64_t> readQueueWatermarks(
+        const std::vector<QueueKey>& queues) = 0;
+    // Peak bytes used in the whole MMU since the previous read
+    virtual uint64_t readDeviceWatermark() = 0;
+  };
+
+  struct Samples {
+    int64_t timestampUsecs{0};
+    uint64_t deviceBytes{0};
+    // In the order of the sampled queues
+    std::vector<uint64_t> queueBytes;
+  };
+
+  /*
+   * Gets every sample taken, on the sampler thread, so must not block.
+   */
+  class Subscriber {
+   public:
+    virtual ~Subscriber() {}
+    // Returns false to unsubscribe
+    virtual bool samplesTaken(
+        const std::vector<QueueKey>& queues,
+        const Samples& samples) = 0;
+    // Sampling was stopped, the subscriber is dropped right after
+    virtual void samplingStopped() {}
+  };
+
+  // Samples are counted in the bucket with the lowest upper bound they fit
+  // in: 0, then 1KB doubling up to 32MB, then one bucket for anything larger
+  static constexpr size_t kNumHistogramBuckets = 18;
+  static uint64_t getHistogramBucketUpperBytes(size_t bucket);
+
+  struct QueueHistogram {
+    QueueKey queue;
+    std::vector<uint64_t> bucketCounts;
+    uint64_t maxBytes{0};
+    uint64_t numSamples{0};
+  };
+
+  static constexpr size_t kDefaultRingSize = 1024;
+
+  explicit BufferWatermarkSampler(
+      std::unique_ptr<Reader> reader,
+      size_t ringSize = kDefaultRingSize);
+  ~BufferWatermarkSampler();
+
+  /*
+   * (Re)start sampling queues every interval. Histograms and peaks of the
+   * previously sampled queues are dropped, subscribers are kept.
+   */
+  void start(std::vector<QueueKey> queues, std::chrono::milliseconds interval);
+  // Stops sampling, and tells subscribers there will be no more samples
+  void stop();
+  bool isRunning() const {
+    return running_;
+  }
+
+  std::vector<QueueKey> getSampledQueues() const;
+  // Over the samples still in the rings, i.e. ringSize * interval
+  std::vector<QueueHistogram> getHistograms() const;
+
+  /*
+   * Peak the sampler saw on a queue since the last call, 0 if the queue
+   * isn't sampled. Called by the regular stats collection, so peaks the
+   * sampler cleared aren't lost.
+   */
+  uint64_t collectPeakBytes(PortID port, int queue);
+  uint64_t collectDevicePeakBytes();
+
+  void subscribe(std::shared_ptr<Subscriber> subscriber);
+
+  /*
+   * Returns once any read of the hardware in progress when called is done.
+   * A read may have looked up a queue just before the queue was removed
+   * from the reader's lookup table, so removing a queue must first remove
+   * it from that table, then wait for reads, and only then remove it from
+   * the hardware.
+   */
+  void waitForReads();
+
+  /*
+   * Take a sample of the selected queues on the calling thread. Used by
+   * the sampler thread, and by tests with no thread running.
+   */
+  void sampleOnce();
+
+  uint64_t getNumSamples() const {
+    return numSamples_;
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  BufferWatermarkSampler(BufferWatermarkSampler const&) = delete;
+  BufferWatermarkSampler& operator=(BufferWatermarkSampler const&) = delete;
+
+  /*
+   * Queues being sampled along with their samples. Replaced as a whole when
+   * the selection changes, so the sampler thread and readers only lock to
+   * copy the pointer.
+   */
+  struct Selection {
+    Selection(std::vector<QueueKey> queues, size_t ringSize);
+
+    std::vector<QueueKey> queues;
+    std::vector<std::unique_ptr<WatermarkRing>> rings;
+    std::vector<std::atomic<uint64_t>> peaks;
+  };
+
+  std::shared_ptr<Selection> getSelection() const {
+    return *selection_.rlock();
+  }
+  void stopLocked();
+  void samplerLoop(std::chrono::milliseconds interval);
+  void publish(const Selection& selection, const Samples& samples);
+
+  std::unique_ptr<Reader> reader_;
+  const size_t ringSize_;
+  folly::Synchronized<std::shared_ptr<Selection>> selection_;
+  folly::Synchronized<std::vector<std::shared_ptr<Subscriber>>> subscribers_;
+  std::atomic<uint64_t> devicePeak_{0};
+  std::atomic<uint64_t> numSamples_{0};
+  // Held while reader_ reads the hardware
+  std::mutex readLock_;
+
+  // Serializes start() and stop()
+  std::mutex controlLock_;
+  std::thread thread_;
+  std::atomic_bool running_{false};
+  std::mutex m_;
+  std::condition_variable cv_;
+};
+
+} // namespace facebook::fboss
@@ -30,6 +30,16 @@ HwSwitchStats::HwSwitchStats(
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.freed",
           SUM,
           RATE),
+      txPktPoolHit_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.pkt.pool.hit",
+          SUM,
+          RATE),
+      txPktPoolMiss_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.pkt.pool.miss",
+          SUM,
+          RATE),
       txSent_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.sent",
@@ -50,12 +60,23 @@ HwSwitchStats::HwSwitchStats(
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.allocation.errors",
           SUM,
           RATE),
+      txQueueFull_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.queue.full",
+          SUM,
+          RATE),
       txQueued_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".tx.pkt.queued_us",
           100,
           0,
           1000),
+      txQueueDepth_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".tx.queue.depth",
+          64,
+          0,
+          4096),
       parityErrors_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".parity.errors",
@@ -28,6 +28,12 @@ class HwSwitchStats {
   void txPktFree() {
     txPktFree_.addValue(1);
   }
+  void txPktPoolHit() {
+    txPktPoolHit_.addValue(1);
+  }
+  void txPktPoolMiss() {
+    txPktPoolMiss_.addValue(1);
+  }
   void txSent() {
     txSent_.addValue(1);
   }
@@ -42,6 +48,13 @@ class HwSwitchStats {
     txErrors_.addValue(1);
     txPktAllocErrors_.addValue(1);
   }
+  void txQueueFull() {
+    txErrors_.addValue(1);
+    txQueueFull_.addValue(1);
+  }
+  void txQueueDepth(uint64_t depth) {
+    txQueueDepth_.addValue(depth);
+  }
 
   void corrParityError() {
     parityErrors_.addValue(1);
@@ -63,6 +76,12 @@ class HwSwitchStats {
   int64_t getTxPktFreeCount() {
     return txPktFree_.count();
   }
+  int64_t getTxPktPoolHitCount() {
+    return txPktPoolHit_.count();
+  }
+  int64_t getTxPktPoolMissCount() {
+    return txPktPoolMiss_.count();
+  }
   int64_t getTxSentCount() {
     return txSent_.count();
   }
@@ -75,6 +94,9 @@ class HwSwitchStats {
   int64_t getTxPktAllocErrorsCount() {
     return txPktAllocErrors_.count();
   }
+  int64_t getTxQueueFullCount() {
+    return txQueueFull_.count();
+  }
   int64_t getCorrParityErrorCount() {
     return corrParityErrors_.count();
   }
@@ -97,15 +119,21 @@ class HwSwitchStats {
   // Total number of Tx packet allocated right now
   TLTimeseries txPktAlloc_;
   TLTimeseries txPktFree_;
+  // Tx packets taken from, or not available in, a pre-allocated pool
+  TLTimeseries txPktPoolHit_;
+  TLTimeseries txPktPoolMiss_;
   TLTimeseries txSent_;
   TLTimeseries txSentDone_;
 
   // Errors in sending packets
   TLTimeseries txErrors_;
   TLTimeseries txPktAllocErrors_;
+  TLTimeseries txQueueFull_;
 
   // Time spent for each Tx packet queued in HW
   TLHistogram txQueued_;
+  // Packets already in the async Tx queue when a packet is queued
+  TLHistogram txQueueDepth_;
 
   // parity errors
   TLTimeseries parityErrors_;
@@ -374,6 +374,15 @@ void BcmAclEntry::createNewAclEntry() {
   bcmCheckError(rv, "failed to install field group");
 }
 
+void BcmAclEntry::updatePriority(const std::shared_ptr<AclEntry>& acl) {
+  CHECK(acl_->isSameExceptPriority(*acl));
+  // Installed entries are moved to their new priority by the SDK
+  auto rv = bcm_field_entry_prio_set(
+      hw_->getUnit(), handle_, swPriorityToHwPriority(acl->getPriority()));
+  bcmCheckError(rv, "failed to update priority of acl ", acl->getID());
+  acl_ = acl;
+}
+
 BcmAclEntry::BcmAclEntry(
     BcmSwitch* hw,
     int gid,
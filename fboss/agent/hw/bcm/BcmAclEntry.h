@@ -43,6 +43,12 @@ class BcmAclEntry {
       int gid,
       BcmAclEntryHandle handle,
       const std::shared_ptr<AclEntry>& acl);
+  /*
+   * Move the entry to acl's priority in place. acl must only differ from
+   * the programmed acl in priority.
+   */
+  void updatePriority(const std::shared_ptr<AclEntry>& acl);
+
   std::optional<std::string> getIngressAclMirror();
   std::optional<std::string> getEgressAclMirror();
 
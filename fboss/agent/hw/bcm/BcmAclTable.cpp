@@ -53,6 +53,27 @@ void BcmAclTable::processRemovedAcl(const std::shared_ptr<AclEntry>& acl) {
   }
 }
 
+void BcmAclTable::processChangedAclPriority(
+    const std::shared_ptr<AclEntry>& oldAcl,
+    const std::shared_ptr<AclEntry>& newAcl) {
+  auto itr = aclEntryMap_.find(oldAcl->getPriority());
+  if (itr == aclEntryMap_.end()) {
+    throw FbossError("Failed to find an existing bcm acl entry");
+  }
+  if (aclEntryMap_.find(newAcl->getPriority()) != aclEntryMap_.end()) {
+    throw FbossError(
+        "ACL=",
+        newAcl->getID(),
+        " priority ",
+        newAcl->getPriority(),
+        " already in use");
+  }
+  auto bcmAcl = std::move(itr->second);
+  aclEntryMap_.erase(itr);
+  bcmAcl->updatePriority(newAcl);
+  aclEntryMap_.emplace(newAcl->getPriority(), std::move(bcmAcl));
+}
+
 BcmAclEntry* FOLLY_NULLABLE BcmAclTable::getAclIf(int priority) const {
   auto iter = aclEntryMap_.find(priority);
   if (iter == aclEntryMap_.end()) {
@@ -33,6 +33,10 @@ class BcmAclTable {
   ~BcmAclTable() {}
   void processAddedAcl(const int groupId, const std::shared_ptr<AclEntry>& acl);
   void processRemovedAcl(const std::shared_ptr<AclEntry>& acl);
+  // newAcl must only differ from oldAcl in priority
+  void processChangedAclPriority(
+      const std::shared_ptr<AclEntry>& oldAcl,
+      const std::shared_ptr<AclEntry>& newAcl);
   void releaseAcls();
 
   // Throw exception if not found
@@ -18,12 +18,37 @@
 #include "fboss/agent/hw/bcm/BcmPortTable.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <algorithm>
+
 extern "C" {
 #include <bcm/field.h>
 }
 
 namespace facebook::fboss {
 
+std::vector<uint64_t> BcmBufferWatermarkReader::readQueueWatermarks(
+    const std::vector<BufferWatermarkSampler::QueueKey>& queues) {
+  auto rv = bcm_cosq_bst_stat_sync(
+      hw_->getUnit(), (bcm_bst_stat_id_t)bcmBstStatIdUcast);
+  bcmCheckError(rv, "Failed to sync bcmBstStatIdUcast stat");
+  auto cosMgr = hw_->getCosMgr();
+  std::vector<uint64_t> peakBytes;
+  peakBytes.reserve(queues.size());
+  for (const auto& [port, queue] : queues) {
+    peakBytes.push_back(
+        cosMgr->statGet(port, queue, bcmBstStatIdUcast) *
+        hw_->getMMUCellBytes());
+  }
+  return peakBytes;
+}
+
+uint64_t BcmBufferWatermarkReader::readDeviceWatermark() {
+  auto peakBytes = hw_->getCosMgr()->deviceStatGet(bcmBstStatIdDevice) *
+      hw_->getMMUCellBytes();
+  // Same bogus first read after enabling BST as in the regular stats
+  return peakBytes > hw_->getMMUBufferBytes() ? 0 : peakBytes;
+}
+
 bool BcmBstStatsMgr::startBufferStatCollection() {
   if (!isBufferStatCollectionEnabled()) {
     hw_->getCosMgr()->enableBst();
@@ -34,6 +59,7 @@ bool BcmBstStatsMgr::startBufferStatCollection() {
 }
 
 bool BcmBstStatsMgr::stopBufferStatCollection() {
+  watermarkSampler_->stop();
   if (isBufferStatCollectionEnabled()) {
     hw_->getCosMgr()->disableBst();
     bufferStatsEnabled_ = false;
@@ -74,6 +100,8 @@ void BcmBstStatsMgr::getAndPublishDeviceWatermark() {
         << peakUsage << " peak bytes: " << peakBytes << " skipping write";
     return;
   }
+  // Peaks the sampler read got cleared from the hardware
+  peakBytes = std::max(peakBytes, watermarkSampler_->collectDevicePeakBytes());
 
   deviceWatermarkBytes_.store(peakBytes);
   publishDeviceWatermark(peakBytes);
@@ -144,13 +172,17 @@ void BcmBstStatsMgr::updateStats() {
         ? bcmPort->getQueueManager()->getNumQueues(cfg::StreamType::UNICAST) - 1
         : 0;
     for (int queue = 0; queue <= maxQueueId; queue++) {
-      auto peakBytes = 0;
+      uint64_t peakBytes = 0;
 
       if (bcmPort->isUp()) {
         auto peakCells = cosMgr->statGet(
             PortID(bcmPort->getBcmPortId()), queue, bcmBstStatIdUcast);
         peakBytes = peakCells * hw_->getMMUCellBytes();
       }
+      peakBytes = std::max(
+          peakBytes,
+          watermarkSampler_->collectPeakBytes(
+              PortID(bcmPort->getBcmPortId()), queue));
       queueId2WatermarkBytes[queue] = peakBytes;
       publishQueueuWatermark(bcmPort->getPortName(), queue, peakBytes);
 
@@ -206,6 +238,32 @@ void BcmBstStatsMgr::updateStats() {
   }
 
   getAndPublishDeviceWatermark();
+
+  if (isFineGrainedBufferStatLoggingEnabled() &&
+      watermarkSampler_->isRunning()) {
+    logSampledWatermarkHistograms();
+  }
+}
+
+void BcmBstStatsMgr::logSampledWatermarkHistograms() const {
+  std::vector<uint64_t> bucketUpperBytes;
+  for (size_t i = 0; i + 1 < BufferWatermarkSampler::kNumHistogramBuckets;
+       ++i) {
+    bucketUpperBytes.push_back(
+        BufferWatermarkSampler::getHistogramBucketUpperBytes(i));
+  }
+  for (const auto& histogram : watermarkSampler_->getHistograms()) {
+    auto bcmPort = hw_->getPortTable()->getBcmPortIf(histogram.queue.first);
+    if (!bcmPort) {
+      continue;
+    }
+    getBufferStatsLogger()->logQueueWatermarkHistogram(
+        bcmPort->getPortName(),
+        histogram.queue.second,
+        bucketUpperBytes,
+        histogram.bucketCounts,
+        histogram.maxBytes);
+  }
 }
 
 } // namespace facebook::fboss
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "fboss/agent/hw/BufferStatsLogger.h"
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
 #include "fboss/agent/hw/bcm/BcmPort.h"
 #include "fboss/agent/hw/bcm/BcmSwitch.h"
 
@@ -17,6 +18,23 @@
 
 namespace facebook::fboss {
 
+/*
+ * Reads BST unicast queue and device watermarks for BufferWatermarkSampler.
+ * Doesn't take the BcmSwitch lock, the BST stat APIs are already called
+ * from the stats thread without it.
+ */
+class BcmBufferWatermarkReader : public BufferWatermarkSampler::Reader {
+ public:
+  explicit BcmBufferWatermarkReader(const BcmSwitch* hw) : hw_(hw) {}
+
+  std::vector<uint64_t> readQueueWatermarks(
+      const std::vector<BufferWatermarkSampler::QueueKey>& queues) override;
+  uint64_t readDeviceWatermark() override;
+
+ private:
+  const BcmSwitch* hw_;
+};
+
 /*
  * Class for BST configuration and stats update
  */
@@ -51,6 +69,10 @@ class BcmBstStatsMgr {
     return deviceWatermarkBytes_.load();
   }
 
+  BufferWatermarkSampler* getWatermarkSampler() const {
+    return watermarkSampler_.get();
+  }
+
   void updateStats();
 
  private:
@@ -73,6 +95,7 @@ class BcmBstStatsMgr {
   void getAndPublishGlobalWatermarks(
       const std::map<int, bcm_port_t>& itmToPortMap) const;
   void createItmToPortMap(std::map<int, bcm_port_t>& itmToPortMap) const;
+  void logSampledWatermarkHistograms() const;
 
   BufferStatsLogger* getBufferStatsLogger() const {
     return bufferStatsLogger_.get();
@@ -82,6 +105,7 @@ class BcmBstStatsMgr {
   bool fineGrainedBufferStatsEnabled_{false};
   bool bufferStatsEnabled_{false};
   std::unique_ptr<BufferStatsLogger> bufferStatsLogger_;
+  std::unique_ptr<BufferWatermarkSampler> watermarkSampler_;
   /*
    * Atomic as the stat is updated in stats thread but
    * maybe read from other threads
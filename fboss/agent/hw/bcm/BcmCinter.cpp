@@ -12,7 +12,10 @@
 
 #include "fboss/agent/hw/bcm/BcmSdkVer.h"
 
+#include <algorithm>
 #include <array>
+#include <cctype>
+#include <cstring>
 #include <iterator>
 #include <string>
 #include <tuple>
@@ -25,6 +28,7 @@
 #include <folly/Singleton.h>
 #include <folly/String.h>
 
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/SysError.h"
 
 extern "C" {
@@ -42,6 +46,12 @@ DEFINE_bool(enable_bcm_cinter, false, "Whether to enable bcm cinter");
 
 DEFINE_bool(gen_tx_cint, false, "Generate cint for packet TX calls");
 
+DEFINE_bool(
+    bcm_cinter_binary,
+    false,
+    "Record route, host and egress calls in a compact binary form instead "
+    "of cint, to be converted to cint offline with bcm_cinter_convert");
+
 DEFINE_int32(
     cinter_log_timeout,
     100,
@@ -59,8 +69,95 @@ using std::vector;
 
 namespace {
 
+using facebook::fboss::FbossError;
+using facebook::fboss::cinter_record::CallId;
+using facebook::fboss::cinter_record::L3EgressCreateCall;
+using facebook::fboss::cinter_record::L3EgressDestroyCall;
+using facebook::fboss::cinter_record::L3HostCall;
+using facebook::fboss::cinter_record::L3RouteCall;
+using facebook::fboss::cinter_record::RecordHeader;
+using facebook::fboss::cinter_record::RecordType;
+
 folly::Singleton<facebook::fboss::BcmCinter> _bcmCinter;
 
+// Lines rendered by wrapFunc
+auto constexpr kWrapFuncLines = 2;
+
+string getTmpV6Var(uint32_t tmpV6Num) {
+  return to<string>("tmpV6_", tmpV6Num);
+}
+
+string getTmpMacVar(uint32_t tmpMacNum) {
+  return to<string>("tmpMac_", tmpMacNum);
+}
+
+string toCint(const vector<string>& lines) {
+  auto constexpr kSeparator = ";\n";
+  return join(kSeparator, lines) + kSeparator;
+}
+
+bool isV6(const bcm_l3_route_t& l3_route) {
+  return l3_route.l3a_flags & BCM_L3_IP6;
+}
+
+bool isV6(const bcm_l3_host_t& l3_host) {
+  return l3_host.l3a_flags & BCM_L3_IP6;
+}
+
+// Egress ids are picked by the SDK, and declared in the cint, unless given
+bool isEgressIdGiven(uint32 flags) {
+  return (flags & BCM_L3_REPLACE) || (flags & BCM_L3_WITH_ID);
+}
+
+/*
+ * Temporary variables and lines rendered for recorded calls. Binary
+ * recording doesn't render calls, but still has to keep these counts in
+ * step with text mode so the cint rendered around them stays the same.
+ */
+uint32_t getNumTmpV6Vars(const bcm_l3_route_t& l3_route) {
+  return isV6(l3_route) ? 2 : 0;
+}
+
+uint32_t getNumTmpV6Vars(const bcm_l3_host_t& l3_host) {
+  return isV6(l3_host) ? 1 : 0;
+}
+
+uint getNumCintLines(const L3RouteCall& call) {
+  return (isV6(call.route) ? 9 : 7) + kWrapFuncLines;
+}
+
+uint getNumCintLines(const L3HostCall& call) {
+  return (isV6(call.host) ? 6 : 5) + kWrapFuncLines;
+}
+
+uint getNumCintLines(const L3EgressCreateCall& call) {
+  return 13 + (isEgressIdGiven(call.flags) ? 0 : 1) + kWrapFuncLines;
+}
+
+uint getNumCintLines(const L3EgressDestroyCall& /*call*/) {
+  return kWrapFuncLines;
+}
+
+const char* getCallName(CallId callId) {
+  switch (callId) {
+    case CallId::L3_ROUTE_ADD:
+      return "bcm_l3_route_add";
+    case CallId::L3_ROUTE_DELETE:
+      return "bcm_l3_route_delete";
+    case CallId::L3_HOST_ADD:
+      return "bcm_l3_host_add";
+    case CallId::L3_HOST_DELETE:
+      return "bcm_l3_host_delete";
+    case CallId::L3_EGRESS_CREATE:
+      return "bcm_l3_egress_create";
+    case CallId::L3_EGRESS_DESTROY:
+      return "bcm_l3_egress_destroy";
+    case CallId::NONE:
+      break;
+  }
+  throw FbossError("Unknown cinter call id ", static_cast<int>(callId));
+}
+
 template <typename T>
 vector<string> makeParamVec(T&& arg) {
   return {to<string>(std::forward<T>(arg))};
@@ -172,16 +269,147 @@ void BcmCinter::writeCintLines(C&& lines) {
   auto constexpr kSeparator = ";\n";
   auto cint = join(kSeparator, std::forward<C>(lines)) + kSeparator;
   if (FLAGS_enable_bcm_cinter) {
-    asyncLogger_->appendLog(cint.c_str(), cint.size());
+    if (FLAGS_bcm_cinter_binary) {
+      RecordHeader header{RecordType::TEXT};
+      header.size = cint.size();
+      string record(reinterpret_cast<const char*>(&header), sizeof(header));
+      record.append(cint);
+      asyncLogger_->appendLog(record.c_str(), record.size());
+    } else {
+      asyncLogger_->appendLog(cint.c_str(), cint.size());
+    }
   }
   linesWritten_ += lines.size();
 }
 
+template <typename Call>
+void BcmCinter::writeCall(CallId callId, Call* call) {
+  auto numLines = getNumCintLines(*call);
+  call->linesWritten = linesWritten_.fetch_add(numLines);
+  if (!FLAGS_enable_bcm_cinter) {
+    return;
+  }
+  if (FLAGS_bcm_cinter_binary) {
+    RecordHeader header{RecordType::CALL, 0, callId, sizeof(Call)};
+    array<char, sizeof(RecordHeader) + sizeof(Call)> record;
+    std::memcpy(record.data(), &header, sizeof(header));
+    std::memcpy(record.data() + sizeof(header), call, sizeof(Call));
+    asyncLogger_->appendLog(record.data(), record.size());
+  } else {
+    auto cintLines = cintForCall(callId, *call);
+    DCHECK_EQ(cintLines.size(), numLines);
+    auto cint = toCint(cintLines);
+    asyncLogger_->appendLog(cint.c_str(), cint.size());
+  }
+}
+
+template <typename Call>
+vector<string> BcmCinter::cintForPayload(
+    CallId callId,
+    folly::ByteRange payload) const {
+  if (payload.size() != sizeof(Call)) {
+    throw FbossError(
+        "Expected ",
+        sizeof(Call),
+        " bytes of arguments for ",
+        getCallName(callId),
+        ", got ",
+        payload.size(),
+        ". Was the recording made with a different SDK?");
+  }
+  Call call;
+  std::memcpy(&call, payload.data(), sizeof(Call));
+  return cintForCall(callId, call);
+}
+
+vector<string> BcmCinter::cintForRecordedCall(
+    CallId callId,
+    folly::ByteRange payload) const {
+  switch (callId) {
+    case CallId::L3_ROUTE_ADD:
+    case CallId::L3_ROUTE_DELETE:
+      return cintForPayload<L3RouteCall>(callId, payload);
+    case CallId::L3_HOST_ADD:
+    case CallId::L3_HOST_DELETE:
+      return cintForPayload<L3HostCall>(callId, payload);
+    case CallId::L3_EGRESS_CREATE:
+      return cintForPayload<L3EgressCreateCall>(callId, payload);
+    case CallId::L3_EGRESS_DESTROY:
+      return cintForPayload<L3EgressDestroyCall>(callId, payload);
+    case CallId::NONE:
+      break;
+  }
+  throw FbossError("Unknown cinter call id ", static_cast<int>(callId));
+}
+
+string BcmCinter::convertRecording(folly::ByteRange recording) const {
+  string cint;
+  auto start = recording.begin();
+  while (!recording.empty()) {
+    auto offset = recording.begin() - start;
+    if (recording.front() == '/') {
+      // Boot header written by AsyncLogger, copied as is
+      auto end = std::find(recording.begin(), recording.end(), '\n');
+      if (end != recording.end()) {
+        ++end;
+      }
+      cint.append(
+          reinterpret_cast<const char*>(recording.begin()),
+          end - recording.begin());
+      recording.advance(end - recording.begin());
+      continue;
+    }
+    if (std::isprint(recording.front())) {
+      // Recordings are appended to across boots, so this is most likely
+      // what an earlier boot without --bcm_cinter_binary wrote
+      throw FbossError(
+          "Text mode cint at byte ",
+          offset,
+          " of binary cinter recording, probably written by a boot without "
+          "--bcm_cinter_binary");
+    }
+    RecordHeader header;
+    if (recording.size() < sizeof(header)) {
+      throw FbossError("Truncated cinter record header at byte ", offset);
+    }
+    std::memcpy(&header, recording.data(), sizeof(header));
+    if ((header.type != RecordType::TEXT && header.type != RecordType::CALL) ||
+        header.reserved != 0) {
+      throw FbossError(
+          "Invalid cinter record header at byte ",
+          offset,
+          ", type ",
+          static_cast<int>(header.type));
+    }
+    recording.advance(sizeof(header));
+    if (recording.size() < header.size) {
+      throw FbossError("Truncated cinter record at byte ", offset);
+    }
+    auto payload = recording.subpiece(0, header.size);
+    recording.advance(header.size);
+    switch (header.type) {
+      case RecordType::TEXT:
+        cint.append(
+            reinterpret_cast<const char*>(payload.data()), payload.size());
+        break;
+      case RecordType::CALL:
+        cint.append(toCint(cintForRecordedCall(header.callId, payload)));
+        break;
+    }
+  }
+  return cint;
+}
+
 void BcmCinter::writeCintLine(const std::string& cint) {
   writeCintLines(array<string, 1>{cint});
 }
 
 vector<string> BcmCinter::wrapFunc(const string& funcCall) const {
+  return wrapFunc(funcCall, linesWritten_.load());
+}
+
+vector<string> BcmCinter::wrapFunc(const string& funcCall, uint linesWritten)
+    const {
   vector<string> cintLines = {
       to<string>("rv = ", funcCall),
       // NOTE this is approximate line number in particular it
@@ -189,7 +417,7 @@ vector<string> BcmCinter::wrapFunc(const string& funcCall) const {
       // in setting up args and making this function call.
       to<string>(
           "if (rv) { printf(\"\\nError around line ",
-          linesWritten_.load(),
+          linesWritten,
           " : ",
           funcCall.substr(0, funcCall.find("(")),
           ": %d -> %s\", rv, bcm_errmsg(rv));  }")};
@@ -252,11 +480,11 @@ vector<string> BcmCinter::cintForCosQDiscard(
 }
 
 string BcmCinter::getNextTmpV6Var() {
-  return to<string>("tmpV6_", ++tmpV6Created_);
+  return getTmpV6Var(++tmpV6Created_);
 }
 
 string BcmCinter::getNextTmpMacVar() {
-  return to<string>("tmpMac_", ++tmpMacCreated_);
+  return getTmpMacVar(++tmpMacCreated_);
 }
 
 string BcmCinter::getNextTmpStatArray() {
@@ -344,22 +572,32 @@ string BcmCinter::getNextStateCounterVar() {
 }
 
 pair<string, string> BcmCinter::cintForIp6(const bcm_ip6_t in) {
+  return cintForIp6(in, getNextTmpV6Var());
+}
+
+pair<string, string> BcmCinter::cintForIp6(
+    const bcm_ip6_t in,
+    const string& v6VarName) const {
   array<string, 16> bytes;
   for (auto i = 0; i < 16; ++i) {
     bytes[i] = to<string>(in[i]);
   }
-  auto v6VarName = getNextTmpV6Var();
   return make_pair(
       to<string>("bcm_ip6_t ", v6VarName, " = ", " {", join(", ", bytes), "}"),
       v6VarName);
 }
 
 pair<string, string> BcmCinter::cintForMac(const bcm_mac_t in) {
+  return cintForMac(in, getNextTmpMacVar());
+}
+
+pair<string, string> BcmCinter::cintForMac(
+    const bcm_mac_t in,
+    const string& macVarName) const {
   array<string, 6> bytes;
   for (auto i = 0; i < 6; ++i) {
     bytes[i] = to<string>(in[i]);
   }
-  auto macVarName = getNextTmpMacVar();
   return make_pair(
       to<string>("bcm_mac_t ", macVarName, " = ", " {", join(", ", bytes), "}"),
       macVarName);
@@ -395,20 +633,30 @@ vector<string> BcmCinter::cintForL3Ecmp(const bcm_l3_egress_ecmp_t& ecmp) {
 }
 
 vector<string> BcmCinter::cintForL3Route(const bcm_l3_route_t& l3_route) {
+  return cintForL3Route(
+      l3_route,
+      tmpV6Created_.fetch_add(getNumTmpV6Vars(l3_route)),
+      getCintVar(l3IntfIdVars, l3_route.l3a_intf));
+}
+
+vector<string> BcmCinter::cintForL3Route(
+    const bcm_l3_route_t& l3_route,
+    uint32_t tmpV6Created,
+    const string& intfVar) const {
   vector<string> cintLines;
 
-  if (l3_route.l3a_flags & BCM_L3_IP6) {
+  if (isV6(l3_route)) {
     string cintV6, v6Var, cintMask, v6Mask;
-    tie(cintV6, v6Var) = cintForIp6(l3_route.l3a_ip6_net);
-    tie(cintMask, v6Mask) = cintForIp6(l3_route.l3a_ip6_mask);
+    tie(cintV6, v6Var) =
+        cintForIp6(l3_route.l3a_ip6_net, getTmpV6Var(tmpV6Created + 1));
+    tie(cintMask, v6Mask) =
+        cintForIp6(l3_route.l3a_ip6_mask, getTmpV6Var(tmpV6Created + 2));
     cintLines = {
         cintV6,
         cintMask,
         "bcm_l3_route_t_init(&l3_route)",
         to<string>("l3_route.l3a_vrf = ", l3_route.l3a_vrf),
-        to<string>(
-            "l3_route.l3a_intf = ",
-            getCintVar(l3IntfIdVars, l3_route.l3a_intf)),
+        to<string>("l3_route.l3a_intf = ", intfVar),
         to<string>("l3_route.l3a_ip6_net = ", v6Var),
         to<string>("l3_route.l3a_ip6_mask = ", v6Mask),
         to<string>("l3_route.l3a_lookup_class = ", l3_route.l3a_lookup_class),
@@ -418,9 +666,7 @@ vector<string> BcmCinter::cintForL3Route(const bcm_l3_route_t& l3_route) {
     cintLines = {
         "bcm_l3_route_t_init(&l3_route)",
         to<string>("l3_route.l3a_vrf = ", l3_route.l3a_vrf),
-        to<string>(
-            "l3_route.l3a_intf = ",
-            getCintVar(l3IntfIdVars, l3_route.l3a_intf)),
+        to<string>("l3_route.l3a_intf = ", intfVar),
         to<string>("l3_route.l3a_subnet = ", l3_route.l3a_subnet),
         to<string>("l3_route.l3a_ip_mask = ", l3_route.l3a_ip_mask),
         to<string>("l3_route.l3a_lookup_class = ", l3_route.l3a_lookup_class),
@@ -582,16 +828,26 @@ vector<string> BcmCinter::cintForMirrorDestination(
 }
 
 vector<string> BcmCinter::cintForL3Host(const bcm_l3_host_t& l3_host) {
+  return cintForL3Host(
+      l3_host,
+      tmpV6Created_.fetch_add(getNumTmpV6Vars(l3_host)),
+      getCintVar(l3IntfIdVars, l3_host.l3a_intf));
+}
+
+vector<string> BcmCinter::cintForL3Host(
+    const bcm_l3_host_t& l3_host,
+    uint32_t tmpV6Created,
+    const string& intfVar) const {
   vector<string> cintLines;
-  if (l3_host.l3a_flags & BCM_L3_IP6) {
+  if (isV6(l3_host)) {
     string cintV6, v6Var;
-    tie(cintV6, v6Var) = cintForIp6(l3_host.l3a_ip6_addr);
+    tie(cintV6, v6Var) =
+        cintForIp6(l3_host.l3a_ip6_addr, getTmpV6Var(tmpV6Created + 1));
     cintLines = {
         cintV6,
         "bcm_l3_host_t_init(&l3_host)",
         to<string>("l3_host.l3a_vrf = ", l3_host.l3a_vrf),
-        to<string>(
-            "l3_host.l3a_intf = ", getCintVar(l3IntfIdVars, l3_host.l3a_intf)),
+        to<string>("l3_host.l3a_intf = ", intfVar),
         to<string>("l3_host.l3a_flags = ", l3_host.l3a_flags),
         to<string>("l3_host.l3a_ip6_addr = ", v6Var)};
 
@@ -599,8 +855,7 @@ vector<string> BcmCinter::cintForL3Host(const bcm_l3_host_t& l3_host) {
     cintLines = {
         "bcm_l3_host_t_init(&l3_host)",
         to<string>("l3_host.l3a_vrf = ", l3_host.l3a_vrf),
-        to<string>(
-            "l3_host.l3a_intf = ", getCintVar(l3IntfIdVars, l3_host.l3a_intf)),
+        to<string>("l3_host.l3a_intf = ", intfVar),
         to<string>("l3_host.l3a_flags = ", l3_host.l3a_flags),
         to<string>("l3_host.l3a_ip_addr = ", l3_host.l3a_ip_addr)};
   }
@@ -2111,26 +2366,12 @@ int BcmCinter::bcm_l3_route_delete_by_interface(
 }
 
 int BcmCinter::bcm_l3_route_delete(int unit, bcm_l3_route_t* l3_route) {
-  auto cint = cintForL3Route(*l3_route);
-  auto cintForFn = wrapFunc(
-      to<string>("bcm_l3_route_delete(", makeParamStr(unit, "&l3_route"), ")"));
-  cint.insert(
-      cint.end(),
-      make_move_iterator(cintForFn.begin()),
-      make_move_iterator(cintForFn.end()));
-  writeCintLines(std::move(cint));
+  writeL3RouteCall(CallId::L3_ROUTE_DELETE, unit, *l3_route);
   return 0;
 }
 
 int BcmCinter::bcm_l3_route_add(int unit, bcm_l3_route_t* l3_route) {
-  auto cint = cintForL3Route(*l3_route);
-  auto cintForFn = wrapFunc(
-      to<string>("bcm_l3_route_add(", makeParamStr(unit, "&l3_route"), ")"));
-  cint.insert(
-      cint.end(),
-      make_move_iterator(cintForFn.begin()),
-      make_move_iterator(cintForFn.end()));
-  writeCintLines(std::move(cint));
+  writeL3RouteCall(CallId::L3_ROUTE_ADD, unit, *l3_route);
   return 0;
 }
 
@@ -2146,6 +2387,32 @@ int BcmCinter::bcm_l3_route_delete_all(int unit, bcm_l3_route_t* info) {
   return 0;
 }
 
+void BcmCinter::writeL3RouteCall(
+    CallId callId,
+    int unit,
+    const bcm_l3_route_t& l3_route) {
+  L3RouteCall call{};
+  call.unit = unit;
+  call.tmpV6Created = tmpV6Created_.fetch_add(getNumTmpV6Vars(l3_route));
+  call.intf.set(getCintVar(l3IntfIdVars, l3_route.l3a_intf));
+  call.route = l3_route;
+  writeCall(callId, &call);
+}
+
+vector<string> BcmCinter::cintForCall(CallId callId, const L3RouteCall& call)
+    const {
+  auto cint = cintForL3Route(call.route, call.tmpV6Created, call.intf.str());
+  auto cintForFn = wrapFunc(
+      to<string>(
+          getCallName(callId), "(", makeParamStr(call.unit, "&l3_route"), ")"),
+      call.linesWritten);
+  cint.insert(
+      cint.end(),
+      make_move_iterator(cintForFn.begin()),
+      make_move_iterator(cintForFn.end()));
+  return cint;
+}
+
 int BcmCinter::bcm_l3_route_max_ecmp_set(int unit, int max) {
   writeCintLine(
       to<string>("bcm_l3_route_max_ecmp_set(", makeParamStr(unit, max), ")"));
@@ -2167,26 +2434,12 @@ int BcmCinter::bcm_l3_host_delete_by_interface(
 }
 
 int BcmCinter::bcm_l3_host_add(int unit, bcm_l3_host_t* l3_host) {
-  auto cint = cintForL3Host(*l3_host);
-  auto cintForFn = wrapFunc(
-      to<string>("bcm_l3_host_add(", makeParamStr(unit, "&l3_host"), ")"));
-  cint.insert(
-      cint.end(),
-      make_move_iterator(cintForFn.begin()),
-      make_move_iterator(cintForFn.end()));
-  writeCintLines(std::move(cint));
+  writeL3HostCall(CallId::L3_HOST_ADD, unit, *l3_host);
   return 0;
 }
 
 int BcmCinter::bcm_l3_host_delete(int unit, bcm_l3_host_t* l3_host) {
-  auto cint = cintForL3Host(*l3_host);
-  auto cintForFn = wrapFunc(
-      to<string>("bcm_l3_host_delete(", makeParamStr(unit, "&l3_host"), ")"));
-  cint.insert(
-      cint.end(),
-      make_move_iterator(cintForFn.begin()),
-      make_move_iterator(cintForFn.end()));
-  writeCintLines(std::move(cint));
+  writeL3HostCall(CallId::L3_HOST_DELETE, unit, *l3_host);
   return 0;
 }
 
@@ -2202,6 +2455,32 @@ int BcmCinter::bcm_l3_host_delete_all(int unit, bcm_l3_host_t* info) {
   return 0;
 }
 
+void BcmCinter::writeL3HostCall(
+    CallId callId,
+    int unit,
+    const bcm_l3_host_t& l3_host) {
+  L3HostCall call{};
+  call.unit = unit;
+  call.tmpV6Created = tmpV6Created_.fetch_add(getNumTmpV6Vars(l3_host));
+  call.intf.set(getCintVar(l3IntfIdVars, l3_host.l3a_intf));
+  call.host = l3_host;
+  writeCall(callId, &call);
+}
+
+vector<string> BcmCinter::cintForCall(CallId callId, const L3HostCall& call)
+    const {
+  auto cint = cintForL3Host(call.host, call.tmpV6Created, call.intf.str());
+  auto cintForFn = wrapFunc(
+      to<string>(
+          getCallName(callId), "(", makeParamStr(call.unit, "&l3_host"), ")"),
+      call.linesWritten);
+  cint.insert(
+      cint.end(),
+      make_move_iterator(cintForFn.begin()),
+      make_move_iterator(cintForFn.end()));
+  return cint;
+}
+
 int BcmCinter::bcm_stat_custom_add(
     int unit,
     bcm_port_t port,
@@ -2237,25 +2516,28 @@ int BcmCinter::bcm_l3_intf_delete(int unit, bcm_l3_intf_t* l3_intf) {
   return 0;
 }
 
-vector<string> BcmCinter::cintForL3Egress(const bcm_l3_egress_t* l3_egress) {
+vector<string> BcmCinter::cintForL3Egress(
+    const bcm_l3_egress_t& l3_egress,
+    uint32_t tmpMacCreated,
+    const string& intfVar) const {
   vector<string> cintLines;
   string cintMac, macVar;
-  tie(cintMac, macVar) = cintForMac(l3_egress->mac_addr);
+  tie(cintMac, macVar) =
+      cintForMac(l3_egress.mac_addr, getTmpMacVar(tmpMacCreated + 1));
   cintLines = {
       cintMac,
       "bcm_l3_egress_t_init(&l3_egress)",
-      to<string>("l3_egress.flags = ", l3_egress->flags),
+      to<string>("l3_egress.flags = ", l3_egress.flags),
       to<string>("l3_egress.mac_addr = ", macVar),
-      to<string>(
-          "l3_egress.intf = ", getCintVar(l3IntfIdVars, l3_egress->intf)),
-      to<string>("l3_egress.vlan = ", l3_egress->vlan),
-      to<string>("l3_egress.module = ", l3_egress->module),
-      to<string>("l3_egress.port = ", l3_egress->port),
-      to<string>("l3_egress.trunk = ", l3_egress->trunk),
-      to<string>("l3_egress.qos_map_id = ", l3_egress->qos_map_id),
-      to<string>("l3_egress.mpls_qos_map_id = ", l3_egress->mpls_qos_map_id),
-      to<string>("l3_egress.mpls_flags = ", l3_egress->mpls_flags),
-      to<string>("l3_egress.mpls_label = ", l3_egress->mpls_label)};
+      to<string>("l3_egress.intf = ", intfVar),
+      to<string>("l3_egress.vlan = ", l3_egress.vlan),
+      to<string>("l3_egress.module = ", l3_egress.module),
+      to<string>("l3_egress.port = ", l3_egress.port),
+      to<string>("l3_egress.trunk = ", l3_egress.trunk),
+      to<string>("l3_egress.qos_map_id = ", l3_egress.qos_map_id),
+      to<string>("l3_egress.mpls_qos_map_id = ", l3_egress.mpls_qos_map_id),
+      to<string>("l3_egress.mpls_flags = ", l3_egress.mpls_flags),
+      to<string>("l3_egress.mpls_label = ", l3_egress.mpls_label)};
   return cintLines;
 }
 
@@ -2264,41 +2546,49 @@ int BcmCinter::bcm_l3_egress_create(
     uint32 flags,
     bcm_l3_egress_t* egr,
     bcm_if_t* if_id) {
-  vector<string> cint =
-      cintForL3Egress(reinterpret_cast<bcm_l3_egress_t*>(egr));
-  if ((flags & BCM_L3_REPLACE) || (flags & BCM_L3_WITH_ID)) {
-    auto funcCint = wrapFunc(to<string>(
-        "bcm_l3_egress_create(",
-        makeParamStr(
-            unit,
-            flags,
-            "&l3_egress",
-            to<string>("&", getCintVar(l3IntfIdVars, *if_id))),
-        ")"));
-    cint.insert(
-        cint.end(),
-        make_move_iterator(funcCint.begin()),
-        make_move_iterator(funcCint.end()));
+  L3EgressCreateCall call{};
+  call.unit = unit;
+  call.flags = flags;
+  call.tmpMacCreated = tmpMacCreated_.fetch_add(1);
+  call.intf.set(getCintVar(l3IntfIdVars, egr->intf));
+  if (isEgressIdGiven(flags)) {
+    call.egressId.set(getCintVar(l3IntfIdVars, *if_id));
   } else {
     auto intfVar = getNextL3IntfIdVar();
-    {
-      l3IntfIdVars.wlock()->emplace(
-          reinterpret_cast<bcm_if_t&>(*if_id), intfVar);
-    }
-    cint.push_back(to<string>("bcm_if_t ", intfVar));
-    auto funcCint = wrapFunc(to<string>(
-        "bcm_l3_egress_create(",
-        makeParamStr(unit, flags, "&l3_egress", to<string>("&", intfVar)),
-        ")"));
-    cint.insert(
-        cint.end(),
-        make_move_iterator(funcCint.begin()),
-        make_move_iterator(funcCint.end()));
+    { l3IntfIdVars.wlock()->emplace(*if_id, intfVar); }
+    call.egressId.set(intfVar);
   }
-  writeCintLines(std::move(cint));
+  call.egress = *egr;
+  writeCall(CallId::L3_EGRESS_CREATE, &call);
   return 0;
 }
 
+vector<string> BcmCinter::cintForCall(
+    CallId /*callId*/,
+    const L3EgressCreateCall& call) const {
+  auto cint =
+      cintForL3Egress(call.egress, call.tmpMacCreated, call.intf.str());
+  auto egressIdVar = call.egressId.str();
+  if (!isEgressIdGiven(call.flags)) {
+    cint.push_back(to<string>("bcm_if_t ", egressIdVar));
+  }
+  auto funcCint = wrapFunc(
+      to<string>(
+          "bcm_l3_egress_create(",
+          makeParamStr(
+              call.unit,
+              call.flags,
+              "&l3_egress",
+              to<string>("&", egressIdVar)),
+          ")"),
+      call.linesWritten);
+  cint.insert(
+      cint.end(),
+      make_move_iterator(funcCint.begin()),
+      make_move_iterator(funcCint.end()));
+  return cint;
+}
+
 int BcmCinter::bcm_vlan_create(int unit, bcm_vlan_t vid) {
   writeCintLines(
       wrapFunc(to<string>("bcm_vlan_create(", makeParamStr(unit, vid), ")")));
@@ -2442,14 +2732,25 @@ int BcmCinter::bcm_port_interface_set(
 }
 
 int BcmCinter::bcm_l3_egress_destroy(int unit, bcm_if_t intf) {
-  writeCintLines(wrapFunc(to<string>(
-      "bcm_l3_egress_destroy(",
-      makeParamStr(unit, getCintVar(l3IntfIdVars, intf)),
-      ")")));
+  L3EgressDestroyCall call{};
+  call.unit = unit;
+  call.egressId.set(getCintVar(l3IntfIdVars, intf));
+  writeCall(CallId::L3_EGRESS_DESTROY, &call);
   { l3IntfIdVars.wlock()->erase(intf); }
   return 0;
 }
 
+vector<string> BcmCinter::cintForCall(
+    CallId /*callId*/,
+    const L3EgressDestroyCall& call) const {
+  return wrapFunc(
+      to<string>(
+          "bcm_l3_egress_destroy(",
+          makeParamStr(call.unit, call.egressId.str()),
+          ")"),
+      call.linesWritten);
+}
+
 int BcmCinter::bcm_field_range_create(
     int unit,
     bcm_field_range_t* range,
@@ -17,10 +17,12 @@
 #include <vector>
 
 #include <folly/File.h>
+#include <folly/Range.h>
 #include <folly/Synchronized.h>
 #include <folly/logging/xlog.h>
 
 #include "fboss/agent/AsyncLogger.h"
+#include "fboss/agent/hw/bcm/BcmCinterRecord.h"
 #include "fboss/agent/hw/bcm/BcmInterface.h"
 #include "fboss/agent/hw/bcm/BcmSdkInterface.h"
 
@@ -37,6 +39,12 @@ class BcmCinter : public BcmSdkInterface, public BcmInterface {
   ~BcmCinter() override;
   static std::shared_ptr<BcmCinter> getInstance();
 
+  /*
+   * Convert a recording made with --bcm_cinter_binary to the cint a text
+   * recording of the same calls would have had
+   */
+  std::string convertRecording(folly::ByteRange recording) const;
+
   /*
    * TODO: bcm_rx_*
    */
@@ -1752,12 +1760,48 @@ class BcmCinter : public BcmSdkInterface, public BcmInterface {
    * check
    */
   std::vector<std::string> wrapFunc(const std::string& funcCall) const;
+  std::vector<std::string> wrapFunc(
+      const std::string& funcCall,
+      uint linesWritten) const;
   /*
    * Write cint lines to file
    */
   void writeCintLine(const std::string& cint);
   template <typename C>
   void writeCintLines(C&& lines);
+  /*
+   * Write a call recorded as its arguments. In binary mode it is only
+   * rendered to cint offline, by convertRecording().
+   */
+  template <typename Call>
+  void writeCall(cinter_record::CallId callId, Call* call);
+  void writeL3RouteCall(
+      cinter_record::CallId callId,
+      int unit,
+      const bcm_l3_route_t& l3_route);
+  void writeL3HostCall(
+      cinter_record::CallId callId,
+      int unit,
+      const bcm_l3_host_t& l3_host);
+  std::vector<std::string> cintForCall(
+      cinter_record::CallId callId,
+      const cinter_record::L3RouteCall& call) const;
+  std::vector<std::string> cintForCall(
+      cinter_record::CallId callId,
+      const cinter_record::L3HostCall& call) const;
+  std::vector<std::string> cintForCall(
+      cinter_record::CallId callId,
+      const cinter_record::L3EgressCreateCall& call) const;
+  std::vector<std::string> cintForCall(
+      cinter_record::CallId callId,
+      const cinter_record::L3EgressDestroyCall& call) const;
+  template <typename Call>
+  std::vector<std::string> cintForPayload(
+      cinter_record::CallId callId,
+      folly::ByteRange payload) const;
+  std::vector<std::string> cintForRecordedCall(
+      cinter_record::CallId callId,
+      folly::ByteRange payload) const;
   std::vector<std::string> cintForQset(const bcm_field_qset_t& qset) const;
   std::vector<std::string> cintForAset(const bcm_field_aset_t& aset) const;
   std::vector<std::string> cintForFpGroupConfig(
@@ -1767,11 +1811,17 @@ class BcmCinter : public BcmSdkInterface, public BcmInterface {
    * Return cint for initialization and the variable name
    */
   std::pair<std::string, std::string> cintForIp6(const bcm_ip6_t in);
+  std::pair<std::string, std::string> cintForIp6(
+      const bcm_ip6_t in,
+      const std::string& v6VarName) const;
   /*
    * Create a mac variable initialized from in
    * Return cint for initialization and the variable name
    */
   std::pair<std::string, std::string> cintForMac(const bcm_mac_t in);
+  std::pair<std::string, std::string> cintForMac(
+      const bcm_mac_t in,
+      const std::string& macVarName) const;
   /*
    * Create a field stats array
    * Return cint for initialization and the variable name
@@ -1789,8 +1839,20 @@ class BcmCinter : public BcmSdkInterface, public BcmInterface {
   std::vector<std::string> cintForL3Ecmp(const bcm_l3_egress_ecmp_t& ecmp);
 
   std::vector<std::string> cintForL3Route(const bcm_l3_route_t& l3_route);
+  /*
+   * Render with the given temporary variables numbering and interface
+   * variable, as captured when the call was made
+   */
+  std::vector<std::string> cintForL3Route(
+      const bcm_l3_route_t& l3_route,
+      uint32_t tmpV6Created,
+      const std::string& intfVar) const;
 
   std::vector<std::string> cintForL3Host(const bcm_l3_host_t& l3_host);
+  std::vector<std::string> cintForL3Host(
+      const bcm_l3_host_t& l3_host,
+      uint32_t tmpV6Created,
+      const std::string& intfVar) const;
 
   std::vector<std::string> cintForL3Intf(const bcm_l3_intf_t& l3_intf);
 
@@ -1807,7 +1869,10 @@ class BcmCinter : public BcmSdkInterface, public BcmInterface {
       const bcm_trunk_member_t* trunkMemberArray,
       int member_max);
 
-  std::vector<std::string> cintForL3Egress(const bcm_l3_egress_t* l3_egress);
+  std::vector<std::string> cintForL3Egress(
+      const bcm_l3_egress_t& l3_egress,
+      uint32_t tmpMacCreated,
+      const std::string& intfVar) const;
 
   std::vector<std::string> cintForEgressId(const bcm_if_t& if_id);
 
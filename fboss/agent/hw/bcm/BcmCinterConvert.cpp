@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Converts a recording made by wedge_agent with --bcm_cinter_binary to the
+ * cint it would have written without it. Must be built against the same
+ * SDK as the agent which made the recording.
+ */
+
+#include <folly/FileUtil.h>
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/hw/bcm/BcmCinter.h"
+
+DEFINE_string(
+    cint_recording,
+    "",
+    "Binary recording made with --bcm_cinter_binary");
+DEFINE_string(cint_output, "", "File to write the cint to");
+
+using namespace facebook::fboss;
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  if (FLAGS_cint_recording.empty() || FLAGS_cint_output.empty()) {
+    XLOG(ERR) << "Both --cint_recording and --cint_output are required";
+    return 1;
+  }
+
+  std::string recording;
+  if (!folly::readFile(FLAGS_cint_recording.c_str(), recording)) {
+    throw SysError(errno, "error reading ", FLAGS_cint_recording);
+  }
+  // Only renders calls, so no cinter log of its own is written
+  BcmCinter cinter;
+  auto cint = cinter.convertRecording(
+      folly::ByteRange(folly::StringPiece(recording)));
+  if (!folly::writeFile(cint, FLAGS_cint_output.c_str())) {
+    throw SysError(errno, "error writing ", FLAGS_cint_output);
+  }
+  XLOG(INFO) << "Converted " << recording.size() << " bytes of recording to "
+             << cint.size() << " bytes of cint in " << FLAGS_cint_output;
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <glog/logging.h>
+
+extern "C" {
+#include <bcm/l3.h>
+}
+
+/*
+ * Format of the recordings BcmCinter writes with --bcm_cinter_binary.
+ *
+ * A recording is a sequence of records, each a RecordHeader followed by its
+ * payload. Calls on the programming hot path are recorded as their raw
+ * arguments along with the cinter state needed to render them, and turned
+ * into cint offline by bcm_cinter_convert. Every other call is recorded as
+ * the cint text it renders to.
+ *
+ * The boot headers AsyncLogger writes are "//" comment lines in between
+ * records. Since RecordType never starts with '/', they are told apart by
+ * their first byte. Neither is RecordType printable, so text mode cint
+ * left in the file by an earlier boot without --bcm_cinter_binary is
+ * rejected rather than misread as records.
+ *
+ * Payloads are copied as is, so recordings can only be converted by a
+ * converter built against the same SDK as the agent which recorded them.
+ */
+namespace facebook::fboss::cinter_record {
+
+enum class RecordType : uint8_t {
+  TEXT = 1,
+  CALL = 2,
+};
+
+enum class CallId : uint16_t {
+  NONE = 0,
+  L3_ROUTE_ADD = 1,
+  L3_ROUTE_DELETE = 2,
+  L3_HOST_ADD = 3,
+  L3_HOST_DELETE = 4,
+  L3_EGRESS_CREATE = 5,
+  L3_EGRESS_DESTROY = 6,
+};
+
+struct RecordHeader {
+  RecordType type;
+  uint8_t reserved{0};
+  CallId callId{CallId::NONE};
+  // Bytes of payload following the header
+  uint32_t size;
+};
+
+/*
+ * Name of a cint variable, or the handle itself when no variable was
+ * declared for it
+ */
+struct CintVar {
+  static constexpr size_t kMaxLen = 31;
+
+  void set(const std::string& var) {
+    CHECK_LE(var.size(), kMaxLen) << "Cint variable too long: " << var;
+    std::memcpy(name.data(), var.data(), var.size());
+    name[var.size()] = '\0';
+  }
+  std::string str() const {
+    return std::string(name.data(), strnlen(name.data(), name.size()));
+  }
+
+  std::array<char, kMaxLen + 1> name;
+};
+
+/*
+ * linesWritten is where the call's lines start in the cint, used in
+ * error messages. tmpV6Created and tmpMacCreated are the number of
+ * temporary variables declared before the call, the call's own are
+ * numbered from there.
+ */
+struct L3RouteCall {
+  int32_t unit;
+  uint32_t linesWritten;
+  uint32_t tmpV6Created;
+  CintVar intf;
+  bcm_l3_route_t route;
+};
+
+struct L3HostCall {
+  int32_t unit;
+  uint32_t linesWritten;
+  uint32_t tmpV6Created;
+  CintVar intf;
+  bcm_l3_host_t host;
+};
+
+struct L3EgressCreateCall {
+  int32_t unit;
+  uint32_t flags;
+  uint32_t linesWritten;
+  uint32_t tmpMacCreated;
+  CintVar intf;
+  // Declared by the call, unless replacing or creating with an id
+  CintVar egressId;
+  bcm_l3_egress_t egress;
+};
+
+struct L3EgressDestroyCall {
+  int32_t unit;
+  uint32_t linesWritten;
+  CintVar egressId;
+};
+
+static_assert(std::is_trivially_copyable<L3RouteCall>::value);
+static_assert(std::is_trivially_copyable<L3HostCall>::value);
+static_assert(std::is_trivially_copyable<L3EgressCreateCall>::value);
+static_assert(std::is_trivially_copyable<L3EgressDestroyCall>::value);
+
+} // namespace facebook::fboss::cinter_record
@@ -35,6 +35,10 @@ void cfgIcmpTypeCodeToBcmIcmpCodeMaskImpl(
 namespace facebook::fboss::utility {
 
 int swPriorityToHwPriority(int swPrio) {
+  if (swPrio < 0 || swPrio > kPrioMax) {
+    throw FbossError(
+        "Acl priority ", swPrio, " out of supported range [0, ", kPrioMax, "]");
+  }
   return kPrioMax - swPrio;
 }
 
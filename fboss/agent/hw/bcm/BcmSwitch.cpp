@@ -26,6 +26,7 @@
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/FibHelpers.h"
 #include "fboss/agent/LacpTypes.h"
+#include "fboss/agent/StateUpdateTracer.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/Utils.h"
@@ -75,6 +76,7 @@
 #include "fboss/agent/hw/bcm/BcmTrunk.h"
 #include "fboss/agent/hw/bcm/BcmTrunkTable.h"
 #include "fboss/agent/hw/bcm/BcmTxPacket.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
 #include "fboss/agent/hw/bcm/BcmUnit.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootCache.h"
 #include "fboss/agent/hw/bcm/BcmWarmBootHelper.h"
@@ -85,6 +87,7 @@
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 #include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
 #include "fboss/agent/state/AggregatePort.h"
 #include "fboss/agent/state/ArpEntry.h"
 #include "fboss/agent/state/DeltaFunctions.h"
@@ -161,6 +164,12 @@ DEFINE_int32(
     1,
     "Starting ACL entry priority for CoPP");
 
+DEFINE_int32(
+    bcm_tx_pkt_pool_size,
+    256,
+    "Number of tx packets pre-allocated for each packet size class, "
+    "0 to allocate every tx packet on demand");
+
 DEFINE_int32(acl_g_pri, 0, "Group priority for ACL field group");
 DEFINE_int32(
     qcm_ifp_gid,
@@ -364,6 +373,7 @@ BcmSwitch::~BcmSwitch() {
     // In agent this would be done in the signal handler
     // gracefulExit().  In bcm_tests there is no signal.
     // So if unitObject_ is still valid, destroy it.
+    releaseTxPacketPool();
     unitObject_.reset();
   }
 }
@@ -371,6 +381,8 @@ BcmSwitch::~BcmSwitch() {
 void BcmSwitch::resetTables() {
   std::unique_lock<std::mutex> lk(lock_);
   unregisterCallbacks();
+  // The sampler reads ports without lock_, stop it before they go away
+  bstStatsMgr_->getWatermarkSampler()->stop();
   labelMap_.reset();
   routeTable_.reset();
   l3NextHopTable_.reset();
@@ -487,12 +499,27 @@ void BcmSwitch::gracefulExit(folly::dynamic& switchState) {
 
   switchState[kHwSwitch] = toFollyDynamic();
   unitObject_->writeWarmBootState(switchState);
+  // Pooled packets must go back to the SDK before the unit is detached
+  releaseTxPacketPool();
   unitObject_.reset();
   XLOG(INFO)
       << "[Exit] BRCM Graceful Exit time "
       << duration_cast<duration<float>>(steady_clock::now() - begin).count();
 }
 
+void BcmSwitch::releaseTxPacketPool() {
+  auto pool = txPacketPool_.exchange(nullptr);
+  if (!pool) {
+    return;
+  }
+  // Packets sent or freed from now on bypass the pool. Those that got the
+  // pool before only hold it for an alloc() or release().
+  while (pool.use_count() > 1) {
+    std::this_thread::yield();
+  }
+  pool.reset();
+}
+
 folly::dynamic BcmSwitch::toFollyDynamic() const {
   return warmBootCache_->getWarmBootStateFollyDynamic();
 }
@@ -769,6 +796,11 @@ HwInitResult BcmSwitch::init(
   // Create bcmStatUpdater to cache the stat ids
   bcmStatUpdater_ = std::make_unique<BcmStatUpdater>(this);
 
+  if (!usePKTIO() && FLAGS_bcm_tx_pkt_pool_size > 0) {
+    txPacketPool_.store(
+        std::make_shared<BcmTxPacketPool>(unit_, FLAGS_bcm_tx_pkt_pool_size));
+  }
+
   XLOG(INFO) << " Is ALPM enabled: " << BcmAPI::isAlpmEnabled();
   // Additional switch configuration
   auto state = make_shared<SwitchState>();
@@ -1117,16 +1149,27 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
 
   processSwitchSettingsChanged(delta);
 
-  processMacTableChanges(delta);
+  {
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "mac");
+    processMacTableChanges(delta);
+  }
 
   processLoadBalancerChanges(delta);
 
   // remove all routes to be deleted
-  processRemovedRoutes(delta);
+  {
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kHwCategory, "removed routes");
+    processRemovedRoutes(delta);
+  }
 
   // Any neighbor removals, and modify appliedState if some changes fail to
   // apply
-  processNeighborDelta(delta, &appliedState, REMOVED);
+  {
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kHwCategory, "removed neighbors");
+    processNeighborDelta(delta, &appliedState, REMOVED);
+  }
 
   // delete all interface not existing anymore. that should stop
   // all traffic on that interface now
@@ -1173,11 +1216,18 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
 
   // Any neighbor additions/changes, and modify appliedState if some changes
   // fail to apply
-  processNeighborDelta(delta, &appliedState, ADDED);
-  processNeighborDelta(delta, &appliedState, CHANGED);
+  {
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kHwCategory, "added/changed neighbors");
+    processNeighborDelta(delta, &appliedState, ADDED);
+    processNeighborDelta(delta, &appliedState, CHANGED);
+  }
 
   // process label forwarding changes after neighbor entries are updated
-  processChangedLabelForwardingInformationBase(delta);
+  {
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "mpls");
+    processChangedLabelForwardingInformationBase(delta);
+  }
 
   // Add/update mirrors before processing Acl and port changes
   // This is to ensure that port and acls can access latest mirrors
@@ -1191,7 +1241,10 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
       writableBcmMirrorTable());
 
   // Any ACL changes
-  processAclChanges(delta);
+  {
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "acls");
+    processAclChanges(delta);
+  }
 
   // Any changes to the set of sFlow collectors
   processSflowCollectorChanges(delta);
@@ -1200,10 +1253,17 @@ std::shared_ptr<SwitchState> BcmSwitch::stateChangedImpl(
   processSflowSamplingRateChanges(delta);
 
   // Process any new routes or route changes
-  processAddedChangedRoutes(delta, &appliedState);
+  {
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kHwCategory, "added/changed routes");
+    processAddedChangedRoutes(delta, &appliedState);
+  }
 
-  processAddedPorts(delta);
-  processChangedPorts(delta);
+  {
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "ports");
+    processAddedPorts(delta);
+    processChangedPorts(delta);
+  }
 
   // delete any removed mirrors after processing port and acl changes
   forEachRemoved(
@@ -2014,12 +2074,16 @@ void BcmSwitch::processQosChanges(const StateDelta& delta) {
 }
 
 void BcmSwitch::processAclChanges(const StateDelta& delta) {
-  forEachChanged(
-      delta.getAclsDelta(),
-      &BcmSwitch::processChangedAcl,
-      &BcmSwitch::processAddedAcl,
-      &BcmSwitch::processRemovedAcl,
-      this);
+  OrderedAclChanges changes(delta.getAclsDelta());
+  for (const auto& acl : changes.removed) {
+    processRemovedAcl(acl);
+  }
+  for (const auto& [oldAcl, newAcl] : changes.moved) {
+    processChangedAclPriority(oldAcl, newAcl);
+  }
+  for (const auto& acl : changes.added) {
+    processAddedAcl(acl);
+  }
 }
 
 void BcmSwitch::processAggregatePortChanges(const StateDelta& delta) {
@@ -2583,6 +2647,10 @@ uint64_t BcmSwitch::getDeviceWatermarkBytes() const {
   return bstStatsMgr_->getDeviceWatermarkBytes();
 }
 
+BufferWatermarkSampler* BcmSwitch::getBufferWatermarkSampler() const {
+  return bstStatsMgr_->getWatermarkSampler();
+}
+
 bcm_if_t BcmSwitch::getDropEgressId() const {
   return platform_->getAsic()->getDefaultDropEgressID();
 }
@@ -3223,13 +3291,14 @@ void BcmSwitch::fetchL2Table(std::vector<L2EntryThrift>* l2Table) const {
   bcmCheckError(rv, "bcm_l2_traverse failed");
 }
 
-void BcmSwitch::processChangedAcl(
+void BcmSwitch::processChangedAclPriority(
     const std::shared_ptr<AclEntry>& oldAcl,
     const std::shared_ptr<AclEntry>& newAcl) {
-  // Unfortunately, we cannot modify a field entry due to BCM limitation
-  XLOG(DBG3) << "processChangedAcl, ACL=" << oldAcl->getID();
-  processRemovedAcl(oldAcl);
-  processAddedAcl(newAcl);
+  // Unlike other fields, priority of a field entry can be changed in place
+  XLOG(DBG3) << "processChangedAclPriority, ACL=" << oldAcl->getID()
+             << " priority " << oldAcl->getPriority() << " -> "
+             << newAcl->getPriority();
+  aclTable_->processChangedAclPriority(oldAcl, newAcl);
 }
 
 void BcmSwitch::processRemovedAcl(const std::shared_ptr<AclEntry>& acl) {
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <folly/concurrency/AtomicSharedPtr.h>
 #include <folly/dynamic.h>
 #include <folly/io/async/EventBase.h>
 #include <gtest/gtest_prod.h>
@@ -70,6 +71,7 @@ class BcmRxPacket;
 class BcmStatUpdater;
 class BcmSwitchEventCallback;
 class BcmTrunkTable;
+class BcmTxPacketPool;
 class BcmUnit;
 class BcmWarmBootCache;
 class BcmWarmBootHelper;
@@ -380,6 +382,7 @@ class BcmSwitch : public BcmSwitchIf {
   folly::F14FastMap<std::string, HwPortStats> getPortStats() const override;
 
   uint64_t getDeviceWatermarkBytes() const override;
+  BufferWatermarkSampler* getBufferWatermarkSampler() const override;
 
   /*
    * Wrapper functions to register and unregister a BCM event callbacks.  These
@@ -573,7 +576,23 @@ class BcmSwitch : public BcmSwitchIf {
 
   bool usePKTIO() const;
 
+  /*
+   * Pre-allocated packets for bcm_tx. nullptr with PKTIO, or if tx packets
+   * are always allocated on demand. Packets are sent and freed by other
+   * threads while the switch exits, so callers hold on to the pool only
+   * for as long as they use it.
+   */
+  std::shared_ptr<BcmTxPacketPool> getTxPacketPool() const {
+    return txPacketPool_.load();
+  }
+
  private:
+  /*
+   * Frees the pooled packets, once no tx path uses the pool anymore. Must be
+   * done before the unit is detached.
+   */
+  void releaseTxPacketPool();
+
   enum Flags : uint32_t {
     RX_REGISTERED = 0x01,
     LINKSCAN_REGISTERED = 0x02,
@@ -682,7 +701,7 @@ class BcmSwitch : public BcmSwitchIf {
   void processQosChanges(const StateDelta& delta);
 
   void processAclChanges(const StateDelta& delta);
-  void processChangedAcl(
+  void processChangedAclPriority(
       const std::shared_ptr<AclEntry>& oldAcl,
       const std::shared_ptr<AclEntry>& newAcl);
   void processAddedAcl(const std::shared_ptr<AclEntry>& acl);
@@ -1003,6 +1022,7 @@ class BcmSwitch : public BcmSwitchIf {
   std::unique_ptr<BcmMacTable> macTable_;
 
   std::unique_ptr<BcmUnit> unitObject_;
+  folly::atomic_shared_ptr<BcmTxPacketPool> txPacketPool_;
   BootType bootType_{BootType::UNINITIALIZED};
   int64_t bstStatsUpdateTime_{0};
   std::unique_ptr<BcmQcmManager> qcmManager_;
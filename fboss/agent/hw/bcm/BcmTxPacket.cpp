@@ -14,6 +14,7 @@
 
 #include "fboss/agent/hw/HwSwitchStats.h"
 #include "fboss/agent/hw/bcm/BcmError.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
 #include "fboss/agent/packet/EthHdr.h"
 #include "fboss/agent/packet/PktUtil.h"
 
@@ -40,7 +41,12 @@ void freeTxBuf(void* /*ptr*/, void* arg) {
   int rv;
   if (!bcmPacket.usePktIO) {
     bcm_pkt_t* pkt = bcmPacket.ptrUnion.pkt;
-    rv = bcm_pkt_free(pkt->unit, pkt);
+    auto pool = freeTxBufUserData->bcmSwitch->getTxPacketPool();
+    if (pool && pool->release(pkt)) {
+      rv = BCM_E_NONE;
+    } else {
+      rv = bcm_pkt_free(pkt->unit, pkt);
+    }
   } else {
 #ifdef INCLUDE_PKTIO
     bcm_pktio_pkt_t* pktioPkt = bcmPacket.ptrUnion.pktioPkt;
@@ -106,19 +112,29 @@ BcmTxPacket::BcmTxPacket(int unit, uint32_t size, const BcmSwitch* bcmSwitch)
   bcmPacket_.usePktIO = usePktIO;
   if (!usePktIO) {
     bcmPacket_.ptrUnion.pkt = nullptr;
-    rv = bcm_pkt_alloc(
-        unit,
-        size,
-        BCM_TX_CRC_APPEND | BCM_TX_ETHER,
-        &(bcmPacket_.ptrUnion.pkt));
-    if (BCM_FAILURE(rv)) {
-      bcmSwitch->getSwitchStats()->txPktAllocErrors();
-      bcmCheckError(rv, "Failed to allocate packet.");
-    } else {
-      bcm_pkt_t* pkt = bcmPacket_.ptrUnion.pkt;
-      CHECK_NOTNULL(pkt);
-      bufData = pkt->pkt_data->data;
+    if (auto pool = bcmSwitch->getTxPacketPool()) {
+      bcmPacket_.ptrUnion.pkt = pool->alloc(size, &allocatedCapacity);
+      if (bcmPacket_.ptrUnion.pkt) {
+        bcmSwitch->getSwitchStats()->txPktPoolHit();
+      } else {
+        bcmSwitch->getSwitchStats()->txPktPoolMiss();
+      }
+    }
+    if (!bcmPacket_.ptrUnion.pkt) {
+      // Not pooled, or the pool is out of packets of this size
+      rv = bcm_pkt_alloc(
+          unit,
+          size,
+          BCM_TX_CRC_APPEND | BCM_TX_ETHER,
+          &(bcmPacket_.ptrUnion.pkt));
+      if (BCM_FAILURE(rv)) {
+        bcmSwitch->getSwitchStats()->txPktAllocErrors();
+        bcmCheckError(rv, "Failed to allocate packet.");
+      }
     }
+    bcm_pkt_t* pkt = bcmPacket_.ptrUnion.pkt;
+    CHECK_NOTNULL(pkt);
+    bufData = pkt->pkt_data->data;
   } else {
 #ifdef INCLUDE_PKTIO
     if (size < ETH_ZLEN + 4) {
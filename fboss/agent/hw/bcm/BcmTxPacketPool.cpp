@@ -0,0 +1,107 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
+
+#include "fboss/agent/hw/bcm/BcmError.h"
+
+#include <folly/logging/xlog.h>
+
+namespace {
+constexpr uint32_t kTxPktFlags = BCM_TX_CRC_APPEND | BCM_TX_ETHER;
+} // namespace
+
+namespace facebook::fboss {
+
+BcmTxPacketPool::BcmTxPacketPool(int unit, uint32_t packetsPerClass)
+    : unit_(unit) {
+  for (size_t i = 0; i < kSizeClasses.size(); ++i) {
+    auto& free = sizeClasses_[i].free;
+    free.reserve(packetsPerClass);
+    for (uint32_t j = 0; j < packetsPerClass; ++j) {
+      bcm_pkt_t* pkt = nullptr;
+      auto rv = bcm_pkt_alloc(unit_, kSizeClasses[i], kTxPktFlags, &pkt);
+      if (BCM_FAILURE(rv)) {
+        // Run with a smaller pool, packets that do not fit fall back to
+        // allocating on demand
+        bcmLogError(rv, "Failed to pre-allocate tx packet");
+        break;
+      }
+      packets_.emplace(pkt, PooledPacket{i, pkt->pkt_data->data});
+      free.push_back(pkt);
+    }
+  }
+  XLOG(DBG2) << "Pre-allocated " << packets_.size() << " tx packets";
+}
+
+BcmTxPacketPool::~BcmTxPacketPool() {
+  // Packets still out for tx are not from the pool anymore once it is gone,
+  // and are freed to the SDK when done.
+  for (auto& sizeClass : sizeClasses_) {
+    std::lock_guard<std::mutex> g(sizeClass.lock);
+    for (auto pkt : sizeClass.free) {
+      auto rv = bcm_pkt_free(unit_, pkt);
+      bcmLogError(rv, "Failed to free pooled tx packet");
+    }
+    sizeClass.free.clear();
+  }
+}
+
+bcm_pkt_t* BcmTxPacketPool::alloc(uint32_t size, uint32_t* capacity) {
+  for (size_t i = 0; i < kSizeClasses.size(); ++i) {
+    if (size > kSizeClasses[i]) {
+      continue;
+    }
+    // Only use the smallest class that fits, so that large buffers are kept
+    // for large packets
+    auto& sizeClass = sizeClasses_[i];
+    std::lock_guard<std::mutex> g(sizeClass.lock);
+    if (sizeClass.free.empty()) {
+      return nullptr;
+    }
+    auto pkt = sizeClass.free.back();
+    sizeClass.free.pop_back();
+    *capacity = kSizeClasses[i];
+    return pkt;
+  }
+  return nullptr;
+}
+
+bool BcmTxPacketPool::release(bcm_pkt_t* pkt) {
+  auto iter = packets_.find(pkt);
+  if (iter == packets_.end()) {
+    return false;
+  }
+  const auto& pooled = iter->second;
+  // Undo what BcmTxPacket sets for a send, leaving the packet as it was when
+  // first allocated
+  bcm_pkt_flags_init(unit_, pkt, kTxPktFlags);
+  BCM_PBMP_CLEAR(pkt->tx_pbmp);
+  BCM_PBMP_CLEAR(pkt->tx_upbmp);
+  pkt->cos = 0;
+  pkt->call_back = nullptr;
+  pkt->pkt_data->data = pooled.data;
+  pkt->pkt_data->len = kSizeClasses[pooled.sizeClass];
+
+  auto& sizeClass = sizeClasses_[pooled.sizeClass];
+  std::lock_guard<std::mutex> g(sizeClass.lock);
+  sizeClass.free.push_back(pkt);
+  return true;
+}
+
+size_t BcmTxPacketPool::getFreeCount() const {
+  size_t count = 0;
+  for (auto& sizeClass : sizeClasses_) {
+    std::lock_guard<std::mutex> g(sizeClass.lock);
+    count += sizeClass.free.size();
+  }
+  return count;
+}
+
+} // namespace facebook::fboss
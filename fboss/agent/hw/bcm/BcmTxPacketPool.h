@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include <bcm/pkt.h>
+#include <bcm/types.h>
+}
+
+namespace facebook::fboss {
+
+/*
+ * Pool of pre-allocated SDK tx packets, so that sending a packet does not
+ * need a DMA buffer allocation and free from the SDK.
+ *
+ * Packets are kept in a few size classes. A packet is handed out from the
+ * smallest class that fits the requested size, and goes back to its class
+ * once the tx completes. When the class is exhausted, or the packet is larger
+ * than the largest class, alloc() returns nullptr and the caller falls back
+ * to allocating the packet from the SDK.
+ *
+ * Only used for the bcm_tx path: PKTIO packets are not pooled.
+ */
+class BcmTxPacketPool {
+ public:
+  static constexpr std::array<uint32_t, 3> kSizeClasses = {256, 512, 1600};
+
+  BcmTxPacketPool(int unit, uint32_t packetsPerClass);
+  ~BcmTxPacketPool();
+
+  /*
+   * Returns a packet with a buffer of at least size bytes, and sets capacity
+   * to the size of its buffer. Returns nullptr if no pooled packet is free.
+   */
+  bcm_pkt_t* alloc(uint32_t size, uint32_t* capacity);
+
+  /*
+   * Returns the packet to its size class, resetting what was set on it for
+   * the last tx. Returns false if the packet is not from this pool, in which
+   * case the caller still owns it.
+   */
+  bool release(bcm_pkt_t* pkt);
+
+  // Pooled packets not handed out right now
+  size_t getFreeCount() const;
+
+ private:
+  struct PooledPacket {
+    size_t sizeClass;
+    uint8_t* data;
+  };
+  struct SizeClass {
+    mutable std::mutex lock;
+    std::vector<bcm_pkt_t*> free;
+  };
+
+  // Forbidden copy constructor and assignment operator
+  BcmTxPacketPool(BcmTxPacketPool const&) = delete;
+  BcmTxPacketPool& operator=(BcmTxPacketPool const&) = delete;
+
+  const int unit_;
+  // All packets owned by the pool. Filled in at construction and read-only
+  // afterwards, so lookups need no lock.
+  std::unordered_map<const bcm_pkt_t*, PooledPacket> packets_;
+  std::array<SizeClass, kSizeClasses.size()> sizeClasses_;
+};
+
+} // namespace facebook::fboss
@@ -14,7 +14,10 @@
 namespace facebook::fboss {
 
 BcmBstStatsMgr::BcmBstStatsMgr(BcmSwitch* hw)
-    : hw_(hw), bufferStatsLogger_(std::make_unique<GlogBufferStatsLogger>()) {}
+    : hw_(hw),
+      bufferStatsLogger_(std::make_unique<GlogBufferStatsLogger>()),
+      watermarkSampler_(std::make_unique<BufferWatermarkSampler>(
+          std::make_unique<BcmBufferWatermarkReader>(hw))) {}
 
 void BcmBstStatsMgr::publishQueueuWatermark(
     const std::string& /*portName*/,
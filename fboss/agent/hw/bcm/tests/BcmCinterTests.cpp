@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/bcm/BcmCinter.h"
+
+#include <folly/FileUtil.h>
+#include <folly/String.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+struct ibde_t;
+ibde_t* bde;
+}
+
+DECLARE_bool(enable_bcm_cinter);
+DECLARE_bool(bcm_cinter_binary);
+DECLARE_string(cint_file);
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kUnit = 0;
+constexpr bcm_if_t kIntf = 100002;
+
+// Route, host and egress calls, with a text only call in between
+void makeCalls(BcmCinter& cinter) {
+  bcm_l3_egress_t egress;
+  bcm_l3_egress_t_init(&egress);
+  egress.intf = kIntf;
+  egress.port = 1;
+  bcm_if_t egressId = 100010;
+  cinter.bcm_l3_egress_create(kUnit, 0, &egress, &egressId);
+
+  bcm_l3_route_t v4Route;
+  bcm_l3_route_t_init(&v4Route);
+  v4Route.l3a_subnet = 0x0a000000;
+  v4Route.l3a_ip_mask = 0xffffff00;
+  v4Route.l3a_intf = egressId;
+  cinter.bcm_l3_route_add(kUnit, &v4Route);
+
+  bcm_l3_route_t v6Route;
+  bcm_l3_route_t_init(&v6Route);
+  v6Route.l3a_flags = BCM_L3_IP6;
+  std::memset(v6Route.l3a_ip6_net, 0, sizeof(v6Route.l3a_ip6_net));
+  v6Route.l3a_ip6_net[0] = 0x24;
+  v6Route.l3a_ip6_net[1] = 0x01;
+  std::memset(v6Route.l3a_ip6_mask, 0xff, 8);
+  v6Route.l3a_intf = egressId;
+  cinter.bcm_l3_route_add(kUnit, &v6Route);
+
+  cinter.bcm_l3_route_max_ecmp_set(kUnit, 64);
+
+  bcm_l3_host_t v4Host;
+  bcm_l3_host_t_init(&v4Host);
+  v4Host.l3a_ip_addr = 0x0a000001;
+  v4Host.l3a_intf = egressId;
+  cinter.bcm_l3_host_add(kUnit, &v4Host);
+
+  bcm_l3_host_t v6Host;
+  bcm_l3_host_t_init(&v6Host);
+  v6Host.l3a_flags = BCM_L3_IP6;
+  v6Host.l3a_ip6_addr[0] = 0x24;
+  v6Host.l3a_ip6_addr[15] = 0x01;
+  v6Host.l3a_intf = egressId;
+  cinter.bcm_l3_host_add(kUnit, &v6Host);
+
+  cinter.bcm_l3_host_delete(kUnit, &v6Host);
+  cinter.bcm_l3_host_delete(kUnit, &v4Host);
+  cinter.bcm_l3_route_delete(kUnit, &v6Route);
+  cinter.bcm_l3_route_delete(kUnit, &v4Route);
+  cinter.bcm_l3_egress_destroy(kUnit, egressId);
+}
+
+// Make the calls through a cinter of its own, and return what it logged
+std::string record(const std::string& cintFile, bool binary) {
+  FLAGS_enable_bcm_cinter = true;
+  FLAGS_bcm_cinter_binary = binary;
+  FLAGS_cint_file = cintFile;
+  {
+    BcmCinter cinter;
+    makeCalls(cinter);
+  }
+  std::string recording;
+  if (!folly::readFile(cintFile.c_str(), recording)) {
+    throw FbossError("Failed to read ", cintFile);
+  }
+  return recording;
+}
+
+// Boot headers have the time of the boot, which differs between runs
+std::string withoutBootHeaders(const std::string& cint) {
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', cint, lines);
+  std::string result;
+  for (auto line : lines) {
+    if (!line.startsWith("//")) {
+      result.append(line.begin(), line.end());
+      result.push_back('\n');
+    }
+  }
+  return result;
+}
+
+std::string convert(const std::string& recording) {
+  // Conversion only renders calls, so needs no cinter log of its own
+  FLAGS_enable_bcm_cinter = false;
+  BcmCinter cinter;
+  return cinter.convertRecording(
+      folly::ByteRange(folly::StringPiece(recording)));
+}
+
+} // namespace
+
+class BcmCinterTest : public ::testing::Test {
+ protected:
+  std::string cintFile(const std::string& name) const {
+    return (tmpDir_.path() / name).string();
+  }
+
+ private:
+  gflags::FlagSaver flagSaver_;
+  folly::test::TemporaryDirectory tmpDir_;
+};
+
+TEST_F(BcmCinterTest, convertedRecordingMatchesTextMode) {
+  auto text = record(cintFile("text_cint.log"), false);
+  auto recording = record(cintFile("binary_cint.log"), true);
+  auto converted = convert(recording);
+  EXPECT_NE(text.find("bcm_l3_route_add"), std::string::npos);
+  EXPECT_EQ(withoutBootHeaders(converted), withoutBootHeaders(text));
+  // Hot path calls are not rendered in the recording
+  EXPECT_EQ(recording.find("bcm_l3_route_add"), std::string::npos);
+}
+
+TEST_F(BcmCinterTest, textModeCintInRecording) {
+  auto recording = record(cintFile("binary_cint.log"), true);
+  auto text = record(cintFile("text_cint.log"), false);
+  // An earlier boot in text mode, followed by one in binary mode
+  EXPECT_THROW(convert(text + recording), FbossError);
+  // And the other way around
+  EXPECT_THROW(convert(recording + text), FbossError);
+  EXPECT_NO_THROW(convert(recording));
+}
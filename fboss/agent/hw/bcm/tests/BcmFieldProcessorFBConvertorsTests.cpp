@@ -33,6 +33,8 @@ TEST(FPBcmConvertors, priorityToFromBcm) {
   for (auto pri : {10, 99, 1001}) {
     EXPECT_EQ(pri, hwPriorityToSwPriority(swPriorityToHwPriority(pri)));
   }
+  EXPECT_THROW(swPriorityToHwPriority(-1), FbossError);
+  EXPECT_THROW(swPriorityToHwPriority(1000001), FbossError);
 }
 
 TEST(FPBcmConvertors, cfgIpFragToFromBcm) {
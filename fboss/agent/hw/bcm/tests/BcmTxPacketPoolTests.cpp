@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/bcm/tests/BcmTest.h"
+
+#include "fboss/agent/hw/HwSwitchStats.h"
+#include "fboss/agent/hw/bcm/BcmSwitch.h"
+#include "fboss/agent/hw/bcm/BcmTxPacketPool.h"
+
+#include <vector>
+
+namespace facebook::fboss {
+
+class BcmTxPacketPoolTest : public BcmTest {
+ protected:
+  std::shared_ptr<BcmTxPacketPool> getPool() const {
+    return getHwSwitch()->getTxPacketPool();
+  }
+};
+
+TEST_F(BcmTxPacketPoolTest, PacketsReturnToPool) {
+  auto setup = [] {};
+  auto verify = [this] {
+    if (!getPool()) {
+      // PKTIO, or pooling disabled
+      return;
+    }
+    auto stats = getHwSwitch()->getSwitchStats();
+    auto freeBefore = getPool()->getFreeCount();
+    auto hitsBefore = stats->getTxPktPoolHitCount();
+    {
+      auto pkt = getHwSwitch()->allocatePacket(64);
+      EXPECT_EQ(getPool()->getFreeCount(), freeBefore - 1);
+    }
+    EXPECT_EQ(getPool()->getFreeCount(), freeBefore);
+    EXPECT_EQ(stats->getTxPktPoolHitCount() - hitsBefore, 1);
+  };
+  verifyAcrossWarmBoots(setup, verify);
+}
+
+TEST_F(BcmTxPacketPoolTest, FallBackWhenExhausted) {
+  auto setup = [] {};
+  auto verify = [this] {
+    if (!getPool()) {
+      return;
+    }
+    auto stats = getHwSwitch()->getSwitchStats();
+    auto missesBefore = stats->getTxPktPoolMissCount();
+    std::vector<std::unique_ptr<TxPacket>> pkts;
+    // Larger than the largest size class, never pooled
+    pkts.push_back(getHwSwitch()->allocatePacket(
+        BcmTxPacketPool::kSizeClasses.back() + 1));
+    EXPECT_EQ(stats->getTxPktPoolMissCount() - missesBefore, 1);
+    // Drain the smallest size class
+    auto hitsBefore = stats->getTxPktPoolHitCount();
+    while (stats->getTxPktPoolMissCount() - missesBefore < 2) {
+      pkts.push_back(getHwSwitch()->allocatePacket(64));
+    }
+    EXPECT_GT(stats->getTxPktPoolHitCount(), hitsBefore);
+    // Packets allocated on demand are usable all the same
+    EXPECT_EQ(pkts.back()->buf()->length(), 64);
+  };
+  verifyAcrossWarmBoots(setup, verify);
+}
+
+} // namespace facebook::fboss
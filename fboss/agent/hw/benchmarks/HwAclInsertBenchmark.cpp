@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/Platform.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Benchmark.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+namespace {
+constexpr int kNumAcls = 2000;
+constexpr int kNumInserts = 100;
+
+cfg::AclEntry makeAcl(const std::string& name, int l4DstPort) {
+  cfg::AclEntry acl;
+  *acl.name_ref() = name;
+  *acl.actionType_ref() = cfg::AclActionType::DENY;
+  acl.proto_ref() = 6;
+  acl.l4DstPort_ref() = l4DstPort;
+  return acl;
+}
+} // namespace
+
+/*
+ * Start with a 2k entry ACL table, then push kNumInserts configs each
+ * inserting one ACL ahead of all others. With priorities allocated gap
+ * apart only the inserted ACL should be programmed, rather than every
+ * ACL in the table.
+ */
+BENCHMARK(HwAclInsertAtTop) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble({});
+  auto hwSwitch = ensemble->getHwSwitch();
+  auto config = utility::onePortPerVlanConfig(
+      hwSwitch, {ensemble->masterLogicalPortIds()[0]});
+  for (int i = 0; i < kNumAcls; ++i) {
+    config.acls_ref()->push_back(
+        makeAcl(folly::to<std::string>("acl", i), i + 1));
+  }
+  ensemble->applyInitialConfig(config);
+
+  size_t numAdded = 0, numMoved = 0, numRemoved = 0;
+  for (int i = 0; i < kNumInserts; ++i) {
+    auto& acls = *config.acls_ref();
+    acls.insert(
+        acls.begin(),
+        makeAcl(folly::to<std::string>("inserted", i), kNumAcls + i + 1));
+    auto oldState = ensemble->getProgrammedState();
+    suspender.dismiss();
+    auto newState = ensemble->applyNewConfig(config);
+    suspender.rehire();
+    OrderedAclChanges changes(StateDelta(oldState, newState).getAclsDelta());
+    numAdded += changes.added.size();
+    numMoved += changes.moved.size();
+    numRemoved += changes.removed.size();
+  }
+  XLOG(INFO) << "ACLs programmed over " << kNumInserts
+             << " inserts, added: " << numAdded << " moved: " << numMoved
+             << " removed: " << numRemoved;
+}
+
+} // namespace facebook::fboss
@@ -22,9 +22,16 @@
 
 #include <folly/Benchmark.h>
 #include <folly/IPAddress.h>
+#include <gflags/gflags.h>
 
 #include <thread>
 
+// ECMP shrink latency should not grow with the size of the competing update
+DEFINE_int32(
+    competing_route_updates,
+    10'000,
+    "Number of routes programmed while the ECMP group shrinks");
+
 namespace facebook::fboss {
 
 using utility::getEcmpSizeInHw;
@@ -56,9 +63,9 @@ BENCHMARK(HwEcmpGroupShrinkWithCompetingRouteUpdates) {
   ensemble->getLatestPortStats(ensemble->masterLogicalPortIds());
   auto routeChunks = utility::RouteDistributionGenerator(
                          ensemble->getProgrammedState(),
-                         {{64, 10'000}},
+                         {{64, FLAGS_competing_route_updates}},
                          {{}},
-                         10'000,
+                         FLAGS_competing_route_updates,
                          4,
                          RouterID(0))
                          .getThriftRoutes();
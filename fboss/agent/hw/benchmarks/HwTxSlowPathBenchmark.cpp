@@ -20,6 +20,7 @@
 #include <folly/dynamic.h>
 #include <folly/init/Init.h>
 #include <folly/json.h>
+#include <gflags/gflags.h>
 
 #include <chrono>
 #include <iostream>
@@ -40,25 +41,27 @@ std::pair<uint64_t, uint64_t> getOutPktsAndBytes(
   return {*stats.outUnicastPkts__ref(), *stats.outBytes__ref()};
 }
 
-void runTxSlowPathBenchmark() {
-  constexpr int kEcmpWidth = 1;
-  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
-  auto hwSwitch = ensemble->getHwSwitch();
-  auto portUsed = ensemble->masterLogicalPortIds()[0];
-  auto config = utility::oneL3IntfConfig(hwSwitch, portUsed);
-  ensemble->applyInitialConfig(config);
-  auto ecmpHelper =
-      utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
+struct TxRate {
+  uint32_t pps;
+  uint32_t bytesPerSec;
+  // Rate at which the sending thread got packets accepted by the HwSwitch
+  uint32_t acceptedPps;
+};
 
-  ensemble->applyNewState(
-      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth));
-  ecmpHelper.programRoutes(
-      std::make_unique<HwSwitchEnsembleRouteUpdateWrapper>(
-          ensemble->getRouteUpdater()),
-      kEcmpWidth);
+/*
+ * Flood packets from the CPU through the pipeline, with either the sync or
+ * the async HwSwitch send API, and measure the rate packets egress at.
+ */
+TxRate measureTxRate(
+    HwSwitchEnsemble* ensemble,
+    const cfg::SwitchConfig& config,
+    PortID portUsed,
+    bool async) {
+  auto hwSwitch = ensemble->getHwSwitch();
   auto cpuMac = ensemble->getPlatform()->getLocalMac();
   std::atomic<bool> packetTxDone{false};
-  std::thread t([cpuMac, hwSwitch, &config, &packetTxDone]() {
+  std::atomic<uint64_t> accepted{0};
+  std::thread t([cpuMac, hwSwitch, &config, &packetTxDone, &accepted, async]() {
     const auto kSrcIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::3");
     const auto kDstIp = folly::IPAddressV6("2620:0:1cfe:face:b00c::4");
     const auto kSrcMac = folly::MacAddress{"fa:ce:b0:00:00:0c"};
@@ -72,39 +75,79 @@ void runTxSlowPathBenchmark() {
             cpuMac,
             kSrcIp,
             kDstIp);
-        hwSwitch->sendPacketSwitchedAsync(std::move(txPacket));
+        auto sent = async
+            ? hwSwitch->sendPacketSwitchedAsync(std::move(txPacket))
+            : hwSwitch->sendPacketSwitchedSync(std::move(txPacket));
+        accepted += sent;
       }
     }
   });
 
-  auto [pktsBefore, bytesBefore] =
-      getOutPktsAndBytes(ensemble.get(), PortID(portUsed));
+  auto [pktsBefore, bytesBefore] = getOutPktsAndBytes(ensemble, portUsed);
+  auto acceptedBefore = accepted.load();
   auto timeBefore = std::chrono::steady_clock::now();
   // Let the packet flood warm up
   std::this_thread::sleep_for(std::chrono::seconds(5));
-  auto [pktsAfter, bytesAfter] =
-      getOutPktsAndBytes(ensemble.get(), PortID(portUsed));
+  auto [pktsAfter, bytesAfter] = getOutPktsAndBytes(ensemble, portUsed);
+  auto acceptedAfter = accepted.load();
   auto timeAfter = std::chrono::steady_clock::now();
   packetTxDone = true;
   t.join();
   std::chrono::duration<double, std::milli> durationMillseconds =
       timeAfter - timeBefore;
-  uint32_t pps = (static_cast<double>(pktsAfter - pktsBefore) /
-                  durationMillseconds.count()) *
-      1000;
-  uint32_t bytesPerSec = (static_cast<double>(bytesAfter - bytesBefore) /
-                          durationMillseconds.count()) *
-      1000;
+  auto perSec = [&durationMillseconds](uint64_t count) -> uint32_t {
+    return (static_cast<double>(count) / durationMillseconds.count()) * 1000;
+  };
+  TxRate rate{
+      perSec(pktsAfter - pktsBefore),
+      perSec(bytesAfter - bytesBefore),
+      perSec(acceptedAfter - acceptedBefore)};
+  XLOG(DBG2) << (async ? "Async" : "Sync") << " pkts before: " << pktsBefore
+             << " Pkts after: " << pktsAfter
+             << " interval ms: " << durationMillseconds.count();
+  return rate;
+}
+
+void runTxSlowPathBenchmark() {
+  constexpr int kEcmpWidth = 1;
+  // SaiSwitch only queues async sends when created with --sai_async_tx,
+  // and sends them on the caller's thread otherwise. Set it by name, since
+  // the flag does not exist in BCM builds of this benchmark.
+  gflags::SetCommandLineOption("sai_async_tx", "true");
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto hwSwitch = ensemble->getHwSwitch();
+  auto portUsed = ensemble->masterLogicalPortIds()[0];
+  auto config = utility::oneL3IntfConfig(hwSwitch, portUsed);
+  ensemble->applyInitialConfig(config);
+  auto ecmpHelper =
+      utility::EcmpSetupAnyNPorts6(ensemble->getProgrammedState());
+
+  ensemble->applyNewState(
+      ecmpHelper.resolveNextHops(ensemble->getProgrammedState(), kEcmpWidth));
+  ecmpHelper.programRoutes(
+      std::make_unique<HwSwitchEnsembleRouteUpdateWrapper>(
+          ensemble->getRouteUpdater()),
+      kEcmpWidth);
+
+  auto syncRate =
+      measureTxRate(ensemble.get(), config, PortID(portUsed), false);
+  auto asyncRate =
+      measureTxRate(ensemble.get(), config, PortID(portUsed), true);
 
   if (FLAGS_json) {
     folly::dynamic cpuTxRateJson = folly::dynamic::object;
-    cpuTxRateJson["cpu_tx_pps"] = pps;
-    cpuTxRateJson["cpu_tx_bytes_per_sec"] = bytesPerSec;
+    cpuTxRateJson["cpu_tx_pps"] = asyncRate.pps;
+    cpuTxRateJson["cpu_tx_bytes_per_sec"] = asyncRate.bytesPerSec;
+    cpuTxRateJson["cpu_tx_accepted_pps"] = asyncRate.acceptedPps;
+    cpuTxRateJson["cpu_tx_sync_pps"] = syncRate.pps;
+    cpuTxRateJson["cpu_tx_sync_bytes_per_sec"] = syncRate.bytesPerSec;
     std::cout << toPrettyJson(cpuTxRateJson) << std::endl;
   } else {
-    XLOG(INFO) << " Pkts before: " << pktsBefore << " Pkts after: " << pktsAfter
-               << " interval ms: " << durationMillseconds.count()
-               << " pps: " << pps << " bytes per sec: " << bytesPerSec;
+    XLOG(INFO) << " Async pps: " << asyncRate.pps
+               << " bytes per sec: " << asyncRate.bytesPerSec
+               << " accepted pps: " << asyncRate.acceptedPps
+               << " Sync pps: " << syncRate.pps
+               << " bytes per sec: " << syncRate.bytesPerSec;
   }
 }
 } // namespace facebook::fboss
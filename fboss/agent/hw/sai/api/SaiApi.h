@@ -12,6 +12,7 @@
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
 #include "fboss/agent/hw/sai/api/SaiApiError.h"
 #include "fboss/agent/hw/sai/api/SaiApiLock.h"
+#include "fboss/agent/hw/sai/api/SaiApiStats.h"
 #include "fboss/agent/hw/sai/api/SaiAttribute.h"
 #include "fboss/agent/hw/sai/api/SaiAttributeDataTypes.h"
 #include "fboss/agent/hw/sai/api/Traits.h"
@@ -22,6 +23,7 @@
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
+#include <chrono>
 #include <exception>
 #include <mutex>
 #include <stdexcept>
@@ -87,12 +89,10 @@ class SaiApi {
           createAttributes);
     }
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
-    sai_status_t status;
-    {
-      TIME_CALL;
-      status = impl()._create(
+    auto status = timedCall(SaiApiOp::CREATE, [&] {
+      return impl()._create(
           &key, switch_id, saiAttributeTs.size(), saiAttributeTs.data());
-    }
+    });
     saiApiCheckError(
         status,
         apiType(),
@@ -122,12 +122,10 @@ class SaiApi {
           createAttributes);
     }
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
-    sai_status_t status;
-    {
-      TIME_CALL;
-      status =
-          impl()._create(entry, saiAttributeTs.size(), saiAttributeTs.data());
-    }
+    auto status = timedCall(SaiApiOp::CREATE, [&] {
+      return impl()._create(
+          entry, saiAttributeTs.size(), saiAttributeTs.data());
+    });
     saiApiCheckError(
         status,
         apiType(),
@@ -148,11 +146,8 @@ class SaiApi {
           key);
     }
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
-    sai_status_t status;
-    {
-      TIME_CALL;
-      status = impl()._remove(key);
-    }
+    auto status =
+        timedCall(SaiApiOp::REMOVE, [&] { return impl()._remove(key); });
     saiApiCheckError(
         status,
         apiType(),
@@ -182,11 +177,9 @@ class SaiApi {
         "getAttribute must be called on a SaiAttribute or supported "
         "collection of SaiAttributes");
     std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
-    sai_status_t status;
-    {
-      TIME_CALL;
-      status = impl()._getAttribute(key, attr.saiAttr());
-    }
+    auto status = timedCall(SaiApiOp::GET, [&] {
+      return impl()._getAttribute(key, attr.saiAttr());
+    });
     /*
      * If this is a list attribute and we have not allocated enough
      * memory for the data coming from SAI, the Adapter will return
@@ -196,10 +189,9 @@ class SaiApi {
      */
     if (status == SAI_STATUS_BUFFER_OVERFLOW) {
       attr.realloc();
-      {
-        TIME_CALL;
-        status = impl()._getAttribute(key, attr.saiAttr());
-      }
+      status = timedCall(SaiApiOp::GET, [&] {
+        return impl()._getAttribute(key, attr.saiAttr());
+      });
     }
     if constexpr (!std::remove_reference_t<AttrT>::HasDefaultGetter) {
       saiApiCheckError(
@@ -308,11 +300,9 @@ class SaiApi {
             key);
       }
     }
-    sai_status_t status;
-    {
-      TIME_CALL;
-      status = impl()._setAttribute(key, saiAttr(attr));
-    }
+    auto status = timedCall(SaiApiOp::SET, [&] {
+      return impl()._setAttribute(key, saiAttr(attr));
+    });
     saiApiCheckError(
         status,
         apiType(),
@@ -404,12 +394,10 @@ class SaiApi {
     std::vector<uint64_t> counters;
     if (numCounters) {
       counters.resize(numCounters);
-      sai_status_t status;
-      {
-        TIME_CALL
-        status = impl()._getStats(
+      auto status = timedCall(SaiApiOp::GET_STATS, [&] {
+        return impl()._getStats(
             key, counters.size(), counterIds, mode, counters.data());
-      }
+      });
       saiApiCheckError(
           status, apiType(), fmt::format("Failed to get stats {}", key));
       saiApiCheckError(status, apiType(), "Failed to get stats");
@@ -431,14 +419,23 @@ class SaiApi {
             "Attempting clear stats {} , while hw writes are blocked",
             saiApiTypeToString(apiType()));
       }
-      sai_status_t status;
-      {
-        TIME_CALL
-        status = impl()._clearStats(key, numCounters, counterIds);
-      }
+      auto status = timedCall(SaiApiOp::CLEAR_STATS, [&] {
+        return impl()._clearStats(key, numCounters, counterIds);
+      });
       saiApiCheckError(status, apiType(), "Failed to clear stats");
     }
   }
+  template <typename CallFn>
+  sai_status_t timedCall(SaiApiOp op, CallFn&& call) const {
+    TIME_CALL;
+    auto begin = std::chrono::steady_clock::now();
+    sai_status_t status = call();
+    if (apiStats_) {
+      apiStats_->record(
+          apiType(), op, std::chrono::steady_clock::now() - begin, status);
+    }
+    return status;
+  }
   ApiT& impl() {
     return static_cast<ApiT&>(*this);
   }
@@ -446,6 +443,7 @@ class SaiApi {
     return static_cast<const ApiT&>(*this);
   }
   HwWriteBehavior hwWriteBehavior_{HwWriteBehavior::WRITE};
+  const std::shared_ptr<SaiApiStats> apiStats_{SaiApiStats::getInstance()};
 };
 
 } // namespace facebook::fboss
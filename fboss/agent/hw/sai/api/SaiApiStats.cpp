@@ -0,0 +1,188 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/SaiApiStats.h"
+
+#include <folly/Singleton.h>
+#include <folly/lang/Bits.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+struct singleton_tag_type {};
+} // namespace
+
+using facebook::fboss::SaiApiStats;
+static folly::Singleton<SaiApiStats, singleton_tag_type> saiApiStatsSingleton{};
+std::shared_ptr<SaiApiStats> SaiApiStats::getInstance() {
+  return saiApiStatsSingleton.try_get();
+}
+
+namespace facebook::fboss {
+
+folly::StringPiece saiApiOpToString(SaiApiOp op) {
+  switch (op) {
+    case SaiApiOp::CREATE:
+      return "create";
+    case SaiApiOp::REMOVE:
+      return "remove";
+    case SaiApiOp::SET:
+      return "set";
+    case SaiApiOp::GET:
+      return "get";
+    case SaiApiOp::GET_STATS:
+      return "get_stats";
+    case SaiApiOp::CLEAR_STATS:
+      return "clear_stats";
+  }
+  return "unknown";
+}
+
+// static
+size_t SaiApiStats::bucketIndex(uint64_t usecs) {
+  if (usecs < kSubBuckets) {
+    return usecs;
+  }
+  // Index of the power of 2 bucket, then of the sub bucket within it,
+  // given by the bits right below the most significant one
+  size_t msb = folly::findLastSet(usecs) - 1;
+  size_t subBucket = (usecs >> (msb - kSubBucketBits)) & (kSubBuckets - 1);
+  auto index = (msb - kSubBucketBits + 1) * kSubBuckets + subBucket;
+  return std::min(index, kNumBuckets - 1);
+}
+
+// static
+uint64_t SaiApiStats::bucketUpperBound(size_t index) {
+  if (index < kSubBuckets) {
+    return index;
+  }
+  size_t msb = index / kSubBuckets + kSubBucketBits - 1;
+  uint64_t subBucket = index % kSubBuckets;
+  return ((kSubBuckets + subBucket + 1) << (msb - kSubBucketBits)) - 1;
+}
+
+void SaiApiStats::record(
+    sai_api_t api,
+    SaiApiOp op,
+    std::chrono::steady_clock::duration latency,
+    sai_status_t status,
+    TimePoint now) {
+  if (api >= SAI_API_MAX) {
+    // Vendor extension APIs
+    api = SAI_API_UNSPECIFIED;
+  }
+  auto& stats = stats_[api][static_cast<int>(op)];
+  uint64_t usecs =
+      std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+  stats.calls.fetch_add(1, std::memory_order_relaxed);
+  if (status != SAI_STATUS_SUCCESS) {
+    stats.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+  auto latencies = stats.latencies.lock();
+  if (!*latencies) {
+    *latencies = std::make_unique<LatencyHistogram>(
+        1,
+        0,
+        kNumBuckets,
+        LatencyHistogram::ContainerType(
+            kNumWindowBuckets,
+            {std::chrono::seconds(60), std::chrono::seconds(600)}));
+  }
+  (*latencies)->addValue(toHistogramTime(now), bucketIndex(usecs));
+}
+
+// static
+SaiApiStats::LatencyHistogram::TimePoint SaiApiStats::toHistogramTime(
+    TimePoint now) {
+  return LatencyHistogram::TimePoint(
+      std::chrono::duration_cast<LatencyHistogram::Duration>(
+          now.time_since_epoch()));
+}
+
+// static
+SaiApiStats::Latency SaiApiStats::getLatency(
+    const LatencyHistogram& histogram,
+    Window window) {
+  // Histogram bucket 0 is for values below 0, so bucket i + 1 has the calls
+  // of latency bucket i
+  BucketCounts counts{};
+  uint64_t calls = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    counts[i] = histogram.getBucket(i + 1).count(window);
+    calls += counts[i];
+  }
+  Latency latency;
+  if (!calls) {
+    return latency;
+  }
+  latency.p50Usecs = percentile(counts, calls, 50);
+  latency.p99Usecs = percentile(counts, calls, 99);
+  latency.maxUsecs = percentile(counts, calls, 100);
+  return latency;
+}
+
+// static
+uint64_t SaiApiStats::percentile(
+    const BucketCounts& counts,
+    uint64_t calls,
+    double pct) {
+  auto rank = std::max<uint64_t>(1, std::ceil(calls * pct / 100));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucketUpperBound(i);
+    }
+  }
+  return bucketUpperBound(kNumBuckets - 1);
+}
+
+std::vector<SaiApiStats::CallStats> SaiApiStats::getCallStats(
+    TimePoint now) const {
+  std::vector<CallStats> callStats;
+  for (int api = 0; api < SAI_API_MAX; ++api) {
+    for (size_t op = 0; op < kNumOps; ++op) {
+      const auto& stats = stats_[api][op];
+      auto calls = stats.calls.load(std::memory_order_relaxed);
+      if (!calls) {
+        continue;
+      }
+      CallStats entry;
+      entry.api = static_cast<sai_api_t>(api);
+      entry.op = static_cast<SaiApiOp>(op);
+      entry.calls = calls;
+      entry.errors = stats.errors.load(std::memory_order_relaxed);
+      {
+        auto latencies = stats.latencies.lock();
+        if (*latencies) {
+          // Age out calls that left the windows
+          (*latencies)->update(toHistogramTime(now));
+          entry.lastMinute = getLatency(**latencies, LAST_MINUTE);
+          entry.lastTenMinutes = getLatency(**latencies, LAST_TEN_MINUTES);
+        }
+      }
+      callStats.push_back(entry);
+    }
+  }
+  return callStats;
+}
+
+void SaiApiStats::clear() {
+  for (auto& apiStats : stats_) {
+    for (auto& stats : apiStats) {
+      stats.calls.store(0, std::memory_order_relaxed);
+      stats.errors.store(0, std::memory_order_relaxed);
+      stats.latencies.lock()->reset();
+    }
+  }
+}
+
+} // namespace facebook::fboss
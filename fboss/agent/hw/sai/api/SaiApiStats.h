@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/stats/TimeseriesHistogram.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+enum class SaiApiOp : int {
+  CREATE,
+  REMOVE,
+  SET,
+  GET,
+  GET_STATS,
+  CLEAR_STATS,
+};
+
+folly::StringPiece saiApiOpToString(SaiApiOp op);
+
+/*
+ * Call count, error count and latency distribution of every SAI call, per
+ * SAI API and operation, so that slow programming can be attributed to
+ * the SDK or to the agent.
+ *
+ * Always on: recording a call is a relaxed atomic increment or two and an
+ * uncontended lock. Latencies go into fixed log scale buckets (4 per power
+ * of 2 microseconds), so percentiles and maxima are accurate to within 25%.
+ * Like fb303 histograms, latencies are only kept over the last minute and
+ * the last 10 minutes, which move in steps of a sixth of their length.
+ */
+class SaiApiStats {
+ public:
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  struct Latency {
+    uint64_t p50Usecs{0};
+    uint64_t p99Usecs{0};
+    uint64_t maxUsecs{0};
+  };
+
+  struct CallStats {
+    sai_api_t api;
+    SaiApiOp op;
+    // Since the agent started
+    uint64_t calls{0};
+    uint64_t errors{0};
+    // All 0 if there were no calls in the window
+    Latency lastMinute;
+    Latency lastTenMinutes;
+  };
+
+  static std::shared_ptr<SaiApiStats> getInstance();
+
+  void record(
+      sai_api_t api,
+      SaiApiOp op,
+      std::chrono::steady_clock::duration latency,
+      sai_status_t status) {
+    record(api, op, latency, status, std::chrono::steady_clock::now());
+  }
+  void record(
+      sai_api_t api,
+      SaiApiOp op,
+      std::chrono::steady_clock::duration latency,
+      sai_status_t status,
+      TimePoint now);
+
+  // Stats of every API and operation that was called at least once
+  std::vector<CallStats> getCallStats() const {
+    return getCallStats(std::chrono::steady_clock::now());
+  }
+  std::vector<CallStats> getCallStats(TimePoint now) const;
+
+  void clear();
+
+  // Exposed for tests
+  static size_t bucketIndex(uint64_t usecs);
+  static uint64_t bucketUpperBound(size_t index);
+
+ private:
+  static constexpr size_t kSubBucketBits = 2;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits;
+  // Up to 2^28us, about 4.5 minutes
+  static constexpr size_t kNumBuckets = 27 * kSubBuckets;
+  static constexpr size_t kNumOps = 6;
+  // Buckets of every window
+  static constexpr size_t kNumWindowBuckets = 6;
+  enum Window : size_t { LAST_MINUTE, LAST_TEN_MINUTES };
+
+  // Counts calls by their latency bucket index
+  using LatencyHistogram = folly::TimeseriesHistogram<int64_t>;
+  using BucketCounts = std::array<uint64_t, kNumBuckets>;
+
+  struct OpStats {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> errors{0};
+    // Created on the first call, as most operations are never called
+    mutable folly::Synchronized<std::unique_ptr<LatencyHistogram>, std::mutex>
+        latencies;
+  };
+
+  static LatencyHistogram::TimePoint toHistogramTime(TimePoint now);
+  static Latency getLatency(const LatencyHistogram& histogram, Window window);
+  static uint64_t percentile(
+      const BucketCounts& counts,
+      uint64_t calls,
+      double pct);
+
+  std::array<std::array<OpStats, kNumOps>, SAI_API_MAX> stats_;
+};
+
+} // namespace facebook::fboss
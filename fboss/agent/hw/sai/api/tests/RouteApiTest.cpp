@@ -8,10 +8,12 @@
  *
  */
 #include "fboss/agent/hw/sai/api/RouteApi.h"
+#include "fboss/agent/hw/sai/api/SaiApiError.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/fake/FakeSai.h"
 
 #include <folly/IPAddress.h>
+#include <folly/json.h>
 #include <folly/logging/xlog.h>
 
 #include <gtest/gtest.h>
@@ -32,6 +34,10 @@ class RouteApiTest : public ::testing::Test {
     sai_api_initialize(0, nullptr);
     routeApi = std::make_unique<RouteApi>();
   }
+  void TearDown() override {
+    // FakeSai is a singleton, don't let a cost model outlive its test
+    fs->costModel.clear();
+  }
   std::shared_ptr<FakeSai> fs;
   std::unique_ptr<RouteApi> routeApi;
   folly::IPAddress ip4{str4};
@@ -174,6 +180,28 @@ TEST_F(RouteApiTest, routeKeys) {
   EXPECT_EQ(routeKeys[0], r);
 }
 
+TEST_F(RouteApiTest, routeTableFullWithCostModel) {
+  fs->costModel.load(folly::parseJson(R"({
+    "objects": {
+      "route-entry": {
+        "create": {"fixedUsecs": 10, "perAttributeUsecs": 1},
+        "capacity": 1
+      }
+    }
+  })"));
+  SaiRouteTraits::CreateAttributes attrs{
+      SAI_PACKET_ACTION_FORWARD, 5, std::nullopt};
+  SaiRouteTraits::RouteEntry r1(0, 0, folly::CIDRNetwork(ip4, 24));
+  routeApi->create<SaiRouteTraits>(r1, attrs);
+  // fixed cost + 2 attributes
+  EXPECT_EQ(fs->costModel.simulatedTime(), std::chrono::microseconds(12));
+  SaiRouteTraits::RouteEntry r2(0, 0, folly::CIDRNetwork(ip6, 64));
+  EXPECT_THROW(routeApi->create<SaiRouteTraits>(r2, attrs), SaiApiError);
+  EXPECT_EQ(fs->costModel.tableFullCount(), 1);
+  routeApi->remove(r1);
+  routeApi->create<SaiRouteTraits>(r2, attrs);
+}
+
 TEST_F(RouteApiTest, formatRouteNextHopId) {
   SaiRouteTraits::Attributes::NextHopId nhid{42};
   std::string expected("NextHopId: 42");
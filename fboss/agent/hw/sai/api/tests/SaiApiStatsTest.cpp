@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/SaiApiStats.h"
+#include "fboss/agent/hw/sai/api/VirtualRouterApi.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+class SaiApiStatsTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    fs = FakeSai::getInstance();
+    sai_api_initialize(0, nullptr);
+    virtualRouterApi = std::make_unique<VirtualRouterApi>();
+    apiStats = SaiApiStats::getInstance();
+    apiStats->clear();
+  }
+
+  std::optional<SaiApiStats::CallStats> getCallStats(
+      sai_api_t api,
+      SaiApiOp op) {
+    for (const auto& callStats : apiStats->getCallStats()) {
+      if (callStats.api == api && callStats.op == op) {
+        return callStats;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::shared_ptr<FakeSai> fs;
+  std::unique_ptr<VirtualRouterApi> virtualRouterApi;
+  std::shared_ptr<SaiApiStats> apiStats;
+};
+
+TEST_F(SaiApiStatsTest, buckets) {
+  for (uint64_t usecs = 0; usecs < 100000; ++usecs) {
+    auto index = SaiApiStats::bucketIndex(usecs);
+    EXPECT_LE(usecs, SaiApiStats::bucketUpperBound(index));
+    if (index > 0) {
+      EXPECT_GT(usecs, SaiApiStats::bucketUpperBound(index - 1));
+    }
+  }
+  // Buckets are within 25% of the values in them
+  auto index = SaiApiStats::bucketIndex(1000);
+  EXPECT_LE(SaiApiStats::bucketUpperBound(index), 1250);
+}
+
+TEST_F(SaiApiStatsTest, percentiles) {
+  for (int i = 0; i < 98; ++i) {
+    apiStats->record(
+        SAI_API_ROUTE, SaiApiOp::CREATE, microseconds(10), SAI_STATUS_SUCCESS);
+  }
+  apiStats->record(
+      SAI_API_ROUTE, SaiApiOp::CREATE, microseconds(500), SAI_STATUS_SUCCESS);
+  apiStats->record(
+      SAI_API_ROUTE, SaiApiOp::CREATE, microseconds(5000), SAI_STATUS_FAILURE);
+
+  auto callStats = getCallStats(SAI_API_ROUTE, SaiApiOp::CREATE);
+  ASSERT_TRUE(callStats.has_value());
+  EXPECT_EQ(callStats->calls, 100);
+  EXPECT_EQ(callStats->errors, 1);
+  for (const auto& latency :
+       {callStats->lastMinute, callStats->lastTenMinutes}) {
+    EXPECT_EQ(latency.p50Usecs, 11);
+    EXPECT_EQ(latency.p99Usecs, 511);
+    // Upper bound of the bucket 5000us is in
+    EXPECT_EQ(latency.maxUsecs, 5119);
+  }
+
+  // Nothing else was called
+  EXPECT_EQ(apiStats->getCallStats().size(), 1);
+}
+
+TEST_F(SaiApiStatsTest, latenciesAgeOut) {
+  auto start = steady_clock::now();
+  apiStats->record(
+      SAI_API_ROUTE,
+      SaiApiOp::CREATE,
+      microseconds(5000),
+      SAI_STATUS_SUCCESS,
+      start);
+  apiStats->record(
+      SAI_API_ROUTE,
+      SaiApiOp::CREATE,
+      microseconds(10),
+      SAI_STATUS_SUCCESS,
+      start + minutes(5));
+
+  auto getStats = [&](steady_clock::time_point now) {
+    for (const auto& callStats : apiStats->getCallStats(now)) {
+      if (callStats.api == SAI_API_ROUTE && callStats.op == SaiApiOp::CREATE) {
+        return callStats;
+      }
+    }
+    throw std::runtime_error("No route create stats");
+  };
+
+  // The slow call has left the last minute only
+  auto callStats = getStats(start + minutes(5));
+  EXPECT_EQ(callStats.calls, 2);
+  EXPECT_EQ(callStats.lastMinute.maxUsecs, 11);
+  EXPECT_EQ(callStats.lastTenMinutes.maxUsecs, 5119);
+
+  // Then the last 10 minutes too
+  callStats = getStats(start + minutes(12));
+  EXPECT_EQ(callStats.lastMinute.maxUsecs, 0);
+  EXPECT_EQ(callStats.lastTenMinutes.maxUsecs, 11);
+
+  // Counts are kept
+  callStats = getStats(start + minutes(30));
+  EXPECT_EQ(callStats.calls, 2);
+  EXPECT_EQ(callStats.lastTenMinutes.p50Usecs, 0);
+  EXPECT_EQ(callStats.lastTenMinutes.maxUsecs, 0);
+}
+
+TEST_F(SaiApiStatsTest, apiCallsAreRecorded) {
+  SaiVirtualRouterTraits::CreateAttributes c{};
+  auto virtualRouterId = virtualRouterApi->create<SaiVirtualRouterTraits>(c, 0);
+  SaiVirtualRouterTraits::Attributes::SrcMac srcMac{
+      folly::MacAddress{"42:42:42:42:42:42"}};
+  virtualRouterApi->setAttribute(virtualRouterId, srcMac);
+  virtualRouterApi->getAttribute(
+      virtualRouterId, SaiVirtualRouterTraits::Attributes::SrcMac{});
+  virtualRouterApi->remove(virtualRouterId);
+
+  auto creates = getCallStats(SAI_API_VIRTUAL_ROUTER, SaiApiOp::CREATE);
+  ASSERT_TRUE(creates.has_value());
+  EXPECT_EQ(creates->calls, 1);
+  EXPECT_EQ(creates->errors, 0);
+  auto sets = getCallStats(SAI_API_VIRTUAL_ROUTER, SaiApiOp::SET);
+  ASSERT_TRUE(sets.has_value());
+  EXPECT_EQ(sets->calls, 1);
+  auto gets = getCallStats(SAI_API_VIRTUAL_ROUTER, SaiApiOp::GET);
+  ASSERT_TRUE(gets.has_value());
+  EXPECT_EQ(gets->calls, 1);
+  auto removes = getCallStats(SAI_API_VIRTUAL_ROUTER, SaiApiOp::REMOVE);
+  ASSERT_TRUE(removes.has_value());
+  EXPECT_EQ(removes->calls, 1);
+  EXPECT_FALSE(
+      getCallStats(SAI_API_VIRTUAL_ROUTER, SaiApiOp::GET_STATS).has_value());
+}
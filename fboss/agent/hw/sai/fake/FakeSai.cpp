@@ -13,6 +13,9 @@
 #include <folly/Singleton.h>
 
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+DECLARE_string(fake_sai_cost_model_config);
 
 namespace {
 struct singleton_tag_type {};
@@ -95,6 +98,10 @@ sai_status_t sai_api_initialize(
   // Create the CPU port
   sai_create_cpu_port();
 
+  if (!FLAGS_fake_sai_cost_model_config.empty() && !fs->costModel.enabled()) {
+    fs->costModel.loadFromFile(FLAGS_fake_sai_cost_model_config);
+  }
+
   fs->initialized = true;
   return SAI_STATUS_SUCCESS;
 }
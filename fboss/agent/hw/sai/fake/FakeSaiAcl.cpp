@@ -14,6 +14,7 @@
 #include "fboss/agent/hw/sai/fake/FakeSai.h"
 
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 namespace facebook::fboss {
 bool FakeAclTable::entryFieldSupported(const sai_attribute_t& attr) const {
@@ -427,6 +428,8 @@ sai_status_t set_acl_entry_attribute_fn(
     sai_object_id_t acl_entry_id,
     const sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ACL_ENTRY, FakeSaiOp::SET, 1);
   auto& aclEntry = fs->aclEntryManager.get(acl_entry_id);
   sai_status_t res;
   if (!attr) {
@@ -659,6 +662,8 @@ sai_status_t get_acl_entry_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ACL_ENTRY, FakeSaiOp::GET, attr_count);
   auto& aclEntry = fs->aclEntryManager.get(acl_entry_id);
   for (int i = 0; i < attr_count; ++i) {
     switch (attr_list[i].id) {
@@ -859,6 +864,12 @@ sai_status_t create_acl_entry_fn(
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ACL_ENTRY, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_ACL_ENTRY, fs->aclEntryManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
 
   std::optional<sai_object_id_t> tableId;
   for (int i = 0; i < attr_count; ++i) {
@@ -894,6 +905,8 @@ sai_status_t create_acl_entry_fn(
 
 sai_status_t remove_acl_entry_fn(sai_object_id_t acl_entry_id) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ACL_ENTRY, FakeSaiOp::REMOVE, 0);
   fs->aclEntryManager.remove(acl_entry_id);
   return SAI_STATUS_SUCCESS;
 }
@@ -0,0 +1,194 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/fake/FakeSaiCostModel.h"
+
+#include "fboss/agent/hw/sai/api/LoggingUtil.h"
+
+#include <folly/FileUtil.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+#include <stdexcept>
+#include <thread>
+
+DEFINE_string(
+    fake_sai_cost_model_config,
+    "",
+    "Json file with per object type latencies and table capacities "
+    "to be modeled by fake SAI");
+
+namespace {
+// Depth of charged fake SAI calls on this thread, so that calls which fake
+// SAI implements in terms of other calls are only charged once.
+thread_local int chargeDepth = 0;
+
+// sleep_for overshoots by tens of usecs, too coarse for per call latencies
+constexpr auto kMinSleep = std::chrono::microseconds(100);
+
+const std::unordered_map<std::string, facebook::fboss::FakeSaiOp>&
+opsByName() {
+  using facebook::fboss::FakeSaiOp;
+  static const std::unordered_map<std::string, FakeSaiOp> kOps = {
+      {"create", FakeSaiOp::CREATE},
+      {"remove", FakeSaiOp::REMOVE},
+      {"set", FakeSaiOp::SET},
+      {"get", FakeSaiOp::GET},
+      {"getStats", FakeSaiOp::GET_STATS},
+  };
+  return kOps;
+}
+
+sai_object_type_t objectTypeFromString(const std::string& name) {
+  for (int type = SAI_OBJECT_TYPE_NULL + 1; type < SAI_OBJECT_TYPE_MAX;
+       ++type) {
+    auto objectType = static_cast<sai_object_type_t>(type);
+    try {
+      if (facebook::fboss::saiObjectTypeToString(objectType) == name) {
+        return objectType;
+      }
+    } catch (const std::exception&) {
+      // object type not known to fboss
+    }
+  }
+  throw std::invalid_argument(
+      "Unknown sai object type in cost model: " + name);
+}
+
+std::chrono::nanoseconds usecs(const folly::dynamic& cost, const char* key) {
+  return std::chrono::microseconds(cost.getDefault(key, 0).asInt());
+}
+} // namespace
+
+namespace facebook::fboss {
+
+FakeSaiCostModel::Charge::Charge(std::unique_lock<std::mutex> deviceLock)
+    : deviceLock_(std::move(deviceLock)), active_(true) {
+  ++chargeDepth;
+}
+
+FakeSaiCostModel::Charge::Charge(Charge&& other) noexcept
+    : deviceLock_(std::move(other.deviceLock_)), active_(other.active_) {
+  other.active_ = false;
+}
+
+FakeSaiCostModel::Charge::~Charge() {
+  if (active_) {
+    --chargeDepth;
+  }
+}
+
+void FakeSaiCostModel::load(const folly::dynamic& config) {
+  clear();
+  serializeOnDeviceLock_ =
+      config.getDefault("serializeOnDeviceLock", false).asBool();
+  if (auto objects = config.get_ptr("objects")) {
+    for (const auto& [name, model] : objects->items()) {
+      auto& objectModel = objects_[objectTypeFromString(name.asString())];
+      for (const auto& [opName, op] : opsByName()) {
+        if (auto cost = model.get_ptr(opName)) {
+          objectModel.costs[static_cast<size_t>(op)] = Cost{
+              usecs(*cost, "fixedUsecs"), usecs(*cost, "perAttributeUsecs")};
+        }
+      }
+      if (auto capacity = model.get_ptr("capacity")) {
+        objectModel.capacity = capacity->asInt();
+      }
+    }
+  }
+  enabled_ = true;
+  XLOG(INFO) << "Loaded fake SAI cost model for " << objects_.size()
+             << " object types, serialized: " << serializeOnDeviceLock_;
+}
+
+void FakeSaiCostModel::loadFromFile(const std::string& path) {
+  std::string contents;
+  if (!folly::readFile(path.c_str(), contents)) {
+    throw std::runtime_error("Unable to read fake SAI cost model: " + path);
+  }
+  load(folly::parseJson(contents));
+}
+
+void FakeSaiCostModel::clear() {
+  enabled_ = false;
+  serializeOnDeviceLock_ = false;
+  objects_.clear();
+  simulatedNsecs_ = 0;
+  tableFullCount_ = 0;
+}
+
+FakeSaiCostModel::Charge FakeSaiCostModel::charge(
+    sai_object_type_t objectType,
+    FakeSaiOp op,
+    size_t attrCount) {
+  if (!enabled_ || chargeDepth > 0) {
+    return Charge();
+  }
+  std::unique_lock<std::mutex> deviceLock;
+  if (serializeOnDeviceLock_) {
+    deviceLock = std::unique_lock<std::mutex>(deviceLock_);
+  }
+  Charge charge(std::move(deviceLock));
+  if (auto opCost = cost(objectType, op)) {
+    auto latency = opCost->fixed + opCost->perAttribute * attrCount;
+    wait(latency);
+    simulatedNsecs_ += latency.count();
+  }
+  return charge;
+}
+
+bool FakeSaiCostModel::hasCapacity(
+    sai_object_type_t objectType,
+    size_t inUse) {
+  auto maxObjects = capacity(objectType);
+  if (!maxObjects || inUse < *maxObjects) {
+    return true;
+  }
+  ++tableFullCount_;
+  XLOG_EVERY_MS(WARNING, 1000)
+      << "Fake SAI " << saiObjectTypeToString(objectType)
+      << " table full, capacity: " << *maxObjects;
+  return false;
+}
+
+std::optional<size_t> FakeSaiCostModel::capacity(
+    sai_object_type_t objectType) const {
+  auto itr = objects_.find(objectType);
+  if (!enabled_ || itr == objects_.end()) {
+    return std::nullopt;
+  }
+  return itr->second.capacity;
+}
+
+std::optional<FakeSaiCostModel::Cost> FakeSaiCostModel::cost(
+    sai_object_type_t objectType,
+    FakeSaiOp op) const {
+  auto itr = objects_.find(objectType);
+  if (itr == objects_.end()) {
+    return std::nullopt;
+  }
+  return itr->second.costs[static_cast<size_t>(op)];
+}
+
+void FakeSaiCostModel::wait(std::chrono::nanoseconds latency) {
+  if (latency <= std::chrono::nanoseconds::zero()) {
+    return;
+  }
+  if (latency >= kMinSleep) {
+    std::this_thread::sleep_for(latency);
+    return;
+  }
+  auto deadline = std::chrono::steady_clock::now() + latency;
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace facebook::fboss
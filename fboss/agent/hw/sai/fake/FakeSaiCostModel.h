@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/dynamic.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+enum class FakeSaiOp {
+  CREATE,
+  REMOVE,
+  SET,
+  GET,
+  GET_STATS,
+  NUM_OPS,
+};
+
+/*
+ * Latency and capacity model for fake SAI. By default fake SAI completes
+ * every call instantly and has unbounded tables, so benchmarks run against
+ * it only measure agent overhead. With a cost model loaded, each modeled
+ * call takes:
+ *
+ *   fixed latency of (object type, op) + attribute count * per attr latency
+ *
+ * optionally serialized on a single simulated device lock, and creates fail
+ * with SAI_STATUS_TABLE_FULL once an object type's capacity is reached.
+ *
+ * Config is json, keyed by saiObjectTypeToString() names, e.g.
+ *
+ * {
+ *   "serializeOnDeviceLock": true,
+ *   "objects": {
+ *     "route-entry": {
+ *       "create": {"fixedUsecs": 20, "perAttributeUsecs": 2},
+ *       "remove": {"fixedUsecs": 15},
+ *       "set": {"fixedUsecs": 10, "perAttributeUsecs": 2},
+ *       "capacity": 131072
+ *     },
+ *     "port": {"getStats": {"fixedUsecs": 50, "perAttributeUsecs": 1}}
+ *   }
+ * }
+ */
+class FakeSaiCostModel {
+ public:
+  struct Cost {
+    std::chrono::nanoseconds fixed{0};
+    std::chrono::nanoseconds perAttribute{0};
+  };
+
+  /*
+   * RAII handle for a modeled SAI call. The simulated latency is incurred
+   * on construction and, with serializeOnDeviceLock, the device lock is
+   * held until destruction so that the fake's own work is serialized too.
+   * Calls nested inside a charged call (e.g. create implemented via set)
+   * are not charged again.
+   */
+  class Charge {
+   public:
+    Charge(Charge&& other) noexcept;
+    Charge& operator=(Charge&&) = delete;
+    Charge(const Charge&) = delete;
+    Charge& operator=(const Charge&) = delete;
+    ~Charge();
+
+   private:
+    friend class FakeSaiCostModel;
+    Charge() {}
+    explicit Charge(std::unique_lock<std::mutex> deviceLock);
+
+    std::unique_lock<std::mutex> deviceLock_;
+    bool active_{false};
+  };
+
+  void load(const folly::dynamic& config);
+  void loadFromFile(const std::string& path);
+  void clear();
+
+  bool enabled() const {
+    return enabled_;
+  }
+
+  Charge charge(sai_object_type_t objectType, FakeSaiOp op, size_t attrCount);
+
+  /*
+   * Whether one more object of objectType may be created, given inUse
+   * objects already exist. Failed checks are counted in tableFullCount().
+   */
+  bool hasCapacity(sai_object_type_t objectType, size_t inUse);
+
+  std::optional<size_t> capacity(sai_object_type_t objectType) const;
+  std::optional<Cost> cost(sai_object_type_t objectType, FakeSaiOp op) const;
+
+  std::chrono::nanoseconds simulatedTime() const {
+    return std::chrono::nanoseconds(simulatedNsecs_.load());
+  }
+  uint64_t tableFullCount() const {
+    return tableFullCount_.load();
+  }
+
+ private:
+  struct ObjectModel {
+    std::array<std::optional<Cost>, static_cast<size_t>(FakeSaiOp::NUM_OPS)>
+        costs;
+    std::optional<size_t> capacity;
+  };
+
+  static void wait(std::chrono::nanoseconds latency);
+
+  bool enabled_{false};
+  bool serializeOnDeviceLock_{false};
+  std::unordered_map<sai_object_type_t, ObjectModel> objects_;
+  std::mutex deviceLock_;
+  std::atomic<uint64_t> simulatedNsecs_{0};
+  std::atomic<uint64_t> tableFullCount_{0};
+};
+
+} // namespace facebook::fboss
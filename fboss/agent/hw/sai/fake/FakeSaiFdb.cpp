@@ -17,12 +17,19 @@
 
 using facebook::fboss::FakeFdb;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_fdb_entry_fn(
     const sai_fdb_entry_t* fdb_entry,
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_FDB_ENTRY, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_FDB_ENTRY, fs->fdbManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
   auto mac = facebook::fboss::fromSaiMacAddress(fdb_entry->mac_address);
   sai_object_id_t bridgePortId = 0;
   sai_uint32_t metadata{0};
@@ -49,6 +56,8 @@ sai_status_t create_fdb_entry_fn(
 
 sai_status_t remove_fdb_entry_fn(const sai_fdb_entry_t* fdb_entry) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_FDB_ENTRY, FakeSaiOp::REMOVE, 0);
   auto mac = facebook::fboss::fromSaiMacAddress(fdb_entry->mac_address);
   fs->fdbManager.remove(
       std::make_tuple(fdb_entry->switch_id, fdb_entry->bv_id, mac));
@@ -59,6 +68,8 @@ sai_status_t set_fdb_entry_attribute_fn(
     const sai_fdb_entry_t* fdb_entry,
     const sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_FDB_ENTRY, FakeSaiOp::SET, 1);
   auto mac = facebook::fboss::fromSaiMacAddress(fdb_entry->mac_address);
   auto fdbKey = std::make_tuple(fdb_entry->switch_id, fdb_entry->bv_id, mac);
   auto& fdbEntry = fs->fdbManager.get(fdbKey);
@@ -80,6 +91,8 @@ sai_status_t get_fdb_entry_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_FDB_ENTRY, FakeSaiOp::GET, attr_count);
   auto mac = facebook::fboss::fromSaiMacAddress(fdb_entry->mac_address);
   auto fdbKey = std::make_tuple(fdb_entry->switch_id, fdb_entry->bv_id, mac);
   auto& fdbEntry = fs->fdbManager.get(fdbKey);
@@ -17,12 +17,19 @@
 
 using facebook::fboss::FakeNeighbor;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_neighbor_entry_fn(
     const sai_neighbor_entry_t* neighbor_entry,
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, fs->neighborManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
   auto ip = facebook::fboss::fromSaiIpAddress(neighbor_entry->ip_address);
   std::optional<folly::MacAddress> dstMac;
   sai_uint32_t metadata{0};
@@ -51,6 +58,8 @@ sai_status_t create_neighbor_entry_fn(
 sai_status_t remove_neighbor_entry_fn(
     const sai_neighbor_entry_t* neighbor_entry) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, FakeSaiOp::REMOVE, 0);
   auto ip = facebook::fboss::fromSaiIpAddress(neighbor_entry->ip_address);
   fs->neighborManager.remove(
       std::make_tuple(neighbor_entry->switch_id, neighbor_entry->rif_id, ip));
@@ -61,6 +70,8 @@ sai_status_t set_neighbor_entry_attribute_fn(
     const sai_neighbor_entry_t* neighbor_entry,
     const sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, FakeSaiOp::SET, 1);
   auto ip = facebook::fboss::fromSaiIpAddress(neighbor_entry->ip_address);
   auto n =
       std::make_tuple(neighbor_entry->switch_id, neighbor_entry->rif_id, ip);
@@ -83,6 +94,8 @@ sai_status_t get_neighbor_entry_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEIGHBOR_ENTRY, FakeSaiOp::GET, attr_count);
   auto ip = facebook::fboss::fromSaiIpAddress(neighbor_entry->ip_address);
   auto n =
       std::make_tuple(neighbor_entry->switch_id, neighbor_entry->rif_id, ip);
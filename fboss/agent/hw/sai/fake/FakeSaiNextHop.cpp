@@ -17,6 +17,7 @@
 
 using facebook::fboss::FakePort;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_next_hop_fn(
     sai_object_id_t* next_hop_id,
@@ -24,6 +25,12 @@ sai_status_t create_next_hop_fn(
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_NEXT_HOP, fs->nextHopManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
   std::optional<sai_next_hop_type_t> type;
   std::optional<folly::IPAddress> ip;
   std::optional<sai_object_id_t> routerInterfaceId;
@@ -71,6 +78,8 @@ sai_status_t create_next_hop_fn(
 
 sai_status_t remove_next_hop_fn(sai_object_id_t next_hop_id) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP, FakeSaiOp::REMOVE, 0);
   fs->nextHopManager.remove(next_hop_id);
   return SAI_STATUS_SUCCESS;
 }
@@ -78,6 +87,9 @@ sai_status_t remove_next_hop_fn(sai_object_id_t next_hop_id) {
 sai_status_t set_next_hop_attribute_fn(
     sai_object_id_t /* next_hop_id */,
     const sai_attribute_t* attr) {
+  auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP, FakeSaiOp::SET, 1);
   switch (attr->id) {
     default:
       return SAI_STATUS_INVALID_PARAMETER;
@@ -90,6 +102,8 @@ sai_status_t get_next_hop_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP, FakeSaiOp::GET, attr_count);
   const auto& nextHop = fs->nextHopManager.get(next_hop_id);
   for (int i = 0; i < attr_count; ++i) {
     switch (attr[i].id) {
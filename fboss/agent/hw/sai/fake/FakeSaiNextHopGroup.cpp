@@ -17,6 +17,7 @@
 using facebook::fboss::FakeNextHopGroup;
 using facebook::fboss::FakeNextHopGroupMember;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_next_hop_group_fn(
     sai_object_id_t* next_hop_group_id,
@@ -24,6 +25,13 @@ sai_status_t create_next_hop_group_fn(
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_NEXT_HOP_GROUP,
+          fs->nextHopGroupManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
   std::optional<int32_t> type;
   for (int i = 0; i < attr_count; ++i) {
     switch (attr_list[i].id) {
@@ -47,6 +55,8 @@ sai_status_t create_next_hop_group_fn(
 
 sai_status_t remove_next_hop_group_fn(sai_object_id_t next_hop_group_id) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP, FakeSaiOp::REMOVE, 0);
   fs->nextHopGroupManager.remove(next_hop_group_id);
   return SAI_STATUS_SUCCESS;
 }
@@ -56,6 +66,8 @@ sai_status_t get_next_hop_group_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP, FakeSaiOp::GET, attr_count);
   const auto& nextHopGroup = fs->nextHopGroupManager.get(next_hop_group_id);
   for (int i = 0; i < attr_count; ++i) {
     switch (attr[i].id) {
@@ -85,6 +97,9 @@ sai_status_t get_next_hop_group_attribute_fn(
 sai_status_t set_next_hop_group_attribute_fn(
     sai_object_id_t /* next_hop_group_id */,
     const sai_attribute_t* attr) {
+  auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP, FakeSaiOp::SET, 1);
   switch (attr->id) {
     default:
       return SAI_STATUS_NOT_SUPPORTED;
@@ -98,6 +113,8 @@ sai_status_t create_next_hop_group_member_fn(
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, FakeSaiOp::CREATE, attr_count);
   std::optional<sai_object_id_t> nextHopGroupId;
   std::optional<sai_object_id_t> nextHopId;
   std::optional<sai_uint32_t> weight = std::nullopt;
@@ -130,6 +147,8 @@ sai_status_t create_next_hop_group_member_fn(
 sai_status_t remove_next_hop_group_member_fn(
     sai_object_id_t next_hop_group_member_id) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, FakeSaiOp::REMOVE, 0);
   fs->nextHopGroupManager.removeMember(next_hop_group_member_id);
   return SAI_STATUS_SUCCESS;
 }
@@ -139,6 +158,8 @@ sai_status_t get_next_hop_group_member_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, FakeSaiOp::GET, attr_count);
   auto& nextHopGroupMember =
       fs->nextHopGroupManager.getMember(next_hop_group_member_id);
   for (int i = 0; i < attr_count; ++i) {
@@ -164,6 +185,9 @@ sai_status_t get_next_hop_group_member_attribute_fn(
 sai_status_t set_next_hop_group_member_attribute_fn(
     sai_object_id_t next_hop_group_member_id,
     const sai_attribute_t* attr) {
+  auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, FakeSaiOp::SET, 1);
   switch (attr->id) {
     default:
       return SAI_STATUS_NOT_SUPPORTED;
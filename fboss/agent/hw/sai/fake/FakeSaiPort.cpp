@@ -16,6 +16,7 @@
 
 using facebook::fboss::FakePort;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_port_fn(
     sai_object_id_t* port_id,
@@ -237,6 +238,7 @@ sai_status_t set_port_attribute_fn(
     sai_object_id_t port_id,
     const sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(SAI_OBJECT_TYPE_PORT, FakeSaiOp::SET, 1);
   auto& port = fs->portManager.get(port_id);
   sai_status_t res = SAI_STATUS_SUCCESS;
   if (!attr) {
@@ -365,6 +367,8 @@ sai_status_t get_port_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_PORT, FakeSaiOp::GET, attr_count);
   const auto& port = fs->portManager.get(port_id);
   for (int i = 0; i < attr_count; ++i) {
     switch (attr[i].id) {
@@ -529,6 +533,9 @@ sai_status_t get_port_stats_fn(
     uint32_t num_of_counters,
     const sai_stat_id_t* /*counter_ids*/,
     uint64_t* counters) {
+  auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_PORT, FakeSaiOp::GET_STATS, num_of_counters);
   for (auto i = 0; i < num_of_counters; ++i) {
     counters[i] = 0;
   }
@@ -15,6 +15,7 @@
 
 using facebook::fboss::FakeQueue;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t create_queue_fn(
     sai_object_id_t* queue_id,
@@ -150,6 +151,9 @@ sai_status_t get_queue_stats_fn(
     uint32_t num_of_counters,
     const sai_stat_id_t* /*counter_ids*/,
     uint64_t* counters) {
+  auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_QUEUE, FakeSaiOp::GET_STATS, num_of_counters);
   for (auto i = 0; i < num_of_counters; ++i) {
     counters[i] = 0;
   }
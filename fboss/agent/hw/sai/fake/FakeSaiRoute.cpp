@@ -16,11 +16,14 @@
 
 using facebook::fboss::FakeRoute;
 using facebook::fboss::FakeSai;
+using facebook::fboss::FakeSaiOp;
 
 sai_status_t set_route_entry_attribute_fn(
     const sai_route_entry_t* route_entry,
     const sai_attribute_t* attr) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ROUTE_ENTRY, FakeSaiOp::SET, 1);
   auto re = std::make_tuple(
       route_entry->switch_id,
       route_entry->vr_id,
@@ -47,6 +50,12 @@ sai_status_t create_route_entry_fn(
     uint32_t attr_count,
     const sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ROUTE_ENTRY, FakeSaiOp::CREATE, attr_count);
+  if (!fs->costModel.hasCapacity(
+          SAI_OBJECT_TYPE_ROUTE_ENTRY, fs->routeManager.map().size())) {
+    return SAI_STATUS_TABLE_FULL;
+  }
   auto re = std::make_tuple(
       route_entry->switch_id,
       route_entry->vr_id,
@@ -60,6 +69,8 @@ sai_status_t create_route_entry_fn(
 
 sai_status_t remove_route_entry_fn(const sai_route_entry_t* route_entry) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ROUTE_ENTRY, FakeSaiOp::REMOVE, 0);
   auto re = std::make_tuple(
       route_entry->switch_id,
       route_entry->vr_id,
@@ -75,6 +86,8 @@ sai_status_t get_route_entry_attribute_fn(
     uint32_t attr_count,
     sai_attribute_t* attr_list) {
   auto fs = FakeSai::getInstance();
+  auto charge = fs->costModel.charge(
+      SAI_OBJECT_TYPE_ROUTE_ENTRY, FakeSaiOp::GET, attr_count);
   auto re = std::make_tuple(
       route_entry->switch_id,
       route_entry->vr_id,
@@ -20,6 +20,7 @@
 #include "fboss/agent/hw/sai/store/Traits.h"
 #include "fboss/lib/RefMap.h"
 
+#include <folly/container/F14Map.h>
 #include <folly/dynamic.h>
 
 #include <memory>
@@ -42,6 +43,15 @@ struct AdapterHostKeyWarmbootRecoverable<SaiNextHopGroupTraits>
 template <>
 struct AdapterHostKeyWarmbootRecoverable<SaiLagTraits> : std::false_type {};
 
+template <>
+struct IsHighCardinalityObject<SaiRouteTraits> : std::true_type {};
+
+template <>
+struct IsHighCardinalityObject<SaiNeighborTraits> : std::true_type {};
+
+template <>
+struct IsHighCardinalityObject<SaiFdbTraits> : std::true_type {};
+
 /*
  * SaiObjectStore is the critical component of SaiStore,
  * it provides the needed operations on a single type of SaiObject
@@ -56,6 +66,15 @@ class SaiObjectStore {
       SaiObjectWithCounters<SaiObjectTraits>,
       SaiObject<SaiObjectTraits>>::type;
   using ObjectTraits = SaiObjectTraits;
+  using AdapterHostKey = typename SaiObjectTraits::AdapterHostKey;
+  using ObjectMap = std::conditional_t<
+      IsHighCardinalityObject<SaiObjectTraits>::value,
+      SlabRefMap<AdapterHostKey, ObjectType>,
+      UnorderedRefMap<AdapterHostKey, ObjectType>>;
+  using WarmBootHandleMap = std::conditional_t<
+      IsHighCardinalityObject<SaiObjectTraits>::value,
+      folly::F14FastMap<AdapterHostKey, std::shared_ptr<ObjectType>>,
+      std::unordered_map<AdapterHostKey, std::shared_ptr<ObjectType>>>;
 
   explicit SaiObjectStore(sai_object_id_t switchId) : switchId_(switchId) {}
   SaiObjectStore() {}
@@ -164,6 +183,8 @@ class SaiObjectStore {
     if (shouldSkipReloadingObjects()) {
       return;
     }
+    objects_.reserve(objects_.size() + keys.size());
+    warmBootHandles_.reserve(warmBootHandles_.size() + keys.size());
     for (const auto k : keys) {
       ObjectType obj = getObject(k, adapterKeys2AdapterHostKey);
       auto adapterHostKey = obj.adapterHostKey();
@@ -285,25 +306,18 @@ class SaiObjectStore {
     objects_.clear();
   }
 
-  const UnorderedRefMap<typename SaiObjectTraits::AdapterHostKey, ObjectType>&
-  objects() const {
+  const ObjectMap& objects() const {
     return objects_;
   }
 
   uint64_t size() const {
     return objects_.size();
   }
-  typename UnorderedRefMap<
-      typename SaiObjectTraits::AdapterHostKey,
-      ObjectType>::MapType::const_iterator
-  begin() const {
+  typename ObjectMap::MapType::const_iterator begin() const {
     return objects_.begin();
   }
 
-  typename UnorderedRefMap<
-      typename SaiObjectTraits::AdapterHostKey,
-      ObjectType>::MapType::const_iterator
-  end() const {
+  typename ObjectMap::MapType::const_iterator end() const {
     return objects_.end();
   }
 
@@ -431,12 +445,8 @@ class SaiObjectStore {
   }
 
   std::optional<sai_object_id_t> switchId_;
-  UnorderedRefMap<typename SaiObjectTraits::AdapterHostKey, ObjectType>
-      objects_;
-  std::unordered_map<
-      typename SaiObjectTraits::AdapterHostKey,
-      std::shared_ptr<ObjectType>>
-      warmBootHandles_;
+  ObjectMap objects_;
+  WarmBootHandleMap warmBootHandles_;
 };
 
 /*
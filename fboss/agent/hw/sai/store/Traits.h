@@ -68,4 +68,12 @@ struct PublisherKey<
 template <typename ObjectTraits>
 struct AdapterHostKeyWarmbootRecoverable : std::true_type {};
 
+/*
+ * Object types which may have hundreds of thousands of instances at scale
+ * (routes, neighbors, fdb entries). Their stores use open addressing maps
+ * and slab allocated objects to cut per object memory and allocation cost.
+ */
+template <typename ObjectTraits>
+struct IsHighCardinalityObject : std::false_type {};
+
 } // namespace facebook::fboss
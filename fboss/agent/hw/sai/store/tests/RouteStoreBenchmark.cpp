@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/api/RouteApi.h"
+#include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/store/SaiStore.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV4.h>
+#include <folly/init/Init.h>
+
+#include <unistd.h>
+#include <fstream>
+
+using namespace facebook::fboss;
+
+DEFINE_int32(store_route_count, 200000, "Number of routes to load in store");
+
+namespace {
+
+constexpr uint32_t kRouteBase = 0x0a000000; // 10.0.0.0
+
+SaiRouteTraits::RouteEntry routeEntry(uint32_t index) {
+  folly::CIDRNetwork dest(
+      folly::IPAddressV4::fromLongHBO(kRouteBase + index), 32);
+  return SaiRouteTraits::RouteEntry(0, 0, dest);
+}
+
+int64_t residentBytes() {
+  std::ifstream statm("/proc/self/statm");
+  int64_t size = 0, resident = 0;
+  statm >> size >> resident;
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+void initSaiApis() {
+  auto fs = FakeSai::getInstance();
+  sai_api_initialize(0, nullptr);
+  auto saiApiTable = SaiApiTable::getInstance();
+  saiApiTable->queryApis(saiApiTable->getFullApiList());
+}
+
+} // namespace
+
+/*
+ * Program routes through the store, as SaiRouteManager does on cold boot.
+ */
+BENCHMARK_COUNTERS(SaiStoreRouteSetObject, counters) {
+  std::unique_ptr<SaiStore> saiStore;
+  std::vector<std::shared_ptr<SaiObject<SaiRouteTraits>>> routes;
+  BENCHMARK_SUSPEND {
+    initSaiApis();
+    saiStore = std::make_unique<SaiStore>(0);
+    routes.reserve(FLAGS_store_route_count);
+  }
+  auto& store = saiStore->get<SaiRouteTraits>();
+  auto rssBefore = residentBytes();
+  for (auto i = 0; i < FLAGS_store_route_count; ++i) {
+    routes.push_back(
+        store.setObject(routeEntry(i), {SAI_PACKET_ACTION_FORWARD, 5, 42}));
+  }
+  // Includes fake SAI's own copy of every route
+  counters["rss_delta_kb"] = (residentBytes() - rssBefore) / 1024;
+  counters["routes"] = store.size();
+  BENCHMARK_SUSPEND {
+    routes.clear();
+    saiStore.reset();
+    FakeSai::clear();
+  }
+}
+
+/*
+ * Reload routes already programmed in the (fake) SDK, as on warm boot.
+ */
+BENCHMARK_COUNTERS(SaiStoreRouteReload, counters) {
+  std::unique_ptr<SaiStore> saiStore;
+  BENCHMARK_SUSPEND {
+    initSaiApis();
+    auto& routeApi = SaiApiTable::getInstance()->routeApi();
+    for (auto i = 0; i < FLAGS_store_route_count; ++i) {
+      routeApi.create<SaiRouteTraits>(
+          routeEntry(i), {SAI_PACKET_ACTION_FORWARD, 5, 42});
+    }
+    saiStore = std::make_unique<SaiStore>(0);
+  }
+  auto rssBefore = residentBytes();
+  saiStore->reload();
+  counters["rss_delta_kb"] = (residentBytes() - rssBefore) / 1024;
+  counters["routes"] = saiStore->get<SaiRouteTraits>().size();
+  BENCHMARK_SUSPEND {
+    saiStore.reset();
+    FakeSai::clear();
+  }
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
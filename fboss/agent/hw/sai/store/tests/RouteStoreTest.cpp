@@ -42,6 +42,28 @@ TEST_F(SaiStoreTest, loadRoute) {
   EXPECT_EQ(GET_OPT_ATTR(Route, Metadata, got->attributes()), 41);
 }
 
+TEST_F(SaiStoreTest, routeStoreSlabAllocated) {
+  saiStore->setSwitchId(0);
+  auto& store = saiStore->get<SaiRouteTraits>();
+  const auto& arena = store.objects().getAllocator().arena();
+  std::vector<std::shared_ptr<SaiObject<SaiRouteTraits>>> routes;
+  for (auto i = 0; i < 10; i++) {
+    folly::CIDRNetwork dest(
+        folly::IPAddressV4::fromLongHBO(0x0a000000 + i), 32);
+    SaiRouteTraits::RouteEntry r(0, 0, dest);
+    routes.push_back(store.setObject(r, {SAI_PACKET_ACTION_FORWARD, 5, 42}));
+  }
+  EXPECT_EQ(store.size(), 10);
+  // object and its shared_ptr control block share the store's slab arena
+  EXPECT_EQ(arena->slotsInUse(), 20);
+  routes.pop_back();
+  EXPECT_EQ(store.size(), 9);
+  EXPECT_EQ(arena->slotsInUse(), 18);
+  routes.clear();
+  EXPECT_EQ(store.size(), 0);
+  EXPECT_EQ(arena->slotsInUse(), 0);
+}
+
 TEST_F(SaiStoreTest, routeLoadCtor) {
   auto& routeApi = saiApiTable->routeApi();
   folly::IPAddress ip4{"10.10.10.1"};
@@ -14,6 +14,8 @@
 #include "fboss/agent/hw/sai/api/Types.h"
 #include "fboss/agent/types.h"
 
+#include <map>
+
 extern "C" {
 #include <sai.h>
 }
@@ -45,6 +47,12 @@ struct ConcurrentIndices {
    * lag sai id to aggregate port id
    */
   folly::ConcurrentHashMap<LagSaiId, AggregatePortID> aggregatePortIds;
+  /*
+   * Unicast queue sai ids of a port by queue id, read by the buffer
+   * watermark sampler and modified by queue config changes
+   */
+  folly::ConcurrentHashMap<PortID, std::map<int, QueueSaiId>>
+      unicastQueueSaiIds;
 };
 
 } // namespace facebook::fboss
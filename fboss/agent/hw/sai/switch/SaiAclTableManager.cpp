@@ -196,18 +196,19 @@ sai_uint32_t SaiAclTableManager::swPriorityToSaiPriority(int priority) const {
    * But larger priority means higher priority is documented here:
    * https://github.com/opencomputeproject/SAI/blob/master/doc/SAI-Proposal-ACL-1.md
    */
-  sai_uint32_t saiPriority = aclEntryMaximumPriority_ - priority;
-  if (saiPriority < aclEntryMinimumPriority_) {
+  // Checked before converting, as priorities above the maximum would wrap
+  if (priority < 0 ||
+      priority > int64_t(aclEntryMaximumPriority_) - aclEntryMinimumPriority_) {
     throw FbossError(
         "Acl Entry priority out of range. Supported: [",
         aclEntryMinimumPriority_,
         ", ",
         aclEntryMaximumPriority_,
         "], specified: ",
-        saiPriority);
+        int64_t(aclEntryMaximumPriority_) - priority);
   }
 
-  return saiPriority;
+  return aclEntryMaximumPriority_ - priority;
 }
 
 sai_acl_ip_frag_t SaiAclTableManager::cfgIpFragToSaiIpFrag(
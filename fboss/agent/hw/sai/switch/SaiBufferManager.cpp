@@ -12,9 +12,11 @@
 
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/Platform.h"
+#include "fboss/agent/hw/sai/api/QueueApi.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/api/SwitchApi.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
+#include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitchManager.h"
@@ -25,6 +27,8 @@
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
 #include "fboss/agent/state/PortQueue.h"
 
+#include <algorithm>
+
 namespace facebook::fboss {
 
 namespace {
@@ -92,12 +96,80 @@ void assertMaxBufferPoolSize(const SaiPlatform* platform) {
   }
 }
 
+/*
+ * Reads watermarks from the adapter with the sai ids of ConcurrentIndices,
+ * so sampling never takes the SaiSwitch lock.
+ *
+ * A queue id is copied out of the index and read after, so SaiPortManager
+ * could remove the queue in between. To avoid reading a removed queue,
+ * SaiPortManager erases a port's queues from the index and then calls
+ * BufferWatermarkSampler::waitForReads() before removing them.
+ */
+class SaiBufferWatermarkReader : public BufferWatermarkSampler::Reader {
+ public:
+  SaiBufferWatermarkReader(
+      const ConcurrentIndices* concurrentIndices,
+      const std::atomic<sai_object_id_t>* egressBufferPoolSaiId)
+      : concurrentIndices_(concurrentIndices),
+        egressBufferPoolSaiId_(egressBufferPoolSaiId) {}
+
+  std::vector<uint64_t> readQueueWatermarks(
+      const std::vector<BufferWatermarkSampler::QueueKey>& queues) override {
+    static const std::vector<sai_stat_id_t> kWatermarkStats{
+        SAI_QUEUE_STAT_WATERMARK_BYTES};
+    auto& queueApi = SaiApiTable::getInstance()->queueApi();
+    std::vector<uint64_t> peakBytes;
+    peakBytes.reserve(queues.size());
+    for (const auto& [port, queue] : queues) {
+      uint64_t bytes = 0;
+      auto portQueues = concurrentIndices_->unicastQueueSaiIds.find(port);
+      if (portQueues != concurrentIndices_->unicastQueueSaiIds.cend()) {
+        auto queueSaiId = portQueues->second.find(queue);
+        if (queueSaiId != portQueues->second.end()) {
+          bytes = queueApi.getStats<SaiQueueTraits>(
+              queueSaiId->second,
+              kWatermarkStats,
+              SAI_STATS_MODE_READ_AND_CLEAR)[0];
+        }
+      }
+      peakBytes.push_back(bytes);
+    }
+    return peakBytes;
+  }
+
+  uint64_t readDeviceWatermark() override {
+    static const std::vector<sai_stat_id_t> kWatermarkStats{
+        SAI_BUFFER_POOL_STAT_WATERMARK_BYTES};
+    auto poolSaiId = egressBufferPoolSaiId_->load();
+    if (poolSaiId == SAI_NULL_OBJECT_ID) {
+      return 0;
+    }
+    return SaiApiTable::getInstance()
+        ->bufferApi()
+        .getStats<SaiBufferPoolTraits>(
+            BufferPoolSaiId(poolSaiId),
+            kWatermarkStats,
+            SAI_STATS_MODE_READ_AND_CLEAR)[0];
+  }
+
+ private:
+  const ConcurrentIndices* concurrentIndices_;
+  const std::atomic<sai_object_id_t>* egressBufferPoolSaiId_;
+};
+
 } // namespace
 SaiBufferManager::SaiBufferManager(
     SaiStore* saiStore,
     SaiManagerTable* managerTable,
-    const SaiPlatform* platform)
-    : saiStore_(saiStore), managerTable_(managerTable), platform_(platform) {}
+    const SaiPlatform* platform,
+    const ConcurrentIndices* concurrentIndices)
+    : saiStore_(saiStore),
+      managerTable_(managerTable),
+      platform_(platform),
+      watermarkSampler_(std::make_unique<BufferWatermarkSampler>(
+          std::make_unique<SaiBufferWatermarkReader>(
+              concurrentIndices,
+              &egressBufferPoolSaiId_))) {}
 
 uint64_t SaiBufferManager::getMaxEgressPoolBytes(const SaiPlatform* platform) {
   auto asic = platform->getAsic();
@@ -149,13 +221,17 @@ void SaiBufferManager::setupEgressBufferPool() {
       SAI_BUFFER_POOL_THRESHOLD_MODE_DYNAMIC};
   egressBufferPoolHandle_->bufferPool =
       store.setObject(SAI_BUFFER_POOL_TYPE_EGRESS, c);
+  egressBufferPoolSaiId_ = static_cast<sai_object_id_t>(
+      egressBufferPoolHandle_->bufferPool->adapterKey());
 }
 
 void SaiBufferManager::updateStats() {
   if (egressBufferPoolHandle_) {
     egressBufferPoolHandle_->bufferPool->updateStats();
     auto counters = egressBufferPoolHandle_->bufferPool->getStats();
-    deviceWatermarkBytes_ = counters[SAI_BUFFER_POOL_STAT_WATERMARK_BYTES];
+    deviceWatermarkBytes_ = std::max(
+        counters[SAI_BUFFER_POOL_STAT_WATERMARK_BYTES],
+        watermarkSampler_->collectDevicePeakBytes());
     publishDeviceWatermark(deviceWatermarkBytes_);
   }
 }
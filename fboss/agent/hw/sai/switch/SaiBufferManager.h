@@ -10,12 +10,14 @@
 
 #pragma once
 
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
 #include "fboss/agent/hw/sai/api/BufferApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
 #include "fboss/agent/hw/sai/store/SaiObjectWithCounters.h"
 #include "fboss/agent/types.h"
 #include "fboss/lib/RefMap.h"
 
+#include <atomic>
 #include <memory>
 
 namespace facebook::fboss {
@@ -25,6 +27,7 @@ class SaiPlatform;
 class PortQueue;
 class HwAsic;
 class SaiStore;
+struct ConcurrentIndices;
 
 using SaiBufferPool = SaiObjectWithCounters<SaiBufferPoolTraits>;
 using SaiBufferProfile = SaiObject<SaiBufferProfileTraits>;
@@ -38,7 +41,8 @@ class SaiBufferManager {
   SaiBufferManager(
       SaiStore* saiStore,
       SaiManagerTable* managerTable,
-      const SaiPlatform* platform);
+      const SaiPlatform* platform,
+      const ConcurrentIndices* concurrentIndices);
 
   std::shared_ptr<SaiBufferProfile> getOrCreateProfile(const PortQueue& queue);
 
@@ -48,6 +52,9 @@ class SaiBufferManager {
     return deviceWatermarkBytes_;
   }
   static uint64_t getMaxEgressPoolBytes(const SaiPlatform* platform);
+  BufferWatermarkSampler* getWatermarkSampler() const {
+    return watermarkSampler_.get();
+  }
 
  private:
   void publishDeviceWatermark(uint64_t peakBytes) const;
@@ -61,6 +68,9 @@ class SaiBufferManager {
   UnorderedRefMap<SaiBufferProfileTraits::AdapterHostKey, SaiBufferProfile>
       bufferProfiles_;
   uint64_t deviceWatermarkBytes_{0};
+  // Read by the watermark sampler, which doesn't take the SaiSwitch lock
+  std::atomic<sai_object_id_t> egressBufferPoolSaiId_{SAI_NULL_OBJECT_ID};
+  std::unique_ptr<BufferWatermarkSampler> watermarkSampler_;
 };
 
 } // namespace facebook::fboss
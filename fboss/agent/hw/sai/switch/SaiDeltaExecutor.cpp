@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/switch/SaiDeltaExecutor.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/StateUpdateTracer.h"
+
+#include <folly/ScopeGuard.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+SaiDeltaExecutor::SectionId SaiDeltaExecutor::addSection(
+    std::string name,
+    WalkFn walk,
+    std::vector<SectionId> dependencies) {
+  SectionId id = sections_.size();
+  for (auto dependency : dependencies) {
+    if (dependency >= id) {
+      throw FbossError(
+          "Delta section ", name, " depends on a section added after it");
+    }
+  }
+  sections_.emplace_back(
+      std::move(name), std::move(walk), std::move(dependencies));
+  return id;
+}
+
+void SaiDeltaExecutor::walk(Section& section) {
+  try {
+    section.apply = section.walk();
+  } catch (const std::exception&) {
+    section.walkError = std::current_exception();
+  }
+}
+
+void SaiDeltaExecutor::apply(Section& section) {
+  if (section.walkError) {
+    std::rethrow_exception(section.walkError);
+  }
+  XLOG(DBG3) << "Applying delta section " << section.name;
+  StateUpdateTracer::ScopedSpan span(
+      StateUpdateTracer::kHwCategory, section.name);
+  section.apply();
+}
+
+SaiDeltaExecutor::Section* SaiDeltaExecutor::nextToApplyLocked() {
+  for (auto& section : sections_) {
+    if (section.applied || !section.walked) {
+      continue;
+    }
+    bool ready = true;
+    for (auto dependency : section.dependencies) {
+      if (!sections_[dependency].applied) {
+        ready = false;
+        break;
+      }
+    }
+    if (ready) {
+      return &section;
+    }
+  }
+  return nullptr;
+}
+
+void SaiDeltaExecutor::run() {
+  if (!walkExecutor_) {
+    for (auto& section : sections_) {
+      walk(section);
+      apply(section);
+      section.applied = true;
+    }
+    return;
+  }
+
+  pendingWalks_ = sections_.size();
+  // Walks reference the sections and whatever state the caller handed them,
+  // so never return (or throw) while any of them is still running.
+  SCOPE_EXIT {
+    std::unique_lock<std::mutex> guard(lock_);
+    walkedCv_.wait(guard, [this] { return pendingWalks_ == 0; });
+  };
+  for (auto& section : sections_) {
+    walkExecutor_->add([this, &section] {
+      walk(section);
+      // Notify under the lock, run() may return as soon as it is released
+      std::lock_guard<std::mutex> guard(lock_);
+      section.walked = true;
+      --pendingWalks_;
+      walkedCv_.notify_all();
+    });
+  }
+  // The first section not yet applied has all of its dependencies applied,
+  // so there is always a section to apply once its walk completes.
+  for (size_t applied = 0; applied < sections_.size(); ++applied) {
+    Section* next = nullptr;
+    {
+      std::unique_lock<std::mutex> guard(lock_);
+      walkedCv_.wait(guard, [this, &next] {
+        next = nextToApplyLocked();
+        return next != nullptr;
+      });
+    }
+    apply(*next);
+    std::lock_guard<std::mutex> guard(lock_);
+    next->applied = true;
+  }
+}
+
+} // namespace facebook::fboss
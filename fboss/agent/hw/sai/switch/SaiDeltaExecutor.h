@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/Function.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Runs the sections of a state delta (neighbors, v4 routes, v6 routes,
+ * ACLs ...) that SaiSwitch programs. Each section is split in two:
+ *
+ * - walk: diffs the old and new state and collects the changes. Walks only
+ *   read the (immutable) switch states, take no locks and run in parallel
+ *   on the walk executor.
+ * - apply: programs the collected changes through the managers. Applies
+ *   run one at a time on the calling thread, since managers and the store
+ *   are guarded by a single lock, in dependency order.
+ *
+ * A section is applied once it has been walked and every section it
+ * depends on has been applied. Among such sections, the one added first
+ * wins, so without a walk executor (or when walks keep up) sections are
+ * applied in the order they were added.
+ *
+ * With a large route delta, this overlaps diffing of v6 routes (and of
+ * later sections like ACLs) with programming of v4 routes, and lets
+ * independent sections be programmed while a slow walk is in progress.
+ * Only diffing is parallel: SAI calls are all made by applies, serialized
+ * under the SaiSwitch lock policy.
+ */
+class SaiDeltaExecutor {
+ public:
+  using ApplyFn = folly::Function<void()>;
+  using WalkFn = folly::Function<ApplyFn()>;
+  using SectionId = size_t;
+
+  /*
+   * With a null walkExecutor, each section is walked inline right before
+   * it is applied.
+   */
+  explicit SaiDeltaExecutor(folly::Executor* walkExecutor = nullptr)
+      : walkExecutor_(walkExecutor) {}
+  SaiDeltaExecutor(const SaiDeltaExecutor&) = delete;
+  SaiDeltaExecutor& operator=(const SaiDeltaExecutor&) = delete;
+
+  /*
+   * Sections may only depend on sections added before them.
+   */
+  SectionId addSection(
+      std::string name,
+      WalkFn walk,
+      std::vector<SectionId> dependencies = {});
+
+  /*
+   * Walk and apply all sections. Exceptions from a walk are rethrown when
+   * that section would have been applied, exceptions from an apply are
+   * rethrown right away. Either way sections after it are not applied and
+   * run() returns only once no walk is in progress any more.
+   */
+  void run();
+
+  size_t size() const {
+    return sections_.size();
+  }
+
+ private:
+  struct Section {
+    Section(std::string name, WalkFn walk, std::vector<SectionId> deps)
+        : name(std::move(name)),
+          walk(std::move(walk)),
+          dependencies(std::move(deps)) {}
+
+    std::string name;
+    WalkFn walk;
+    std::vector<SectionId> dependencies;
+    ApplyFn apply;
+    std::exception_ptr walkError;
+    bool walked{false};
+    bool applied{false};
+  };
+
+  static void walk(Section& section);
+  static void apply(Section& section);
+  Section* nextToApplyLocked();
+
+  folly::Executor* walkExecutor_;
+  std::vector<Section> sections_;
+  std::mutex lock_;
+  std::condition_variable walkedCv_;
+  size_t pendingWalks_{0};
+};
+
+} // namespace facebook::fboss
@@ -9,6 +9,8 @@
  */
 #include "fboss/agent/hw/sai/switch/SaiHandler.h"
 
+#include "fboss/agent/hw/sai/api/LoggingUtil.h"
+#include "fboss/agent/hw/sai/api/SaiApiStats.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 
 #include <folly/logging/xlog.h>
@@ -56,4 +58,25 @@ void SaiHandler::diagCmd(
   result = diagCmdServer_.diagCmd(std::move(cmd), std::move(client));
 }
 
+void SaiHandler::getSaiApiCallStats(std::vector<SaiApiCallStats>& stats) {
+  auto apiStats = SaiApiStats::getInstance();
+  if (!apiStats) {
+    throw FbossError("SAI API stats are not available");
+  }
+  for (const auto& callStats : apiStats->getCallStats()) {
+    SaiApiCallStats entry;
+    entry.api_ref() = saiApiTypeToString(callStats.api).str();
+    entry.op_ref() = saiApiOpToString(callStats.op).str();
+    entry.calls_ref() = callStats.calls;
+    entry.errors_ref() = callStats.errors;
+    entry.p50Usecs_ref() = callStats.lastMinute.p50Usecs;
+    entry.p99Usecs_ref() = callStats.lastMinute.p99Usecs;
+    entry.maxUsecs_ref() = callStats.lastMinute.maxUsecs;
+    entry.tenMinuteP50Usecs_ref() = callStats.lastTenMinutes.p50Usecs;
+    entry.tenMinuteP99Usecs_ref() = callStats.lastTenMinutes.p99Usecs;
+    entry.tenMinuteMaxUsecs_ref() = callStats.lastTenMinutes.maxUsecs;
+    stats.push_back(std::move(entry));
+  }
+}
+
 } // namespace facebook::fboss
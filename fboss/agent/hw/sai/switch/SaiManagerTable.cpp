@@ -58,7 +58,8 @@ void SaiManagerTable::createSaiTableManagers(
   aclTableManager_ =
       std::make_unique<SaiAclTableManager>(saiStore, this, platform);
   bridgeManager_ = std::make_unique<SaiBridgeManager>(saiStore, this, platform);
-  bufferManager_ = std::make_unique<SaiBufferManager>(saiStore, this, platform);
+  bufferManager_ = std::make_unique<SaiBufferManager>(
+      saiStore, this, platform, concurrentIndices);
   debugCounterManager_ =
       std::make_unique<SaiDebugCounterManager>(saiStore, this);
   fdbManager_ = std::make_unique<SaiFdbManager>(
@@ -104,6 +105,8 @@ SaiManagerTable::~SaiManagerTable() {
 }
 
 void SaiManagerTable::reset(bool skipSwitchManager) {
+  // Stop reading watermarks of objects about to be removed
+  bufferManager_->getWatermarkSampler()->stop();
   // Need to destroy routes and label fib entries before destroying other
   // managers, as the route and label fib entry destructors will trigger calls
   // in those managers
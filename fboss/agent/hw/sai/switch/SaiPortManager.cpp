@@ -15,8 +15,10 @@
 #include "fboss/agent/hw/HwPortFb303Stats.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_constants.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
 #include "fboss/agent/hw/sai/switch/ConcurrentIndices.h"
 #include "fboss/agent/hw/sai/switch/SaiBridgeManager.h"
+#include "fboss/agent/hw/sai/switch/SaiBufferManager.h"
 #include "fboss/agent/hw/sai/switch/SaiDebugCounterManager.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiPortUtils.h"
@@ -30,6 +32,7 @@
 
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
 #include <chrono>
 
 #include <fmt/ranges.h>
@@ -306,8 +309,11 @@ void SaiPortManager::removePort(const std::shared_ptr<Port>& swPort) {
 
   concurrentIndices_->portIds.erase(itr->second->port->adapterKey());
   concurrentIndices_->portSaiIds.erase(swId);
+  concurrentIndices_->unicastQueueSaiIds.erase(swId);
   concurrentIndices_->vlanIds.erase(
       PortDescriptorSaiId(itr->second->port->adapterKey()));
+  // The watermark sampler may have looked up the port's queues already
+  managerTable_->bufferManager().getWatermarkSampler()->waitForReads();
   addRemovedHandle(itr->first);
   handles_.erase(itr);
   portStats_.erase(swId);
@@ -327,6 +333,7 @@ void SaiPortManager::changeQueue(
   }
   auto pitr = portStats_.find(swId);
   portHandle->configuredQueues.clear();
+  std::map<int, QueueSaiId> unicastQueueSaiIds;
   const auto asic = platform_->getAsic();
   for (auto newPortQueue : newQueueConfig) {
     // Queue create or update
@@ -353,7 +360,16 @@ void SaiPortManager::changeQueue(
       pitr->second->queueChanged(newPortQueue->getID(), queueName);
     }
     portHandle->configuredQueues.push_back(queueHandle);
+    if (newPortQueue->getStreamType() == cfg::StreamType::UNICAST) {
+      unicastQueueSaiIds.emplace(
+          newPortQueue->getID(), queueHandle->queue->adapterKey());
+    }
   }
+  concurrentIndices_->unicastQueueSaiIds.insert_or_assign(
+      swId, std::move(unicastQueueSaiIds));
+  // Removed queues are no longer in the index, but the watermark sampler
+  // may have looked them up already
+  managerTable_->bufferManager().getWatermarkSampler()->waitForReads();
 
   for (auto oldPortQueue : oldQueueConfig) {
     auto portQueueIter = std::find_if(
@@ -697,6 +713,14 @@ void SaiPortManager::updateStats(PortID portId, bool updateWatermarks) {
       toSubtractFromInDiscardsRaw);
   managerTable_->queueManager().updateStats(
       handle->configuredQueues, curPortStats, updateWatermarks);
+  if (updateWatermarks) {
+    // Peaks the sampler read got cleared from the hardware
+    auto sampler = managerTable_->bufferManager().getWatermarkSampler();
+    for (auto& [queueId, bytes] : *curPortStats.queueWatermarkBytes__ref()) {
+      bytes = std::max<int64_t>(
+          bytes, sampler->collectPeakBytes(portId, queueId));
+    }
+  }
   portStats_[portId]->updateStats(curPortStats, now);
 }
 
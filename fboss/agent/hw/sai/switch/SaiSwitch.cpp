@@ -21,6 +21,7 @@
 #include "fboss/agent/hw/sai/api/FdbApi.h"
 #include "fboss/agent/hw/sai/api/HostifApi.h"
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
+#include "fboss/agent/hw/sai/api/SaiApiStats.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
@@ -58,6 +59,8 @@
 #include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 
+#include <fb303/ServiceData.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
 #include <folly/logging/xlog.h>
 
 #include <chrono>
@@ -90,6 +93,35 @@ DEFINE_bool(
 
 DECLARE_bool(enable_acl_table_group);
 
+DEFINE_int32(
+    sai_delta_walk_threads,
+    0,
+    "Number of threads diffing sections of a state delta in parallel with "
+    "HW programming. 0 walks each section inline before programming it");
+
+DEFINE_bool(
+    sai_async_tx,
+    false,
+    "Queue packets sent via sendPacket*Async to a dedicated tx thread, "
+    "instead of sending them on the caller's thread");
+
+DEFINE_int32(
+    sai_tx_queue_depth,
+    4096,
+    "Max packets queued per priority for async tx, beyond which packets "
+    "are dropped");
+
+DEFINE_int32(
+    sai_tx_batch_size,
+    64,
+    "Max packets the async tx thread dequeues at a time");
+
+DEFINE_int32(
+    sai_delta_chunk_size,
+    16,
+    "Max objects of a state delta section programmed per hold of the "
+    "SaiSwitch lock. Link down handling can preempt a chunk after any object");
+
 namespace {
 /*
  * For the devices/SDK we use, the only events we should get (and process)
@@ -168,6 +200,19 @@ SaiSwitch::SaiSwitch(SaiPlatform* platform, uint32_t featuresDesired)
       saiStore_(std::make_unique<SaiStore>()) {
   utilCreateDir(platform_->getVolatileStateDir());
   utilCreateDir(platform_->getPersistentStateDir());
+  if (FLAGS_sai_delta_walk_threads > 0) {
+    deltaWalkExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_sai_delta_walk_threads,
+        std::make_shared<folly::NamedThreadFactory>("SaiDeltaWalk"));
+  }
+  if (FLAGS_sai_async_tx) {
+    txQueue_ = std::make_unique<SaiTxQueue>(
+        [this](SaiTxQueue::TxRequest request) {
+          sendQueuedPacket(std::move(request));
+        },
+        FLAGS_sai_tx_queue_depth,
+        FLAGS_sai_tx_batch_size);
+  }
 }
 
 SaiSwitch::~SaiSwitch() {}
@@ -208,6 +253,10 @@ HwInitResult SaiSwitch::init(
 }
 
 void SaiSwitch::unregisterCallbacks() noexcept {
+  if (txQueue_) {
+    // No more packets go out once hw is no longer expected to call back
+    txQueue_->stop();
+  }
   // after unregistering there could still be a single packet in our
   // pipeline. To fully shut down rx, we need to stop the thread and
   // let the possible last packet get processed. Since processing a
@@ -411,7 +460,8 @@ bool SaiSwitch::l2LearningModeChangeProhibited() const {
 }
 
 std::shared_ptr<SwitchState> SaiSwitch::stateChanged(const StateDelta& delta) {
-  FineGrainedLockPolicy lockPolicy(saiSwitchMutex_);
+  FineGrainedLockPolicy lockPolicy(
+      saiSwitchMutex_, &saiSwitchMutexPriorityWaiters_);
   return stateChangedImpl(delta, lockPolicy);
 }
 
@@ -510,95 +560,140 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       &SaiRouterInterfaceManager::addRouterInterface,
       &SaiRouterInterfaceManager::removeRouterInterface);
 
+  // Neighbors, routes, MPLS and ACLs make up the bulk of large deltas. Diff
+  // them in parallel, and program them as soon as what they depend on has
+  // been programmed. Past routes, sections are programmed in the order they
+  // always were: control plane, MPLS, load balancers and then ACLs.
+  SaiDeltaExecutor deltaExecutor(deltaWalkExecutor_.get());
+  std::vector<SaiDeltaExecutor::SectionId> neighborSections;
   for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<ArpEntry>,
-        &SaiNeighborManager::addNeighbor<ArpEntry>,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<NdpEntry>,
-        &SaiNeighborManager::addNeighbor<NdpEntry>,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
-
-    processDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::changeMac,
-        &SaiFdbManager::addMac,
-        &SaiFdbManager::removeMac);
-  }
-
-  auto processV4RoutesDelta = [this, &lockPolicy](
-                                  RouterID rid, const auto& routesDelta) {
-    processDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::changeRoute<folly::IPAddressV4>,
-        &SaiRouteManager::addRoute<folly::IPAddressV4>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV4>,
-        rid);
-  };
-
-  auto processV6RoutesDelta = [this, &lockPolicy](
-                                  RouterID rid, const auto& routesDelta) {
-    processDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::changeRoute<folly::IPAddressV6>,
-        &SaiRouteManager::addRoute<folly::IPAddressV6>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV6>,
-        rid);
-  };
-
+    auto arpSection =
+        deltaExecutor.addSection("arp", [this, vlanDelta, &lockPolicy] {
+          return walkDelta(
+              vlanDelta.getArpDelta(),
+              managerTable_->neighborManager(),
+              lockPolicy,
+              &SaiNeighborManager::changeNeighbor<ArpEntry>,
+              &SaiNeighborManager::addNeighbor<ArpEntry>,
+              &SaiNeighborManager::removeNeighbor<ArpEntry>);
+        });
+    auto ndpSection = deltaExecutor.addSection(
+        "ndp",
+        [this, vlanDelta, &lockPolicy] {
+          return walkDelta(
+              vlanDelta.getNdpDelta(),
+              managerTable_->neighborManager(),
+              lockPolicy,
+              &SaiNeighborManager::changeNeighbor<NdpEntry>,
+              &SaiNeighborManager::addNeighbor<NdpEntry>,
+              &SaiNeighborManager::removeNeighbor<NdpEntry>);
+        },
+        {arpSection});
+    auto macSection = deltaExecutor.addSection(
+        "mac",
+        [this, vlanDelta, &lockPolicy] {
+          return walkDelta(
+              vlanDelta.getMacDelta(),
+              managerTable_->fdbManager(),
+              lockPolicy,
+              &SaiFdbManager::changeMac,
+              &SaiFdbManager::addMac,
+              &SaiFdbManager::removeMac);
+        },
+        {ndpSection});
+    neighborSections.insert(
+        neighborSections.end(), {arpSection, ndpSection, macSection});
+  }
+
+  // v4 and v6 routes only depend on neighbors, not on each other
+  std::vector<SaiDeltaExecutor::SectionId> routeSections;
   for (const auto& routeDelta : delta.getFibsDelta()) {
     auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
                                         : routeDelta.getNew()->getID();
-    processV4RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV4>());
-    processV6RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV6>());
-  }
-  {
-    auto controlPlaneDelta = delta.getControlPlaneDelta();
-    if (*controlPlaneDelta.getOld() != *controlPlaneDelta.getNew()) {
-      [[maybe_unused]] const auto& lock = lockPolicy.lock();
-      managerTable_->hostifManager().processHostifDelta(controlPlaneDelta);
-    }
-  }
-
-  processDelta(
-      delta.getLabelForwardingInformationBaseDelta(),
-      managerTable_->inSegEntryManager(),
-      lockPolicy,
-      &SaiInSegEntryManager::processChangedInSegEntry,
-      &SaiInSegEntryManager::processAddedInSegEntry,
-      &SaiInSegEntryManager::processRemovedInSegEntry);
-  processDelta(
-      delta.getLoadBalancersDelta(),
-      managerTable_->switchManager(),
-      lockPolicy,
-      &SaiSwitchManager::changeLoadBalancer,
-      &SaiSwitchManager::addOrUpdateLoadBalancer,
-      &SaiSwitchManager::removeLoadBalancer);
-
-  processDelta(
-      delta.getAclsDelta(),
-      managerTable_->aclTableManager(),
-      lockPolicy,
-      &SaiAclTableManager::changedAclEntry,
-      &SaiAclTableManager::addAclEntry,
-      &SaiAclTableManager::removeAclEntry,
-      kAclTable1);
+    auto v4Section = deltaExecutor.addSection(
+        "v4 routes",
+        [this, routeDelta, routerID, &lockPolicy] {
+          return walkDelta(
+              routeDelta.getFibDelta<folly::IPAddressV4>(),
+              managerTable_->routeManager(),
+              lockPolicy,
+              &SaiRouteManager::changeRoute<folly::IPAddressV4>,
+              &SaiRouteManager::addRoute<folly::IPAddressV4>,
+              &SaiRouteManager::removeRoute<folly::IPAddressV4>,
+              routerID);
+        },
+        neighborSections);
+    auto v6Section = deltaExecutor.addSection(
+        "v6 routes",
+        [this, routeDelta, routerID, &lockPolicy] {
+          return walkDelta(
+              routeDelta.getFibDelta<folly::IPAddressV6>(),
+              managerTable_->routeManager(),
+              lockPolicy,
+              &SaiRouteManager::changeRoute<folly::IPAddressV6>,
+              &SaiRouteManager::addRoute<folly::IPAddressV6>,
+              &SaiRouteManager::removeRoute<folly::IPAddressV6>,
+              routerID);
+        },
+        neighborSections);
+    routeSections.insert(routeSections.end(), {v4Section, v6Section});
+  }
+  auto controlPlaneDependencies = neighborSections;
+  controlPlaneDependencies.insert(
+      controlPlaneDependencies.end(),
+      routeSections.begin(),
+      routeSections.end());
+  auto controlPlaneSection = deltaExecutor.addSection(
+      "control plane",
+      [this, &delta, &lockPolicy] {
+        return SaiDeltaExecutor::ApplyFn([this, &delta, &lockPolicy] {
+          auto controlPlaneDelta = delta.getControlPlaneDelta();
+          if (*controlPlaneDelta.getOld() != *controlPlaneDelta.getNew()) {
+            [[maybe_unused]] const auto& lock = lockPolicy.lock();
+            managerTable_->hostifManager().processHostifDelta(
+                controlPlaneDelta);
+          }
+        });
+      },
+      std::move(controlPlaneDependencies));
+  auto mplsSection = deltaExecutor.addSection(
+      "mpls",
+      [this, &delta, &lockPolicy] {
+        return walkDelta(
+            delta.getLabelForwardingInformationBaseDelta(),
+            managerTable_->inSegEntryManager(),
+            lockPolicy,
+            &SaiInSegEntryManager::processChangedInSegEntry,
+            &SaiInSegEntryManager::processAddedInSegEntry,
+            &SaiInSegEntryManager::processRemovedInSegEntry);
+      },
+      {controlPlaneSection});
+  auto loadBalancerSection = deltaExecutor.addSection(
+      "load balancers",
+      [this, &delta, &lockPolicy] {
+        return walkDelta(
+            delta.getLoadBalancersDelta(),
+            managerTable_->switchManager(),
+            lockPolicy,
+            &SaiSwitchManager::changeLoadBalancer,
+            &SaiSwitchManager::addOrUpdateLoadBalancer,
+            &SaiSwitchManager::removeLoadBalancer);
+      },
+      {mplsSection});
+  deltaExecutor.addSection(
+      "acls",
+      [this, &delta, &lockPolicy] {
+        return walkDelta(
+            delta.getAclsDelta(),
+            managerTable_->aclTableManager(),
+            lockPolicy,
+            &SaiAclTableManager::changedAclEntry,
+            &SaiAclTableManager::addAclEntry,
+            &SaiAclTableManager::removeAclEntry,
+            kAclTable1);
+      },
+      {loadBalancerSection});
+  deltaExecutor.run();
 
   if (platform_->getAsic()->isSupported(
           HwAsic::Feature::RESOURCE_USAGE_STATS)) {
@@ -731,14 +826,49 @@ std::unique_ptr<TxPacket> SaiSwitch::allocatePacket(uint32_t size) const {
 
 bool SaiSwitch::sendPacketSwitchedAsync(
     std::unique_ptr<TxPacket> pkt) noexcept {
-  return sendPacketSwitchedSync(std::move(pkt));
+  if (!txQueue_) {
+    return sendPacketSwitchedSync(std::move(pkt));
+  }
+  return queuePacket(std::move(pkt), std::nullopt, std::nullopt);
 }
 
 bool SaiSwitch::sendPacketOutOfPortAsync(
     std::unique_ptr<TxPacket> pkt,
     PortID portID,
     std::optional<uint8_t> queueId) noexcept {
-  return sendPacketOutOfPortSync(std::move(pkt), portID, queueId);
+  if (!txQueue_) {
+    return sendPacketOutOfPortSync(std::move(pkt), portID, queueId);
+  }
+  return queuePacket(std::move(pkt), portID, queueId);
+}
+
+bool SaiSwitch::queuePacket(
+    std::unique_ptr<TxPacket> pkt,
+    std::optional<PortID> portID,
+    std::optional<uint8_t> queueId) noexcept {
+  auto priority = SaiTxQueue::getPriority(*pkt, portID, queueId);
+  size_t depth = 0;
+  auto queued = txQueue_->enqueue(
+      priority, SaiTxQueue::TxRequest{std::move(pkt), portID, queueId}, &depth);
+  getSwitchStats()->txQueueDepth(depth);
+  if (!queued) {
+    XLOG_EVERY_MS(ERR, 1000) << "Async tx queue full, dropping packet";
+    getSwitchStats()->txQueueFull();
+    return false;
+  }
+  return true;
+}
+
+void SaiSwitch::sendQueuedPacket(SaiTxQueue::TxRequest request) noexcept {
+  if (request.portID) {
+    sendPacketOutOfPortSync(
+        std::move(request.pkt), *request.portID, request.queueId);
+  } else {
+    sendPacketSwitchedSync(std::move(request.pkt));
+  }
+  auto queued = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - request.enqueued);
+  getSwitchStats()->txSentDone(queued.count());
 }
 
 void SaiSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
@@ -783,6 +913,35 @@ void SaiSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
     std::lock_guard<std::mutex> locked(saiSwitchMutex_);
     managerTable_->aclTableManager().updateStats();
   }
+  publishSaiApiCallStats();
+}
+
+void SaiSwitch::publishSaiApiCallStats() const {
+  auto apiStats = SaiApiStats::getInstance();
+  if (!apiStats) {
+    return;
+  }
+  for (const auto& callStats : apiStats->getCallStats()) {
+    auto prefix = folly::to<std::string>(
+        "sai.",
+        saiApiTypeToString(callStats.api),
+        ".",
+        saiApiOpToString(callStats.op),
+        ".");
+    fb303::fbData->setCounter(prefix + "calls", callStats.calls);
+    fb303::fbData->setCounter(prefix + "errors", callStats.errors);
+    // Suffixed with the window in seconds, as fb303 histograms are
+    for (const auto& [latency, window] :
+         {std::make_pair(callStats.lastMinute, ".60"),
+          std::make_pair(callStats.lastTenMinutes, ".600")}) {
+      fb303::fbData->setCounter(
+          prefix + "latency_us.p50" + window, latency.p50Usecs);
+      fb303::fbData->setCounter(
+          prefix + "latency_us.p99" + window, latency.p99Usecs);
+      fb303::fbData->setCounter(
+          prefix + "latency_us.max" + window, latency.maxUsecs);
+    }
+  }
 }
 
 uint64_t SaiSwitch::getDeviceWatermarkBytes() const {
@@ -795,6 +954,11 @@ uint64_t SaiSwitch::getDeviceWatermarkBytesLocked(
   return managerTable_->bufferManager().getDeviceWatermarkBytes();
 }
 
+BufferWatermarkSampler* SaiSwitch::getBufferWatermarkSampler() const {
+  // The sampler is safe to use without saiSwitchMutex_
+  return managerTable_->bufferManager().getWatermarkSampler();
+}
+
 folly::F14FastMap<std::string, HwPortStats> SaiSwitch::getPortStats() const {
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
   return getPortStatsLocked(lock);
@@ -958,7 +1122,7 @@ void SaiSwitch::linkStateChangedCallbackBottomHalf(
        * guaranteed to have the link be ready for packet transmission, since we
        * already resolved neighbors over that link.
        */
-      std::lock_guard<std::mutex> lock{saiSwitchMutex_};
+      PriorityLockGuard lock{saiSwitchMutex_, saiSwitchMutexPriorityWaiters_};
       if (swAggPort) {
         // member of lag is gone down. unbundle it from LAG
         // once link comes back up LACP engine in SwSwitch will bundle it again
@@ -1874,6 +2038,59 @@ void SaiSwitch::processDelta(
       });
 }
 
+template <
+    typename Delta,
+    typename Manager,
+    typename LockPolicyT,
+    typename... Args,
+    typename ChangeFunc,
+    typename AddedFunc,
+    typename RemovedFunc>
+SaiDeltaExecutor::ApplyFn SaiSwitch::walkDelta(
+    const Delta& delta,
+    Manager& manager,
+    const LockPolicyT& lockPolicy,
+    ChangeFunc changedFunc,
+    AddedFunc addedFunc,
+    RemovedFunc removedFunc,
+    Args... args) {
+  using NodePtr = std::shared_ptr<typename Delta::Node>;
+  // Changes in delta iteration order, with a null old (new) node for added
+  // (removed) nodes, so they are programmed in the same order processDelta
+  // would program them.
+  std::vector<std::pair<NodePtr, NodePtr>> changes;
+  for (const auto& entry : delta) {
+    changes.emplace_back(entry.getOld(), entry.getNew());
+  }
+  size_t chunkSize = std::max(FLAGS_sai_delta_chunk_size, 1);
+  return [changes = std::move(changes),
+          chunkSize,
+          &manager,
+          &lockPolicy,
+          changedFunc,
+          addedFunc,
+          removedFunc,
+          args...]() {
+    // Program in bounded chunks, giving up the lock in between and as soon as
+    // the link down fast path wants it.
+    size_t i = 0;
+    while (i < changes.size()) {
+      [[maybe_unused]] const auto& lock = lockPolicy.lockChunk();
+      auto chunkEnd = std::min(changes.size(), i + chunkSize);
+      do {
+        const auto& [oldNode, newNode] = changes[i++];
+        if (oldNode && newNode) {
+          (manager.*changedFunc)(oldNode, newNode, args...);
+        } else if (newNode) {
+          (manager.*addedFunc)(newNode, args...);
+        } else {
+          (manager.*removedFunc)(oldNode, args...);
+        }
+      } while (i < chunkEnd && !lockPolicy.shouldYield());
+    }
+  };
+}
+
 template <
     typename Delta,
     typename Manager,
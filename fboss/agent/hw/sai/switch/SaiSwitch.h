@@ -11,13 +11,17 @@
 
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/L2Entry.h"
+#include "fboss/agent/LockPolicy.h"
 #include "fboss/agent/hw/HwSwitchStats.h"
 #include "fboss/agent/hw/gen-cpp2/hardware_stats_types.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/switch/SaiDeltaExecutor.h"
 #include "fboss/agent/hw/sai/switch/SaiManagerTable.h"
 #include "fboss/agent/hw/sai/switch/SaiRxPacket.h"
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/io/async/EventBase.h>
 
 #include <memory>
@@ -103,6 +107,7 @@ class SaiSwitch : public HwSwitch {
   folly::F14FastMap<std::string, HwPortStats> getPortStats() const override;
 
   uint64_t getDeviceWatermarkBytes() const override;
+  BufferWatermarkSampler* getBufferWatermarkSampler() const override;
 
   void fetchL2Table(std::vector<L2EntryThrift>* l2Table) const override;
 
@@ -198,6 +203,8 @@ class SaiSwitch : public HwSwitch {
   void switchRunStateChangedImpl(SwitchRunState newState) override;
 
   void updateStatsImpl(SwitchStats* switchStats) override;
+  // Export SAI API call counts and latencies as fb303 counters
+  void publishSaiApiCallStats() const;
   template <typename LockPolicyT>
   void updateResourceUsage(const LockPolicyT& lockPolicy);
   /*
@@ -324,6 +331,32 @@ class SaiSwitch : public HwSwitch {
       RemovedFunc removedFunc,
       Args... args);
 
+  /*
+   * Like processDelta, but only collects the changes in delta, returning
+   * a function that programs them. For use as a SaiDeltaExecutor section.
+   */
+  template <
+      typename Delta,
+      typename Manager,
+      typename LockPolicyT,
+      typename... Args,
+      typename ChangeFunc = void (Manager::*)(
+          const std::shared_ptr<typename Delta::Node>&,
+          const std::shared_ptr<typename Delta::Node>&,
+          Args...),
+      typename AddedFunc = void (
+          Manager::*)(const std::shared_ptr<typename Delta::Node>&, Args...),
+      typename RemovedFunc = void (
+          Manager::*)(const std::shared_ptr<typename Delta::Node>&, Args...)>
+  SaiDeltaExecutor::ApplyFn walkDelta(
+      const Delta& delta,
+      Manager& manager,
+      const LockPolicyT& lockPolicy,
+      ChangeFunc changedFunc,
+      AddedFunc addedFunc,
+      RemovedFunc removedFunc,
+      Args... args);
+
   template <
       typename Delta,
       typename Manager,
@@ -388,6 +421,13 @@ class SaiSwitch : public HwSwitch {
 
   std::shared_ptr<SwitchState> getColdBootSwitchState();
 
+  bool queuePacket(
+      std::unique_ptr<TxPacket> pkt,
+      std::optional<PortID> portID,
+      std::optional<uint8_t> queueId) noexcept;
+  // Called on the async tx thread
+  void sendQueuedPacket(SaiTxQueue::TxRequest request) noexcept;
+
   std::optional<L2Entry> getL2Entry(
       const FdbEventNotificationData& fdbEvent) const;
 
@@ -395,7 +435,8 @@ class SaiSwitch : public HwSwitch {
    * SaiSwitch must support a few varieties of concurrent access:
    * 1. state updates on the SwSwitch update thread calling stateChanged
    * 2. packet rx callback
-   * 3. async tx thread
+   * 3. async tx thread, sending packets queued on txQueue_ when
+   *    --sai_async_tx is set, and on the caller's thread otherwise
    * 4. port state event callback (i.e., linkscan)
    * 5. stats collection
    * 6. getters exposed to thrift or other threads
@@ -415,6 +456,12 @@ class SaiSwitch : public HwSwitch {
    * performance by 2000 pps.
    */
   mutable std::mutex saiSwitchMutex_;
+  /*
+   * Link down fast path threads waiting for saiSwitchMutex_. State delta
+   * programming gives up the mutex at the end of its current chunk of work
+   * for them, so an ECMP shrink does not wait for a whole delta.
+   */
+  PriorityLockWaiters saiSwitchMutexPriorityWaiters_;
   std::unique_ptr<ConcurrentIndices> concurrentIndices_;
 
   SaiPlatform* platform_;
@@ -427,11 +474,17 @@ class SaiSwitch : public HwSwitch {
 
   SwitchSaiId switchId_;
 
+  // Walks delta sections in parallel, null if --sai_delta_walk_threads is 0
+  std::unique_ptr<folly::CPUThreadPoolExecutor> deltaWalkExecutor_;
+
   std::unique_ptr<std::thread> linkStateBottomHalfThread_;
   folly::EventBase linkStateBottomHalfEventBase_;
   std::unique_ptr<std::thread> fdbEventBottomHalfThread_;
   folly::EventBase fdbEventBottomHalfEventBase_;
 
+  // Sends packets for sendPacket*Async, null if --sai_async_tx is off
+  std::unique_ptr<SaiTxQueue> txQueue_;
+
   HwResourceStats hwResourceStats_;
   std::atomic<SwitchRunState> runState_{SwitchRunState::UNINITIALIZED};
 
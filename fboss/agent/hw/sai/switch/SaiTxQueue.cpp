@@ -0,0 +1,167 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
+
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/packet/PktMetadata.h"
+
+#include <folly/logging/xlog.h>
+#include <folly/system/ThreadName.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+using facebook::fboss::ICMPv6Type;
+using facebook::fboss::IP_PROTO;
+using facebook::fboss::PktMetadata;
+
+// Single hop and multi hop BFD control packets
+constexpr uint16_t kBfdPort = 3784;
+constexpr uint16_t kBfdMultihopPort = 4784;
+
+bool isBfd(const PktMetadata& metadata) {
+  return metadata.ipProtocol == static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP) &&
+      metadata.hasL4Ports() &&
+      (metadata.l4DstPort == kBfdPort ||
+       metadata.l4DstPort == kBfdMultihopPort);
+}
+
+// Router and neighbor solicitations and advertisements, and redirects
+bool isNdp(const PktMetadata& metadata) {
+  if (metadata.ipProtocol !=
+          static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP) ||
+      !metadata.hasL4()) {
+    return false;
+  }
+  auto type = static_cast<ICMPv6Type>(metadata.icmpType);
+  return type >= ICMPv6Type::ICMPV6_TYPE_NDP_ROUTER_SOLICITATION &&
+      type <= ICMPv6Type::ICMPV6_TYPE_NDP_REDIRECT_MESSAGE;
+}
+
+} // namespace
+
+namespace facebook::fboss {
+
+SaiTxQueue::SaiTxQueue(SendFn send, size_t maxDepth, size_t batchSize)
+    : send_(std::move(send)),
+      maxDepth_(std::max<size_t>(maxDepth, 1)),
+      batchSize_(std::max<size_t>(batchSize, 1)) {
+  senderThread_ = std::thread([this] {
+    folly::setThreadName("SaiTxQueue");
+    senderLoop();
+  });
+}
+
+SaiTxQueue::~SaiTxQueue() {
+  stop();
+}
+
+SaiTxQueue::Priority SaiTxQueue::getPriority(
+    const TxPacket& pkt,
+    std::optional<PortID> portID,
+    std::optional<uint8_t> queueId) {
+  if (queueId) {
+    // Only network control packets pick their egress queue
+    return Priority::HIGH;
+  }
+  auto metadata = PktMetadata::parse(pkt.buf());
+  switch (static_cast<ETHERTYPE>(metadata.etherType)) {
+    case ETHERTYPE::ETHERTYPE_ARP:
+    case ETHERTYPE::ETHERTYPE_LLDP:
+    case ETHERTYPE::ETHERTYPE_SLOW_PROTOCOLS:
+      return Priority::HIGH;
+    case ETHERTYPE::ETHERTYPE_IPV4:
+    case ETHERTYPE::ETHERTYPE_IPV6:
+      if (isBfd(metadata) || isNdp(metadata)) {
+        return Priority::HIGH;
+      }
+      break;
+    default:
+      break;
+  }
+  return portID ? Priority::NORMAL : Priority::LOW;
+}
+
+bool SaiTxQueue::enqueue(
+    Priority priority,
+    TxRequest request,
+    size_t* depth) {
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (depth) {
+      *depth = depth_;
+    }
+    auto& queue = queues_[static_cast<size_t>(priority)];
+    if (stopped_ || queue.size() >= maxDepth_) {
+      return false;
+    }
+    request.enqueued = std::chrono::steady_clock::now();
+    queue.push_back(std::move(request));
+    ++depth_;
+  }
+  cv_.notify_one();
+  return true;
+}
+
+size_t SaiTxQueue::depth() const {
+  std::lock_guard<std::mutex> g(lock_);
+  return depth_;
+}
+
+void SaiTxQueue::stop() {
+  {
+    std::lock_guard<std::mutex> g(lock_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  cv_.notify_one();
+  senderThread_.join();
+  std::lock_guard<std::mutex> g(lock_);
+  if (depth_) {
+    XLOG(WARNING) << "Dropping " << depth_ << " queued tx packets on stop";
+  }
+  for (auto& queue : queues_) {
+    queue.clear();
+  }
+  depth_ = 0;
+}
+
+void SaiTxQueue::senderLoop() {
+  std::vector<TxRequest> batch;
+  batch.reserve(batchSize_);
+  while (true) {
+    {
+      std::unique_lock<std::mutex> g(lock_);
+      cv_.wait(g, [this] { return stopped_ || depth_ > 0; });
+      if (stopped_) {
+        return;
+      }
+      for (auto& queue : queues_) {
+        while (!queue.empty() && batch.size() < batchSize_) {
+          batch.push_back(std::move(queue.front()));
+          queue.pop_front();
+        }
+      }
+      depth_ -= batch.size();
+    }
+    for (auto& request : batch) {
+      send_(std::move(request));
+    }
+    batch.clear();
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/TxPacket.h"
+#include "fboss/agent/types.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace facebook::fboss {
+
+/*
+ * Queue of packets to be sent by SaiSwitch asynchronously, drained by a
+ * dedicated sender thread, so that callers of sendPacket*Async (rx, neighbor,
+ * LACP threads) do not block on the SAI hostif send.
+ *
+ * Packets are queued by priority and the sender always drains higher
+ * priorities first, taking up to batchSize packets per wakeup. Each priority
+ * holds at most maxDepth packets, beyond which enqueue fails, so that a flood
+ * of bulk traffic can neither grow the queue unbounded nor crowd out network
+ * control packets.
+ */
+class SaiTxQueue {
+ public:
+  enum class Priority : uint8_t {
+    // Network control: LACP, LLDP, ARP, NDP, BFD, packets for a specific
+    // egress queue
+    HIGH,
+    // Other packets sent out of a port
+    NORMAL,
+    // Other packets sent through the pipeline, e.g. ICMP errors
+    LOW,
+  };
+  static constexpr size_t kNumPriorities = 3;
+
+  struct TxRequest {
+    std::unique_ptr<TxPacket> pkt;
+    // Sent out of this port, or through the pipeline if not set
+    std::optional<PortID> portID;
+    std::optional<uint8_t> queueId;
+    std::chrono::steady_clock::time_point enqueued;
+  };
+  using SendFn = std::function<void(TxRequest request)>;
+
+  SaiTxQueue(SendFn send, size_t maxDepth, size_t batchSize);
+  ~SaiTxQueue();
+
+  static Priority getPriority(
+      const TxPacket& pkt,
+      std::optional<PortID> portID,
+      std::optional<uint8_t> queueId);
+
+  /*
+   * Returns false, dropping the packet, if the queue for this priority is
+   * full or the queue was stopped. If depth is set, it is filled with the
+   * depth seen by this enqueue, so callers need not take the lock again
+   * through depth().
+   */
+  bool enqueue(Priority priority, TxRequest request, size_t* depth = nullptr);
+
+  // Packets queued across all priorities
+  size_t depth() const;
+
+  /*
+   * Stop the sender thread, dropping packets not yet sent. No packets are
+   * sent once this returns.
+   */
+  void stop();
+
+ private:
+  void senderLoop();
+
+  // Forbidden copy constructor and assignment operator
+  SaiTxQueue(SaiTxQueue const&) = delete;
+  SaiTxQueue& operator=(SaiTxQueue const&) = delete;
+
+  const SendFn send_;
+  const size_t maxDepth_;
+  const size_t batchSize_;
+
+  mutable std::mutex lock_;
+  std::condition_variable cv_;
+  std::array<std::deque<TxRequest>, kNumPriorities> queues_;
+  size_t depth_{0};
+  bool stopped_{false};
+  std::thread senderThread_;
+};
+
+} // namespace facebook::fboss
@@ -53,11 +53,16 @@ PortSaiId SaiPortManager::addPort(const std::shared_ptr<Port>& swPort) {
     portStats_.emplace(
         swPort->getID(), std::make_unique<HwPortFb303Stats>(swPort->getName()));
   }
+  std::map<int, QueueSaiId> unicastQueueSaiIds;
   for (auto portQueue : swPort->getPortQueues()) {
     auto queueKey =
         std::make_pair(portQueue->getID(), portQueue->getStreamType());
     const auto& configuredQueue = handle->queues[queueKey];
     handle->configuredQueues.push_back(configuredQueue.get());
+    if (portQueue->getStreamType() == cfg::StreamType::UNICAST) {
+      unicastQueueSaiIds.emplace(
+          portQueue->getID(), configuredQueue->queue->adapterKey());
+    }
     portQueue->setReservedBytes(
         portQueue->getReservedBytes()
             ? *portQueue->getReservedBytes()
@@ -103,6 +108,10 @@ PortSaiId SaiPortManager::addPort(const std::shared_ptr<Port>& swPort) {
   concurrentIndices_->portIds.emplace(saiPort->adapterKey(), swPort->getID());
   concurrentIndices_->portSaiIds.emplace(
       swPort->getID(), saiPort->adapterKey());
+  // As after changeQueue(), so the watermark sampler reads the queues of
+  // ports added at boot or by config too
+  concurrentIndices_->unicastQueueSaiIds.insert_or_assign(
+      swPort->getID(), std::move(unicastQueueSaiIds));
   concurrentIndices_->vlanIds.emplace(
       PortDescriptorSaiId(saiPort->adapterKey()), swPort->getIngressVlan());
   XLOG(INFO) << "added port " << swPort->getID() << " with vlan "
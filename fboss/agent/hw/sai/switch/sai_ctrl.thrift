@@ -6,9 +6,27 @@ namespace py3 neteng.fboss
 include "fboss/agent/if/fboss.thrift"
 include "fboss/agent/if/ctrl.thrift"
 
+// Calls made to one SAI API operation since the agent started. Latencies
+// are of the calls in the last minute and, for the tenMinute ones, in the
+// last 10 minutes, and are 0 if there were none.
+struct SaiApiCallStats {
+  1: string api;
+  2: string op;
+  3: i64 calls;
+  4: i64 errors;
+  5: i64 p50Usecs;
+  6: i64 p99Usecs;
+  7: i64 maxUsecs;
+  8: i64 tenMinuteP50Usecs;
+  9: i64 tenMinuteP99Usecs;
+  10: i64 tenMinuteMaxUsecs;
+}
+
 service SaiCtrl extends ctrl.FbossCtrl {
   string, stream<string> startDiagShell()
     throws (1: fboss.FbossBaseError error)
   void produceDiagShellInput(1: string input, 2: ctrl.ClientInformation client)
     throws (1: fboss.FbossBaseError error)
+  list<SaiApiCallStats> getSaiApiCallStats()
+    throws (1: fboss.FbossBaseError error)
 }
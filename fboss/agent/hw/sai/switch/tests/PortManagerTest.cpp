@@ -10,6 +10,7 @@
 #include "fboss/agent/hw/HwPortFb303Stats.h"
 #include "fboss/agent/hw/StatsConstants.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
+#include "fboss/agent/hw/sai/switch/SaiBufferManager.h"
 #include "fboss/agent/hw/sai/switch/SaiPortManager.h"
 #include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
 #include "fboss/agent/platforms/sai/SaiPlatform.h"
@@ -18,8 +19,11 @@
 #include "fboss/agent/types.h"
 
 #include <fb303/ServiceData.h>
+#include <folly/json.h>
 
+#include <chrono>
 #include <string>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -33,6 +37,11 @@ class PortManagerTest : public ManagerTestBase {
     p0 = testInterfaces[0].remoteHosts[0].port;
     p1 = testInterfaces[1].remoteHosts[0].port;
   }
+
+  void TearDown() override {
+    fs->costModel.clear();
+    ManagerTestBase::TearDown();
+  }
   // TODO: make it properly handle different lanes/speeds for different
   // port ids...
   void checkPort(
@@ -212,6 +221,28 @@ TEST_F(PortManagerTest, removePort) {
   EXPECT_FALSE(port);
 }
 
+TEST_F(PortManagerTest, watermarkSamplerReadsAddedPort) {
+  std::shared_ptr<Port> swPort = makePort(p0);
+  QueueConfig queues;
+  queues.push_back(makePortQueue(1));
+  swPort->resetPortQueues(queues);
+  saiManagerTable->portManager().addPort(swPort);
+
+  // Watermarks are always 0 in fake SAI, so count the queue reads instead
+  fs->costModel.load(folly::parseJson(R"({
+    "objects": {"queue": {"getStats": {"fixedUsecs": 1}}}
+  })"));
+  auto sampler = saiManagerTable->bufferManager().getWatermarkSampler();
+  sampler->start({{swPort->getID(), 1}}, std::chrono::milliseconds(1));
+  while (sampler->getNumSamples() == 0) {
+    std::this_thread::yield();
+  }
+  sampler->stop();
+  EXPECT_EQ(
+      fs->costModel.simulatedTime(),
+      std::chrono::microseconds(sampler->getNumSamples()));
+}
+
 TEST_F(PortManagerTest, removeNonExistentPort) {
   std::shared_ptr<Port> swPort = makePort(p0);
   saiManagerTable->portManager().addPort(swPort);
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Runs SaiDeltaExecutor over sections shaped like the ones
+ * SaiSwitch::stateChangedImpl adds for a large route delta: per VLAN
+ * neighbor sections, v4 and v6 route sections depending on them, then
+ * control plane, MPLS, load balancer and ACL sections in a chain.
+ *
+ * Walks diff two maps, as the state delta walks do. Applies wait
+ * --delta_apply_usecs_per_change for every change, standing in for SAI
+ * calls waiting on the SDK and hardware. So this measures how much diffing
+ * overlaps with programming, without the rest of the agent.
+ */
+
+#include "fboss/agent/hw/sai/switch/SaiDeltaExecutor.h"
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+DEFINE_int32(delta_v4_routes, 50000, "Size of the v4 route tables diffed");
+DEFINE_int32(delta_v6_routes, 50000, "Size of the v6 route tables diffed");
+DEFINE_int32(delta_walk_threads, 4, "Walk threads of the parallel run");
+DEFINE_double(
+    delta_apply_usecs_per_change,
+    1.0,
+    "Time each change takes to program");
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kNumVlans = 4;
+constexpr int kNeighborsPerVlan = 512;
+constexpr int kNumAcls = 512;
+
+/*
+ * Half of the old entries are removed, the other half changed, and as many
+ * new entries added.
+ */
+struct Table {
+  explicit Table(uint64_t size) {
+    for (uint64_t i = 0; i < size; ++i) {
+      oldEntries.emplace(i, 0);
+      newEntries.emplace(i + size / 2, 1);
+    }
+  }
+
+  std::map<uint64_t, uint64_t> oldEntries;
+  std::map<uint64_t, uint64_t> newEntries;
+};
+
+std::vector<uint64_t> diff(const Table& table) {
+  std::vector<uint64_t> changes;
+  auto oldIt = table.oldEntries.begin();
+  auto newIt = table.newEntries.begin();
+  while (oldIt != table.oldEntries.end() || newIt != table.newEntries.end()) {
+    if (newIt == table.newEntries.end() ||
+        (oldIt != table.oldEntries.end() && oldIt->first < newIt->first)) {
+      changes.push_back(oldIt++->first);
+    } else if (
+        oldIt == table.oldEntries.end() || newIt->first < oldIt->first) {
+      changes.push_back(newIt++->first);
+    } else {
+      if (oldIt->second != newIt->second) {
+        changes.push_back(newIt->first);
+      }
+      ++oldIt;
+      ++newIt;
+    }
+  }
+  return changes;
+}
+
+void applyChanges(const std::vector<uint64_t>& changes) {
+  // Sleep in batches, single changes are below the timer resolution
+  constexpr size_t kBatchSize = 256;
+  for (size_t i = 0; i < changes.size(); i += kBatchSize) {
+    auto batch = std::min(kBatchSize, changes.size() - i);
+    folly::doNotOptimizeAway(changes[i]);
+    std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(
+        batch * FLAGS_delta_apply_usecs_per_change * 1000)));
+  }
+}
+
+SaiDeltaExecutor::WalkFn walkTable(const Table& table) {
+  return [&table]() -> SaiDeltaExecutor::ApplyFn {
+    return [changes = diff(table)]() { applyChanges(changes); };
+  };
+}
+
+struct Delta {
+  Delta()
+      : v4Routes(FLAGS_delta_v4_routes),
+        v6Routes(FLAGS_delta_v6_routes),
+        controlPlane(16),
+        mpls(0),
+        loadBalancers(2),
+        acls(kNumAcls) {
+    // ARP, NDP and MAC tables of every VLAN
+    for (int i = 0; i < kNumVlans * 3; ++i) {
+      neighbors.emplace_back(kNeighborsPerVlan);
+    }
+  }
+
+  std::vector<Table> neighbors;
+  Table v4Routes;
+  Table v6Routes;
+  Table controlPlane;
+  Table mpls;
+  Table loadBalancers;
+  Table acls;
+};
+
+void runDelta(const Delta& delta, folly::Executor* walkExecutor) {
+  SaiDeltaExecutor executor(walkExecutor);
+  std::vector<SaiDeltaExecutor::SectionId> neighborSections;
+  for (size_t i = 0; i < delta.neighbors.size(); ++i) {
+    neighborSections.push_back(executor.addSection(
+        "neighbors" + std::to_string(i), walkTable(delta.neighbors[i])));
+  }
+  auto routesDone = neighborSections;
+  routesDone.push_back(executor.addSection(
+      "v4 routes", walkTable(delta.v4Routes), neighborSections));
+  routesDone.push_back(executor.addSection(
+      "v6 routes", walkTable(delta.v6Routes), neighborSections));
+  auto controlPlane = executor.addSection(
+      "control plane", walkTable(delta.controlPlane), routesDone);
+  auto mpls =
+      executor.addSection("mpls", walkTable(delta.mpls), {controlPlane});
+  auto loadBalancers = executor.addSection(
+      "load balancers", walkTable(delta.loadBalancers), {mpls});
+  executor.addSection("acls", walkTable(delta.acls), {loadBalancers});
+  executor.run();
+}
+
+void deltaBenchmark(unsigned int iters, int walkThreads) {
+  std::unique_ptr<Delta> delta;
+  std::unique_ptr<folly::CPUThreadPoolExecutor> walkExecutor;
+  BENCHMARK_SUSPEND {
+    delta = std::make_unique<Delta>();
+    if (walkThreads > 0) {
+      walkExecutor =
+          std::make_unique<folly::CPUThreadPoolExecutor>(walkThreads);
+    }
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    runDelta(*delta, walkExecutor.get());
+  }
+  BENCHMARK_SUSPEND {
+    walkExecutor.reset();
+    delta.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(SaiDeltaInlineWalks, iters) {
+  deltaBenchmark(iters, 0);
+}
+
+BENCHMARK_RELATIVE(SaiDeltaParallelWalks, iters) {
+  deltaBenchmark(iters, FLAGS_delta_walk_threads);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/switch/SaiDeltaExecutor.h"
+#include "fboss/agent/FbossError.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+class SaiDeltaExecutorTest : public ::testing::TestWithParam<bool> {
+ public:
+  void SetUp() override {
+    if (GetParam()) {
+      walkExecutor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+    }
+  }
+
+ protected:
+  SaiDeltaExecutor::WalkFn recordSection(int id) {
+    return [this, id] {
+      return SaiDeltaExecutor::ApplyFn([this, id] { applied.push_back(id); });
+    };
+  }
+  size_t appliedAt(int id) const {
+    return std::find(applied.begin(), applied.end(), id) - applied.begin();
+  }
+
+  std::unique_ptr<folly::CPUThreadPoolExecutor> walkExecutor;
+  std::vector<int> applied;
+};
+
+TEST_P(SaiDeltaExecutorTest, appliesAfterDependencies) {
+  SaiDeltaExecutor executor(walkExecutor.get());
+  auto neighbors = executor.addSection("neighbors", [this] {
+    // Let the other walks complete first
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    return SaiDeltaExecutor::ApplyFn([this] { applied.push_back(0); });
+  });
+  executor.addSection("v4 routes", recordSection(1), {neighbors});
+  executor.addSection("v6 routes", recordSection(2), {neighbors});
+  executor.addSection("acls", recordSection(3));
+  executor.run();
+  ASSERT_EQ(applied.size(), 4);
+  EXPECT_LT(appliedAt(0), appliedAt(1));
+  EXPECT_LT(appliedAt(0), appliedAt(2));
+  if (!walkExecutor) {
+    // Inline walks preserve the order sections were added in
+    EXPECT_EQ(applied, std::vector<int>({0, 1, 2, 3}));
+  }
+}
+
+TEST_P(SaiDeltaExecutorTest, walkErrorStopsLaterSections) {
+  SaiDeltaExecutor executor(walkExecutor.get());
+  executor.addSection("neighbors", recordSection(0));
+  auto routes =
+      executor.addSection("routes", []() -> SaiDeltaExecutor::ApplyFn {
+        throw std::runtime_error("walk failed");
+      });
+  executor.addSection("mpls", recordSection(2), {routes});
+  EXPECT_THROW(executor.run(), std::runtime_error);
+  EXPECT_EQ(applied, std::vector<int>({0}));
+}
+
+TEST_P(SaiDeltaExecutorTest, applyErrorPropagates) {
+  SaiDeltaExecutor executor(walkExecutor.get());
+  executor.addSection("neighbors", [] {
+    return SaiDeltaExecutor::ApplyFn(
+        [] { throw std::runtime_error("apply failed"); });
+  });
+  executor.addSection("routes", recordSection(1), {0});
+  EXPECT_THROW(executor.run(), std::runtime_error);
+  EXPECT_TRUE(applied.empty());
+}
+
+TEST_P(SaiDeltaExecutorTest, forwardDependencyRejected) {
+  SaiDeltaExecutor executor(walkExecutor.get());
+  EXPECT_THROW(
+      executor.addSection("routes", recordSection(0), {1}), FbossError);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SaiDeltaExecutorTest,
+    SaiDeltaExecutorTest,
+    ::testing::Values(false, true));
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/switch/SaiTxQueue.h"
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+class TestTxPacket : public TxPacket {
+ public:
+  explicit TestTxPacket(ETHERTYPE etherType, uint8_t id = 0) {
+    buf_ = folly::IOBuf::create(64);
+    buf_->append(64);
+    folly::io::RWPrivateCursor cursor(buf_.get());
+    TxPacket::writeEthHeader(
+        &cursor,
+        folly::MacAddress("02:00:00:00:00:01"),
+        folly::MacAddress("02:00:00:00:00:02"),
+        VlanID(1),
+        static_cast<uint16_t>(etherType));
+    cursor.write<uint8_t>(id);
+  }
+  explicit TestTxPacket(folly::StringPiece hex) {
+    buf_ = std::make_unique<folly::IOBuf>(PktUtil::parseHexData(hex));
+  }
+};
+
+uint8_t packetId(const TxPacket& pkt) {
+  // Right after the vlan tagged ethernet header
+  return pkt.buf()->data()[18];
+}
+
+std::unique_ptr<TxPacket> makePacket(uint8_t id) {
+  return std::make_unique<TestTxPacket>(ETHERTYPE::ETHERTYPE_IPV6, id);
+}
+
+} // namespace
+
+TEST(SaiTxQueueTest, getPriority) {
+  TestTxPacket arp(ETHERTYPE::ETHERTYPE_ARP);
+  TestTxPacket lacp(ETHERTYPE::ETHERTYPE_SLOW_PROTOCOLS);
+  TestTxPacket v6(ETHERTYPE::ETHERTYPE_IPV6);
+  EXPECT_EQ(
+      SaiTxQueue::getPriority(arp, std::nullopt, std::nullopt),
+      SaiTxQueue::Priority::HIGH);
+  EXPECT_EQ(
+      SaiTxQueue::getPriority(lacp, PortID(1), std::nullopt),
+      SaiTxQueue::Priority::HIGH);
+  EXPECT_EQ(
+      SaiTxQueue::getPriority(v6, PortID(1), 7), SaiTxQueue::Priority::HIGH);
+  EXPECT_EQ(
+      SaiTxQueue::getPriority(v6, PortID(1), std::nullopt),
+      SaiTxQueue::Priority::NORMAL);
+  EXPECT_EQ(
+      SaiTxQueue::getPriority(v6, std::nullopt, std::nullopt),
+      SaiTxQueue::Priority::LOW);
+}
+
+TEST(SaiTxQueueTest, getPriorityL4) {
+  const std::string eth = "02 00 00 00 00 01  02 00 00 00 00 02  81 00 00 01";
+  const std::string v4 = eth + "08 00  45 00 00 30 00 00 00 00 ff 11 00 00" +
+      "0a 00 00 01  0a 00 00 02";
+  const std::string v6 = eth + "86 dd  60 00 00 00 00 18 11 ff" +
+      "26 20 00 00 1c fe fa ce b0 0c 00 00 00 00 00 01" +
+      "26 20 00 00 1c fe fa ce b0 0c 00 00 00 00 00 02";
+  const std::string icmp6 = eth + "86 dd  60 00 00 00 00 18 3a ff" +
+      "fe 80 00 00 00 00 00 00 00 00 00 00 00 00 00 01" +
+      "ff 02 00 00 00 00 00 00 00 00 00 01 ff 00 00 02";
+  auto priority = [](const std::string& hex) {
+    return SaiTxQueue::getPriority(
+        TestTxPacket(hex), std::nullopt, std::nullopt);
+  };
+
+  // BFD single hop over IPv4 and multi hop over IPv6
+  EXPECT_EQ(
+      priority(v4 + "c0 00 0e c8 00 1c 00 00"), SaiTxQueue::Priority::HIGH);
+  EXPECT_EQ(
+      priority(v6 + "c0 00 12 b0 00 18 00 00"), SaiTxQueue::Priority::HIGH);
+  // BFD echo, and other UDP
+  EXPECT_EQ(
+      priority(v4 + "c0 00 0e c9 00 1c 00 00"), SaiTxQueue::Priority::LOW);
+  EXPECT_EQ(
+      priority(v6 + "c0 00 00 35 00 18 00 00"), SaiTxQueue::Priority::LOW);
+  // Router solicitation to neighbor advertisement, and redirect
+  for (auto type : {"85", "86", "87", "88", "89"}) {
+    EXPECT_EQ(
+        priority(icmp6 + type + " 00 00 00"), SaiTxQueue::Priority::HIGH);
+  }
+  // Echo request
+  EXPECT_EQ(priority(icmp6 + "80 00 00 00"), SaiTxQueue::Priority::LOW);
+  // Truncated before the ICMPv6 type
+  EXPECT_EQ(priority(icmp6), SaiTxQueue::Priority::LOW);
+}
+
+TEST(SaiTxQueueTest, higherPrioritySentFirst) {
+  folly::Baton<> sending;
+  folly::Baton<> unblock;
+  std::vector<uint8_t> sent;
+  SaiTxQueue queue(
+      [&](SaiTxQueue::TxRequest request) {
+        if (sent.empty()) {
+          sending.post();
+          unblock.wait();
+        }
+        sent.push_back(packetId(*request.pkt));
+      },
+      16,
+      16);
+
+  // Hold the sender thread in the first send, while the others queue up
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(0)}));
+  sending.wait();
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(1)}));
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::NORMAL, {makePacket(2)}));
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::HIGH, {makePacket(3)}));
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(4)}));
+  EXPECT_EQ(queue.depth(), 4);
+  unblock.post();
+  while (queue.depth()) {
+    std::this_thread::yield();
+  }
+  queue.stop();
+  EXPECT_EQ(sent, std::vector<uint8_t>({0, 3, 2, 1, 4}));
+}
+
+TEST(SaiTxQueueTest, fullQueueDropsPerPriority) {
+  folly::Baton<> sending;
+  folly::Baton<> unblock;
+  int sent = 0;
+  SaiTxQueue queue(
+      [&](SaiTxQueue::TxRequest /*request*/) {
+        if (!sent++) {
+          sending.post();
+          unblock.wait();
+        }
+      },
+      2,
+      16);
+
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(0)}));
+  sending.wait();
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(1)}));
+  size_t depth = 0;
+  EXPECT_TRUE(
+      queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(2)}, &depth));
+  EXPECT_EQ(depth, 1);
+  EXPECT_FALSE(
+      queue.enqueue(SaiTxQueue::Priority::LOW, {makePacket(3)}, &depth));
+  EXPECT_EQ(depth, 2);
+  // A flood of low priority packets leaves room for network control
+  EXPECT_TRUE(queue.enqueue(SaiTxQueue::Priority::HIGH, {makePacket(4)}));
+  unblock.post();
+  queue.stop();
+  EXPECT_FALSE(queue.enqueue(SaiTxQueue::Priority::HIGH, {makePacket(5)}));
+  EXPECT_EQ(queue.depth(), 0);
+}
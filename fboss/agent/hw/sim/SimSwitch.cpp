@@ -11,6 +11,7 @@
 
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 #include "fboss/agent/hw/mock/MockTxPacket.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/SwitchState.h"
 
@@ -42,6 +43,7 @@ HwInitResult SimSwitch::init(
   bootType_ = BootType::COLD_BOOT;
   ret.bootType = bootType_;
   ret.switchState = state;
+  ret.rib = std::make_unique<RoutingInformationBase>();
   return ret;
 }
 
@@ -0,0 +1,264 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/BufferWatermarkSampler.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <thread>
+
+using namespace facebook::fboss;
+using QueueKey = BufferWatermarkSampler::QueueKey;
+
+namespace {
+
+// Returns whatever the test last set, like clear on read watermarks would
+// for a steady occupancy
+struct FakeWatermarks {
+  std::vector<uint64_t> queueBytes;
+  uint64_t deviceBytes{0};
+};
+
+class FakeReader : public BufferWatermarkSampler::Reader {
+ public:
+  explicit FakeReader(std::shared_ptr<FakeWatermarks> watermarks)
+      : watermarks_(std::move(watermarks)) {}
+
+  std::vector<uint64_t> readQueueWatermarks(
+      const std::vector<QueueKey>& queues) override {
+    auto bytes = watermarks_->queueBytes;
+    bytes.resize(queues.size());
+    return bytes;
+  }
+  uint64_t readDeviceWatermark() override {
+    return watermarks_->deviceBytes;
+  }
+
+ private:
+  std::shared_ptr<FakeWatermarks> watermarks_;
+};
+
+// Blocks its first read until unblocked
+class BlockingReader : public BufferWatermarkSampler::Reader {
+ public:
+  BlockingReader(std::promise<void>& reading, std::shared_future<void> unblock)
+      : reading_(reading), unblock_(std::move(unblock)) {}
+
+  std::vector<uint64_t> readQueueWatermarks(
+      const std::vector<QueueKey>& queues) override {
+    if (!blocked_) {
+      blocked_ = true;
+      reading_.set_value();
+      unblock_.wait();
+    }
+    return std::vector<uint64_t>(queues.size());
+  }
+  uint64_t readDeviceWatermark() override {
+    return 0;
+  }
+
+ private:
+  std::promise<void>& reading_;
+  std::shared_future<void> unblock_;
+  bool blocked_{false};
+};
+
+class CountingSubscriber : public BufferWatermarkSampler::Subscriber {
+ public:
+  explicit CountingSubscriber(int maxSamples) : maxSamples_(maxSamples) {}
+
+  bool samplesTaken(
+      const std::vector<QueueKey>& queues,
+      const BufferWatermarkSampler::Samples& samples) override {
+    EXPECT_EQ(queues.size(), samples.queueBytes.size());
+    lastSamples = samples;
+    return ++numSamples < maxSamples_;
+  }
+  void samplingStopped() override {
+    stopped = true;
+  }
+
+  int numSamples{0};
+  bool stopped{false};
+  BufferWatermarkSampler::Samples lastSamples;
+
+ private:
+  int maxSamples_;
+};
+
+} // namespace
+
+class BufferWatermarkSamplerTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    watermarks_ = std::make_shared<FakeWatermarks>();
+    sampler_ = std::make_unique<BufferWatermarkSampler>(
+        std::make_unique<FakeReader>(watermarks_), 8);
+  }
+
+  // Select queues without leaving the sampler thread running, so tests
+  // take the samples themselves
+  void selectQueues(std::vector<QueueKey> queues) {
+    sampler_->start(std::move(queues), std::chrono::hours(1));
+    sampler_->stop();
+  }
+
+ protected:
+  std::shared_ptr<FakeWatermarks> watermarks_;
+  std::unique_ptr<BufferWatermarkSampler> sampler_;
+};
+
+TEST(WatermarkRingTest, keepsMostRecentSamples) {
+  WatermarkRing ring(4);
+  EXPECT_TRUE(ring.snapshot().empty());
+  ring.push(1);
+  ring.push(2);
+  EXPECT_EQ(ring.snapshot(), (std::vector<uint64_t>{1, 2}));
+  for (uint64_t i = 3; i <= 10; ++i) {
+    ring.push(i);
+  }
+  EXPECT_EQ(ring.snapshot(), (std::vector<uint64_t>{7, 8, 9, 10}));
+}
+
+TEST_F(BufferWatermarkSamplerTest, histograms) {
+  selectQueues({{PortID(1), 0}, {PortID(2), 7}});
+  // One sample is taken by the sampler thread before it stops
+  auto initialSamples = sampler_->getHistograms()[0].numSamples;
+  for (uint64_t bytes : {0, 1000, 1024, 1025, 50000000}) {
+    watermarks_->queueBytes = {bytes, 0};
+    sampler_->sampleOnce();
+  }
+  auto histograms = sampler_->getHistograms();
+  ASSERT_EQ(histograms.size(), 2);
+  const auto& histogram = histograms[0];
+  EXPECT_EQ(histogram.queue, QueueKey(PortID(1), 0));
+  EXPECT_EQ(histogram.numSamples, initialSamples + 5);
+  EXPECT_EQ(histogram.maxBytes, 50000000);
+  ASSERT_EQ(
+      histogram.bucketCounts.size(),
+      BufferWatermarkSampler::kNumHistogramBuckets);
+  EXPECT_EQ(histogram.bucketCounts[0], initialSamples + 1);
+  // 1000 and 1024 are both at most 1KB
+  EXPECT_EQ(histogram.bucketCounts[1], 2);
+  EXPECT_EQ(histogram.bucketCounts[2], 1);
+  EXPECT_EQ(
+      histogram.bucketCounts[BufferWatermarkSampler::kNumHistogramBuckets - 1],
+      1);
+  EXPECT_EQ(histograms[1].maxBytes, 0);
+}
+
+TEST_F(BufferWatermarkSamplerTest, histogramOverRing) {
+  selectQueues({{PortID(1), 0}});
+  for (int i = 0; i < 20; ++i) {
+    watermarks_->queueBytes = {static_cast<uint64_t>(i * 1024)};
+    sampler_->sampleOnce();
+  }
+  auto histogram = sampler_->getHistograms()[0];
+  // Only the ring size's worth of most recent samples
+  EXPECT_EQ(histogram.numSamples, 8);
+  EXPECT_EQ(histogram.maxBytes, 19 * 1024);
+}
+
+TEST_F(BufferWatermarkSamplerTest, collectPeaks) {
+  selectQueues({{PortID(1), 0}});
+  sampler_->collectPeakBytes(PortID(1), 0);
+  sampler_->collectDevicePeakBytes();
+  for (uint64_t bytes : {100, 3000, 200}) {
+    watermarks_->queueBytes = {bytes};
+    watermarks_->deviceBytes = bytes * 2;
+    sampler_->sampleOnce();
+  }
+  EXPECT_EQ(sampler_->collectPeakBytes(PortID(1), 0), 3000);
+  EXPECT_EQ(sampler_->collectDevicePeakBytes(), 6000);
+  // Collecting resets the peaks
+  EXPECT_EQ(sampler_->collectPeakBytes(PortID(1), 0), 0);
+  EXPECT_EQ(sampler_->collectDevicePeakBytes(), 0);
+  // Not sampled
+  EXPECT_EQ(sampler_->collectPeakBytes(PortID(1), 1), 0);
+  EXPECT_EQ(sampler_->collectPeakBytes(PortID(2), 0), 0);
+}
+
+TEST_F(BufferWatermarkSamplerTest, subscribers) {
+  selectQueues({{PortID(1), 0}, {PortID(1), 1}});
+  auto subscriber = std::make_shared<CountingSubscriber>(2);
+  sampler_->subscribe(subscriber);
+  watermarks_->queueBytes = {10, 20};
+  watermarks_->deviceBytes = 30;
+  sampler_->sampleOnce();
+  EXPECT_EQ(subscriber->numSamples, 1);
+  EXPECT_EQ(
+      subscriber->lastSamples.queueBytes, (std::vector<uint64_t>{10, 20}));
+  EXPECT_EQ(subscriber->lastSamples.deviceBytes, 30);
+  EXPECT_GT(subscriber->lastSamples.timestampUsecs, 0);
+  // The subscriber unsubscribes on its second sample
+  sampler_->sampleOnce();
+  sampler_->sampleOnce();
+  EXPECT_EQ(subscriber->numSamples, 2);
+}
+
+TEST_F(BufferWatermarkSamplerTest, stopCompletesSubscribers) {
+  selectQueues({{PortID(1), 0}});
+  auto subscriber = std::make_shared<CountingSubscriber>(10);
+  sampler_->subscribe(subscriber);
+  sampler_->sampleOnce();
+  EXPECT_FALSE(subscriber->stopped);
+  sampler_->stop();
+  EXPECT_TRUE(subscriber->stopped);
+  // And is no longer subscribed
+  sampler_->sampleOnce();
+  EXPECT_EQ(subscriber->numSamples, 1);
+}
+
+TEST_F(BufferWatermarkSamplerTest, samplesOnThread) {
+  sampler_->start({{PortID(1), 0}}, std::chrono::milliseconds(1));
+  EXPECT_TRUE(sampler_->isRunning());
+  for (int i = 0; i < 1000 && sampler_->getNumSamples() < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  sampler_->stop();
+  EXPECT_FALSE(sampler_->isRunning());
+  auto numSamples = sampler_->getNumSamples();
+  EXPECT_GE(numSamples, 5);
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(sampler_->getNumSamples(), numSamples);
+}
+
+TEST_F(BufferWatermarkSamplerTest, restartReplacesQueues) {
+  selectQueues({{PortID(1), 0}});
+  selectQueues({{PortID(2), 3}});
+  EXPECT_EQ(
+      sampler_->getSampledQueues(), std::vector<QueueKey>{{PortID(2), 3}});
+  EXPECT_THROW(
+      sampler_->start({{PortID(1), 0}}, std::chrono::milliseconds(0)),
+      FbossError);
+}
+
+TEST(BufferWatermarkSamplerReadTest, waitForReadsWaitsForReadInProgress) {
+  std::promise<void> reading;
+  std::promise<void> unblock;
+  BufferWatermarkSampler sampler(
+      std::make_unique<BlockingReader>(reading, unblock.get_future().share()),
+      8);
+  sampler.start({{PortID(1), 0}}, std::chrono::hours(1));
+  reading.get_future().wait();
+  auto waited = std::async(std::launch::async, [&sampler] {
+    sampler.waitForReads();
+  });
+  EXPECT_EQ(
+      waited.wait_for(std::chrono::milliseconds(50)),
+      std::future_status::timeout);
+  unblock.set_value();
+  waited.get();
+  sampler.stop();
+  // Nothing to wait for with no read in progress
+  sampler.waitForReads();
+}
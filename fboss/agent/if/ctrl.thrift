@@ -460,6 +460,41 @@ struct CaptureInfo {
   4: CaptureFilter filter;
 }
 
+struct BufferWatermarkSamplingInfo {
+  // Ports whose queues to sample
+  1: list<i32> portIds;
+  // Queues to sample on each port, all configured unicast queues if empty
+  2: list<i16> queueIds;
+  // Sampling interval, typically well under a second, and at least 5ms
+  3: i32 intervalMsecs = 10;
+}
+
+struct QueueWatermarkSample {
+  1: i32 portId;
+  2: i16 queueId;
+  // Peak bytes used since the previous sample
+  3: i64 bytes;
+}
+
+struct BufferWatermarkSamples {
+  1: i64 timestampUsecs;
+  2: i64 deviceBytes;
+  3: list<QueueWatermarkSample> queues;
+}
+
+struct QueueWatermarkHistogram {
+  1: i32 portId;
+  2: i16 queueId;
+  /*
+   * Number of samples whose bytes are at most the matching upper bound and
+   * above the previous one. The last bucket has no upper bound.
+   */
+  3: list<i64> bucketUpperBoundBytes;
+  4: list<i64> bucketCounts;
+  5: i64 maxBytes;
+  6: i64 numSamples;
+}
+
 struct RouteUpdateLoggingInfo {
   // The prefix to log route updates for
   1: IpPrefix prefix;
@@ -947,6 +982,24 @@ service FbossCtrl extends fb303.FacebookService {
   void stopPktCapture(1: string name) throws (1: fboss.FbossBaseError error);
   void stopAllPktCaptures() throws (1: fboss.FbossBaseError error);
 
+  /*
+   * Sample queue watermarks at sub-second intervals to catch microbursts.
+   * Starting again replaces the sampled queues.
+   */
+  void startBufferWatermarkSampling(
+    1: BufferWatermarkSamplingInfo info,
+  ) throws (1: fboss.FbossBaseError error);
+  void stopBufferWatermarkSampling() throws (1: fboss.FbossBaseError error);
+  // Over the most recent samples of each sampled queue
+  list<QueueWatermarkHistogram> getBufferWatermarkHistograms() throws (
+    1: fboss.FbossBaseError error,
+  );
+  // Every sample taken from now on, until sampling is stopped. Samples a
+  // slow client falls far behind on are merged, keeping the peaks.
+  stream<BufferWatermarkSamples> subscribeToBufferWatermarkSamples() throws (
+    1: fboss.FbossBaseError error,
+  );
+
   /*
    * Log all updates to routes that match this prefix, or are more
    * specific.
@@ -985,6 +1038,13 @@ service FbossCtrl extends fb303.FacebookService {
    */
   string getCurrentStateJSON(1: string jsonPointer);
 
+  /*
+   * Timeline of the most recent state updates, in the Chrome trace event
+   * format: time queued, in update functions, programming HW and notifying
+   * each state observer.
+   */
+  string getStateUpdateTrace();
+
   /*
    * Apply patch at given path within the state tree. jsonPatch must  be
    * a valid JSON object string
@@ -9,6 +9,20 @@ struct TPacket {
   3: binary buf
 }
 
+typedef binary (cpp2.type = "folly::IOBuf") IOBuf
+
+// Same as TPacket, but the payload is not copied in to or out of a string
+struct TPacketFrame {
+  1: i64 timestamp
+  2: string l2Port
+  3: IOBuf buf
+}
+
+// Packets sent as a single stream element
+struct TPacketBatch {
+  1: list<TPacketFrame> packets
+}
+
 enum TPacketErrorCode {
   INVALID_L2PORT = 1,
   CLIENT_NOT_CONNECTED = 2,
@@ -26,6 +40,10 @@ exception TPacketException {
 service PacketStream extends fb303.FacebookService {
   stream<TPacket throws (1: TPacketException ex)> connect(1: string clientId)
     throws (1: TPacketException ex)
+  // Same as connect, but packets are sent in batches
+  stream<TPacketBatch throws (1: TPacketException ex)> connectBatched(
+    1: string clientId,
+  ) throws (1: TPacketException ex)
   void registerPort(1: string clientId, 2: string l2Port)
     throws (1: TPacketException ex)
   void clearPort(1: string clientId, 2: string l2Port)
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/packet/PktMetadata.h"
+
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include <stdexcept>
+
+using folly::io::Cursor;
+
+namespace {
+
+using facebook::fboss::ETHERTYPE;
+using facebook::fboss::IP_PROTO;
+using facebook::fboss::PktMetadata;
+
+// Bound the IPv6 extension headers walked, packets with more go to the
+// handlers unparsed
+constexpr int kMaxIPv6ExtHeaders = 4;
+
+constexpr uint32_t kIPv6HeaderLen = 40;
+
+bool isProto(uint8_t proto, IP_PROTO expected) {
+  return proto == static_cast<uint8_t>(expected);
+}
+
+uint16_t getOffset(const Cursor& start, const Cursor& cursor) {
+  return cursor - start;
+}
+
+void parseL4(const Cursor& start, Cursor c, PktMetadata* md) {
+  auto l4Offset = getOffset(start, c);
+  if (isProto(md->ipProtocol, IP_PROTO::IP_PROTO_TCP)) {
+    md->l4SrcPort = c.readBE<uint16_t>();
+    md->l4DstPort = c.readBE<uint16_t>();
+  } else if (isProto(md->ipProtocol, IP_PROTO::IP_PROTO_UDP)) {
+    md->l4SrcPort = c.readBE<uint16_t>();
+    md->l4DstPort = c.readBE<uint16_t>();
+    // A UDP header too short to parse is treated as truncated, like the
+    // handlers do
+    c += 4;
+  } else if (
+      isProto(md->ipProtocol, IP_PROTO::IP_PROTO_ICMP) ||
+      isProto(md->ipProtocol, IP_PROTO::IP_PROTO_IPV6_ICMP)) {
+    md->icmpType = c.read<uint8_t>();
+    md->icmpCode = c.read<uint8_t>();
+  }
+  // Only once the fields above are known to be there
+  md->l4Offset = l4Offset;
+}
+
+void parseIPv4(const Cursor& start, Cursor c, PktMetadata* md) {
+  auto versionAndIhl = c.read<uint8_t>();
+  auto headerLen = (versionAndIhl & 0x0f) * 4;
+  c += 1; // Skip to total length
+  auto totalLen = c.readBE<uint16_t>();
+  c += 2; // Skip to flags and fragment offset
+  auto fragment = c.readBE<uint16_t>();
+  md->ttl = c.read<uint8_t>();
+  md->ipProtocol = c.read<uint8_t>();
+  // Same checks as IPv4Hdr, so handlers can use the fields without parsing
+  // the header again
+  if ((versionAndIhl >> 4) != 4 || headerLen < 20 || totalLen < headerLen ||
+      md->ttl == 0) {
+    md->flags |= PktMetadata::IP_MALFORMED;
+    return;
+  }
+  md->l3Length = totalLen;
+  if (headerLen > 20) {
+    md->flags |= PktMetadata::IP_OPTIONS;
+  }
+  // More fragments flag, or a fragment offset
+  if (fragment & 0x3fff) {
+    md->flags |= PktMetadata::IP_FRAGMENT;
+    if (fragment & 0x1fff) {
+      // Only the first fragment has the L4 header
+      return;
+    }
+  }
+  c += headerLen - 10;
+  parseL4(start, c, md);
+}
+
+void parseIPv6(const Cursor& start, Cursor c, PktMetadata* md) {
+  auto version = c.read<uint8_t>() >> 4;
+  c += 3; // Skip to payload length
+  auto payloadLen = c.readBE<uint16_t>();
+  auto nextHeader = c.read<uint8_t>();
+  md->ttl = c.read<uint8_t>();
+  c += 32; // Skip the addresses
+  // Same checks as IPv6Hdr
+  if (version != 6 || md->ttl == 0) {
+    md->flags |= PktMetadata::IP_MALFORMED;
+    return;
+  }
+  md->l3Length = payloadLen + kIPv6HeaderLen;
+  for (int i = 0; i < kMaxIPv6ExtHeaders; ++i) {
+    if (isProto(nextHeader, IP_PROTO::IP_PROTO_IPV6_HOPOPT) ||
+        isProto(nextHeader, IP_PROTO::IP_PROTO_IPV6_ROUTE) ||
+        isProto(nextHeader, IP_PROTO::IP_PROTO_IPV6_OPTS)) {
+      md->flags |= PktMetadata::IP_OPTIONS;
+      nextHeader = c.read<uint8_t>();
+      c += c.read<uint8_t>() * 8 + 6;
+    } else if (isProto(nextHeader, IP_PROTO::IP_PROTO_IPV6_FRAG)) {
+      md->flags |= PktMetadata::IP_FRAGMENT;
+      nextHeader = c.read<uint8_t>();
+      c += 1;
+      auto offset = c.readBE<uint16_t>() >> 3;
+      c += 4;
+      if (offset) {
+        md->ipProtocol = nextHeader;
+        return;
+      }
+    } else {
+      md->ipProtocol = nextHeader;
+      parseL4(start, c, md);
+      return;
+    }
+  }
+  md->ipProtocol = nextHeader;
+}
+
+} // namespace
+
+namespace facebook::fboss {
+
+// static
+PktMetadata PktMetadata::parse(const folly::IOBuf* buf) {
+  PktMetadata md;
+  try {
+    Cursor start(buf);
+    Cursor c(start);
+    md.dstMac = PktUtil::readMac(&c);
+    md.srcMac = PktUtil::readMac(&c);
+    md.etherType = c.readBE<uint16_t>();
+    if (md.etherType == static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN)) {
+      md.vlanTagged = true;
+      md.vlanTci = c.readBE<uint16_t>();
+      md.etherType = c.readBE<uint16_t>();
+    }
+    // The payload of everything but IP (ARP, LLDP, LACP, MPLS...) is left
+    // to its handler
+    md.l3Offset = getOffset(start, c);
+    if (md.etherType == static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_IPV4)) {
+      parseIPv4(start, c, &md);
+    } else if (
+        md.etherType == static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_IPV6)) {
+      parseIPv6(start, c, &md);
+    }
+  } catch (const std::out_of_range&) {
+    md.flags |= TRUNCATED;
+  }
+  return md;
+}
+
+bool PktMetadata::hasL4Ports() const {
+  return hasL4() &&
+      (isProto(ipProtocol, IP_PROTO::IP_PROTO_TCP) ||
+       isProto(ipProtocol, IP_PROTO::IP_PROTO_UDP));
+}
+
+} // namespace facebook::fboss
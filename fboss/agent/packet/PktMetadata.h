@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/MacAddress.h>
+
+#include <cstdint>
+
+namespace folly {
+class IOBuf;
+} // namespace folly
+
+namespace facebook::fboss {
+
+/*
+ * Where the headers of a packet are and the fields RX dispatch decisions are
+ * made on, found walking the headers once. Handlers then start their own
+ * parsing at the header they care about instead of from the start of the
+ * packet.
+ *
+ * Parsing never throws: headers that don't fit in the packet are left
+ * unparsed and the packet flagged as truncated.
+ */
+struct PktMetadata {
+  enum Flags : uint8_t {
+    // A header was cut short by the end of the packet
+    TRUNCATED = 0x1,
+    // IPv4 fragment, or IPv6 packet with a fragment header
+    IP_FRAGMENT = 0x2,
+    // IPv4 header with options, or IPv6 extension headers before the L4 one
+    IP_OPTIONS = 0x4,
+    // IP header that IPv4Hdr/IPv6Hdr reject: wrong version, header or total
+    // length too small, or a zero TTL/hop limit. Nothing past it is parsed.
+    IP_MALFORMED = 0x8,
+  };
+
+  static PktMetadata parse(const folly::IOBuf* buf);
+
+  bool isTruncated() const {
+    return flags & TRUNCATED;
+  }
+  bool hasL3() const {
+    return l3Offset != 0;
+  }
+  bool hasL4() const {
+    return l4Offset != 0;
+  }
+  // TCP or UDP, whose ports are parsed
+  bool hasL4Ports() const;
+
+  folly::MacAddress dstMac;
+  folly::MacAddress srcMac;
+  bool vlanTagged{false};
+  // Of the 802.1Q tag, if any
+  uint16_t vlanTci{0};
+  // Ethertype after the VLAN tag
+  uint16_t etherType{0};
+
+  // Offsets from the start of the packet. l3Offset is where the payload of
+  // the ethertype starts, l4Offset where the header following the IP
+  // header(s) does. 0 if the header isn't there or couldn't be parsed.
+  uint16_t l3Offset{0};
+  uint16_t l4Offset{0};
+  // IPv4 total length, or the IPv6 payload length plus the fixed header.
+  // Data past it, such as the FCS, is not part of the IP packet.
+  uint32_t l3Length{0};
+
+  // IPv4 protocol or the IPv6 next header of the L4 header
+  uint8_t ipProtocol{0};
+  // IPv4 TTL or IPv6 hop limit
+  uint8_t ttl{0};
+  uint8_t flags{0};
+
+  // TCP/UDP ports, or the ICMP/ICMPv6 type and code
+  uint16_t l4SrcPort{0};
+  uint16_t l4DstPort{0};
+  uint8_t icmpType{0};
+  uint8_t icmpCode{0};
+};
+
+} // namespace facebook::fboss
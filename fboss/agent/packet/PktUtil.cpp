@@ -14,8 +14,12 @@
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
 #include <folly/io/Cursor.h>
+#include <folly/lang/Bits.h>
 #include "fboss/agent/FbossError.h"
 
+#include <algorithm>
+#include <cstring>
+
 using folly::ByteRange;
 using folly::IOBuf;
 using folly::IPAddressV4;
@@ -26,6 +30,49 @@ using folly::io::Appender;
 using folly::io::Cursor;
 using std::string;
 
+namespace {
+
+uint16_t foldChecksum(uint64_t sum) {
+  while (sum >> 16) {
+    sum = (sum & 0xffff) + (sum >> 16);
+  }
+  return static_cast<uint16_t>(sum);
+}
+
+/*
+ * Ones' complement sum of a contiguous range of bytes, as 16 bit words.
+ *
+ * The sum doesn't depend on byte order (RFC 1071 section 2), so words are
+ * loaded as they are in memory, and 32 bits at a time into a 64 bit
+ * accumulator, which can't overflow for any packet size and which
+ * compilers vectorize. The result is in host byte order.
+ */
+uint16_t hostOrderSum(const uint8_t* data, uint64_t length) {
+  uint64_t sum = 0;
+  for (; length >= sizeof(uint32_t); length -= sizeof(uint32_t)) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    sum += word;
+    data += sizeof(word);
+  }
+  if (length >= sizeof(uint16_t)) {
+    uint16_t word;
+    std::memcpy(&word, data, sizeof(word));
+    sum += word;
+    data += sizeof(word);
+    length -= sizeof(word);
+  }
+  if (length) {
+    // The last odd byte is the first byte of a zero padded word
+    uint16_t word = 0;
+    std::memcpy(&word, data, 1);
+    sum += word;
+  }
+  return foldChecksum(sum);
+}
+
+} // namespace
+
 namespace facebook::fboss {
 
 MacAddress PktUtil::readMac(Cursor* cursor) {
@@ -80,20 +127,24 @@ uint32_t PktUtil::partialChecksumImpl(
     folly::io::Cursor cursor,
     uint64_t length,
     uint32_t value) {
-  // Checksum all the pairs of bytes first
-  while (length > 1) {
-    value += cursor.readBE<uint16_t>();
-    length -= 2;
-  }
-  if (length) {
-    // Bytes are interpreted in n/w byte order
-    // so this last octet represents the 8 MSbits
-    // of the last 16 bit number in this buffer.
-    uint16_t last = cursor.read<uint8_t>();
-    value += (last << 8);
-    --length;
+  // Sum each contiguous segment of the chain on its own
+  uint32_t sum = 0;
+  bool oddOffset = false;
+  while (length > 0) {
+    auto bytes = cursor.peekBytes();
+    if (bytes.empty()) {
+      throw std::out_of_range("checksum length past the end of the buffer");
+    }
+    auto segmentLength = std::min<uint64_t>(length, bytes.size());
+    auto segmentSum = hostOrderSum(bytes.data(), segmentLength);
+    // The words of a segment starting at an odd offset straddle the
+    // previous segment, summing it as is yields the byte swapped sum.
+    sum += oddOffset ? folly::Endian::swap(segmentSum) : segmentSum;
+    oddOffset ^= (segmentLength & 1) != 0;
+    cursor.skip(segmentLength);
+    length -= segmentLength;
   }
-  return value;
+  return value + folly::Endian::big(foldChecksum(sum));
 }
 
 uint32_t PktUtil::partialChecksum(
@@ -121,6 +172,31 @@ uint16_t PktUtil::finalizeChecksum(uint32_t sum) {
   return static_cast<uint16_t>(sum);
 }
 
+uint16_t PktUtil::updateChecksum(
+    uint16_t checksum,
+    ByteRange oldData,
+    ByteRange newData) {
+  CHECK_EQ(oldData.size(), newData.size());
+  CHECK((oldData.size() & 1) == 0);
+  // HC' = ~(~HC + ~m + m')
+  uint32_t sum = static_cast<uint16_t>(~checksum);
+  for (size_t i = 0; i < oldData.size(); i += 2) {
+    uint16_t oldWord = (oldData[i] << 8) | oldData[i + 1];
+    uint16_t newWord = (newData[i] << 8) | newData[i + 1];
+    sum += static_cast<uint16_t>(~oldWord);
+    sum += newWord;
+  }
+  return finalizeChecksum(sum);
+}
+
+uint16_t
+PktUtil::updateChecksum(uint16_t checksum, uint16_t oldWord, uint16_t newWord) {
+  uint32_t sum = static_cast<uint16_t>(~checksum);
+  sum += static_cast<uint16_t>(~oldWord);
+  sum += newWord;
+  return finalizeChecksum(sum);
+}
+
 string PktUtil::hexDump(Cursor cursor) {
   return hexDump(cursor, cursor.totalLength());
 }
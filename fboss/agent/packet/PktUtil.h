@@ -14,6 +14,7 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/Range.h>
 
 namespace folly {
 class IOBuf;
@@ -83,6 +84,22 @@ class PktUtil {
   finalizeChecksum(folly::io::Cursor start, uint64_t length, uint32_t value);
   static uint16_t finalizeChecksum(uint32_t value);
 
+  /*
+   * Update a checksum after some of the data it covers is rewritten, e.g.
+   * the TTL or an address of a header, without summing all of the data
+   * again (RFC 1624, eqn. 3).
+   *
+   * oldData and newData are the rewritten bytes before and after the
+   * rewrite, and must be the same, even, size and start at an even offset
+   * into the checksummed data. Checksums are in host byte order.
+   */
+  static uint16_t updateChecksum(
+      uint16_t checksum,
+      folly::ByteRange oldData,
+      folly::ByteRange newData);
+  static uint16_t
+  updateChecksum(uint16_t checksum, uint16_t oldWord, uint16_t newWord);
+
   /**
    * Return a string containing a human readable hex dump of the binary data.
    */
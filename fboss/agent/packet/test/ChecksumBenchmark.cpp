@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+
+#include "fboss/agent/packet/PktUtil.h"
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::io::Cursor;
+
+namespace {
+
+constexpr size_t kMtu = 1500;
+
+std::unique_ptr<IOBuf> makeBuf(size_t size) {
+  auto buf = IOBuf::create(size);
+  for (size_t i = 0; i < size; ++i) {
+    buf->writableTail()[i] = static_cast<uint8_t>(i * 7);
+  }
+  buf->append(size);
+  return buf;
+}
+
+// Packets larger than the MTU, as a chain of MTU sized segments
+std::unique_ptr<IOBuf> makeChain(size_t size) {
+  auto chain = makeBuf(std::min(size, kMtu));
+  for (size_t offset = kMtu; offset < size; offset += kMtu) {
+    chain->prependChain(makeBuf(std::min(size - offset, kMtu)));
+  }
+  return chain;
+}
+
+// The checksum as it was computed before, two bytes at a time
+uint16_t readBEChecksum(Cursor cursor, uint64_t length) {
+  uint32_t sum = 0;
+  while (length > 1) {
+    sum += cursor.readBE<uint16_t>();
+    length -= 2;
+  }
+  if (length) {
+    sum += cursor.read<uint8_t>() << 8;
+  }
+  return PktUtil::finalizeChecksum(sum);
+}
+
+void checksumReadBE(unsigned int iters, size_t size) {
+  std::unique_ptr<IOBuf> buf;
+  BENCHMARK_SUSPEND {
+    buf = makeChain(size);
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(readBEChecksum(Cursor(buf.get()), size));
+  }
+}
+
+void checksum(unsigned int iters, size_t size) {
+  std::unique_ptr<IOBuf> buf;
+  BENCHMARK_SUSPEND {
+    buf = makeChain(size);
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(PktUtil::internetChecksum(buf.get()));
+  }
+}
+
+} // namespace
+
+#define CHECKSUM_BENCHMARKS(size)                   \
+  BENCHMARK(ChecksumReadBE_##size, iters) {         \
+    checksumReadBE(iters, size);                    \
+  }                                                 \
+  BENCHMARK_RELATIVE(Checksum_##size, iters) {      \
+    checksum(iters, size);                          \
+  }                                                 \
+  BENCHMARK_DRAW_LINE();
+
+CHECKSUM_BENCHMARKS(64)
+CHECKSUM_BENCHMARKS(128)
+CHECKSUM_BENCHMARKS(512)
+CHECKSUM_BENCHMARKS(1500)
+CHECKSUM_BENCHMARKS(4096)
+CHECKSUM_BENCHMARKS(9000)
+
+BENCHMARK(ChecksumRecompute_IPv4Header, iters) {
+  uint8_t hdr[20] = {0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40,
+                     0x00, 0x40, 0x11, 0x00, 0x00, 0xc0, 0xa8,
+                     0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7};
+  for (unsigned int i = 0; i < iters; ++i) {
+    hdr[8] = static_cast<uint8_t>(i);
+    folly::doNotOptimizeAway(PktUtil::internetChecksum(hdr, sizeof(hdr)));
+  }
+}
+
+BENCHMARK_RELATIVE(ChecksumUpdate_IPv4Header, iters) {
+  uint16_t csum = 0xb861;
+  for (unsigned int i = 0; i < iters; ++i) {
+    // TTL decrement
+    uint16_t oldWord = (i + 1) << 8;
+    uint16_t newWord = i << 8;
+    csum = PktUtil::updateChecksum(csum, oldWord, newWord);
+    folly::doNotOptimizeAway(csum);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/packet/PktMetadata.h"
+
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/IPProto.h"
+#include "fboss/agent/packet/PktUtil.h"
+
+#include <folly/MacAddress.h>
+#include <folly/io/IOBuf.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace facebook::fboss;
+using folly::IOBuf;
+using folly::MacAddress;
+
+namespace {
+
+PktMetadata parseHex(folly::StringPiece hex) {
+  auto buf = PktUtil::parseHexData(hex);
+  return PktMetadata::parse(&buf);
+}
+
+} // namespace
+
+TEST(PktMetadata, VlanTaggedIPv4Tcp) {
+  auto md = parseHex(
+      // dst mac, src mac
+      "02 00 01 00 00 01  02 00 02 00 00 02"
+      // 802.1q, VLAN 5
+      "81 00  00 05"
+      // IPv4
+      "08 00"
+      // Version 4, IHL 5, length 40, don't fragment, TTL 64, proto TCP
+      "45 00 00 28  00 00 40 00  40 06 00 00"
+      // 10.0.0.2 -> 10.0.0.1
+      "0a 00 00 02  0a 00 00 01"
+      // TCP 49153 -> 179
+      "c0 01 00 b3  00 00 00 00  00 00 00 00  50 02 00 00  00 00 00 00");
+  EXPECT_EQ(md.dstMac, MacAddress("02:00:01:00:00:01"));
+  EXPECT_EQ(md.srcMac, MacAddress("02:00:02:00:00:02"));
+  EXPECT_TRUE(md.vlanTagged);
+  EXPECT_EQ(md.vlanTci, 5);
+  EXPECT_EQ(md.etherType, static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_IPV4));
+  EXPECT_EQ(md.l3Offset, 18);
+  EXPECT_EQ(md.l4Offset, 38);
+  EXPECT_EQ(md.l3Length, 40);
+  EXPECT_EQ(md.ipProtocol, static_cast<uint8_t>(IP_PROTO::IP_PROTO_TCP));
+  EXPECT_EQ(md.ttl, 64);
+  EXPECT_TRUE(md.hasL4Ports());
+  EXPECT_EQ(md.l4SrcPort, 49153);
+  EXPECT_EQ(md.l4DstPort, 179);
+  EXPECT_EQ(md.flags, 0);
+}
+
+TEST(PktMetadata, IPv4NonFirstFragment) {
+  auto md = parseHex(
+      "02 00 01 00 00 01  02 00 02 00 00 02  08 00"
+      // IHL 6, fragment offset 16, TTL 1, proto UDP
+      "46 00 00 2c  00 00 00 10  01 11 00 00"
+      "0a 00 00 02  0a 00 00 01"
+      // Options
+      "01 01 01 00"
+      // Fragment payload
+      "00 43 00 44  00 10 00 00  00 00 00 00  00 00 00 00");
+  EXPECT_FALSE(md.vlanTagged);
+  EXPECT_EQ(md.l3Offset, 14);
+  EXPECT_EQ(md.ttl, 1);
+  EXPECT_EQ(md.ipProtocol, static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP));
+  EXPECT_EQ(md.flags, PktMetadata::IP_FRAGMENT | PktMetadata::IP_OPTIONS);
+  // Only the first fragment has the UDP header
+  EXPECT_FALSE(md.hasL4());
+  EXPECT_FALSE(md.hasL4Ports());
+}
+
+TEST(PktMetadata, IPv6ExtensionHeaders) {
+  auto md = parseHex(
+      "33 33 ff 00 00 01  02 00 02 00 00 02  86 dd"
+      // Payload length 32, next header hop-by-hop, hop limit 255
+      "60 00 00 00  00 20 00 ff"
+      // fe80::2 -> ff02::1:ff00:1
+      "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 02"
+      "ff 02 00 00 00 00 00 00  00 00 00 01 ff 00 00 01"
+      // Hop-by-hop, next header ICMPv6, 8 bytes
+      "3a 00 01 04  00 00 00 00"
+      // Neighbor solicitation
+      "87 00 00 00  00 00 00 00"
+      "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 01");
+  EXPECT_EQ(md.etherType, static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_IPV6));
+  EXPECT_EQ(md.l3Offset, 14);
+  EXPECT_EQ(md.l4Offset, 62);
+  EXPECT_EQ(md.l3Length, 72);
+  EXPECT_EQ(md.ipProtocol, static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP));
+  EXPECT_EQ(md.ttl, 255);
+  EXPECT_EQ(md.icmpType, 135);
+  EXPECT_EQ(md.flags, PktMetadata::IP_OPTIONS);
+  EXPECT_FALSE(md.hasL4Ports());
+}
+
+TEST(PktMetadata, TruncatedUdp) {
+  auto md = parseHex(
+      "02 00 01 00 00 01  02 00 02 00 00 02  08 00"
+      "45 00 00 20  00 00 00 00  40 11 00 00"
+      "0a 00 00 02  0a 00 00 01"
+      // Half a UDP header
+      "00 44 00 43");
+  EXPECT_TRUE(md.isTruncated());
+  EXPECT_EQ(md.l3Offset, 14);
+  EXPECT_EQ(md.ipProtocol, static_cast<uint8_t>(IP_PROTO::IP_PROTO_UDP));
+  EXPECT_FALSE(md.hasL4());
+  EXPECT_FALSE(md.hasL4Ports());
+}
+
+TEST(PktMetadata, MalformedIP) {
+  const std::string eth = "02 00 01 00 00 01  02 00 02 00 00 02";
+  const std::string v4Addrs = "0a 00 00 02  0a 00 00 01";
+  const std::string udp = "00 44 00 43  00 08 00 00";
+  // Version 6 in an IPv4 header
+  auto md = parseHex(eth + "08 00  65 00 00 1c 00 00 00 00 40 11 00 00" +
+                     v4Addrs + udp);
+  EXPECT_EQ(md.flags, PktMetadata::IP_MALFORMED);
+  EXPECT_FALSE(md.hasL4());
+  // IHL 4
+  md = parseHex(eth + "08 00  44 00 00 1c 00 00 00 00 40 11 00 00" +
+                v4Addrs + udp);
+  EXPECT_EQ(md.flags, PktMetadata::IP_MALFORMED);
+  // Total length shorter than the header
+  md = parseHex(eth + "08 00  45 00 00 10 00 00 00 00 40 11 00 00" +
+                v4Addrs + udp);
+  EXPECT_EQ(md.flags, PktMetadata::IP_MALFORMED);
+  // TTL 0
+  md = parseHex(eth + "08 00  45 00 00 1c 00 00 00 00 00 11 00 00" +
+                v4Addrs + udp);
+  EXPECT_EQ(md.flags, PktMetadata::IP_MALFORMED);
+  EXPECT_EQ(md.l3Length, 0);
+  // Hop limit 0
+  md = parseHex(eth + "86 dd  60 00 00 00 00 08 11 00" +
+                "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 02"
+                "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 01" +
+                udp);
+  EXPECT_EQ(md.flags, PktMetadata::IP_MALFORMED);
+  EXPECT_FALSE(md.hasL4());
+}
+
+TEST(PktMetadata, NonIP) {
+  auto md = parseHex(
+      "ff ff ff ff ff ff  02 00 02 00 00 02  81 00 00 01  08 06"
+      "00 01 08 00 06 04 00 01");
+  EXPECT_EQ(md.etherType, static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_ARP));
+  EXPECT_EQ(md.l3Offset, 18);
+  EXPECT_FALSE(md.hasL4());
+  EXPECT_FALSE(md.isTruncated());
+}
+
+TEST(PktMetadata, TruncatedEthernet) {
+  auto md = parseHex("ff ff ff ff ff ff  02 00 02 00");
+  EXPECT_TRUE(md.isTruncated());
+  EXPECT_FALSE(md.hasL3());
+}
@@ -18,6 +18,10 @@
 #include <folly/logging/xlog.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 using namespace facebook::fboss;
 using folly::IOBuf;
 using folly::IPAddressV4;
@@ -222,3 +226,53 @@ TEST(Checksum, TestKnownOdd) {
   expected = ~expected;
   EXPECT_EQ(expected, PktUtil::internetChecksum(bytes, 9));
 }
+
+TEST(Checksum, TestChained) {
+  // Odd sized segments, so that words straddle segment boundaries
+  std::vector<uint8_t> bytes(1001);
+  for (auto& byte : bytes) {
+    byte = Random::rand32(std::numeric_limits<uint8_t>::max());
+  }
+  auto chain = IOBuf::create(0);
+  for (size_t offset = 0, segment = 1; offset < bytes.size();
+       offset += segment, segment = segment % 7 + 2) {
+    segment = std::min(segment, bytes.size() - offset);
+    chain->prependChain(IOBuf::copyBuffer(&bytes[offset], segment));
+  }
+  EXPECT_EQ(
+      PktUtil::internetChecksum(bytes.data(), bytes.size()),
+      PktUtil::internetChecksum(chain.get()));
+  EXPECT_EQ(
+      PktUtil::internetChecksum(&bytes[3], 500),
+      PktUtil::internetChecksum(Cursor(chain.get()) + 3, 500));
+}
+
+TEST(Checksum, TestUpdate) {
+  // IPv4 header with a valid checksum
+  auto buf = PktUtil::parseHexData(
+      "45 00 00 73 00 00 40 00 40 11 b8 61 c0 a8 00 01"
+      "c0 a8 00 c7");
+  auto data = buf.writableData();
+  ASSERT_EQ(0, PktUtil::internetChecksum(data, buf.length()));
+  uint16_t csum = (data[10] << 8) | data[11];
+
+  // Decrement the TTL
+  uint16_t oldWord = (data[8] << 8) | data[9];
+  data[8] -= 1;
+  uint16_t newWord = (data[8] << 8) | data[9];
+  csum = PktUtil::updateChecksum(csum, oldWord, newWord);
+  data[10] = csum >> 8;
+  data[11] = csum & 0xff;
+  EXPECT_EQ(0, PktUtil::internetChecksum(data, buf.length()));
+
+  // Rewrite the destination address
+  auto newDst = IPAddressV4("10.0.0.1");
+  std::array<uint8_t, 4> oldDst;
+  memcpy(oldDst.data(), &data[16], 4);
+  memcpy(&data[16], newDst.bytes(), 4);
+  csum = PktUtil::updateChecksum(
+      csum, folly::ByteRange(oldDst.data(), 4), folly::ByteRange(&data[16], 4));
+  data[10] = csum >> 8;
+  data[11] = csum & 0xff;
+  EXPECT_EQ(0, PktUtil::internetChecksum(data, buf.length()));
+}
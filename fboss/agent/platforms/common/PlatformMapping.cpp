@@ -16,15 +16,39 @@
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
 
 DEFINE_bool(
     override_cmis_tx_setting,
     false,
     "Flag to turn on new GB line tx setting for cmis module running in 100G");
 
+DEFINE_bool(
+    use_precompiled_platform_mappings,
+    true,
+    "Load platform mappings from their build time precompiled thrift compact "
+    "form when available, instead of parsing the embedded json");
+
 namespace {
 constexpr auto kFbossPortNameRegex = "eth(\\d+)/(\\d+)/(\\d+)";
 const re2::RE2 portNameRegex(kFbossPortNameRegex);
+
+facebook::fboss::cfg::PlatformMapping loadPlatformMapping(
+    const std::string& jsonPlatformMappingStr,
+    bool* precompiled) {
+  using facebook::fboss::cfg::PlatformMapping;
+  *precompiled = false;
+  if (FLAGS_use_precompiled_platform_mappings) {
+    if (auto compact = facebook::fboss::findPrecompiledPlatformMapping(
+            jsonPlatformMappingStr)) {
+      *precompiled = true;
+      return apache::thrift::CompactSerializer::deserialize<PlatformMapping>(
+          *compact);
+    }
+  }
+  return apache::thrift::SimpleJSONSerializer::deserialize<PlatformMapping>(
+      jsonPlatformMappingStr);
+}
 } // namespace
 
 namespace facebook {
@@ -124,9 +148,7 @@ std::string PlatformPortProfileConfigMatcher::toString() const {
 }
 
 PlatformMapping::PlatformMapping(const std::string& jsonPlatformMappingStr) {
-  auto mapping =
-      apache::thrift::SimpleJSONSerializer::deserialize<cfg::PlatformMapping>(
-          jsonPlatformMappingStr);
+  auto mapping = loadPlatformMapping(jsonPlatformMappingStr, &precompiled_);
   platformPorts_ = std::move(*mapping.ports_ref());
   platformSupportedProfiles_ =
       std::move(*mapping.platformSupportedProfiles_ref());
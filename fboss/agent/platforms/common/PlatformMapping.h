@@ -85,6 +85,11 @@ class PlatformMapping {
 
   cfg::PlatformMapping toThrift() const;
 
+  // Whether the json was found precompiled, and not parsed
+  bool isPrecompiled() const {
+    return precompiled_;
+  }
+
   const std::map<int32_t, cfg::PlatformPortEntry>& getPlatformPorts() const {
     return platformPorts_;
   }
@@ -151,6 +156,8 @@ class PlatformMapping {
       cfg::PortProfileID profileID) const;
 
  private:
+  bool precompiled_{false};
+
   // Forbidden copy constructor and assignment operator
   PlatformMapping(PlatformMapping const&) = delete;
   PlatformMapping& operator=(PlatformMapping const&) = delete;
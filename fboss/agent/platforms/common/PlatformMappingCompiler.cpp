@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Build time tool generating the source that defines
+ * getPrecompiledPlatformMappings(), see PrecompiledPlatformMappings.h
+ *
+ * Usage: platform_mapping_compiler --output=<generated.cpp> <mapping.cpp>...
+ *
+ * Every raw string literal in the given platform mapping sources must be a
+ * json cfg::PlatformMapping. Sources that fail to parse fail the build.
+ */
+
+#include "fboss/agent/gen-cpp2/platform_config_types.h"
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
+
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <string>
+#include <vector>
+
+DEFINE_string(output, "", "Generated source to write");
+
+namespace {
+
+// Contents of every raw string literal R"delim(...)delim" in source
+std::vector<folly::StringPiece> rawStringLiterals(folly::StringPiece source) {
+  std::vector<folly::StringPiece> literals;
+  size_t pos = 0;
+  while ((pos = source.find("R\"", pos)) != folly::StringPiece::npos) {
+    auto open = source.find('(', pos);
+    if (open == folly::StringPiece::npos) {
+      break;
+    }
+    auto delimiter = source.subpiece(pos + 2, open - pos - 2).str();
+    auto terminator = folly::to<std::string>(")", delimiter, "\"");
+    auto close = source.find(terminator, open + 1);
+    if (close == folly::StringPiece::npos) {
+      break;
+    }
+    literals.push_back(source.subpiece(open + 1, close - open - 1));
+    pos = close + terminator.size();
+  }
+  return literals;
+}
+
+void appendBytes(folly::StringPiece bytes, std::string* out) {
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    folly::toAppend(
+        i % 16 == 0 ? "\n    " : " ",
+        folly::sformat("'\\x{:02x}',", static_cast<uint8_t>(bytes[i])),
+        out);
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  if (FLAGS_output.empty() || argc < 2) {
+    XLOG(ERR) << "Usage: " << argv[0]
+              << " --output=<generated.cpp> <mapping.cpp>...";
+    return 1;
+  }
+
+  std::string arrays;
+  std::string entries;
+  int mappingIdx = 0;
+  for (int arg = 1; arg < argc; ++arg) {
+    std::string source;
+    if (!folly::readFile(argv[arg], source)) {
+      XLOG(ERR) << "Unable to read " << argv[arg];
+      return 1;
+    }
+    for (auto json : rawStringLiterals(source)) {
+      facebook::fboss::cfg::PlatformMapping mapping;
+      try {
+        mapping = apache::thrift::SimpleJSONSerializer::deserialize<
+            facebook::fboss::cfg::PlatformMapping>(json);
+      } catch (const std::exception& ex) {
+        XLOG(ERR) << "Invalid platform mapping in " << argv[arg] << ": "
+                  << ex.what();
+        return 1;
+      }
+      auto compact = apache::thrift::CompactSerializer::serialize<std::string>(
+          mapping);
+      XLOG(INFO) << argv[arg] << ": " << json.size() << " bytes of json, "
+                 << compact.size() << " bytes compact";
+
+      folly::toAppend(
+          "// ",
+          argv[arg],
+          "\nconst char kMapping",
+          mappingIdx,
+          "[] = {",
+          &arrays);
+      appendBytes(compact, &arrays);
+      folly::toAppend("\n};\n\n", &arrays);
+      folly::toAppend(
+          folly::sformat(
+              "      {{{}, {}ULL, folly::StringPiece(kMapping{}, {})}},\n",
+              json.size(),
+              facebook::fboss::platformMappingJsonHash(json),
+              mappingIdx,
+              compact.size()),
+          &entries);
+      ++mappingIdx;
+    }
+  }
+
+  auto generated = folly::to<std::string>(
+      "// @",
+      "generated by platform_mapping_compiler, do not edit\n\n",
+      "#include \"fboss/agent/platforms/common/",
+      "PrecompiledPlatformMappings.h\"\n\n",
+      "namespace facebook::fboss {\n\nnamespace {\n",
+      arrays,
+      "} // namespace\n\n",
+      "const std::vector<PrecompiledPlatformMapping>& ",
+      "getPrecompiledPlatformMappings() {\n",
+      "  static const std::vector<PrecompiledPlatformMapping> kMappings = {\n",
+      entries,
+      "  };\n  return kMappings;\n}\n\n} // namespace facebook::fboss\n");
+  if (!folly::writeFile(generated, FLAGS_output.c_str())) {
+    XLOG(ERR) << "Unable to write " << FLAGS_output;
+    return 1;
+  }
+  return 0;
+}
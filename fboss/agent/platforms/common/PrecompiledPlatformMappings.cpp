@@ -0,0 +1,33 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
+
+namespace facebook::fboss {
+
+std::optional<folly::StringPiece> findPrecompiledPlatformMapping(
+    folly::StringPiece json) {
+  std::optional<uint64_t> jsonHash;
+  for (const auto& mapping : getPrecompiledPlatformMappings()) {
+    if (mapping.jsonSize != json.size()) {
+      continue;
+    }
+    // Only hash if some mapping has a matching size
+    if (!jsonHash) {
+      jsonHash = platformMappingJsonHash(json);
+    }
+    if (mapping.jsonHash == *jsonHash) {
+      return mapping.compact;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,51 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/hash/SpookyHashV2.h>
+
+#include <optional>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * Platform mappings are written as json embedded in each platform's
+ * *PlatformMapping.cpp, which remains the source of truth. Parsing that json
+ * (several MB for multi pim platforms) dominates PlatformMapping
+ * construction, so at build time platform_mapping_compiler parses every
+ * embedded mapping once and serializes it with the thrift compact protocol.
+ *
+ * At run time, PlatformMapping looks up the json it was handed by size and
+ * hash and, on a hit, deserializes the compact form instead. Json that was
+ * modified before being handed to PlatformMapping (e.g. per linecard
+ * rewrites) simply misses and is parsed as before.
+ */
+struct PrecompiledPlatformMapping {
+  size_t jsonSize;
+  uint64_t jsonHash;
+  // cfg::PlatformMapping, thrift compact serialized
+  folly::StringPiece compact;
+};
+
+inline uint64_t platformMappingJsonHash(folly::StringPiece json) {
+  return folly::hash::SpookyHashV2::Hash64(json.data(), json.size(), 0);
+}
+
+/*
+ * Defined in the source generated by platform_mapping_compiler.
+ */
+const std::vector<PrecompiledPlatformMapping>& getPrecompiledPlatformMappings();
+
+std::optional<folly::StringPiece> findPrecompiledPlatformMapping(
+    folly::StringPiece json);
+
+} // namespace facebook::fboss
@@ -21,8 +21,11 @@
 #include "fboss/agent/platforms/common/wedge400/Wedge400PlatformMapping.h"
 #include "fboss/agent/platforms/common/yamp/YampPlatformMapping.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+DECLARE_bool(use_precompiled_platform_mappings);
+
 namespace facebook::fboss::test {
 
 cfg::PlatformPortProfileConfigEntry createPlatformPortProfileConfigEntry(
@@ -1091,4 +1094,28 @@ TEST_F(PlatformMappingTest, VerifyPlatformSupportedProfileMerge) {
   EXPECT_THROW(
       platformMapping.mergePlatformSupportedProfile(configEntry4), FbossError);
 }
+
+TEST_F(PlatformMappingTest, VerifyPrecompiledPlatformMappings) {
+  gflags::FlagSaver flagSaver;
+  auto loadMappings = [](bool precompiled) {
+    FLAGS_use_precompiled_platform_mappings = precompiled;
+    std::vector<std::unique_ptr<PlatformMapping>> mappings;
+    mappings.push_back(std::make_unique<Wedge400PlatformMapping>());
+    mappings.push_back(std::make_unique<Wedge100PlatformMapping>());
+    mappings.push_back(std::make_unique<Minipack16QPimPlatformMapping>(
+        ExternalPhyVersion::MILN5_2));
+    return mappings;
+  };
+  auto parsedMappings = loadMappings(false);
+  auto precompiledMappings = loadMappings(true);
+  ASSERT_EQ(parsedMappings.size(), precompiledMappings.size());
+  for (size_t i = 0; i < parsedMappings.size(); ++i) {
+    EXPECT_FALSE(parsedMappings[i]->isPrecompiled());
+    // Otherwise both sides were parsed from json, and trivially match
+    ASSERT_TRUE(precompiledMappings[i]->isPrecompiled())
+        << "No precompiled mapping for platform " << i;
+    EXPECT_EQ(
+        parsedMappings[i]->toThrift(), precompiledMappings[i]->toThrift());
+  }
+}
 } // namespace facebook::fboss::test
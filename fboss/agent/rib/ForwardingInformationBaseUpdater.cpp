@@ -19,6 +19,7 @@
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
+#include <optional>
 
 namespace facebook::fboss {
 
@@ -30,6 +31,18 @@ ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
       v4NetworkToRoute_(v4NetworkToRoute),
       v6NetworkToRoute_(v6NetworkToRoute) {}
 
+ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
+    RouterID vrf,
+    const IPv4NetworkToRouteMap& v4NetworkToRoute,
+    const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const IPv4NetworkToRouteMap& previousV4NetworkToRoute,
+    const IPv6NetworkToRouteMap& previousV6NetworkToRoute)
+    : vrf_(vrf),
+      v4NetworkToRoute_(v4NetworkToRoute),
+      v6NetworkToRoute_(v6NetworkToRoute),
+      previousV4NetworkToRoute_(&previousV4NetworkToRoute),
+      previousV6NetworkToRoute_(&previousV6NetworkToRoute) {}
+
 std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
   // A ForwardingInformationBaseContainer holds a
@@ -49,11 +62,23 @@ std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     previousFibContainer = nextState->getFibs()->getFibContainerIf(vrf_);
   }
   CHECK(previousFibContainer);
-  auto newFibV4 =
-      createUpdatedFib(v4NetworkToRoute_, previousFibContainer->getFibV4());
-
-  auto newFibV6 =
-      createUpdatedFib(v6NetworkToRoute_, previousFibContainer->getFibV6());
+  std::shared_ptr<ForwardingInformationBaseV4> newFibV4;
+  std::shared_ptr<ForwardingInformationBaseV6> newFibV6;
+  if (previousV4NetworkToRoute_) {
+    newFibV4 = createUpdatedFib(
+        v4NetworkToRoute_,
+        *previousV4NetworkToRoute_,
+        previousFibContainer->getFibV4());
+    newFibV6 = createUpdatedFib(
+        v6NetworkToRoute_,
+        *previousV6NetworkToRoute_,
+        previousFibContainer->getFibV6());
+  } else {
+    newFibV4 =
+        createUpdatedFib(v4NetworkToRoute_, previousFibContainer->getFibV4());
+    newFibV6 =
+        createUpdatedFib(v6NetworkToRoute_, previousFibContainer->getFibV6());
+  }
 
   if (!newFibV4 && !newFibV6) {
     // return nextState in case we modified state above to insert new VRF
@@ -135,4 +160,66 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
                  : nullptr;
 }
 
+template <typename AddressT>
+std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+ForwardingInformationBaseUpdater::createUpdatedFib(
+    const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+    const facebook::fboss::NetworkToRouteMap<AddressT>& previousRib,
+    const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
+        fib) {
+  // Copied from the FIB on the first change only
+  std::optional<typename facebook::fboss::ForwardingInformationBase<
+      AddressT>::Base::NodeContainer>
+      updatedFib;
+  auto setFibRoute =
+      [&fib, &updatedFib](
+          const facebook::fboss::RoutePrefix<AddressT>& prefix,
+          const std::shared_ptr<facebook::fboss::Route<AddressT>>& ribRoute) {
+        const auto& fibRoutes = updatedFib ? *updatedFib : fib->getAllNodes();
+        auto fibRoute = fibRoutes.find(prefix);
+        if (fibRoute == fibRoutes.end()) {
+          if (!ribRoute) {
+            return;
+          }
+        } else if (
+            ribRoute &&
+            (fibRoute->second == ribRoute ||
+             fibRoute->second->isSame(ribRoute.get()))) {
+          return;
+        }
+        if (!updatedFib) {
+          updatedFib = fib->getAllNodes();
+        }
+        if (ribRoute) {
+          CHECK(ribRoute->isPublished());
+          (*updatedFib)[prefix] = ribRoute;
+        } else {
+          updatedFib->erase(prefix);
+        }
+      };
+
+  // Routes are copied on write by the RIB, so unchanged routes are the same
+  // objects in both copies of it
+  for (const auto& entry : rib) {
+    const auto& ribRoute = entry.value();
+    const auto& prefix = ribRoute->prefix();
+    auto previous = previousRib.exactMatch(prefix.network, prefix.mask);
+    if (previous != previousRib.end() && previous->value() == ribRoute) {
+      continue;
+    }
+    // Unresolved routes are not in the FIB
+    setFibRoute(prefix, ribRoute->isResolved() ? ribRoute : nullptr);
+  }
+  for (const auto& entry : previousRib) {
+    const auto& prefix = entry.value()->prefix();
+    if (rib.exactMatch(prefix.network, prefix.mask) == rib.end()) {
+      setFibRoute(prefix, nullptr);
+    }
+  }
+
+  return updatedFib ? std::make_shared<ForwardingInformationBase<AddressT>>(
+                          std::move(*updatedFib))
+                    : nullptr;
+}
+
 } // namespace facebook::fboss
@@ -28,6 +28,17 @@ class ForwardingInformationBaseUpdater {
       const IPv4NetworkToRouteMap& v4NetworkToRoute,
       const IPv6NetworkToRouteMap& v6NetworkToRoute);
 
+  /*
+   * Only apply to the FIB the routes that differ between an earlier copy of
+   * the RIB and the current one, leaving other FIB routes as they are.
+   */
+  ForwardingInformationBaseUpdater(
+      RouterID vrf,
+      const IPv4NetworkToRouteMap& v4NetworkToRoute,
+      const IPv6NetworkToRouteMap& v6NetworkToRoute,
+      const IPv4NetworkToRouteMap& previousV4NetworkToRoute,
+      const IPv6NetworkToRouteMap& previousV6NetworkToRoute);
+
   std::shared_ptr<SwitchState> operator()(
       const std::shared_ptr<SwitchState>& state);
 
@@ -42,9 +53,23 @@ class ForwardingInformationBaseUpdater {
       const std::shared_ptr<
           facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
 
+  /*
+   * Return FIB updated with the routes that changed from previousRib to rib
+   * on change, null otherwise
+   */
+  template <typename AddressT>
+  std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+  createUpdatedFib(
+      const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+      const facebook::fboss::NetworkToRouteMap<AddressT>& previousRib,
+      const std::shared_ptr<
+          facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
+
   RouterID vrf_;
   const IPv4NetworkToRouteMap& v4NetworkToRoute_;
   const IPv6NetworkToRouteMap& v6NetworkToRoute_;
+  const IPv4NetworkToRouteMap* previousV4NetworkToRoute_{nullptr};
+  const IPv6NetworkToRouteMap* previousV6NetworkToRoute_{nullptr};
 };
 
 } // namespace facebook::fboss
@@ -206,22 +206,26 @@ void RibRouteTables::updateFib(
     fibUpdateCallback(
         vrf, routeTable.v4NetworkToRoute, routeTable.v6NetworkToRoute, cookie);
   } catch (const FbossHwUpdateError& hwUpdateError) {
-    {
-      SCOPE_FAIL {
-        XLOG(FATAL) << " RIB Rollback failed, aborting program";
-      };
-      auto fib = hwUpdateError.appliedState->getFibs()->getFibContainer(vrf);
-      auto lockedRouteTables = synchronizedRouteTables_.wlock();
-      auto& routeTable = lockedRouteTables->find(vrf)->second;
-      reconstructRibFromFib<folly::IPAddressV4>(
-          fib->getFibV4(), &routeTable.v4NetworkToRoute);
-      reconstructRibFromFib<folly::IPAddressV6>(
-          fib->getFibV6(), &routeTable.v6NetworkToRoute);
-    }
+    reconstructFromFib(vrf, hwUpdateError.appliedState);
     throw;
   }
 }
 
+void RibRouteTables::reconstructFromFib(
+    RouterID rid,
+    const std::shared_ptr<SwitchState>& appliedState) {
+  SCOPE_FAIL {
+    XLOG(FATAL) << " RIB Rollback failed, aborting program";
+  };
+  auto fib = appliedState->getFibs()->getFibContainer(rid);
+  auto lockedRouteTables = synchronizedRouteTables_.wlock();
+  auto& routeTable = lockedRouteTables->find(rid)->second;
+  reconstructRibFromFib<folly::IPAddressV4>(
+      fib->getFibV4(), &routeTable.v4NetworkToRoute);
+  reconstructRibFromFib<folly::IPAddressV6>(
+      fib->getFibV6(), &routeTable.v6NetworkToRoute);
+}
+
 void RibRouteTables::ensureVrf(RouterID rid) {
   auto lockedRouteTables = synchronizedRouteTables_.wlock();
   if (lockedRouteTables->find(rid) == lockedRouteTables->end()) {
@@ -238,6 +242,29 @@ std::vector<RouterID> RibRouteTables::getVrfList() const {
   return res;
 }
 
+template <typename RouteTable>
+static void updateRouteClassID(
+    RouteTable& routeTable,
+    const folly::CIDRNetwork& prefix,
+    const std::optional<cfg::AclLookupClass>& classId) {
+  auto updateRoute = [&classId](auto& rib, auto ip, uint8_t mask) {
+    auto ritr = rib.exactMatch(ip, mask);
+    if (ritr == rib.end() || ritr->value()->getClassID() == classId) {
+      return;
+    }
+    ritr->value() = ritr->value()->clone();
+    ritr->value()->updateClassID(classId);
+    ritr->value()->publish();
+  };
+  if (prefix.first.isV4()) {
+    updateRoute(
+        routeTable.v4NetworkToRoute, prefix.first.asV4(), prefix.second);
+  } else {
+    updateRoute(
+        routeTable.v6NetworkToRoute, prefix.first.asV6(), prefix.second);
+  }
+}
+
 void RibRouteTables::setClassID(
     RouterID rid,
     const std::vector<folly::CIDRNetwork>& prefixes,
@@ -246,23 +273,21 @@ void RibRouteTables::setClassID(
     void* cookie) {
   updateRib(rid, [&](auto& routeTable) {
     // Update rib
-    auto updateRoute = [&classId](auto& rib, auto ip, uint8_t mask) {
-      auto ritr = rib.exactMatch(ip, mask);
-      if (ritr == rib.end() || ritr->value()->getClassID() == classId) {
-        return;
-      }
-      ritr->value() = ritr->value()->clone();
-      ritr->value()->updateClassID(classId);
-      ritr->value()->publish();
-    };
-    auto& v4Rib = routeTable.v4NetworkToRoute;
-    auto& v6Rib = routeTable.v6NetworkToRoute;
     for (auto& prefix : prefixes) {
-      if (prefix.first.isV4()) {
-        updateRoute(v4Rib, prefix.first.asV4(), prefix.second);
-      } else {
-        updateRoute(v6Rib, prefix.first.asV6(), prefix.second);
-      }
+      updateRouteClassID(routeTable, prefix, classId);
+    }
+  });
+  updateFib(rid, fibUpdateCallback, cookie);
+}
+
+void RibRouteTables::setClassIDs(
+    RouterID rid,
+    const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+    FibUpdateFunction fibUpdateCallback,
+    void* cookie) {
+  updateRib(rid, [&](auto& routeTable) {
+    for (const auto& [prefix, classId] : prefixesAndClassIDs) {
+      updateRouteClassID(routeTable, prefix, classId);
     }
   });
   updateFib(rid, fibUpdateCallback, cookie);
@@ -463,6 +488,33 @@ void RoutingInformationBase::setClassIDImpl(
   }
 }
 
+void RoutingInformationBase::setClassIDsImpl(
+    RouterID rid,
+    const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+    FibUpdateFunction fibUpdateCallback,
+    void* cookie,
+    bool async) {
+  ensureRunning();
+  auto updateFn = [=]() {
+    ribTables_.setClassIDs(
+        rid, prefixesAndClassIDs, fibUpdateCallback, cookie);
+  };
+  if (async) {
+    ribUpdateEventBase_.runInEventBaseThread(updateFn);
+  } else {
+    ribUpdateEventBase_.runInEventBaseThreadAndWait(updateFn);
+  }
+}
+
+void RoutingInformationBase::reconstructFromFib(
+    RouterID rid,
+    const AppliedStateFunction& getAppliedState) {
+  ensureRunning();
+  ribUpdateEventBase_.runInEventBaseThreadAndWait([&]() {
+    ribTables_.reconstructFromFib(rid, getAppliedState());
+  });
+}
+
 folly::dynamic RibRouteTables::toFollyDynamic() const {
   return toFollyDynamicImpl([](const auto& /*route*/) { return true; });
 }
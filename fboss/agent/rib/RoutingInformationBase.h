@@ -32,6 +32,8 @@ using FibUpdateFunction = std::function<std::shared_ptr<SwitchState>(
     const IPv6NetworkToRouteMap& v6NetworkToRoute,
     void* cookie)>;
 
+using AppliedStateFunction = std::function<std::shared_ptr<SwitchState>()>;
+
 /*
  * RibRouteTables provides a thread safe abstraction for maintaining Rib data
  * structures and programming them down to the FIB. Its designed to abstract
@@ -40,6 +42,9 @@ using FibUpdateFunction = std::function<std::shared_ptr<SwitchState>(
  */
 class RibRouteTables {
  public:
+  using PrefixAndClassID =
+      std::pair<folly::CIDRNetwork, std::optional<cfg::AclLookupClass>>;
+
   void update(
       RouterID routerID,
       ClientID clientID,
@@ -57,6 +62,24 @@ class RibRouteTables {
       FibUpdateFunction fibUpdateCallback,
       std::optional<cfg::AclLookupClass> classId,
       void* cookie);
+
+  /*
+   * Set a possibly different classID for each prefix, with a single FIB
+   * update. If a prefix appears more than once, the last classID wins.
+   */
+  void setClassIDs(
+      RouterID rid,
+      const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie);
+
+  /*
+   * Rebuild the RIB of rid from its FIB in appliedState, rolling back RIB
+   * changes which failed to be programmed
+   */
+  void reconstructFromFib(
+      RouterID rid,
+      const std::shared_ptr<SwitchState>& appliedState);
   /*
    * VrfAndNetworkToInterfaceRoute is conceptually a mapping from the pair
    * (RouterID, folly::CIDRNetwork) to the pair (Interface(1),
@@ -240,6 +263,25 @@ class RoutingInformationBase {
     setClassIDImpl(rid, prefixes, fibUpdateCallback, classId, cookie, true);
   }
 
+  using PrefixAndClassID = RibRouteTables::PrefixAndClassID;
+
+  void setClassIDs(
+      RouterID rid,
+      const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie) {
+    setClassIDsImpl(
+        rid, prefixesAndClassIDs, fibUpdateCallback, cookie, false);
+  }
+
+  void setClassIDsAsync(
+      RouterID rid,
+      const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie) {
+    setClassIDsImpl(rid, prefixesAndClassIDs, fibUpdateCallback, cookie, true);
+  }
+
   folly::dynamic toFollyDynamic() const {
     return ribTables_.toFollyDynamic();
   }
@@ -266,6 +308,18 @@ class RoutingInformationBase {
     return ribTables_.getRouteTableDetails(rid);
   }
 
+  /*
+   * Roll back the RIB of rid after one of its FIB updates failed to be
+   * programmed, when the FIB update callback did not wait for programming
+   * to finish (see SwSwitchRouteUpdateWrapper). Runs on the RIB thread,
+   * so no RIB update starts in the meantime, and rebuilds the RIB from the
+   * FIB in the state getAppliedState returns. getAppliedState should wait
+   * for the FIB updates already scheduled to be programmed first.
+   */
+  void reconstructFromFib(
+      RouterID rid,
+      const AppliedStateFunction& getAppliedState);
+
   void waitForRibUpdates() {
     ensureRunning();
     ribUpdateEventBase_.runInEventBaseThreadAndWait([] { return; });
@@ -289,6 +343,12 @@ class RoutingInformationBase {
       std::optional<cfg::AclLookupClass> classId,
       void* cookie,
       bool async);
+  void setClassIDsImpl(
+      RouterID rid,
+      const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie,
+      bool async);
 
   std::unique_ptr<std::thread> ribUpdateThread_;
   folly::EventBase ribUpdateEventBase_;
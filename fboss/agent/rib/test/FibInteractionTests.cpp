@@ -411,3 +411,63 @@ TEST(ForwardingInformationBaseUpdater, Deduplication) {
   ASSERT_TRUE(route3);
   EXPECT_NE(route, route3);
 }
+
+TEST(Rib, SetClassIDsLastWins) {
+  using namespace facebook::fboss;
+
+  cfg::SwitchConfig config;
+  config.vlans_ref()->resize(1);
+  *config.vlans_ref()[0].id_ref() = 1;
+  config.interfaces_ref()->resize(1);
+  *config.interfaces_ref()[0].intfID_ref() = 1;
+  *config.interfaces_ref()[0].vlanID_ref() = 1;
+  *config.interfaces_ref()[0].routerID_ref() = vrfZero;
+  config.interfaces_ref()[0].mac_ref() = "00:00:00:00:00:11";
+  config.interfaces_ref()[0].ipAddresses_ref()->resize(2);
+  config.interfaces_ref()[0].ipAddresses_ref()[0] = "10.120.70.44/31";
+  config.interfaces_ref()[0].ipAddresses_ref()[1] =
+      "2401:db00:e003:9100:1006::2c/127";
+
+  auto testHandle = createTestHandle(&config);
+  auto sw = testHandle->getSw();
+
+  RoutePrefixV4 prefix4{folly::IPAddressV4("7.1.0.0"), 16};
+  RoutePrefixV6 prefix6{folly::IPAddressV6("aaaa:1::"), 64};
+  std::vector<UnicastRoute> routesToAdd;
+  routesToAdd.push_back(createUnicastRoute(
+      prefix4.network, prefix4.mask, folly::IPAddress("10.120.70.45")));
+  routesToAdd.push_back(createUnicastRoute(
+      prefix6.network,
+      prefix6.mask,
+      folly::IPAddress("2401:db00:e003:9100:1006::2d")));
+  programRoutes(sw, ClientID(0), routesToAdd);
+
+  folly::CIDRNetwork cidr4{folly::IPAddress(prefix4.network), prefix4.mask};
+  folly::CIDRNetwork cidr6{folly::IPAddress(prefix6.network), prefix6.mask};
+  // Routes updated more than once end up with their last classID, all of
+  // them programmed with a single state update
+  EXPECT_HW_CALL(sw, stateChanged(testing::_)).Times(1);
+  sw->getRouteUpdater().programClassIDs(
+      vrfZero,
+      {{cidr4, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0},
+       {cidr6, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1},
+       {cidr4, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_2},
+       {cidr6, std::nullopt},
+       {cidr4, cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3}},
+      false /* async */);
+
+  auto fibContainer = sw->getState()->getFibs()->getFibContainer(vrfZero);
+  auto route4 = fibContainer->getFibV4()->exactMatch(prefix4);
+  auto route6 = fibContainer->getFibV6()->exactMatch(prefix6);
+  ASSERT_TRUE(route4);
+  ASSERT_TRUE(route6);
+  EXPECT_EQ(
+      route4->getClassID(), cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3);
+  EXPECT_EQ(route6->getClassID(), std::nullopt);
+
+  auto ribRoute4 = sw->getRib()->longestMatch(prefix4.network, vrfZero);
+  ASSERT_TRUE(ribRoute4);
+  EXPECT_EQ(
+      ribRoute4->getClassID(),
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3);
+}
@@ -146,7 +146,20 @@ class AclEntry : public NodeBaseT<AclEntry, AclEntryFields> {
 
   bool operator==(const AclEntry& acl) const {
     return getFields()->priority == acl.getPriority() &&
-        getFields()->name == acl.getID() &&
+        isSameExceptPriority(acl);
+  }
+
+  bool operator!=(const AclEntry& acl) const {
+    return !(*this == acl);
+  }
+
+  /*
+   * Whether acl differs from this one, if at all, only in priority. Such
+   * changes may be applied to hardware by moving the entry, rather than
+   * removing and re-adding it.
+   */
+  bool isSameExceptPriority(const AclEntry& acl) const {
+    return getFields()->name == acl.getID() &&
         getFields()->actionType == acl.getActionType() &&
         getFields()->aclAction == acl.getAclAction() &&
         getFields()->srcIp == acl.getSrcIp() &&
@@ -171,10 +184,6 @@ class AclEntry : public NodeBaseT<AclEntry, AclEntryFields> {
         getFields()->etherType == acl.getEtherType();
   }
 
-  bool operator!=(const AclEntry& acl) const {
-    return !(*this == acl);
-  }
-
   int getPriority() const {
     return getFields()->priority;
   }
@@ -13,6 +13,10 @@
 #include "fboss/agent/state/NodeMapDelta-defs.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace facebook::fboss {
 
 AclMap::AclMap() {}
@@ -32,6 +36,68 @@ AclMap* AclMap::modify(std::shared_ptr<SwitchState>* state) {
   return ptr;
 }
 
+OrderedAclChanges::OrderedAclChanges(const AclMapDelta& delta) {
+  std::unordered_map<std::string, std::shared_ptr<AclEntry>> oldAcls;
+  std::vector<std::shared_ptr<AclEntry>> newAcls;
+  for (const auto& aclDelta : delta) {
+    if (const auto& oldAcl = aclDelta.getOld()) {
+      oldAcls.emplace(oldAcl->getID(), oldAcl);
+    }
+    if (const auto& newAcl = aclDelta.getNew()) {
+      newAcls.push_back(newAcl);
+    }
+  }
+
+  decltype(moved) moves;
+  for (const auto& newAcl : newAcls) {
+    auto itr = oldAcls.find(newAcl->getID());
+    if (itr == oldAcls.end() || !itr->second->isSameExceptPriority(*newAcl)) {
+      added.push_back(newAcl);
+      continue;
+    }
+    if (itr->second->getPriority() != newAcl->getPriority()) {
+      moves.emplace_back(itr->second, newAcl);
+    }
+    oldAcls.erase(itr);
+  }
+  for (const auto& [name, oldAcl] : oldAcls) {
+    removed.push_back(oldAcl);
+  }
+  std::sort(removed.begin(), removed.end(), [](const auto& a, const auto& b) {
+    return a->getPriority() < b->getPriority();
+  });
+
+  /*
+   * Acls moving to a larger priority go first, furthest along first, then
+   * acls moving to a smaller priority, again furthest along first. As
+   * long as moving acls keep their relative order, which is what the acl
+   * priority allocator produces, every move then lands on a free priority.
+   */
+  std::sort(moves.begin(), moves.end(), [](const auto& a, const auto& b) {
+    bool aUp = a.second->getPriority() > a.first->getPriority();
+    bool bUp = b.second->getPriority() > b.first->getPriority();
+    if (aUp != bUp) {
+      return aUp;
+    }
+    return aUp ? a.first->getPriority() > b.first->getPriority()
+               : a.first->getPriority() < b.first->getPriority();
+  });
+  std::unordered_set<int> pendingPriorities;
+  for (const auto& move : moves) {
+    pendingPriorities.insert(move.first->getPriority());
+  }
+  for (auto& move : moves) {
+    pendingPriorities.erase(move.first->getPriority());
+    if (pendingPriorities.count(move.second->getPriority())) {
+      // Acls were reordered, e.g. swapped. Fall back to remove and re-add.
+      removed.push_back(std::move(move.first));
+      added.push_back(std::move(move.second));
+    } else {
+      moved.push_back(std::move(move));
+    }
+  }
+}
+
 FBOSS_INSTANTIATE_NODE_MAP(AclMap, AclMapTraits);
 FBOSS_INSTANTIATE_NODE_MAP(PrioAclMap, PrioAclMapTraits);
 
@@ -120,4 +120,22 @@ using AclMapDelta = NodeMapDelta<
     DeltaValue<PrioAclMap::Node>,
     MapUniquePointerTraits<PrioAclMap>>;
 
+/*
+ * AclMapDelta, being keyed by priority, shows an acl whose priority changed
+ * as removed at its old priority and added at its new one. OrderedAclChanges
+ * pairs those up by name, so that hardware can move acls whose priority alone
+ * changed instead of removing and re-adding them. Changes are to be applied
+ * in order: removed, then moved, then added. Moves are ordered so that a
+ * moving acl never lands on a priority still held by another acl, and never
+ * overtakes an acl it must stay behind.
+ */
+struct OrderedAclChanges {
+  explicit OrderedAclChanges(const AclMapDelta& delta);
+
+  std::vector<std::shared_ptr<AclEntry>> removed;
+  std::vector<std::pair<std::shared_ptr<AclEntry>, std::shared_ptr<AclEntry>>>
+      moved;
+  std::vector<std::shared_ptr<AclEntry>> added;
+};
+
 } // namespace facebook::fboss
@@ -9,6 +9,7 @@
  */
 #pragma once
 
+#include <chrono>
 #include <memory>
 
 #include <folly/FBString.h>
@@ -65,6 +66,10 @@ class StateUpdate {
    * changes to the state.  (This may occur in cases where the update would
    * have caused changes when it was first scheduled, but no longer results in
    * changes by the time it is actually applied.)
+   *
+   * With pipelined state updates, applyUpdate() may be called a second time
+   * with a different origState, if an update ahead of it failed to apply to
+   * HW after this update had already been computed on top of it.
    */
   virtual std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& origState) = 0;
@@ -101,6 +106,8 @@ class StateUpdate {
 
   // An intrusive list hook for maintaining the list of pending updates.
   folly::IntrusiveListHook listHook_;
+  // When SwSwitch queued the update, to trace how long it waited
+  std::chrono::steady_clock::time_point queuedTime_;
   // The SwSwitch code needs access to our listHook_ member so it can maintain
   // the update list.
   friend class SwSwitch;
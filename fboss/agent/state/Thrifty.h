@@ -2,8 +2,10 @@
 
 #include <folly/dynamic.h>
 #include <folly/json.h>
+#include <thrift/lib/cpp2/folly_dynamic/folly_dynamic.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
+#include "fboss/agent/gen-cpp2/switch_state_fatal_types.h"
 #include "fboss/agent/state/NodeBase.h"
 
 namespace facebook::fboss {
@@ -13,6 +15,10 @@ namespace facebook::fboss {
 // object to/from JSON using Thrift serializers. For this to work
 // one must supply Thrift type (ThrifT) that stores FieldsT state.
 //
+// folly::dynamic is converted to/from thrift directly, using thrift
+// reflection, in the same format as the SimpleJSON protocol. This avoids
+// serializing to a JSON string and parsing it back.
+//
 // TODO: in future, FieldsT and ThrifT should be one type
 //
 template <typename ThriftT, typename NodeT, typename FieldsT>
@@ -21,8 +27,12 @@ class ThriftyBaseT : public NodeBaseT<NodeT, FieldsT> {
   using NodeBaseT<NodeT, FieldsT>::NodeBaseT;
 
   static std::shared_ptr<NodeT> fromFollyDynamic(folly::dynamic const& dyn) {
-    auto const jsonStr = folly::toJson(dyn);
-    return fromJson(jsonStr);
+    auto obj = apache::thrift::from_dynamic<ThriftT>(
+        dyn,
+        apache::thrift::dynamic_format::JSON_1,
+        apache::thrift::format_adherence::LENIENT);
+    auto fields = FieldsT::fromThrift(obj);
+    return std::make_shared<NodeT>(fields);
   }
 
   static std::shared_ptr<NodeT> fromJson(const folly::fbstring& jsonStr) {
@@ -42,7 +52,9 @@ class ThriftyBaseT : public NodeBaseT<NodeT, FieldsT> {
   }
 
   folly::dynamic toFollyDynamic() const override {
-    return folly::parseJson(this->str());
+    auto obj = this->getFields()->toThrift();
+    return apache::thrift::to_dynamic(
+        obj, apache::thrift::dynamic_format::JSON_1);
   }
 };
 
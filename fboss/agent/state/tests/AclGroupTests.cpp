@@ -30,6 +30,16 @@ using std::shared_ptr;
 DECLARE_bool(enable_acl_table_group);
 
 const int kAclStartPriority = 100000;
+const int kAclPriorityGap = 16;
+
+namespace {
+// Priority ThriftConfigApplier allocates the next acl of a table
+int nextPriority(int* priority) {
+  auto allocated = *priority;
+  *priority += kAclPriorityGap;
+  return allocated;
+}
+} // namespace
 
 const std::string kDscp1 = "dscp1";
 const std::string kDscp2 = "dscp2";
@@ -286,9 +296,9 @@ TEST(AclGroup, ApplyConfigColdbootMultipleAclTable) {
   auto stateEmpty = make_shared<SwitchState>();
 
   // Config contains single acl table
-  auto entry1a = make_shared<AclEntry>(priority1++, kAcl1a);
+  auto entry1a = make_shared<AclEntry>(nextPriority(&priority1), kAcl1a);
   entry1a->setActionType(cfg::AclActionType::DENY);
-  auto entry1b = make_shared<AclEntry>(priority1++, kAcl1b);
+  auto entry1b = make_shared<AclEntry>(nextPriority(&priority1), kAcl1b);
   entry1b->setAclAction(MatchAction());
   auto map1 = std::make_shared<AclMap>();
   map1->addEntry(entry1a);
@@ -376,9 +386,9 @@ TEST(AclGroup, ApplyConfigWarmbootMultipleAclTable) {
   auto platform = createMockPlatform();
 
   // State unchanged
-  auto entry1a = make_shared<AclEntry>(priority1++, kAcl1a);
+  auto entry1a = make_shared<AclEntry>(nextPriority(&priority1), kAcl1a);
   entry1a->setActionType(cfg::AclActionType::DENY);
-  auto entry1b = make_shared<AclEntry>(priority1++, kAcl1b);
+  auto entry1b = make_shared<AclEntry>(nextPriority(&priority1), kAcl1b);
   entry1b->setActionType(cfg::AclActionType::DENY);
   auto map1 = std::make_shared<AclMap>();
   map1->addEntry(entry1a);
@@ -386,7 +396,7 @@ TEST(AclGroup, ApplyConfigWarmbootMultipleAclTable) {
   auto table1 = std::make_shared<AclTable>(1, kTable1);
   table1->setAclMap(map1);
 
-  auto entry2a = make_shared<AclEntry>(priority2++, kAcl2a);
+  auto entry2a = make_shared<AclEntry>(nextPriority(&priority2), kAcl2a);
   entry2a->setActionType(cfg::AclActionType::DENY);
   auto map2 = std::make_shared<AclMap>();
   map2->addEntry(entry2a);
@@ -444,7 +454,7 @@ TEST(AclGroup, ApplyConfigWarmbootMultipleAclTable) {
   EXPECT_NE(nullptr, stateV2);
   EXPECT_NE(*(stateV2->getAclTableGroup()), *tableGroup);
 
-  auto entry3a = make_shared<AclEntry>(priority3++, kAcl3a);
+  auto entry3a = make_shared<AclEntry>(nextPriority(&priority3), kAcl3a);
   entry3a->setActionType(cfg::AclActionType::DENY);
   auto map3 = std::make_shared<AclMap>();
   map3->addEntry(entry3a);
@@ -491,7 +501,7 @@ TEST(AclGroup, ApplyConfigWarmbootMultipleAclTable) {
   EXPECT_NE(nullptr, stateV5);
   EXPECT_NE(*(stateV5->getAclTableGroup()), *tableGroup);
 
-  auto entry2b = make_shared<AclEntry>(priority2++, kAcl2b);
+  auto entry2b = make_shared<AclEntry>(nextPriority(&priority2), kAcl2b);
   entry2b->setActionType(cfg::AclActionType::DENY);
   tableGroup->getAclTableMap()
       ->getTable(table2->getID())
@@ -32,6 +32,8 @@ DECLARE_bool(enable_acl_table_group);
 namespace {
 // We offset the start point in ApplyThriftConfig
 constexpr auto kAclStartPriority = 100000;
+// and space acls apart
+constexpr auto kAclPriorityGap = 16;
 } // namespace
 
 TEST(Acl, applyConfig) {
@@ -422,10 +424,18 @@ TEST(Acl, AclGeneration) {
   EXPECT_NE(acls->getEntryIf("acl5"), nullptr);
 
   EXPECT_EQ(acls->getEntryIf("acl1")->getPriority(), kAclStartPriority);
-  EXPECT_EQ(acls->getEntryIf("acl4")->getPriority(), kAclStartPriority + 1);
-  EXPECT_EQ(acls->getEntryIf("acl2")->getPriority(), kAclStartPriority + 2);
-  EXPECT_EQ(acls->getEntryIf("acl3")->getPriority(), kAclStartPriority + 3);
-  EXPECT_EQ(acls->getEntryIf("acl5")->getPriority(), kAclStartPriority + 4);
+  EXPECT_EQ(
+      acls->getEntryIf("acl4")->getPriority(),
+      kAclStartPriority + 1 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl2")->getPriority(),
+      kAclStartPriority + 2 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl3")->getPriority(),
+      kAclStartPriority + 3 * kAclPriorityGap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl5")->getPriority(),
+      kAclStartPriority + 4 * kAclPriorityGap);
 
   // Ensure that the global actions in global traffic policy has been added to
   // the ACL entries
@@ -845,3 +855,93 @@ TEST(Acl, TrafficCounterCompatibility) {
   EXPECT_EQ(
       aclAction.getTrafficCounter()->types_ref()[0], cfg::CounterType::PACKETS);
 }
+
+TEST(Acl, InsertAclKeepsPriorities) {
+  FLAGS_enable_acl_table_group = false;
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  cfg::SwitchConfig config;
+  config.acls_ref()->resize(100);
+  for (int i = 0; i < 100; ++i) {
+    *config.acls_ref()[i].name_ref() = folly::to<std::string>("acl", i);
+    *config.acls_ref()[i].actionType_ref() = cfg::AclActionType::DENY;
+    config.acls_ref()[i].l4DstPort_ref() = i + 1;
+  }
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+
+  // Insert at the top and in the middle
+  for (auto pos : {0, 50}) {
+    cfg::AclEntry acl;
+    *acl.name_ref() = folly::to<std::string>("inserted", pos);
+    *acl.actionType_ref() = cfg::AclActionType::DENY;
+    acl.l4SrcPort_ref() = pos + 1;
+    config.acls_ref()->insert(config.acls_ref()->begin() + pos, acl);
+  }
+  auto stateV2 = publishAndApplyConfig(stateV1, &config, platform.get());
+  ASSERT_NE(nullptr, stateV2);
+
+  int lastPriority = 0;
+  for (const auto& aclCfg : *config.acls_ref()) {
+    auto acl = stateV2->getAcl(*aclCfg.name_ref());
+    ASSERT_NE(nullptr, acl);
+    EXPECT_LT(lastPriority, acl->getPriority());
+    lastPriority = acl->getPriority();
+    if (auto oldAcl = stateV1->getAcl(*aclCfg.name_ref())) {
+      EXPECT_EQ(oldAcl, acl);
+    }
+  }
+
+  OrderedAclChanges changes(StateDelta(stateV1, stateV2).getAclsDelta());
+  EXPECT_TRUE(changes.removed.empty());
+  EXPECT_TRUE(changes.moved.empty());
+  EXPECT_EQ(2, changes.added.size());
+}
+
+TEST(Acl, OrderedAclChanges) {
+  auto makeAcl = [](const std::string& name, int priority) {
+    auto acl = make_shared<AclEntry>(priority, name);
+    acl->setActionType(cfg::AclActionType::DENY);
+    return acl;
+  };
+  auto stateV0 = make_shared<SwitchState>();
+  for (const auto& [name, priority] : std::vector<std::pair<std::string, int>>{
+           {"a", 10}, {"b", 11}, {"c", 12}, {"d", 13}, {"e", 20}}) {
+    stateV0->addAcl(makeAcl(name, priority));
+  }
+  stateV0->publish();
+
+  // Insert x after a, shifting b, c down by one. Replace d, remove e.
+  auto stateV1 = stateV0->clone();
+  auto acls = stateV1->getAcls()->modify(&stateV1);
+  acls->addEntry(makeAcl("x", 9));
+  acls->removeEntry("a");
+  acls->addEntry(makeAcl("a", 8));
+  for (const auto& [name, priority] :
+       std::vector<std::pair<std::string, int>>{{"b", 12}, {"c", 13}}) {
+    acls->removeEntry(name);
+    acls->addEntry(makeAcl(name, priority));
+  }
+  acls->removeEntry("d");
+  auto d = makeAcl("d", 14);
+  d->setProto(6);
+  acls->addEntry(d);
+  acls->removeEntry("e");
+
+  OrderedAclChanges changes(StateDelta(stateV0, stateV1).getAclsDelta());
+  std::vector<std::string> removed, moved, added;
+  for (const auto& acl : changes.removed) {
+    removed.push_back(acl->getID());
+  }
+  for (const auto& [oldAcl, newAcl] : changes.moved) {
+    moved.push_back(oldAcl->getID());
+  }
+  for (const auto& acl : changes.added) {
+    added.push_back(acl->getID());
+  }
+  EXPECT_EQ(removed, std::vector<std::string>({"d", "e"}));
+  // Moving down, furthest along first so that no priority is ever shared
+  EXPECT_EQ(moved, std::vector<std::string>({"c", "b", "a"}));
+  EXPECT_EQ(added, std::vector<std::string>({"x", "d"}));
+}
@@ -365,6 +365,11 @@ TEST(Port, ToFromJSON) {
   auto dyn2 = folly::parseJson(jsonStr);
 
   EXPECT_EQ(dyn1, dyn2);
+
+  // Converting from folly::dynamic gives the same port as parsing the JSON
+  auto port2 = Port::fromFollyDynamic(dyn2);
+  EXPECT_EQ(port->str(), port2->str());
+  EXPECT_EQ(dyn1, port2->toFollyDynamic());
 }
 
 TEST(Port, ToFromJSONMissingMaxFrameSize) {
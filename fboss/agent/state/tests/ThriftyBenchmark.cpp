@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+
+#include "fboss/agent/state/BufferPoolConfig.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortPgConfig.h"
+#include "fboss/agent/state/PortQueue.h"
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kNumQueues = 8;
+constexpr int kNumPgs = 8;
+
+std::shared_ptr<BufferPoolCfg> makeBufferPoolCfg() {
+  auto cfg = std::make_shared<BufferPoolCfg>("bufferPool");
+  cfg->setSharedBytes(78773528);
+  cfg->setHeadroomBytes(4405376);
+  return cfg;
+}
+
+std::shared_ptr<PortQueue> makePortQueue(int id) {
+  auto queue = std::make_shared<PortQueue>(static_cast<uint8_t>(id));
+  queue->setName(folly::to<std::string>("queue", id));
+  queue->setStreamType(cfg::StreamType::UNICAST);
+  queue->setScheduling(cfg::QueueScheduling::WEIGHTED_ROUND_ROBIN);
+  queue->setWeight(id + 1);
+  queue->setReservedBytes(3328);
+  queue->setScalingFactor(cfg::MMUScalingFactor::ONE);
+  return queue;
+}
+
+std::shared_ptr<PortPgConfig> makePortPgConfig(int id) {
+  auto pg = std::make_shared<PortPgConfig>(static_cast<uint8_t>(id));
+  pg->setName(folly::to<std::string>("pg", id));
+  pg->setMinLimitBytes(2000);
+  pg->setHeadroomLimitBytes(2000);
+  pg->setResumeOffsetBytes(1800);
+  pg->setScalingFactor(cfg::MMUScalingFactor::ONE);
+  pg->setBufferPoolName("bufferPool");
+  return pg;
+}
+
+std::shared_ptr<Port> makePort() {
+  auto port = std::make_shared<Port>(PortID(1), "eth1/1/1");
+  port->setDescription("benchmark port");
+  Port::VlanMembership vlans;
+  vlans.emplace(VlanID(2000), Port::VlanInfo(false));
+  port->setVlans(vlans);
+  QueueConfig queues;
+  for (int i = 0; i < kNumQueues; ++i) {
+    queues.push_back(makePortQueue(i));
+  }
+  port->resetPortQueues(queues);
+  std::optional<PortPgConfigs> pgs = PortPgConfigs{};
+  for (int i = 0; i < kNumPgs; ++i) {
+    pgs->push_back(makePortPgConfig(i));
+  }
+  port->resetPgConfigs(pgs);
+  return port;
+}
+
+// Conversions through a JSON string, as ThriftyBaseT used to do them
+template <typename MakeNodeFn>
+void toFollyDynamicViaJson(unsigned int iters, MakeNodeFn makeNode) {
+  decltype(makeNode()) node;
+  BENCHMARK_SUSPEND {
+    node = makeNode();
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(folly::parseJson(node->str()));
+  }
+}
+
+template <typename MakeNodeFn>
+void fromFollyDynamicViaJson(unsigned int iters, MakeNodeFn makeNode) {
+  using NodeT = typename decltype(makeNode())::element_type;
+  folly::dynamic dyn;
+  BENCHMARK_SUSPEND {
+    dyn = makeNode()->toFollyDynamic();
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(NodeT::fromJson(folly::toJson(dyn)));
+  }
+}
+
+template <typename MakeNodeFn>
+void toFollyDynamic(unsigned int iters, MakeNodeFn makeNode) {
+  decltype(makeNode()) node;
+  BENCHMARK_SUSPEND {
+    node = makeNode();
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(node->toFollyDynamic());
+  }
+}
+
+template <typename MakeNodeFn>
+void fromFollyDynamic(unsigned int iters, MakeNodeFn makeNode) {
+  using NodeT = typename decltype(makeNode())::element_type;
+  folly::dynamic dyn;
+  BENCHMARK_SUSPEND {
+    dyn = makeNode()->toFollyDynamic();
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(NodeT::fromFollyDynamic(dyn));
+  }
+}
+
+} // namespace
+
+#define THRIFTY_BENCHMARKS(name, makeNode)                  \
+  BENCHMARK(name##ToFollyDynamicViaJson, iters) {           \
+    toFollyDynamicViaJson(iters, makeNode);                 \
+  }                                                         \
+  BENCHMARK_RELATIVE(name##ToFollyDynamic, iters) {         \
+    toFollyDynamic(iters, makeNode);                        \
+  }                                                         \
+  BENCHMARK(name##FromFollyDynamicViaJson, iters) {         \
+    fromFollyDynamicViaJson(iters, makeNode);               \
+  }                                                         \
+  BENCHMARK_RELATIVE(name##FromFollyDynamic, iters) {       \
+    fromFollyDynamic(iters, makeNode);                      \
+  }                                                         \
+  BENCHMARK_DRAW_LINE();
+
+THRIFTY_BENCHMARKS(BufferPoolCfg, makeBufferPoolCfg)
+THRIFTY_BENCHMARKS(PortQueue, [] { return makePortQueue(0); })
+THRIFTY_BENCHMARKS(PortPgConfig, [] { return makePortPgConfig(0); })
+THRIFTY_BENCHMARKS(Port, makePort)
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+#include "fboss/agent/FbossError.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr int kMinPriority = 1000;
+constexpr int kMaxPriority = 100000;
+constexpr int kStartPriority = 10000;
+constexpr int kGap = 16;
+
+using ExistingPriorities = std::vector<std::optional<int>>;
+
+AclPriorityAllocator allocator() {
+  return AclPriorityAllocator(kMinPriority, kMaxPriority, kStartPriority, kGap);
+}
+
+int numMoved(const ExistingPriorities& existing, const std::vector<int>& got) {
+  int moved = 0;
+  for (size_t i = 0; i < existing.size(); ++i) {
+    moved += existing[i] && *existing[i] != got[i];
+  }
+  return moved;
+}
+
+void checkIncreasing(const std::vector<int>& priorities) {
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    EXPECT_GE(priorities[i], kMinPriority);
+    EXPECT_LE(priorities[i], kMaxPriority);
+    if (i > 0) {
+      EXPECT_LT(priorities[i - 1], priorities[i]);
+    }
+  }
+}
+} // namespace
+
+TEST(AclPriorityAllocator, freshAllocationIsGapped) {
+  auto priorities = allocator().allocate(ExistingPriorities(3));
+  EXPECT_EQ(
+      priorities,
+      std::vector<int>(
+          {kStartPriority, kStartPriority + kGap, kStartPriority + 2 * kGap}));
+}
+
+TEST(AclPriorityAllocator, insertAtTopKeepsExisting) {
+  auto priorities = allocator().allocate(ExistingPriorities(2000));
+  ExistingPriorities existing(priorities.begin(), priorities.end());
+  existing.insert(existing.begin(), std::nullopt);
+  auto newPriorities = allocator().allocate(existing);
+  checkIncreasing(newPriorities);
+  EXPECT_EQ(0, numMoved(existing, newPriorities));
+  EXPECT_EQ(kStartPriority - kGap, newPriorities[0]);
+}
+
+TEST(AclPriorityAllocator, insertBetweenSplitsGap) {
+  ExistingPriorities existing{
+      kStartPriority, std::nullopt, kStartPriority + 2 * kGap};
+  auto priorities = allocator().allocate(existing);
+  EXPECT_EQ(
+      priorities,
+      std::vector<int>(
+          {kStartPriority, kStartPriority + kGap, kStartPriority + 2 * kGap}));
+}
+
+TEST(AclPriorityAllocator, exhaustedGapRenumbersLocally) {
+  // Packed priorities, as allocated before gaps were introduced
+  ExistingPriorities existing;
+  for (int i = 0; i < 10; ++i) {
+    existing.push_back(kStartPriority + i);
+  }
+  existing.insert(existing.begin() + 8, std::nullopt);
+  auto priorities = allocator().allocate(existing);
+  checkIncreasing(priorities);
+  // Only the acls behind the insertion point move
+  EXPECT_EQ(2, numMoved(existing, priorities));
+}
+
+TEST(AclPriorityAllocator, reorderMovesFewest) {
+  ExistingPriorities existing{
+      kStartPriority, kStartPriority + 32, kStartPriority + 16};
+  auto priorities = allocator().allocate(existing);
+  checkIncreasing(priorities);
+  EXPECT_EQ(1, numMoved(existing, priorities));
+}
+
+TEST(AclPriorityAllocator, outOfRangeExistingIgnored) {
+  ExistingPriorities existing{kMinPriority - 1, kMaxPriority + 1};
+  auto priorities = allocator().allocate(existing);
+  EXPECT_EQ(
+      priorities, std::vector<int>({kStartPriority, kStartPriority + kGap}));
+}
+
+TEST(AclPriorityAllocator, gapShrinksToFitRange) {
+  AclPriorityAllocator tight(1, 10, 5, kGap);
+  auto priorities = tight.allocate(ExistingPriorities(10));
+  EXPECT_EQ(priorities, std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+  EXPECT_THROW(tight.allocate(ExistingPriorities(11)), FbossError);
+}
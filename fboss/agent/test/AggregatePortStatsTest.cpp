@@ -204,3 +204,46 @@ TEST(AggregatePortStats, UpdateAggregatePortName) {
   EXPECT_FALSE(counters.checkExist(initialFlapsCounterName));
   EXPECT_TRUE(counters.checkExist(updatedFlapsCounterName));
 }
+
+TEST(LinkAggregationManager, NonMemberDoesNotBlockOtherMembers) {
+  const AggregatePortID aggregatePortID = AggregatePortID(1);
+  AggregatePort::PartnerState pState{};
+
+  auto config = createConfig(aggregatePortID, "Port-Channel1");
+  auto handle = createTestHandle(&config);
+  auto sw = handle->getSw();
+  LinkAggregationManager lagManager(sw);
+
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([&]() {
+    // Programmed right away, so the other two are programmed together
+    lagManager.disableForwardingAndSetPartnerState(
+        PortID(1), aggregatePortID, pState);
+    // Port 3 is not a member, so programming it throws
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(3), aggregatePortID, pState);
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(2), aggregatePortID, pState);
+  });
+  waitForStateUpdates(sw);
+  // The second batch is scheduled from the LACP EventBase
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([]() {});
+  waitForStateUpdates(sw);
+
+  auto aggPort = getAggregatePort(sw, aggregatePortID);
+  EXPECT_EQ(
+      AggregatePort::Forwarding::DISABLED,
+      aggPort->getForwardingState(PortID(1)));
+  EXPECT_EQ(
+      AggregatePort::Forwarding::ENABLED,
+      aggPort->getForwardingState(PortID(2)));
+
+  // Later transitions still get programmed
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([&]() {
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(1), aggregatePortID, pState);
+  });
+  waitForStateUpdates(sw);
+  EXPECT_EQ(
+      AggregatePort::Forwarding::ENABLED,
+      getAggregatePort(sw, aggregatePortID)->getForwardingState(PortID(1)));
+}
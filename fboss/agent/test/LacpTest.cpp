@@ -1288,3 +1288,108 @@ TEST_F(LacpTest, lacpDownCounters) {
   // both members should timeout
   counters.checkDelta(SwitchStats::kCounterPrefix + "lacp.rx_timeout.sum", 2);
 }
+
+namespace {
+cfg::SwitchConfig twoMemberLagConfig() {
+  cfg::SwitchConfig config;
+  config.ports_ref()->resize(2);
+  config.vlanPorts_ref()->resize(2);
+  for (int i = 0; i < 2; ++i) {
+    *config.ports_ref()[i].logicalID_ref() = i + 1;
+    *config.ports_ref()[i].state_ref() = cfg::PortState::ENABLED;
+    *config.vlanPorts_ref()[i].logicalPort_ref() = i + 1;
+    *config.vlanPorts_ref()[i].vlanID_ref() = 1;
+  }
+  config.vlans_ref()->resize(1);
+  *config.vlans_ref()[0].id_ref() = 1;
+  *config.vlans_ref()[0].name_ref() = "vlan1";
+
+  config.aggregatePorts_ref()->resize(1);
+  *config.aggregatePorts_ref()[0].key_ref() = 1;
+  *config.aggregatePorts_ref()[0].name_ref() = "Port-Channel1";
+  config.aggregatePorts_ref()[0].memberPorts_ref()->resize(2);
+  *config.aggregatePorts_ref()[0].memberPorts_ref()[0].memberPortID_ref() = 1;
+  *config.aggregatePorts_ref()[0].memberPorts_ref()[1].memberPortID_ref() = 2;
+  return config;
+}
+
+AggregatePort::Forwarding getForwardingState(SwSwitch* sw, PortID portID) {
+  return sw->getState()
+      ->getAggregatePorts()
+      ->getAggregatePort(AggregatePortID(1))
+      ->getForwardingState(portID);
+}
+
+std::string stateUpdateLatencyCount() {
+  return SwitchStats::kCounterPrefix + "lacp.state_update_latency.ms.count";
+}
+} // namespace
+
+TEST_F(LacpTest, memberTransitionProgrammedRightAway) {
+  auto config = twoMemberLagConfig();
+  auto handle = createTestHandle(&config);
+  auto sw = handle->getSw();
+  // No LACP controllers are created for the existing LAG, so the test is
+  // the only source of member transitions
+  LinkAggregationManager lagManager(sw);
+  CounterCache counters(sw);
+
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([&lagManager]() {
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), ParticipantInfo());
+  });
+  // Queued as soon as the transition happens, rather than after a delay
+  waitForStateUpdates(sw);
+  EXPECT_EQ(
+      getForwardingState(sw, PortID(1)), AggregatePort::Forwarding::ENABLED);
+
+  counters.update();
+  counters.checkDelta(stateUpdateLatencyCount(), 1);
+}
+
+TEST_F(LacpTest, memberTransitionsCoalescedWhileUpdateInFlight) {
+  auto config = twoMemberLagConfig();
+  auto handle = createTestHandle(&config);
+  auto sw = handle->getSw();
+  LinkAggregationManager lagManager(sw);
+  CounterCache counters(sw);
+
+  // Hold up the update thread, so the first transition's update stays in
+  // flight while the others happen
+  folly::Baton<> unblockUpdates;
+  sw->updateState(
+      "Block state updates",
+      [&unblockUpdates](const std::shared_ptr<SwitchState>& /* unused */) {
+        unblockUpdates.wait();
+        return std::shared_ptr<SwitchState>();
+      });
+  EXPECT_HW_CALL(sw, stateChanged(testing::_)).Times(2);
+
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([&lagManager]() {
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), ParticipantInfo());
+    lagManager.disableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), ParticipantInfo());
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(2), AggregatePortID(1), ParticipantInfo());
+    lagManager.enableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), ParticipantInfo());
+    lagManager.disableForwardingAndSetPartnerState(
+        PortID(1), AggregatePortID(1), ParticipantInfo());
+  });
+  unblockUpdates.post();
+
+  // The first update schedules the coalesced one once it is applied
+  waitForStateUpdates(sw);
+  sw->getLacpEvb()->runInEventBaseThreadAndWait([]() {});
+  waitForStateUpdates(sw);
+
+  EXPECT_EQ(
+      getForwardingState(sw, PortID(1)), AggregatePort::Forwarding::DISABLED);
+  EXPECT_EQ(
+      getForwardingState(sw, PortID(2)), AggregatePort::Forwarding::ENABLED);
+  // One sample for the first update, and one per member for the second,
+  // where the last transition of port 1 superseded the earlier ones
+  counters.update();
+  counters.checkDelta(stateUpdateLatencyCount(), 3);
+}
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/LockPolicy.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+// Take the lock through a PriorityLockGuard on another thread, and return
+// once it is waiting for it
+std::thread startPriorityLocker(
+    std::mutex& mutex,
+    PriorityLockWaiters& waiters,
+    const FineGrainedLockPolicy& lockPolicy,
+    std::vector<std::string>& events) {
+  std::thread locker([&]() {
+    PriorityLockGuard lock(mutex, waiters);
+    events.push_back("priority");
+  });
+  while (!lockPolicy.shouldYield()) {
+    std::this_thread::yield();
+  }
+  return locker;
+}
+
+} // namespace
+
+TEST(LockPolicyTest, priorityLockerGetsInBetweenChunks) {
+  std::mutex mutex;
+  PriorityLockWaiters waiters;
+  FineGrainedLockPolicy lockPolicy(mutex, &waiters);
+  // Only touched with mutex held
+  std::vector<std::string> events;
+  std::thread locker;
+  {
+    auto lock = lockPolicy.lockChunk();
+    events.push_back("chunk1");
+    locker = startPriorityLocker(mutex, waiters, lockPolicy, events);
+  }
+  {
+    auto lock = lockPolicy.lockChunk();
+    events.push_back("chunk2");
+  }
+  locker.join();
+  EXPECT_FALSE(lockPolicy.shouldYield());
+  EXPECT_EQ(
+      events, (std::vector<std::string>{"chunk1", "priority", "chunk2"}));
+}
+
+TEST(LockPolicyTest, chunkEndsEarlyForPriorityLocker) {
+  std::mutex mutex;
+  PriorityLockWaiters waiters;
+  FineGrainedLockPolicy lockPolicy(mutex, &waiters);
+  std::vector<std::string> events;
+  std::thread locker;
+  // Same loop as SaiSwitch::walkDelta, with chunks of 10 objects
+  constexpr int kNumObjects = 30;
+  constexpr int kChunkSize = 10;
+  int i = 0;
+  while (i < kNumObjects) {
+    auto lock = lockPolicy.lockChunk();
+    auto chunkEnd = std::min(kNumObjects, i + kChunkSize);
+    do {
+      events.push_back(std::to_string(i));
+      if (i == 13) {
+        locker = startPriorityLocker(mutex, waiters, lockPolicy, events);
+      }
+      ++i;
+    } while (i < chunkEnd && !lockPolicy.shouldYield());
+  }
+  locker.join();
+  ASSERT_EQ(events.size(), kNumObjects + 1);
+  // The second chunk ended after the object during which the locker came
+  EXPECT_EQ(events[14], "priority");
+  EXPECT_EQ(events[15], "14");
+}
+
+TEST(LockPolicyTest, noPriorityWaiters) {
+  std::mutex mutex;
+  FineGrainedLockPolicy lockPolicy(mutex);
+  EXPECT_FALSE(lockPolicy.shouldYield());
+  {
+    auto lock = lockPolicy.lockChunk();
+    EXPECT_TRUE(lock.owns_lock());
+  }
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
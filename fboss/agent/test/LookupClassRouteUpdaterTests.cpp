@@ -110,6 +110,15 @@ class LookupClassRouteUpdaterTest : public ::testing::Test {
     }
   }
 
+  // In the subnet of the interface of Vlan55
+  AddrT kIpAddressD() {
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      return IPAddressV4("10.0.55.2");
+    } else {
+      return IPAddressV6("2401:db00:2110:3055::0002");
+    }
+  }
+
   AddrT kIpAddressC() {
     if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
       return IPAddressV4("10.0.0.4");
@@ -235,14 +244,19 @@ class LookupClassRouteUpdaterTest : public ::testing::Test {
     waitForStateUpdates(this->sw_);
   }
 
+  // Update the lookupClasses of all the ports, or only of those in vlanID
   void updateLookupClasses(
-      const std::vector<cfg::AclLookupClass>& lookupClasses) {
+      const std::vector<cfg::AclLookupClass>& lookupClasses,
+      std::optional<VlanID> vlanID = std::nullopt) {
     this->updateState(
         "Remove lookupclasses", [=](const std::shared_ptr<SwitchState>& state) {
           auto newState = state->clone();
           auto newPortMap = newState->getPorts()->modify(&newState);
 
           for (auto port : *newPortMap) {
+            if (vlanID && !port->getVlans().count(*vlanID)) {
+              continue;
+            }
             auto newPort = port->clone();
             newPort->setLookupClassesToDistributeTrafficOn(lookupClasses);
             newPortMap->updatePort(newPort);
@@ -583,6 +597,96 @@ TYPED_TEST(LookupClassRouteUpdaterTest, PortLookupClassesChange) {
       this->kroutePrefix1(), cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3);
 }
 
+TYPED_TEST(LookupClassRouteUpdaterTest, ReAddOnlyRoutesInVlanWithNewSubnets) {
+  const std::vector<cfg::AclLookupClass> kLookupClasses = {
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0,
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_1,
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_2,
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_3,
+      cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_4};
+  auto updater = this->sw_->getLookupClassRouteUpdater();
+  // Interface routes are indexed too, so only look for the test's routes
+  auto isIndexed = [&](VlanID vlanID, RoutePrefix<TypeParam> routePrefix) {
+    bool indexed = false;
+    this->verifyStateUpdate([&]() {
+      indexed = updater->getIndexedPrefixes(vlanID).count(std::make_pair(
+          this->kRid(),
+          folly::CIDRNetwork{
+              folly::IPAddress(routePrefix.network), routePrefix.mask}));
+    });
+    return indexed;
+  };
+  auto numIndexed = [&](VlanID vlanID) {
+    size_t numPrefixes = 0;
+    this->verifyStateUpdate([&]() {
+      numPrefixes = updater->getIndexedPrefixes(vlanID).size();
+    });
+    return numPrefixes;
+  };
+  // Toggle the lookupClasses of the ports in vlan1, dropping and then adding
+  // back its subnets while vlan55 keeps its own. Returns the number of routes
+  // re-added for the new subnets.
+  auto toggleVlan1LookupClasses = [&]() {
+    uint64_t numReAddedBefore = 0;
+    this->verifyStateUpdate(
+        [&]() { numReAddedBefore = updater->getNumRoutesReAdded(); });
+    this->updateLookupClasses({}, this->kVlan());
+    this->updateLookupClasses(kLookupClasses, this->kVlan());
+    uint64_t numReAdded = 0;
+    this->verifyStateUpdate([&]() {
+      EXPECT_TRUE(updater->isRouteIndexValid());
+      numReAdded = updater->getNumRoutesReAdded() - numReAddedBefore;
+    });
+    return numReAdded;
+  };
+
+  // Caching subnets from none builds the index from a walk of all the
+  // routes, after which it is kept up to date
+  this->updateLookupClasses({});
+  this->updateLookupClasses(kLookupClasses);
+  this->verifyStateUpdate([&]() { EXPECT_TRUE(updater->isRouteIndexValid()); });
+
+  this->addRoute(this->kroutePrefix1(), {this->kIpAddressA()});
+  this->addRoute(this->kroutePrefix2(), {this->kIpAddressD()});
+  this->resolveNeighbor(this->kIpAddressA(), this->kMacAddressA());
+  this->verifyClassIDHelper(
+      this->kroutePrefix1(), cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+
+  // Routes are indexed as they are added, by the vlans of their nexthops
+  EXPECT_TRUE(isIndexed(this->kVlan(), this->kroutePrefix1()));
+  EXPECT_FALSE(isIndexed(this->kVlan(), this->kroutePrefix2()));
+  EXPECT_TRUE(isIndexed(VlanID(55), this->kroutePrefix2()));
+  EXPECT_FALSE(isIndexed(VlanID(55), this->kroutePrefix1()));
+  auto numVlan1Routes = numIndexed(this->kVlan());
+  auto numVlan55Routes = numIndexed(VlanID(55));
+
+  // Only the routes with nexthops in vlan1 are re-added
+  EXPECT_EQ(toggleVlan1LookupClasses(), numVlan1Routes);
+  this->verifyClassIDHelper(
+      this->kroutePrefix1(), cfg::AclLookupClass::CLASS_QUEUE_PER_HOST_QUEUE_0);
+  this->verifyClassIDHelper(this->kroutePrefix2(), std::nullopt);
+
+  this->removeRoute(this->kroutePrefix2());
+  EXPECT_FALSE(isIndexed(VlanID(55), this->kroutePrefix2()));
+  EXPECT_EQ(numIndexed(VlanID(55)), numVlan55Routes - 1);
+  EXPECT_TRUE(isIndexed(this->kVlan(), this->kroutePrefix1()));
+
+  // Route updates are not processed without any cached subnet, so the index
+  // is dropped, and rebuilt the next time subnets are cached, along with the
+  // routes added in the meantime
+  this->updateLookupClasses({});
+  this->verifyStateUpdate(
+      [&]() { EXPECT_FALSE(updater->isRouteIndexValid()); });
+  EXPECT_EQ(numIndexed(this->kVlan()), 0);
+  this->addRoute(this->kroutePrefix2(), {this->kIpAddressD()});
+  this->updateLookupClasses(kLookupClasses);
+  this->verifyStateUpdate([&]() { EXPECT_TRUE(updater->isRouteIndexValid()); });
+  EXPECT_TRUE(isIndexed(this->kVlan(), this->kroutePrefix1()));
+  EXPECT_TRUE(isIndexed(VlanID(55), this->kroutePrefix2()));
+  EXPECT_EQ(numIndexed(this->kVlan()), numVlan1Routes);
+  EXPECT_EQ(numIndexed(VlanID(55)), numVlan55Routes);
+}
+
 TYPED_TEST(LookupClassRouteUpdaterTest, CompeteClassIdUpdatesWithRouteUpdates) {
   this->addRoute(this->kroutePrefix1(), {this->kIpAddressA()});
   std::thread classIdUpdates([this]() {
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborCacheScheduler.h"
+
+#include <folly/io/async/EventBase.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+TEST(NeighborCacheSchedulerTest, burstSizing) {
+  folly::EventBase evb;
+  NeighborCacheScheduler fast(&evb, milliseconds(100), 2000);
+  EXPECT_EQ(fast.getBurstSize(), 20);
+  EXPECT_EQ(fast.getBurstInterval(), milliseconds(10));
+
+  NeighborCacheScheduler slow(&evb, milliseconds(100), 50);
+  EXPECT_EQ(slow.getBurstSize(), 1);
+  EXPECT_EQ(slow.getBurstInterval(), milliseconds(20));
+
+  // Interval rounds up so that the max rate is never exceeded
+  NeighborCacheScheduler uneven(&evb, milliseconds(100), 150);
+  EXPECT_EQ(uneven.getBurstSize(), 1);
+  EXPECT_EQ(uneven.getBurstInterval(), milliseconds(7));
+}
+
+TEST(NeighborCacheSchedulerTest, probesArePaced) {
+  folly::EventBase evb;
+  NeighborCacheScheduler scheduler(&evb, milliseconds(100), 1000);
+  ASSERT_EQ(scheduler.getBurstSize(), 10);
+
+  constexpr int kNumProbes = 35;
+  std::vector<size_t> pendingAtSend;
+  for (int i = 0; i < kNumProbes; ++i) {
+    scheduler.scheduleProbe(&scheduler, [&]() {
+      pendingAtSend.push_back(scheduler.getPendingProbes());
+    });
+  }
+  auto start = steady_clock::now();
+  evb.loop();
+  auto elapsed = steady_clock::now() - start;
+
+  ASSERT_EQ(pendingAtSend.size(), kNumProbes);
+  EXPECT_EQ(scheduler.getPendingProbes(), 0);
+  // 4 bursts of at most 10 probes, at least one burst interval apart
+  EXPECT_EQ(pendingAtSend[0], kNumProbes - 1);
+  EXPECT_EQ(pendingAtSend[9], kNumProbes - 10);
+  EXPECT_GE(elapsed, 3 * scheduler.getBurstInterval());
+}
+
+TEST(NeighborCacheSchedulerTest, cancelProbes) {
+  folly::EventBase evb;
+  NeighborCacheScheduler scheduler(&evb, milliseconds(100), 0);
+  int owner1 = 0, owner2 = 0;
+  int sent1 = 0, sent2 = 0;
+  for (int i = 0; i < 5; ++i) {
+    scheduler.scheduleProbe(&owner1, [&]() { ++sent1; });
+    scheduler.scheduleProbe(&owner2, [&]() { ++sent2; });
+  }
+  scheduler.cancelProbes(&owner1);
+  EXPECT_EQ(scheduler.getPendingProbes(), 5);
+  evb.loop();
+  EXPECT_EQ(sent1, 0);
+  EXPECT_EQ(sent2, 5);
+}
+
+TEST(NeighborCacheSchedulerTest, timerWheelFiresCallbacks) {
+  folly::EventBase evb;
+  NeighborCacheScheduler scheduler(&evb, milliseconds(10), 0);
+  struct Callback : public folly::HHWheelTimer::Callback {
+    void timeoutExpired() noexcept override {
+      ++fired;
+    }
+    int fired{0};
+  };
+  std::vector<Callback> callbacks(100);
+  for (auto& callback : callbacks) {
+    scheduler.getTimer()->scheduleTimeout(&callback, milliseconds(20));
+  }
+  evb.loop();
+  for (const auto& callback : callbacks) {
+    EXPECT_EQ(callback.fired, 1);
+  }
+}
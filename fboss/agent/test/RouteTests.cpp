@@ -9,6 +9,7 @@
  */
 #include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/FbossHwUpdateError.h"
 #include "fboss/agent/FibHelpers.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
@@ -22,8 +23,15 @@
 #include "fboss/agent/if/gen-cpp2/common_types.h"
 
 #include <folly/logging/xlog.h>
+#include <folly/synchronization/Baton.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <atomic>
 #include <optional>
+#include <thread>
+
+DECLARE_bool(enable_state_update_pipelining);
+DECLARE_bool(ack_route_updates_on_schedule);
 
 using namespace facebook::fboss;
 using facebook::network::toBinaryAddress;
@@ -32,6 +40,8 @@ using folly::IPAddressV4;
 using folly::IPAddressV6;
 using std::make_shared;
 using std::shared_ptr;
+using ::testing::_;
+using ::testing::Invoke;
 using ::testing::Return;
 
 namespace {
@@ -2135,6 +2145,200 @@ TEST_F(StaticRoutesTest, staticRoutesGetApplied) {
   EXPECT_EQ(9, numV6Routes);
 }
 
+class PipelinedRouteTest : public RouteTest {
+ public:
+  void SetUp() override {
+    FLAGS_enable_state_update_pipelining = true;
+    RouteTest::SetUp();
+  }
+
+  void TearDown() override {
+    handle_.reset();
+    FLAGS_enable_state_update_pipelining = false;
+    FLAGS_ack_route_updates_on_schedule = false;
+  }
+
+  bool ribHasRoute(RouterID rid, const std::string& prefixStr) const {
+    auto prefix = makePrefixV4(prefixStr);
+    auto ribRoute = this->sw_->getRib()->longestMatch(prefix.network, rid);
+    return ribRoute && ribRoute->prefix() == prefix;
+  }
+};
+
+TEST_F(PipelinedRouteTest, routesProgrammedWhenProgramReturns) {
+  auto rid = RouterID(0);
+  auto updater = this->sw_->getRouteUpdater();
+  // Updates of different clients are separate RIB updates, so the FIB
+  // update of the first is programmed while the second is resolved
+  updater.addRoute(
+      rid,
+      IPAddress("10.1.1.1"),
+      24,
+      kClientA,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  updater.addRoute(
+      rid,
+      IPAddress("2001::1"),
+      48,
+      kClientB,
+      RouteNextHopEntry(makeNextHops({"2::2"}), DISTANCE));
+  updater.program();
+
+  auto state = this->sw_->getState();
+  EXPECT_RESOLVED(this->findRoute4(state, rid, "10.1.1.0/24"));
+  EXPECT_RESOLVED(this->findRoute6(state, rid, "2001::0/48"));
+}
+
+TEST_F(PipelinedRouteTest, hwFailureRollsBackRib) {
+  auto rid = RouterID(0);
+  auto origState = this->sw_->getState();
+  EXPECT_HW_CALL(this->sw_, stateChanged(_))
+      .WillOnce(Return(origState))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+
+  auto updater = this->sw_->getRouteUpdater();
+  updater.addRoute(
+      rid,
+      IPAddress("10.1.1.1"),
+      24,
+      kClientA,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  EXPECT_THROW(updater.program(), FbossHwUpdateError);
+
+  auto state = this->sw_->getState();
+  EXPECT_EQ(nullptr, this->findRoute4(state, rid, "10.1.1.0/24"));
+  // The RIB no longer has the route either
+  auto ribRoute =
+      this->sw_->getRib()->longestMatch(IPAddressV4("10.1.1.1"), rid);
+  ASSERT_NE(nullptr, ribRoute);
+  EXPECT_NE(makePrefixV4("10.1.1.0/24"), ribRoute->prefix());
+
+  // And later updates go through
+  auto updater2 = this->sw_->getRouteUpdater();
+  updater2.addRoute(
+      rid,
+      IPAddress("10.1.2.1"),
+      24,
+      kClientA,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  updater2.program();
+  state = this->sw_->getState();
+  EXPECT_RESOLVED(this->findRoute4(state, rid, "10.1.2.0/24"));
+  EXPECT_EQ(nullptr, this->findRoute4(state, rid, "10.1.1.0/24"));
+}
+
+TEST_F(PipelinedRouteTest, hwFailureNotRetriedByOtherClient) {
+  auto rid = RouterID(0);
+  // Fail HW updates adding client A's route, holding the first one until
+  // client B's FIB update is scheduled behind it
+  folly::Baton<> clientAProgramming;
+  folly::Baton<> clientBScheduled;
+  std::atomic<int> clientAAttempts{0};
+  EXPECT_HW_CALL(this->sw_, stateChanged(_))
+      .WillRepeatedly(Invoke([&](const StateDelta& delta) {
+        if (this->findRoute4(delta.newState(), rid, "10.1.1.0/24") &&
+            !this->findRoute4(delta.oldState(), rid, "10.1.1.0/24")) {
+          if (clientAAttempts++ == 0) {
+            clientAProgramming.post();
+            clientBScheduled.wait();
+          }
+          return delta.oldState();
+        }
+        return delta.newState();
+      }));
+
+  std::thread clientA([&] {
+    auto updater = this->sw_->getRouteUpdater();
+    updater.addRoute(
+        rid,
+        IPAddress("10.1.1.1"),
+        24,
+        kClientA,
+        RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+    EXPECT_THROW(updater.program(), FbossHwUpdateError);
+  });
+  clientAProgramming.wait();
+  std::thread clientB([&] {
+    auto updater = this->sw_->getRouteUpdater();
+    updater.addRoute(
+        rid,
+        IPAddress("10.1.2.1"),
+        24,
+        kClientB,
+        RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+    EXPECT_NO_THROW(updater.program());
+  });
+  // The RIB update of client B schedules its FIB update before the RIB
+  // thread moves on
+  while (!ribHasRoute(rid, "10.1.2.0/24")) {
+    std::this_thread::yield();
+  }
+  waitForRibUpdates(this->sw_);
+  clientBScheduled.post();
+  clientA.join();
+  clientB.join();
+
+  // Client B's update did not carry client A's route along
+  EXPECT_EQ(1, clientAAttempts);
+  auto state = this->sw_->getState();
+  EXPECT_EQ(nullptr, this->findRoute4(state, rid, "10.1.1.0/24"));
+  EXPECT_RESOLVED(this->findRoute4(state, rid, "10.1.2.0/24"));
+  EXPECT_FALSE(ribHasRoute(rid, "10.1.1.0/24"));
+  EXPECT_TRUE(ribHasRoute(rid, "10.1.2.0/24"));
+}
+
+TEST_F(PipelinedRouteTest, hwFailureReportedOnNextUpdateOfClient) {
+  FLAGS_ack_route_updates_on_schedule = true;
+  auto rid = RouterID(0);
+  auto origState = this->sw_->getState();
+  EXPECT_HW_CALL(this->sw_, stateChanged(_))
+      .WillOnce(Return(origState))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+
+  auto updater = this->sw_->getRouteUpdater();
+  updater.addRoute(
+      rid,
+      IPAddress("10.1.1.1"),
+      24,
+      kClientA,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  EXPECT_NO_THROW(updater.program());
+  waitForStateUpdates(this->sw_);
+  EXPECT_EQ(
+      nullptr, this->findRoute4(this->sw_->getState(), rid, "10.1.1.0/24"));
+  // The RIB keeps the route until client A is told it failed
+  EXPECT_TRUE(ribHasRoute(rid, "10.1.1.0/24"));
+
+  // Other clients are not told
+  auto updater2 = this->sw_->getRouteUpdater();
+  updater2.addRoute(
+      rid,
+      IPAddress("10.1.2.1"),
+      24,
+      kClientB,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  EXPECT_NO_THROW(updater2.program());
+
+  auto updater3 = this->sw_->getRouteUpdater();
+  updater3.addRoute(
+      rid,
+      IPAddress("10.1.3.1"),
+      24,
+      kClientA,
+      RouteNextHopEntry(makeNextHops({"1.1.1.10"}), DISTANCE));
+  EXPECT_THROW(updater3.program(), FbossHwUpdateError);
+  waitForStateUpdates(this->sw_);
+
+  auto state = this->sw_->getState();
+  EXPECT_EQ(nullptr, this->findRoute4(state, rid, "10.1.1.0/24"));
+  EXPECT_RESOLVED(this->findRoute4(state, rid, "10.1.2.0/24"));
+  EXPECT_RESOLVED(this->findRoute4(state, rid, "10.1.3.0/24"));
+  EXPECT_FALSE(ribHasRoute(rid, "10.1.1.0/24"));
+  EXPECT_TRUE(ribHasRoute(rid, "10.1.3.0/24"));
+}
+
 /*
  * Class that makes it easy to run tests with the following
  * configurable entities:
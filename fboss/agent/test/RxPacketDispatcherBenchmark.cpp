@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "fboss/agent/RxPacketDispatcher.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+DEFINE_int32(
+    arp_flood_size,
+    1000,
+    "Number of ARP packets trapped right before each LACP packet");
+DEFINE_int32(arp_handling_us, 5, "Time it takes to handle one ARP packet");
+
+using namespace facebook::fboss;
+using Priority = RxPacketDispatcher::Priority;
+
+namespace {
+
+const PortID kLacpPort(1);
+const PortID kArpPort(2);
+
+std::unique_ptr<MockRxPacket> makePacket(const std::string& hex, PortID port) {
+  auto pkt = MockRxPacket::fromHex(hex);
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  return pkt;
+}
+
+/*
+ * Measures how long a LACP packet takes to get handled, when it is trapped
+ * right behind an ARP flood. With prioritized set to false, every packet is
+ * queued in the same class, which is what handling them inline in arrival
+ * order amounts to.
+ */
+void lacpUnderArpFlood(unsigned int iters, bool prioritized) {
+  folly::BenchmarkSuspender suspender;
+  std::atomic<unsigned int> lacpHandled{0};
+  std::atomic<int> arpPending{0};
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        if (pkt->getSrcPort() == kLacpPort) {
+          ++lacpHandled;
+          return;
+        }
+        auto until = std::chrono::steady_clock::now() +
+            std::chrono::microseconds(FLAGS_arp_handling_us);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+        --arpPending;
+      },
+      1,
+      FLAGS_arp_flood_size + 1);
+
+  auto lacp = makePacket(
+      "01 80 c2 00 00 02  02 00 00 00 00 01  88 09  01 01", kLacpPort);
+  auto arp = makePacket(
+      "ff ff ff ff ff ff  02 00 00 00 00 01  08 06"
+      "00 01 08 00 06 04 00 01",
+      kArpPort);
+  auto lacpPriority = prioritized ? dispatcher.classify(*lacp) : Priority::MID;
+  auto arpPriority = dispatcher.classify(*arp);
+
+  for (unsigned int i = 0; i < iters; ++i) {
+    for (int j = 0; j < FLAGS_arp_flood_size; ++j) {
+      if (dispatcher.enqueue(arp->clone(), arpPriority)) {
+        ++arpPending;
+      }
+    }
+    suspender.dismiss();
+    dispatcher.enqueue(lacp->clone(), lacpPriority);
+    while (lacpHandled.load() <= i) {
+      std::this_thread::yield();
+    }
+    suspender.rehire();
+    // Start every iteration with the same backlog
+    while (arpPending.load() > 0) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(LacpUnderArpFloodInOrder, iters) {
+  lacpUnderArpFlood(iters, false);
+}
+
+BENCHMARK_RELATIVE(LacpUnderArpFloodPrioritized, iters) {
+  lacpUnderArpFlood(iters, true);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
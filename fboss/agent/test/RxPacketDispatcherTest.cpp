@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using Priority = RxPacketDispatcher::Priority;
+
+namespace {
+
+const std::string kMacs = "01 80 c2 00 00 02  02 00 00 00 00 01";
+const std::string kIPv4Addrs = "0a 00 00 01  0a 00 00 02";
+const std::string kIPv6Addrs =
+    "26 20 00 00 1c fe fa ce b0 0c 00 00 00 00 00 01"
+    "26 20 00 00 1c fe fa ce b0 0c 00 00 00 00 00 02";
+
+std::unique_ptr<MockRxPacket> makePacket(
+    const std::string& hex,
+    PortID port = PortID(1)) {
+  auto pkt = MockRxPacket::fromHex(hex);
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  return pkt;
+}
+
+Priority classify(const std::string& hex) {
+  RxPacketDispatcher dispatcher([](auto) {}, 1, 1);
+  return dispatcher.classify(*makePacket(hex));
+}
+
+} // namespace
+
+TEST(RxPacketDispatcherTest, classifyL2) {
+  // LACP
+  EXPECT_EQ(classify(kMacs + "88 09  01 01"), Priority::HIGH);
+  // LLDP
+  EXPECT_EQ(classify(kMacs + "88 cc  02 07"), Priority::HIGH);
+  // ARP request, 802.1q tagged
+  EXPECT_EQ(
+      classify(kMacs + "81 00 00 01  08 06  00 01 08 00 06 04 00 01"),
+      Priority::MID);
+}
+
+TEST(RxPacketDispatcherTest, classifyIPv4) {
+  // TCP to port 179, TTL 1 as used by single hop eBGP
+  EXPECT_EQ(
+      classify(
+          kMacs + "08 00  45 00 00 28 00 00 00 00 01 06 00 00" + kIPv4Addrs +
+          "c3 50 00 b3"),
+      Priority::HIGH);
+  // UDP, TTL 64
+  EXPECT_EQ(
+      classify(
+          kMacs + "08 00  45 00 00 1c 00 00 00 00 40 11 00 00" + kIPv4Addrs +
+          "c3 50 00 35"),
+      Priority::MID);
+  // UDP, TTL 1
+  EXPECT_EQ(
+      classify(
+          kMacs + "08 00  45 00 00 1c 00 00 00 00 01 11 00 00" + kIPv4Addrs +
+          "c3 50 00 35"),
+      Priority::LOW);
+}
+
+TEST(RxPacketDispatcherTest, classifyIPv6) {
+  // TCP from port 179
+  EXPECT_EQ(
+      classify(kMacs + "86 dd  60 00 00 00 00 14 06 40" + kIPv6Addrs +
+               "00 b3 c3 50"),
+      Priority::HIGH);
+  // TCP to port 179 behind a destination options header
+  EXPECT_EQ(
+      classify(kMacs + "86 dd  60 00 00 00 00 1c 3c 40" + kIPv6Addrs +
+               "06 00 01 04 00 00 00 00  c3 50 00 b3"),
+      Priority::HIGH);
+  // Neighbor solicitation, hop limit 255
+  EXPECT_EQ(
+      classify(kMacs + "86 dd  60 00 00 00 00 20 3a ff" + kIPv6Addrs +
+               "87 00"),
+      Priority::MID);
+  // UDP, hop limit 1
+  EXPECT_EQ(
+      classify(kMacs + "86 dd  60 00 00 00 00 08 11 01" + kIPv6Addrs +
+               "c3 50 00 35"),
+      Priority::LOW);
+}
+
+TEST(RxPacketDispatcherTest, classifyByCosQueue) {
+  class CosQueueRxPacket : public MockRxPacket {
+   public:
+    using MockRxPacket::MockRxPacket;
+    int cosQueue() const override {
+      return 9;
+    }
+  };
+  auto arp = makePacket(kMacs + "08 06  00 01 08 00 06 04 00 01");
+  CosQueueRxPacket pkt(arp->buf()->clone());
+
+  RxPacketDispatcher byContents([](auto) {}, 1, 1);
+  EXPECT_EQ(byContents.classify(pkt), Priority::MID);
+  RxPacketDispatcher byCosQueue([](auto) {}, 1, 1, 9);
+  EXPECT_EQ(byCosQueue.classify(pkt), Priority::HIGH);
+}
+
+TEST(RxPacketDispatcherTest, classifyTruncated) {
+  auto pkt = MockRxPacket::fromHex("01 80 c2 00 00 02  02 00 00");
+  RxPacketDispatcher dispatcher([](auto) {}, 1, 1);
+  EXPECT_EQ(dispatcher.classify(*pkt), Priority::LOW);
+}
+
+TEST(RxPacketDispatcherTest, strictPriority) {
+  folly::Baton<> blocked;
+  folly::Baton<> unblock;
+  folly::Baton<> done;
+  std::mutex lock;
+  std::vector<PortID> handled;
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        auto port = pkt->getSrcPort();
+        if (port == PortID(1)) {
+          blocked.post();
+          unblock.wait();
+        }
+        std::lock_guard<std::mutex> g(lock);
+        handled.push_back(port);
+        if (handled.size() == 4) {
+          done.post();
+        }
+      },
+      1,
+      4);
+
+  auto arp = kMacs + "08 06  00 01 08 00 06 04 00 01";
+  // Keep the only worker busy while the other packets are queued
+  ASSERT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(1)), Priority::MID));
+  blocked.wait();
+  EXPECT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(2)), Priority::LOW));
+  EXPECT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(3)), Priority::MID));
+  EXPECT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(4)), Priority::HIGH));
+  unblock.post();
+  done.wait();
+
+  std::vector<PortID> expected = {PortID(1), PortID(4), PortID(3), PortID(2)};
+  EXPECT_EQ(handled, expected);
+}
+
+TEST(RxPacketDispatcherTest, dropsWhenQueueFull) {
+  folly::Baton<> blocked;
+  folly::Baton<> unblock;
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        if (pkt->getSrcPort() == PortID(1)) {
+          blocked.post();
+          unblock.wait();
+        }
+      },
+      1,
+      1);
+
+  auto arp = kMacs + "08 06  00 01 08 00 06 04 00 01";
+  ASSERT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(1)), Priority::LOW));
+  blocked.wait();
+  EXPECT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(2)), Priority::LOW));
+  EXPECT_FALSE(dispatcher.enqueue(makePacket(arp, PortID(3)), Priority::LOW));
+  // Other classes have their own queue
+  EXPECT_TRUE(dispatcher.enqueue(makePacket(arp, PortID(4)), Priority::HIGH));
+  EXPECT_EQ(dispatcher.getDropCount(Priority::LOW), 1);
+  EXPECT_EQ(dispatcher.getDropCount(Priority::HIGH), 0);
+  unblock.post();
+
+  dispatcher.stop();
+  EXPECT_FALSE(dispatcher.enqueue(makePacket(arp), Priority::HIGH));
+  EXPECT_EQ(dispatcher.getDropCount(Priority::HIGH), 1);
+}
+
+TEST(RxPacketDispatcherTest, flowsHandledInOrder) {
+  constexpr int kPorts = 3;
+  constexpr int kPktsPerPort = 1000;
+  folly::Baton<> done;
+  std::mutex lock;
+  std::map<PortID, std::vector<VlanID>> handled;
+  int numHandled = 0;
+  std::atomic<int> inFlight[kPorts + 1] = {};
+  std::atomic<bool> concurrent{false};
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        auto port = pkt->getSrcPort();
+        if (inFlight[static_cast<int>(port)].fetch_add(1) != 0) {
+          concurrent = true;
+        }
+        // Give the other workers time to get ahead, if they can
+        std::this_thread::yield();
+        inFlight[static_cast<int>(port)].fetch_sub(1);
+        std::lock_guard<std::mutex> g(lock);
+        handled[port].push_back(pkt->getSrcVlan());
+        if (++numHandled == kPorts * kPktsPerPort) {
+          done.post();
+        }
+      },
+      4,
+      kPorts * kPktsPerPort);
+
+  auto lacp = kMacs + "88 09  01 01";
+  for (int i = 0; i < kPktsPerPort; ++i) {
+    for (int port = 1; port <= kPorts; ++port) {
+      auto pkt = makePacket(lacp, PortID(port));
+      pkt->setSrcVlan(VlanID(i));
+      ASSERT_TRUE(dispatcher.enqueue(std::move(pkt), Priority::HIGH));
+    }
+  }
+  done.wait();
+
+  EXPECT_FALSE(concurrent);
+  for (int port = 1; port <= kPorts; ++port) {
+    const auto& vlans = handled[PortID(port)];
+    ASSERT_EQ(vlans.size(), static_cast<size_t>(kPktsPerPort));
+    for (int i = 0; i < kPktsPerPort; ++i) {
+      EXPECT_EQ(vlans[i], VlanID(i));
+    }
+  }
+}
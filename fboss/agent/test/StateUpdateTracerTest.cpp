@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "fboss/agent/StateUpdateTracer.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/json.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+folly::dynamic getEvents(const StateUpdateTracer& tracer) {
+  return folly::parseJson(tracer.getChromeTrace())["traceEvents"];
+}
+
+int countEvents(
+    const folly::dynamic& events,
+    folly::StringPiece category,
+    folly::StringPiece name) {
+  int count = 0;
+  for (const auto& event : events) {
+    if (event.getDefault("cat", "") == category && event["name"] == name) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(StateUpdateTracerTest, noSpansWithoutTrace) {
+  StateUpdateTracer tracer(4);
+  {
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "hw");
+  }
+  auto trace = tracer.startTrace();
+  {
+    StateUpdateTracer::ScopedTrace scopedTrace(nullptr);
+    StateUpdateTracer::ScopedSpan span(StateUpdateTracer::kHwCategory, "hw");
+  }
+  EXPECT_TRUE(trace->spans.empty());
+}
+
+TEST(StateUpdateTracerTest, spansGoToCurrentTrace) {
+  StateUpdateTracer tracer(4);
+  auto trace = tracer.startTrace();
+  auto start = StateUpdateTracer::Clock::now();
+  {
+    StateUpdateTracer::ScopedTrace scopedTrace(trace.get());
+    StateUpdateTracer::addSpan(
+        StateUpdateTracer::kQueueCategory,
+        "update",
+        start,
+        StateUpdateTracer::Clock::now());
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kUpdateCategory, "update");
+    {
+      StateUpdateTracer::ScopedSpan hwSpan(
+          StateUpdateTracer::kHwCategory, "routes");
+    }
+  }
+  // Spans are added as they end
+  ASSERT_EQ(trace->spans.size(), 3);
+  EXPECT_EQ(trace->spans[0].category, StateUpdateTracer::kQueueCategory);
+  EXPECT_EQ(trace->spans[1].name, "routes");
+  EXPECT_EQ(trace->spans[2].category, StateUpdateTracer::kUpdateCategory);
+  EXPECT_LE(trace->spans[2].start, trace->spans[1].start);
+  EXPECT_GE(trace->spans[2].end, trace->spans[1].end);
+  EXPECT_EQ(trace->threadNames.size(), 1);
+}
+
+TEST(StateUpdateTracerTest, keepsLastTraces) {
+  StateUpdateTracer tracer(2);
+  for (int generation = 1; generation <= 3; ++generation) {
+    auto trace = tracer.startTrace();
+    trace->generation = generation;
+    StateUpdateTracer::ScopedTrace scopedTrace(trace.get());
+    {
+      StateUpdateTracer::ScopedSpan span(
+          StateUpdateTracer::kUpdateCategory, "update");
+    }
+    tracer.record(std::move(trace));
+  }
+  EXPECT_EQ(tracer.size(), 2);
+  std::vector<int64_t> generations;
+  for (const auto& event : getEvents(tracer)) {
+    if (event["ph"] == "X") {
+      generations.push_back(event["args"]["generation"].asInt());
+    }
+  }
+  EXPECT_EQ(generations, (std::vector<int64_t>{2, 3}));
+}
+
+TEST(StateUpdateTracerTest, disabled) {
+  StateUpdateTracer tracer(0);
+  EXPECT_EQ(tracer.startTrace(), nullptr);
+  tracer.record(std::make_unique<StateUpdateTracer::Trace>());
+  EXPECT_EQ(tracer.size(), 0);
+  EXPECT_TRUE(getEvents(tracer).empty());
+}
+
+TEST(StateUpdateTracerTest, chromeTraceEvents) {
+  StateUpdateTracer tracer(1);
+  auto trace = tracer.startTrace();
+  {
+    StateUpdateTracer::ScopedTrace scopedTrace(trace.get());
+    auto now = StateUpdateTracer::Clock::now();
+    StateUpdateTracer::addSpan(
+        StateUpdateTracer::kQueueCategory, "update", now, now);
+    StateUpdateTracer::ScopedSpan span(
+        StateUpdateTracer::kObserverCategory, "observer");
+  }
+  tracer.record(std::move(trace));
+  auto events = getEvents(tracer);
+  // Queue spans are async begin/end pairs, other spans complete events,
+  // followed by the name of each thread
+  ASSERT_EQ(events.size(), 4);
+  EXPECT_EQ(events[0]["ph"], "b");
+  EXPECT_EQ(events[1]["ph"], "e");
+  EXPECT_EQ(events[0]["id"], events[1]["id"]);
+  EXPECT_EQ(events[2]["ph"], "X");
+  EXPECT_EQ(events[2]["cat"], "observer");
+  EXPECT_GE(events[2]["dur"].asDouble(), 0);
+  EXPECT_EQ(events[3]["ph"], "M");
+  EXPECT_EQ(events[3]["tid"], events[2]["tid"]);
+}
+
+TEST(StateUpdateTracerTest, swSwitchUpdates) {
+  auto state = testStateA();
+  state->publish();
+  auto handle = createTestHandle(state);
+  auto sw = handle->getSw();
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  waitForStateUpdates(sw);
+
+  auto oldGeneration = sw->getState()->getGeneration();
+  sw->updateStateBlocking(
+      "trace test", [](const std::shared_ptr<SwitchState>& state) {
+        return bringAllPortsUp(state);
+      });
+  waitForStateUpdates(sw);
+
+  auto events = getEvents(*sw->getStateUpdateTracer());
+  // Begin and end of the time queued
+  EXPECT_EQ(countEvents(events, "queue", "trace test"), 2);
+  EXPECT_EQ(countEvents(events, "update", "trace test"), 1);
+  int hwSpans = 0;
+  int observerSpans = 0;
+  for (const auto& event : events) {
+    if (event.getDefault("args", folly::dynamic::object())
+            .getDefault("generation", 0)
+            .asInt() <= oldGeneration) {
+      continue;
+    }
+    if (event["cat"] == "hw") {
+      ++hwSpans;
+    } else if (event["cat"] == "observer") {
+      ++observerSpans;
+    }
+  }
+  EXPECT_GT(hwSpans, 0);
+  EXPECT_GT(observerSpans, 0);
+}
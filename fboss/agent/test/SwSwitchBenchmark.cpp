@@ -0,0 +1,385 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Benchmarks of the SwSwitch software pipeline alone, on top of a
+ * MockHwSwitch, so that agent side regressions show up without an ASIC:
+ * route programming through the RIB, RX packet handling, neighbor
+ * resolution, config reload and state delta computation.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Format.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/RouteGeneratorTestUtils.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+#include "fboss/agent/test/TestPacketFactory.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <chrono>
+#include <thread>
+
+DEFINE_int32(
+    num_neighbors,
+    1000,
+    "Number of neighbors learnt by the neighbor resolution benchmark");
+DEFINE_int32(
+    neighbor_resolution_timeout_s,
+    60,
+    "Time to wait for all neighbors to be resolved before giving up");
+DECLARE_bool(enable_state_update_pipelining);
+DECLARE_bool(ack_route_updates_on_schedule);
+
+using namespace facebook::fboss;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+using folly::MacAddress;
+
+namespace {
+
+const RouterID kRid(0);
+// Hosts per VLAN in the neighbor resolution benchmark, in 10.0.<vlan>.0/24
+constexpr int kHostsPerVlan = 250;
+
+// Global state used by the RX and config benchmarks
+std::unique_ptr<HwTestHandle> handle;
+cfg::SwitchConfig config;
+std::unique_ptr<MockRxPacket> arpRequestMine;
+std::unique_ptr<MockRxPacket> v4PacketMine;
+std::unique_ptr<MockRxPacket> v6PacketMine;
+std::unique_ptr<MockRxPacket> v4PacketToUnresolved;
+
+/*
+ * 64 ports, each in its own VLAN with interface <id> having 10.0.<id>.0/24
+ * and 2400:<id>::/64, and MAC 00:02:00:00:00:<id>
+ */
+std::unique_ptr<HwTestHandle> setupSwitch(cfg::SwitchConfig* cfg) {
+  auto testHandle = createTestHandle(cfg);
+  testHandle->getSw()->initialConfigApplied(std::chrono::steady_clock::now());
+  waitForStateUpdates(testHandle->getSw());
+  return testHandle;
+}
+
+std::unique_ptr<MockRxPacket> makePacket(
+    std::unique_ptr<MockRxPacket> pkt,
+    PortID port,
+    VlanID vlan) {
+  pkt->padToLength(68);
+  pkt->setSrcPort(port);
+  pkt->setSrcVlan(vlan);
+  return pkt;
+}
+
+std::unique_ptr<MockRxPacket> makeIpPacket(folly::IOBuf buf, int vlan) {
+  return makePacket(
+      std::make_unique<MockRxPacket>(
+          std::make_unique<folly::IOBuf>(std::move(buf))),
+      PortID(vlan),
+      VlanID(vlan));
+}
+
+// ARP request for interface <vlan>'s address, from host <host> in its subnet
+std::unique_ptr<MockRxPacket> makeArpRequest(int vlan, int host) {
+  auto hex = folly::sformat(
+      // dst mac, src mac
+      "ff ff ff ff ff ff  02 00 00 00 {0:02x} {1:02x}"
+      // 802.1q
+      "81 00  {0:04x}"
+      // ARP, htype: ethernet, ptype: IPv4, hlen: 6, plen: 4
+      "08 06  00 01  08 00  06  04"
+      // ARP Request
+      "00 01"
+      // Sender MAC
+      "02 00 00 00 {0:02x} {1:02x}"
+      // Sender IP: 10.0.<vlan>.<host>
+      "0a 00 {0:02x} {1:02x}"
+      // Target MAC
+      "00 00 00 00 00 00"
+      // Target IP: 10.0.<vlan>.0
+      "0a 00 {0:02x} 00",
+      vlan,
+      host);
+  return makePacket(MockRxPacket::fromHex(hex), PortID(vlan), VlanID(vlan));
+}
+
+void init() {
+  config = getTestConfig();
+  handle = setupSwitch(&config);
+
+  const int kVlan = 1;
+  const MacAddress kIntfMac("00:02:00:00:00:01");
+  const MacAddress kHostMac("02:00:00:00:01:0f");
+  arpRequestMine = makeArpRequest(1, 15);
+  v4PacketMine = makeIpPacket(
+      createV4Packet(
+          IPAddressV4("10.0.1.15"),
+          IPAddressV4("10.0.1.0"),
+          kHostMac,
+          kIntfMac),
+      kVlan);
+  v6PacketMine = makeIpPacket(
+      createV6Packet(
+          IPAddressV6("2400:1::f"),
+          IPAddressV6("2400:1::"),
+          kHostMac,
+          kIntfMac),
+      kVlan);
+  // Routed to a connected subnet with no neighbor for the destination
+  v4PacketToUnresolved = makeIpPacket(
+      createV4Packet(
+          IPAddressV4("10.0.1.15"),
+          IPAddressV4("10.0.2.200"),
+          kHostMac,
+          kIntfMac),
+      kVlan);
+}
+
+void rxPackets(unsigned int iters, const MockRxPacket& pkt) {
+  auto sw = handle->getSw();
+  for (unsigned int i = 0; i < iters; ++i) {
+    sw->packetReceived(pkt.clone());
+  }
+}
+
+enum class RouteOp {
+  ADD,
+  DEL,
+  SYNC_FIB,
+  STATE_DELTA,
+};
+
+/*
+ * Programs the routes of a scale generator through the RIB, measuring one
+ * of: adding them, deleting them, syncing the FIB to the same routes, or
+ * computing and walking the state delta of adding them.
+ */
+template <typename RouteScaleGeneratorT>
+void routeBenchmark(RouteOp op) {
+  folly::BenchmarkSuspender suspender;
+  auto cfg = getTestConfig();
+  auto testHandle = setupSwitch(&cfg);
+  auto sw = testHandle->getSw();
+  RouteScaleGeneratorT routeGenerator(sw->getState());
+  sw->updateStateBlocking(
+      "resolve next hops", [&](const std::shared_ptr<SwitchState>& state) {
+        return routeGenerator.resolveNextHops(state);
+      });
+  const auto& routeChunks = routeGenerator.getThriftRoutes();
+  auto updater = sw->getRouteUpdater();
+  auto addRoutes = [&updater](const auto& routes) {
+    for (const auto& route : routes) {
+      updater.addRoute(kRid, ClientID::BGPD, route);
+    }
+  };
+
+  auto stateWithoutRoutes = sw->getState();
+  if (op == RouteOp::ADD) {
+    suspender.dismiss();
+  }
+  for (const auto& routeChunk : routeChunks) {
+    addRoutes(routeChunk);
+    updater.program();
+  }
+  // program() may return before its routes are programmed
+  waitForStateUpdates(sw);
+  suspender.rehire();
+
+  switch (op) {
+    case RouteOp::ADD:
+      break;
+    case RouteOp::DEL:
+      suspender.dismiss();
+      for (const auto& routeChunk : routeChunks) {
+        for (const auto& route : routeChunk) {
+          updater.delRoute(kRid, *route.dest_ref(), ClientID::BGPD);
+        }
+        updater.program();
+      }
+      suspender.rehire();
+      break;
+    case RouteOp::SYNC_FIB:
+      addRoutes(routeGenerator.allThriftRoutes());
+      suspender.dismiss();
+      updater.program({{kRid, ClientID::BGPD}});
+      suspender.rehire();
+      break;
+    case RouteOp::STATE_DELTA: {
+      auto stateWithRoutes = sw->getState();
+      suspender.dismiss();
+      StateDelta delta(stateWithoutRoutes, stateWithRoutes);
+      size_t changed = 0;
+      for (const auto& routeDelta : delta.getFibsDelta()) {
+        for (const auto& v4Delta : routeDelta.getFibDelta<IPAddressV4>()) {
+          changed += v4Delta.getNew() != nullptr;
+        }
+        for (const auto& v6Delta : routeDelta.getFibDelta<IPAddressV6>()) {
+          changed += v6Delta.getNew() != nullptr;
+        }
+      }
+      folly::doNotOptimizeAway(changed);
+      suspender.rehire();
+      CHECK_EQ(changed, getRouteCount(routeChunks));
+      break;
+    }
+  }
+}
+
+int numResolvedNeighbors(const std::shared_ptr<SwitchState>& state) {
+  int resolved = 0;
+  for (const auto& vlan : *state->getVlans()) {
+    for (const auto& entry : *vlan->getArpTable()) {
+      resolved += !entry->isPending();
+    }
+  }
+  return resolved;
+}
+
+} // namespace
+
+#define ROUTE_BENCHMARKS(name, RouteScaleGeneratorT)            \
+  BENCHMARK(name##RouteAdd) {                                   \
+    routeBenchmark<RouteScaleGeneratorT>(RouteOp::ADD);         \
+  }                                                             \
+  BENCHMARK(name##RouteDel) {                                   \
+    routeBenchmark<RouteScaleGeneratorT>(RouteOp::DEL);         \
+  }                                                             \
+  BENCHMARK(name##SyncFib) {                                    \
+    routeBenchmark<RouteScaleGeneratorT>(RouteOp::SYNC_FIB);    \
+  }                                                             \
+  BENCHMARK(name##StateDelta) {                                 \
+    routeBenchmark<RouteScaleGeneratorT>(RouteOp::STATE_DELTA); \
+  }                                                             \
+  BENCHMARK_DRAW_LINE();
+
+ROUTE_BENCHMARKS(Rsw, utility::RSWRouteScaleGenerator)
+ROUTE_BENCHMARKS(Fsw, utility::FSWRouteScaleGenerator)
+ROUTE_BENCHMARKS(ThAlpm, utility::THAlpmRouteScaleGenerator)
+ROUTE_BENCHMARKS(HgridUu, utility::HgridUuRouteScaleGenerator)
+
+namespace {
+
+/*
+ * Back to back route updates of a single client, as in BGP churn, with state
+ * updates pipelined, and with route updates acknowledged once scheduled.
+ */
+template <typename RouteScaleGeneratorT>
+void routeChurnBenchmark(bool ackOnSchedule) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_enable_state_update_pipelining = true;
+  FLAGS_ack_route_updates_on_schedule = ackOnSchedule;
+  routeBenchmark<RouteScaleGeneratorT>(RouteOp::ADD);
+}
+
+} // namespace
+
+BENCHMARK(FswRouteChurn) {
+  routeBenchmark<utility::FSWRouteScaleGenerator>(RouteOp::ADD);
+}
+
+BENCHMARK_RELATIVE(FswRouteChurnPipelined) {
+  routeChurnBenchmark<utility::FSWRouteScaleGenerator>(false);
+}
+
+BENCHMARK_RELATIVE(FswRouteChurnAckOnSchedule) {
+  routeChurnBenchmark<utility::FSWRouteScaleGenerator>(true);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(RxArpRequestMine, iters) {
+  rxPackets(iters, *arpRequestMine);
+}
+
+BENCHMARK(RxIPv4Mine, iters) {
+  rxPackets(iters, *v4PacketMine);
+}
+
+BENCHMARK(RxIPv6Mine, iters) {
+  rxPackets(iters, *v6PacketMine);
+}
+
+BENCHMARK(RxIPv4ToUnresolvedNeighbor, iters) {
+  rxPackets(iters, *v4PacketToUnresolved);
+}
+
+BENCHMARK_DRAW_LINE();
+
+/*
+ * Time from ARP requests of num_neighbors hosts arriving to all of them
+ * being resolved in the switch state.
+ */
+BENCHMARK(NeighborResolution) {
+  folly::BenchmarkSuspender suspender;
+  auto cfg = getTestConfig();
+  auto testHandle = setupSwitch(&cfg);
+  auto sw = testHandle->getSw();
+  CHECK_LE(
+      FLAGS_num_neighbors,
+      kHostsPerVlan * static_cast<int>(cfg.vlans_ref()->size()));
+  std::vector<std::unique_ptr<MockRxPacket>> arpRequests;
+  for (int i = 0; i < FLAGS_num_neighbors; ++i) {
+    arpRequests.push_back(
+        makeArpRequest(i / kHostsPerVlan + 1, i % kHostsPerVlan + 1));
+  }
+
+  suspender.dismiss();
+  for (auto& arpRequest : arpRequests) {
+    sw->packetReceived(std::move(arpRequest));
+  }
+  auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::seconds(FLAGS_neighbor_resolution_timeout_s);
+  while (numResolvedNeighbors(sw->getState()) < FLAGS_num_neighbors) {
+    CHECK(std::chrono::steady_clock::now() < deadline)
+        << "Only " << numResolvedNeighbors(sw->getState()) << " of "
+        << FLAGS_num_neighbors << " neighbors got resolved";
+    std::this_thread::yield();
+  }
+  suspender.rehire();
+}
+
+/*
+ * Reloads a config changing the MTU of every interface, and back
+ */
+BENCHMARK(ConfigReload, iters) {
+  auto sw = handle->getSw();
+  cfg::SwitchConfig newConfig;
+  BENCHMARK_SUSPEND {
+    newConfig = config;
+    for (auto& intf : *newConfig.interfaces_ref()) {
+      intf.mtu_ref() = 1500;
+    }
+  }
+  for (unsigned int i = 0; i < iters; ++i) {
+    sw->applyConfig("benchmark", i % 2 ? config : newConfig);
+  }
+  BENCHMARK_SUSPEND {
+    sw->applyConfig("benchmark", config);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  // Setting up the switch is fairly expensive, so the RX and config reload
+  // benchmarks share a switch set up once before they run.
+  init();
+  folly::runBenchmarks();
+  handle.reset();
+  return 0;
+}
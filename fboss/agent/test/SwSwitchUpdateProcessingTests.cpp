@@ -21,8 +21,12 @@
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 
+DECLARE_bool(enable_state_update_pipelining);
+
 using namespace facebook::fboss;
 using std::string;
 using ::testing::_;
@@ -242,3 +246,72 @@ INSTANTIATE_TEST_CASE_P(
     SwSwitchUpdateProcessingTest,
     SwSwitchUpdateProcessingTest,
     ::testing::Values(true, false));
+
+class SwSwitchPipelinedUpdateProcessingTest
+    : public SwSwitchUpdateProcessingTest {
+ public:
+  void SetUp() override {
+    FLAGS_enable_state_update_pipelining = true;
+    SwSwitchUpdateProcessingTest::SetUp();
+  }
+
+  void TearDown() override {
+    SwSwitchUpdateProcessingTest::TearDown();
+    FLAGS_enable_state_update_pipelining = false;
+  }
+};
+
+TEST_P(SwSwitchPipelinedUpdateProcessingTest, UpdatesAppliedInOrder) {
+  auto prevState = sw->getState();
+  prevState->publish();
+  for (auto i = 0; i < 10; ++i) {
+    auto nextState = prevState->clone();
+    nextState->publish();
+    // Each update is computed on top of the previous one, even if that
+    // has not been programmed yet
+    sw->updateState(
+        "Pipelined update",
+        [prevState, nextState](const std::shared_ptr<SwitchState>& state) {
+          EXPECT_EQ(state, prevState);
+          return nextState;
+        });
+    prevState = nextState;
+  }
+  waitForStateUpdates(sw);
+  EXPECT_EQ(prevState, sw->getState());
+}
+
+TEST_P(
+    SwSwitchPipelinedUpdateProcessingTest,
+    FailedHwFailureProtectedUpdateThrowsError) {
+  CounterCache counters(sw);
+  auto origState = sw->getState();
+  auto newState = bringAllPortsUp(sw->getState()->clone());
+  newState->publish();
+  setStateChangedReturn(origState);
+  auto stateUpdateFn = [=](const std::shared_ptr<SwitchState>& /*state*/) {
+    return newState;
+  };
+  EXPECT_THROW(
+      sw->updateStateWithHwFailureProtection(
+          "HwFailureProtectedUpdate fail", stateUpdateFn),
+      FbossHwUpdateError);
+  counters.update();
+  counters.checkDelta(SwitchStats::kCounterPrefix + "hw_update_failures", 1);
+
+  // Next update must start from what was applied, not what was desired
+  auto newerState = newState->clone();
+  auto stateUpdateFn2 = [=](const std::shared_ptr<SwitchState>& state) {
+    EXPECT_EQ(state, origState);
+    return newerState;
+  };
+  StateDelta expectedDelta(origState, newerState);
+  EXPECT_HW_CALL(sw, stateChanged(Eq(testing::ByRef(expectedDelta))));
+  sw->updateState("Accept update", stateUpdateFn2);
+  waitForStateUpdates(sw);
+}
+
+INSTANTIATE_TEST_CASE_P(
+    SwSwitchPipelinedUpdateProcessingTest,
+    SwSwitchPipelinedUpdateProcessingTest,
+    ::testing::Values(true, false));
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/ThriftHandler.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
+#include "fboss/agent/UpdateStreamReplayer.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/HwTestHandle.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/FileUtil.h>
+#include <folly/IPAddress.h>
+#include <folly/experimental/TestUtil.h>
+
+DECLARE_string(update_stream_record_file);
+
+using namespace facebook::fboss;
+using facebook::network::toBinaryAddress;
+using folly::IPAddress;
+
+namespace {
+
+UnicastRoute makeRoute(const std::string& prefix, const std::string& nhop) {
+  auto network = IPAddress::createNetwork(prefix);
+  UnicastRoute route;
+  route.dest_ref()->ip_ref() = toBinaryAddress(network.first);
+  route.dest_ref()->prefixLength_ref() = network.second;
+  route.nextHopAddrs_ref()->push_back(toBinaryAddress(IPAddress(nhop)));
+  return route;
+}
+
+IpPrefix makePrefix(const std::string& prefix) {
+  auto network = IPAddress::createNetwork(prefix);
+  IpPrefix ipPrefix;
+  ipPrefix.ip_ref() = toBinaryAddress(network.first);
+  ipPrefix.prefixLength_ref() = network.second;
+  return ipPrefix;
+}
+
+MplsRoute makePopAndLookupRoute(int32_t label, const std::string& nhop) {
+  MplsAction action;
+  action.action_ref() = MplsActionCode::POP_AND_LOOKUP;
+  NextHopThrift nexthop;
+  nexthop.address_ref() = toBinaryAddress(IPAddress(nhop));
+  nexthop.mplsAction_ref() = action;
+  MplsRoute route;
+  route.topLabel_ref() = label;
+  route.nextHops_ref()->push_back(nexthop);
+  return route;
+}
+
+// A state with just the ports of config, as it is before config is applied
+std::shared_ptr<SwitchState> makePortsOnlyState(
+    const cfg::SwitchConfig& config) {
+  auto state = std::make_shared<SwitchState>();
+  for (const auto& port : *config.ports_ref()) {
+    state->registerPort(
+        PortID(*port.logicalID_ref()),
+        folly::to<std::string>("port", *port.logicalID_ref()));
+  }
+  return state;
+}
+
+} // namespace
+
+class UpdateStreamRecorderTest : public ::testing::Test {
+ public:
+  std::string getRecordFile() const {
+    return tmpDir_.path().string() + "/update_stream";
+  }
+
+ private:
+  folly::test::TemporaryDirectory tmpDir_;
+};
+
+TEST_F(UpdateStreamRecorderTest, readBack) {
+  {
+    UpdateStreamRecorder recorder(getRecordFile());
+    recorder.recordRouteUpdate(
+        RouterID(0),
+        ClientID::BGPD,
+        update_stream::RouteUpdateType::ADD,
+        {makeRoute("7.1.0.0/16", "10.0.0.2")});
+    recorder.recordRouteUpdate(
+        RouterID(0),
+        ClientID::BGPD,
+        update_stream::RouteUpdateType::DELETE,
+        {},
+        {makePrefix("7.1.0.0/16")});
+    recorder.recordConfigApplied(testConfigA());
+    recorder.recordLinkStateChanged(PortID(1), false);
+    recorder.recordNeighborLearnt(
+        VlanID(1),
+        IPAddress("10.0.0.2"),
+        folly::MacAddress("02:00:00:00:00:02"),
+        PortDescriptor(PortID(2)),
+        2,
+        0);
+  }
+  auto records = UpdateStreamRecorder::readRecords(getRecordFile());
+  ASSERT_EQ(records.size(), 5);
+  using Type = update_stream::UpdateStreamEvent::Type;
+  EXPECT_EQ(records[0].event_ref()->getType(), Type::routeUpdate);
+  EXPECT_EQ(
+      *records[0].event_ref()->get_routeUpdate().toAdd_ref(),
+      std::vector<UnicastRoute>{makeRoute("7.1.0.0/16", "10.0.0.2")});
+  EXPECT_EQ(
+      *records[1].event_ref()->get_routeUpdate().type_ref(),
+      update_stream::RouteUpdateType::DELETE);
+  EXPECT_EQ(
+      *records[2].event_ref()->get_configApplied().config_ref(),
+      testConfigA());
+  EXPECT_FALSE(*records[3].event_ref()->get_linkStateChanged().up_ref());
+  const auto& neighbor = records[4].event_ref()->get_neighborLearnt();
+  EXPECT_EQ(
+      facebook::network::toIPAddress(*neighbor.ip_ref()),
+      IPAddress("10.0.0.2"));
+  EXPECT_EQ(*neighbor.port_ref(), 2);
+  EXPECT_FALSE(*neighbor.isAggregatePort_ref());
+  for (size_t i = 1; i < records.size(); ++i) {
+    EXPECT_GE(
+        *records[i].timestampUsecs_ref(), *records[i - 1].timestampUsecs_ref());
+  }
+}
+
+TEST_F(UpdateStreamRecorderTest, truncatedRecordIgnored) {
+  {
+    UpdateStreamRecorder recorder(getRecordFile());
+    recorder.recordLinkStateChanged(PortID(1), true);
+    recorder.recordLinkStateChanged(PortID(2), true);
+  }
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(getRecordFile().c_str(), contents));
+  contents.resize(contents.size() - 1);
+  ASSERT_TRUE(folly::writeFile(contents, getRecordFile().c_str()));
+  auto records = UpdateStreamRecorder::readRecords(getRecordFile());
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(*records[0].event_ref()->get_linkStateChanged().port_ref(), 1);
+}
+
+TEST_F(UpdateStreamRecorderTest, flushWhileRecording) {
+  UpdateStreamRecorder recorder(getRecordFile());
+  recorder.recordLinkStateChanged(PortID(1), true);
+  recorder.flush();
+  EXPECT_EQ(UpdateStreamRecorder::readRecords(getRecordFile()).size(), 1);
+  recorder.recordLinkStateChanged(PortID(1), false);
+  recorder.flush();
+  EXPECT_EQ(UpdateStreamRecorder::readRecords(getRecordFile()).size(), 2);
+}
+
+TEST_F(UpdateStreamRecorderTest, dropPastMaxPending) {
+  {
+    // Too small to hold any record, so everything is dropped
+    UpdateStreamRecorder recorder(getRecordFile(), 1);
+    recorder.recordLinkStateChanged(PortID(1), true);
+    recorder.recordLinkStateChanged(PortID(2), true);
+    EXPECT_EQ(recorder.getNumDropped(), 2);
+  }
+  EXPECT_TRUE(UpdateStreamRecorder::readRecords(getRecordFile()).empty());
+}
+
+TEST_F(UpdateStreamRecorderTest, replayReachesRecordedState) {
+  folly::dynamic recordedState;
+  {
+    gflags::FlagSaver flagSaver;
+    FLAGS_update_stream_record_file = getRecordFile();
+    auto config = testConfigA();
+    auto handle = createTestHandle(&config);
+    auto sw = handle->getSw();
+    sw->initialConfigApplied(std::chrono::steady_clock::now());
+    ThriftHandler handler(sw);
+
+    auto client = static_cast<int16_t>(ClientID::BGPD);
+    auto routes = std::make_unique<std::vector<UnicastRoute>>();
+    routes->push_back(makeRoute("7.1.0.0/16", "10.0.0.2"));
+    routes->push_back(makeRoute("7.2.0.0/16", "10.0.0.3"));
+    handler.addUnicastRoutes(client, std::move(routes));
+    auto prefixes = std::make_unique<std::vector<IpPrefix>>();
+    prefixes->push_back(makePrefix("7.1.0.0/16"));
+    handler.deleteUnicastRoutes(client, std::move(prefixes));
+    routes = std::make_unique<std::vector<UnicastRoute>>();
+    routes->push_back(makeRoute("aaaa:1::/64", "2401:db00:2110:3001::2"));
+    handler.syncFib(client, std::move(routes));
+    auto mplsRoutes = std::make_unique<std::vector<MplsRoute>>();
+    mplsRoutes->push_back(makePopAndLookupRoute(101, "10.0.0.2"));
+    mplsRoutes->push_back(makePopAndLookupRoute(102, "10.0.0.2"));
+    handler.addMplsRoutes(client, std::move(mplsRoutes));
+    handler.deleteMplsRoutes(
+        client, std::make_unique<std::vector<int32_t>>(1, 102));
+    sw->linkStateChanged(PortID(1), true);
+    waitForStateUpdates(sw);
+    recordedState = UpdateStreamReplayer::getReplayedState(*sw->getState());
+  }
+  EXPECT_EQ(recordedState["fibs"]["0"].count("7.2.0.0/16"), 1);
+  EXPECT_EQ(recordedState["ports"]["1"], true);
+  EXPECT_EQ(recordedState["labels"].count("101"), 1);
+  EXPECT_EQ(recordedState["labels"].count("102"), 0);
+
+  auto records = UpdateStreamRecorder::readRecords(getRecordFile());
+  // The replay starts with applying the config, as the recording did
+  auto handle = createTestHandle(makePortsOnlyState(testConfigA()));
+  auto sw = handle->getSw();
+  UpdateStreamReplayer replayer(sw, 0);
+  auto result = replayer.replay(records);
+  EXPECT_EQ(result.errors, 0);
+  EXPECT_EQ(result.latencies["routeUpdate"].count, 3);
+  EXPECT_EQ(result.latencies["mplsRouteUpdate"].count, 2);
+  EXPECT_EQ(result.latencies["configApplied"].count, 1);
+  EXPECT_EQ(result.latencies["linkStateChanged"].count, 1);
+  EXPECT_TRUE(UpdateStreamReplayer::diffReplayedStates(
+                  recordedState,
+                  UpdateStreamReplayer::getReplayedState(*sw->getState()))
+                  .empty());
+}
+
+TEST_F(UpdateStreamRecorderTest, diffReplayedStates) {
+  auto state = folly::dynamic::object(
+      "fibs", folly::dynamic::object("0", folly::dynamic::object("a", "x")))(
+      "ports", folly::dynamic::object("1", true));
+  EXPECT_TRUE(UpdateStreamReplayer::diffReplayedStates(state, state).empty());
+  auto other = state;
+  other["fibs"]["0"]["a"] = "y";
+  other["fibs"]["0"]["b"] = "z";
+  other["ports"].erase("1");
+  EXPECT_EQ(
+      UpdateStreamReplayer::diffReplayedStates(state, other),
+      (std::vector<std::string>{
+          "/fibs/0/a: expected \"x\", got \"y\"",
+          "/fibs/0/b: unexpected \"z\"",
+          "/ports/1: missing"}));
+}
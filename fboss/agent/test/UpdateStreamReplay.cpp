@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Replays an update stream recorded with --update_stream_record_file
+ * against a SwSwitch running on SimSwitch, and reports how long each type
+ * of update took. The replayed state can be saved, and compared against a
+ * previously saved one, e.g. to check a replay at an accelerated speed ends
+ * up in the same state as one at the original speed.
+ */
+
+#include <folly/FileUtil.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+
+#include "fboss/agent/AgentConfig.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/UpdateStreamRecorder.h"
+#include "fboss/agent/UpdateStreamReplayer.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <algorithm>
+#include <iostream>
+
+DEFINE_string(replay_file, "", "Update stream to replay");
+DEFINE_double(
+    replay_speedup,
+    1.0,
+    "How many times faster than recorded to replay, 0 for as fast as "
+    "possible");
+DEFINE_int32(
+    replay_num_ports,
+    0,
+    "Number of ports of the simulated switch, 0 to fit the recorded configs");
+DEFINE_string(
+    replay_state_output,
+    "",
+    "File to write the state reached by the replay to");
+DEFINE_string(
+    replay_expected_state,
+    "",
+    "File written by a previous replay with --replay_state_output, "
+    "to check this replay reaches the same state");
+
+using namespace facebook::fboss;
+
+namespace {
+
+uint32_t getNumPorts(
+    const std::vector<update_stream::UpdateStreamRecord>& records) {
+  if (FLAGS_replay_num_ports > 0) {
+    return FLAGS_replay_num_ports;
+  }
+  int32_t maxPort = 1;
+  for (const auto& record : records) {
+    const auto& event = *record.event_ref();
+    if (event.getType() ==
+        update_stream::UpdateStreamEvent::Type::configApplied) {
+      for (const auto& port :
+           *event.get_configApplied().config_ref()->ports_ref()) {
+        maxPort = std::max(maxPort, *port.logicalID_ref());
+      }
+    }
+  }
+  return maxPort;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  if (FLAGS_replay_file.empty()) {
+    XLOG(FATAL) << "--replay_file is required";
+  }
+  auto records = UpdateStreamRecorder::readRecords(FLAGS_replay_file);
+  XLOG(INFO) << "Replaying " << records.size() << " events from "
+             << FLAGS_replay_file;
+
+  auto platform = std::make_unique<SimPlatform>(
+      folly::MacAddress("02:00:00:00:00:01"), getNumPorts(records));
+  platform->init(createEmptyAgentConfig(), 0);
+  auto sw = std::make_unique<SwSwitch>(std::move(platform));
+  sw->init(nullptr /* No custom TunManager */);
+
+  UpdateStreamReplayer replayer(sw.get(), FLAGS_replay_speedup);
+  auto result = replayer.replay(records);
+  std::cout << UpdateStreamReplayer::formatResult(result);
+
+  auto state = UpdateStreamReplayer::getReplayedState(*sw->getState());
+  if (!FLAGS_replay_state_output.empty()) {
+    folly::writeFile(
+        folly::toPrettyJson(state), FLAGS_replay_state_output.c_str());
+  }
+  int ret = result.errors ? 1 : 0;
+  if (!FLAGS_replay_expected_state.empty()) {
+    std::string expected;
+    if (!folly::readFile(FLAGS_replay_expected_state.c_str(), expected)) {
+      XLOG(FATAL) << "Unable to read " << FLAGS_replay_expected_state;
+    }
+    auto differences = UpdateStreamReplayer::diffReplayedStates(
+        folly::parseJson(expected), state);
+    for (const auto& difference : differences) {
+      std::cout << difference << std::endl;
+    }
+    std::cout << (differences.empty() ? "Replayed state matches expected"
+                                      : "Replayed state differs from expected")
+              << std::endl;
+    if (!differences.empty()) {
+      ret = 1;
+    }
+  }
+  return ret;
+}
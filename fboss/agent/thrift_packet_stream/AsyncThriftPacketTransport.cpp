@@ -12,9 +12,11 @@ ssize_t AsyncThriftPacketTransport::send(
   if (!buf) {
     return 0;
   }
-  TPacket packet;
+  // Shares the buffer instead of copying it, it is only copied if the
+  // peer did not connect for batches
+  TPacketFrame packet;
   *packet.l2Port_ref() = iface();
-  *packet.buf_ref() = buf->moveToFbString().toStdString();
+  *packet.buf_ref() = buf->cloneAsValue();
   if (auto serverSharedPtr = server_.lock()) {
     return serverSharedPtr->send(std::move(packet));
   }
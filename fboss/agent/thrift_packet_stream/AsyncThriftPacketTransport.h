@@ -33,6 +33,14 @@ class AsyncThriftPacketTransport : public AsyncPacketTransport {
     }
     readCallback_->onDataAvailable(folly::IOBuf::copyBuffer(*packet.buf_ref()));
   }
+
+  void recvPacket(TPacketFrame&& packet) {
+    if (!isReading()) {
+      return;
+    }
+    readCallback_->onDataAvailable(
+        std::make_unique<folly::IOBuf>(std::move(*packet.buf_ref())));
+  }
   /**
    * Stop listening on the socket.
    */
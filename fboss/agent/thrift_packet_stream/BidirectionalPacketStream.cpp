@@ -43,6 +43,10 @@ namespace fboss {
           folly::to<std::string>(serviceName, ".pkt_recvd"),                   \
           fb303::SUM,                                                          \
           fb303::RATE),                                                        \
+      STATS_pkt_batch_recvd(                                                   \
+          folly::to<std::string>(serviceName, ".pkt_batch_recvd"),             \
+          fb303::SUM,                                                          \
+          fb303::RATE),                                                        \
       STATS_pkt_send_success(                                                  \
           folly::to<std::string>(serviceName, ".pkt_send_success"),            \
           fb303::SUM,                                                          \
@@ -86,16 +90,27 @@ BidirectionalPacketStream::BidirectionalPacketStream(
     throw std::runtime_error("Invalid timer settings");
   }
   // timer will be started when connectClient call is made.
+  // Created even if this side doesn't enable batching, as the peer may still
+  // connect to our service batched.
+  batchFlushTimeout_ = folly::AsyncTimeout::make(
+      *evb_, [this]() noexcept { PacketStreamService::flushBatches(); });
 }
 
 BidirectionalPacketStream::~BidirectionalPacketStream() {
   XLOG(INFO) << "Closing Bidirectional stream:";
   if (evb_) {
-    evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
-        [this]() { cancelTimeout(); });
+    evb_->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+      cancelTimeout();
+      batchFlushTimeout_.reset();
+    });
   }
 }
 
+void BidirectionalPacketStream::enableBatching(const BatchConfig& config) {
+  PacketStreamService::setBatchConfig(config);
+  batched_ = true;
+}
+
 void BidirectionalPacketStream::registerPortsToServer() {
   if (newConnection_.load() && PacketStreamClient::isConnectedToServer() &&
       clientConnected_.load()) {
@@ -129,14 +144,16 @@ void BidirectionalPacketStream::connectClient(uint16_t port) {
   XLOG(INFO) << serviceName_ << ": Starting Connection to Server: " << port;
   peerServerPort_.store(port);
   newConnection_.store(true);
-  PacketStreamClient::connectToServer("::1", port);
+  PacketStreamClient::connectToServer("::1", port, batched_);
   registerPortsToServer();
 
   evb_->runInEventBaseThread([this]() { scheduleTimeout(timeout_); });
 }
 void BidirectionalPacketStream::stopClient() {
-  evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
-      [this]() { cancelTimeout(); });
+  evb_->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+    cancelTimeout();
+    batchFlushTimeout_.reset();
+  });
   PacketStreamClient::cancel();
   // called when destructing so we can clean up evb_
   evb_ = nullptr;
@@ -151,7 +168,7 @@ void BidirectionalPacketStream::timeoutExpired() noexcept {
     auto port = peerServerPort_.load();
     XLOG(INFO) << serviceName_ << ": Reconnecting to server on port: " << port;
     newConnection_.store(true);
-    PacketStreamClient::connectToServer("::1", port);
+    PacketStreamClient::connectToServer("::1", port, batched_);
   }
   scheduleTimeout(timeout_);
 }
@@ -253,13 +270,57 @@ void BidirectionalPacketStream::recvPacket(TPacket&& packet) {
   }
 }
 
+void BidirectionalPacketStream::recvPacketBatch(TPacketBatch&& batch) {
+  STATS_pkt_batch_recvd.add(1);
+  STATS_pkt_recvd.add(batch.packets_ref()->size());
+  transportMap_.withRLock([&](auto& lockedMap) {
+    for (auto& frame : *batch.packets_ref()) {
+      const auto& port = *frame.l2Port_ref();
+      if (port.empty()) {
+        STATS_err_pkt_recv_empty_port.add(1);
+        continue;
+      }
+      auto iter = lockedMap.find(port);
+      if (iter != lockedMap.end()) {
+        auto* transport =
+            reinterpret_cast<AsyncThriftPacketTransport*>(iter->second.get());
+        transport->recvPacket(std::move(frame));
+        continue;
+      }
+      auto acceptor = acceptor_.load();
+      if (acceptor) {
+        TPacket packet;
+        packet.timestamp_ref() = *frame.timestamp_ref();
+        packet.l2Port_ref() = port;
+        packet.buf_ref() = frame.buf_ref()->moveToFbString().toStdString();
+        acceptor->recvPacket(std::move(packet));
+        continue;
+      }
+      // Unlike a single packet, don't throw and lose the rest of the batch
+      XLOG(ERR) << "Packet received for port:" << port
+                << " that's doesn't have transport to forward";
+      STATS_err_acceptor_not_registered.add(1);
+    }
+  });
+}
+
 ssize_t BidirectionalPacketStream::send(TPacket&& packet) {
+  ssize_t sz = packet.buf_ref()->size();
+  return sendImpl(std::move(packet), sz);
+}
+
+ssize_t BidirectionalPacketStream::send(TPacketFrame&& packet) {
+  ssize_t sz = packet.buf_ref()->computeChainDataLength();
+  return sendImpl(std::move(packet), sz);
+}
+
+template <typename Packet>
+ssize_t BidirectionalPacketStream::sendImpl(Packet&& packet, ssize_t sz) {
   if (!clientConnected_.load()) {
     STATS_err_send_client_not_connected.add(1);
     XLOG(ERR) << "client not yet connected";
     return -1;
   }
-  ssize_t sz = packet.buf_ref()->size();
   try {
     // call the packetstreamservice send method to send the packet.
     PacketStreamService::send(connectedClientId_, std::move(packet));
@@ -300,5 +361,19 @@ void BidirectionalPacketStream::removePort(
   STATS_port_removed.add(1);
 }
 
+void BidirectionalPacketStream::batchStarted(
+    const std::string& /* clientId */) {
+  auto evb = evb_;
+  if (!evb) {
+    return;
+  }
+  evb->runInEventBaseThread([this]() {
+    if (batchFlushTimeout_ && !batchFlushTimeout_->isScheduled()) {
+      batchFlushTimeout_->scheduleTimeout(
+          PacketStreamService::getBatchConfig().maxDelay);
+    }
+  });
+}
+
 } // namespace fboss
 } // namespace facebook
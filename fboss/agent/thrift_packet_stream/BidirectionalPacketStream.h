@@ -34,6 +34,13 @@ class BidirectionalPacketStream
 
   virtual ~BidirectionalPacketStream() override;
 
+  /*
+   * Receive packets from the peer in batches, and send them in batches to
+   * a peer that asked for it. Must be called before connectClient. Peers
+   * asking for batches are sent them with the default config otherwise.
+   */
+  void enableBatching(const BatchConfig& config);
+
   void connectClient(uint16_t peerServerPort);
   // Should be called only when destruction. After stop client is called
   // connectClient should never be called again on this object.
@@ -42,6 +49,7 @@ class BidirectionalPacketStream
   std::shared_ptr<AsyncPacketTransport> listen(const std::string& port);
   void close(const std::string& port);
   ssize_t send(TPacket&& packet);
+  ssize_t send(TPacketFrame&& packet);
 
   void setPacketAcceptor(BidirectionalPacketAcceptor* acceptor) {
     acceptor_.store(acceptor);
@@ -55,6 +63,7 @@ class BidirectionalPacketStream
  protected:
   // client calls
   virtual void recvPacket(TPacket&& packet) override;
+  virtual void recvPacketBatch(TPacketBatch&& batch) override;
   // server calls
   virtual void clientConnected(const std::string& clientId) override;
   virtual void clientDisconnected(const std::string& clientId) override;
@@ -63,9 +72,12 @@ class BidirectionalPacketStream
   virtual void removePort(
       const std::string& clientId,
       const std::string& l2Port) override;
+  virtual void batchStarted(const std::string& clientId) override;
 
  private:
   void registerPortsToServer();
+  template <typename Packet>
+  ssize_t sendImpl(Packet&& packet, ssize_t size);
   folly::EventBase* evb_;
   double timeout_;
   using TransportMap =
@@ -78,6 +90,9 @@ class BidirectionalPacketStream
   std::atomic<uint16_t> peerServerPort_{0};
   std::string serviceName_;
   std::atomic<bool> newConnection_{false};
+  bool batched_{false};
+  // Sends pending batches maxDelay after the first packet of a batch
+  std::unique_ptr<folly::AsyncTimeout> batchFlushTimeout_;
   fb303::TimeseriesWrapper STATS_err_port_register;
   fb303::TimeseriesWrapper STATS_err_invalid_connect_client_port;
   fb303::TimeseriesWrapper STATS_err_delete_port;
@@ -86,6 +101,7 @@ class BidirectionalPacketStream
   fb303::TimeseriesWrapper STATS_err_send_pkt_failed;
   fb303::TimeseriesWrapper STATS_err_send_client_not_connected;
   fb303::TimeseriesWrapper STATS_pkt_recvd;
+  fb303::TimeseriesWrapper STATS_pkt_batch_recvd;
   fb303::TimeseriesWrapper STATS_pkt_send_success;
   fb303::TimeseriesWrapper STATS_start_reconnect_to_server;
   fb303::TimeseriesWrapper STATS_client_connected;
@@ -51,7 +51,10 @@ void PacketStreamClient::createClient(const std::string& ip, uint16_t port) {
       });
 }
 
-void PacketStreamClient::connectToServer(const std::string& ip, uint16_t port) {
+void PacketStreamClient::connectToServer(
+    const std::string& ip,
+    uint16_t port,
+    bool batched) {
 #if FOLLY_HAS_COROUTINES
   if (State::INIT != state_.load()) {
     XLOG(INFO) << "Client is already in process of connecting to server";
@@ -62,14 +65,14 @@ void PacketStreamClient::connectToServer(const std::string& ip, uint16_t port) {
   }
   state_.store(State::CONNECTING);
   cancelSource_ = std::make_unique<folly::CancellationSource>();
-  evb_->runInEventBaseThread([this, ip, port] {
+  evb_->runInEventBaseThread([this, ip, port, batched] {
     try {
       createClient(ip, port);
       if (cancelSource_->isCancellationRequested()) {
         state_.store(State::INIT);
         return;
       }
-      folly::coro::blockingWait(connect());
+      folly::coro::blockingWait(connect(batched));
     } catch (const std::exception& ex) {
       XLOG(ERR) << "Connect to server failed with ex:" << ex.what();
       state_.store(State::INIT);
@@ -81,8 +84,24 @@ void PacketStreamClient::connectToServer(const std::string& ip, uint16_t port) {
 }
 
 #if FOLLY_HAS_COROUTINES
-folly::coro::Task<void> PacketStreamClient::connect() {
-  auto result = co_await client_->co_connect(clientId_);
+folly::coro::Task<void> PacketStreamClient::connect(bool batched) {
+  if (batched) {
+    auto result = co_await client_->co_connectBatched(clientId_);
+    co_await receive(std::move(result), [this](TPacketBatch&& batch) {
+      recvPacketBatch(std::move(batch));
+    });
+  } else {
+    auto result = co_await client_->co_connect(clientId_);
+    co_await receive(std::move(result), [this](TPacket&& packet) {
+      recvPacket(std::move(packet));
+    });
+  }
+}
+
+template <typename Stream, typename RecvFn>
+folly::coro::Task<void> PacketStreamClient::receive(
+    Stream result,
+    RecvFn recv) {
   if (cancelSource_->isCancellationRequested()) {
     state_.store(State::INIT);
     XLOG(ERR) << "Cancellation Requested;";
@@ -94,10 +113,11 @@ folly::coro::Task<void> PacketStreamClient::connect() {
       cancelSource_->getToken(),
       folly::coro::co_invoke(
           [gen = std::move(result).toAsyncGenerator(),
+           recv = std::move(recv),
            this]() mutable -> folly::coro::Task<void> {
             try {
               while (auto packet = co_await gen.next()) {
-                recvPacket(std::move(*packet));
+                recv(std::move(*packet));
               }
             } catch (const std::exception& ex) {
               XLOG(ERR) << clientId_
@@ -110,6 +130,16 @@ folly::coro::Task<void> PacketStreamClient::connect() {
 }
 #endif
 
+void PacketStreamClient::recvPacketBatch(TPacketBatch&& batch) {
+  for (auto& frame : *batch.packets_ref()) {
+    TPacket packet;
+    packet.timestamp_ref() = *frame.timestamp_ref();
+    packet.l2Port_ref() = std::move(*frame.l2Port_ref());
+    packet.buf_ref() = frame.buf_ref()->moveToFbString().toStdString();
+    recvPacket(std::move(packet));
+  }
+}
+
 void PacketStreamClient::cancel() {
   XLOG(INFO) << "Cancel PacketStreamClient";
 
@@ -17,7 +17,11 @@ class PacketStreamClient {
   PacketStreamClient(const std::string& clientId, folly::EventBase* evb);
 
   virtual ~PacketStreamClient();
-  void connectToServer(const std::string& ip, uint16_t port);
+  // With batched, packets are received in batches from connectBatched
+  void connectToServer(
+      const std::string& ip,
+      uint16_t port,
+      bool batched = false);
   void registerPortToServer(const std::string& port);
   void clearPortFromServer(const std::string& l2port);
   bool isConnectedToServer();
@@ -28,6 +32,9 @@ class PacketStreamClient {
   // will have the logic to do operation after receiving this
   // packet.
   virtual void recvPacket(TPacket&& packet) = 0;
+  // Batched clients get this instead. Passes each packet to recvPacket()
+  // by default, derived clients can override it to avoid the copy.
+  virtual void recvPacketBatch(TPacketBatch&& batch);
 
  private:
   enum class State : uint16_t {
@@ -37,7 +44,9 @@ class PacketStreamClient {
   };
   void createClient(const std::string& ip, uint16_t port);
 #if FOLLY_HAS_COROUTINES
-  folly::coro::Task<void> connect();
+  folly::coro::Task<void> connect(bool batched);
+  template <typename Stream, typename RecvFn>
+  folly::coro::Task<void> receive(Stream stream, RecvFn recv);
   std::unique_ptr<folly::CancellationSource> cancelSource_;
 #endif
   std::string clientId_;
@@ -10,9 +10,7 @@ PacketStreamService::~PacketStreamService() {
   try {
     clientMap_.withWLock([](auto& lockedMap) {
       for (auto& iter : lockedMap) {
-        auto& clientInfo = iter.second;
-        auto publisher = std::move(clientInfo.publisher_);
-        std::move(*publisher.get()).complete();
+        iter.second.complete();
       }
       lockedMap.clear();
     });
@@ -30,8 +28,30 @@ static TPacketException createTPacketException(
   return ex;
 }
 
+void PacketStreamService::ClientInfo::complete() {
+  if (publisher_) {
+    auto publisher = std::move(publisher_);
+    std::move(*publisher.get()).complete();
+  }
+  if (batchPublisher_) {
+    auto publisher = std::move(batchPublisher_);
+    std::move(*publisher.get()).complete();
+  }
+}
+
 apache::thrift::ServerStream<TPacket> PacketStreamService::connect(
     std::unique_ptr<std::string> clientIdPtr) {
+  return connectClient<TPacket>(std::move(clientIdPtr));
+}
+
+apache::thrift::ServerStream<TPacketBatch> PacketStreamService::connectBatched(
+    std::unique_ptr<std::string> clientIdPtr) {
+  return connectClient<TPacketBatch>(std::move(clientIdPtr));
+}
+
+template <typename T>
+apache::thrift::ServerStream<T> PacketStreamService::connectClient(
+    std::unique_ptr<std::string> clientIdPtr) {
   try {
     if (!clientIdPtr || clientIdPtr->empty()) {
       XLOG(ERR) << "Invalid Client";
@@ -39,16 +59,14 @@ apache::thrift::ServerStream<TPacket> PacketStreamService::connect(
           TPacketErrorCode::INVALID_CLIENT, "Invalid client");
     }
     const auto& clientId = *clientIdPtr;
-    auto streamAndPublisher =
-        apache::thrift::ServerStream<TPacket>::createPublisher(
-            [client = clientId, this] {
-              // when the client is disconnected run this section.
-              XLOG(INFO) << "Client disconnected: " << client;
-              clientMap_.withWLock([client = client](auto& lockedMap) {
-                lockedMap.erase(client);
-              });
-              clientDisconnected(client);
-            });
+    auto streamAndPublisher = apache::thrift::ServerStream<T>::createPublisher(
+        [client = clientId, this] {
+          // when the client is disconnected run this section.
+          XLOG(INFO) << "Client disconnected: " << client;
+          clientMap_.withWLock(
+              [client = client](auto& lockedMap) { lockedMap.erase(client); });
+          clientDisconnected(client);
+        });
 
     clientMap_.withWLock(
         [client = clientId,
@@ -66,22 +84,105 @@ apache::thrift::ServerStream<TPacket> PacketStreamService::connect(
   }
 }
 
+template <typename ClientMap>
+static const auto& getRegisteredClient(
+    const ClientMap& lockedMap,
+    const std::string& clientId,
+    const std::string& l2Port) {
+  auto iter = lockedMap.find(clientId);
+  if (iter == lockedMap.end()) {
+    XLOG(ERR) << "Client '" << clientId << "' Not Connected";
+    throw createTPacketException(
+        TPacketErrorCode::CLIENT_NOT_CONNECTED, "client not connected");
+  }
+  const auto& clientInfo = iter->second;
+  auto portIter = clientInfo.portList_.find(l2Port);
+  if (portIter == clientInfo.portList_.end()) {
+    XLOG(ERR) << "Port '" << l2Port << "'Not Registered";
+    throw createTPacketException(
+        TPacketErrorCode::PORT_NOT_REGISTERED, "PORT not registered");
+  }
+  return clientInfo;
+}
+
 void PacketStreamService::send(const std::string& clientId, TPacket&& packet) {
-  clientMap_.withRLock([&](auto& lockedMap) {
-    auto iter = lockedMap.find(clientId);
-    if (iter == lockedMap.end()) {
-      XLOG(ERR) << "Client '" << clientId << "' Not Connected";
-      throw createTPacketException(
-          TPacketErrorCode::CLIENT_NOT_CONNECTED, "client not connected");
+  auto started = clientMap_.withRLock([&](auto& lockedMap) {
+    const auto& clientInfo =
+        getRegisteredClient(lockedMap, clientId, *packet.l2Port_ref());
+    if (clientInfo.publisher_) {
+      clientInfo.publisher_->next(packet);
+      return false;
     }
-    const auto& clientInfo = iter->second;
-    auto portIter = clientInfo.portList_.find(*packet.l2Port_ref());
-    if (portIter == clientInfo.portList_.end()) {
-      XLOG(ERR) << "Port '" << *packet.l2Port_ref() << "'Not Registered";
-      throw createTPacketException(
-          TPacketErrorCode::PORT_NOT_REGISTERED, "PORT not registered");
+    // The IOBuf takes over the string, no copy
+    TPacketFrame frame;
+    frame.timestamp_ref() = *packet.timestamp_ref();
+    frame.l2Port_ref() = std::move(*packet.l2Port_ref());
+    frame.buf_ref() =
+        std::move(*folly::IOBuf::fromString(std::move(*packet.buf_ref())));
+    return addToBatch(clientInfo, std::move(frame));
+  });
+  if (started) {
+    batchStarted(clientId);
+  }
+}
+
+void PacketStreamService::send(
+    const std::string& clientId,
+    TPacketFrame&& packet) {
+  auto started = clientMap_.withRLock([&](auto& lockedMap) {
+    const auto& clientInfo =
+        getRegisteredClient(lockedMap, clientId, *packet.l2Port_ref());
+    if (clientInfo.batchPublisher_) {
+      return addToBatch(clientInfo, std::move(packet));
+    }
+    TPacket tpacket;
+    tpacket.timestamp_ref() = *packet.timestamp_ref();
+    tpacket.l2Port_ref() = std::move(*packet.l2Port_ref());
+    tpacket.buf_ref() = packet.buf_ref()->moveToFbString().toStdString();
+    clientInfo.publisher_->next(std::move(tpacket));
+    return false;
+  });
+  if (started) {
+    batchStarted(clientId);
+  }
+}
+
+bool PacketStreamService::addToBatch(
+    const ClientInfo& clientInfo,
+    TPacketFrame&& packet) {
+  auto pending = clientInfo.pendingBatch_->wlock();
+  auto& packets = *pending->batch.packets_ref();
+  bool started = packets.empty();
+  pending->bytes += packet.buf_ref()->computeChainDataLength();
+  packets.push_back(std::move(packet));
+  if (packets.size() >= batchConfig_.maxPackets ||
+      pending->bytes >= batchConfig_.maxBytes) {
+    flushLocked(clientInfo, *pending);
+    return false;
+  }
+  return started;
+}
+
+// static
+void PacketStreamService::flushLocked(
+    const ClientInfo& clientInfo,
+    PendingBatch& pending) {
+  if (pending.batch.packets_ref()->empty()) {
+    return;
+  }
+  clientInfo.batchPublisher_->next(std::move(pending.batch));
+  pending.batch = TPacketBatch();
+  pending.bytes = 0;
+}
+
+void PacketStreamService::flushBatches() {
+  clientMap_.withRLock([](auto& lockedMap) {
+    for (const auto& iter : lockedMap) {
+      const auto& clientInfo = iter.second;
+      if (clientInfo.pendingBatch_) {
+        flushLocked(clientInfo, *clientInfo.pendingBatch_->wlock());
+      }
     }
-    clientInfo.publisher_->next(packet);
   });
 }
 
@@ -187,8 +288,10 @@ void PacketStreamService::disconnect(std::unique_ptr<std::string> clientIdPtr) {
           TPacketErrorCode::CLIENT_NOT_CONNECTED, "client not connected");
     }
     auto& clientInfo = iter->second;
-    auto publisher = std::move(clientInfo.publisher_);
-    std::move(*publisher.get()).complete();
+    if (clientInfo.pendingBatch_) {
+      flushLocked(clientInfo, *clientInfo.pendingBatch_->wlock());
+    }
+    clientInfo.complete();
     lockedMap.erase(iter);
     clientDisconnected(clientId);
   });
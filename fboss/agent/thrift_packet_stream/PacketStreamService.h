@@ -4,6 +4,9 @@
 
 #include <common/fb303/cpp/FacebookBase2.h>
 #include <fboss/agent/if/gen-cpp2/PacketStream.tcc>
+
+#include <chrono>
+
 namespace facebook {
 namespace fboss {
 class PacketStreamService : virtual public PacketStreamSvIf,
@@ -13,8 +16,33 @@ class PacketStreamService : virtual public PacketStreamSvIf,
       : facebook::fb303::FacebookBase2(serviceName.c_str()) {}
   virtual ~PacketStreamService() override;
 
+  /*
+   * When a batch is sent to a client connected with connectBatched. The
+   * batch is sent once any of the limits is reached, or when flushBatches()
+   * is called.
+   */
+  struct BatchConfig {
+    size_t maxPackets{64};
+    size_t maxBytes{64 * 1024};
+    // Longest a packet should wait in a batch. Services batching packets
+    // are expected to call flushBatches() within this much time of
+    // batchStarted().
+    std::chrono::milliseconds maxDelay{1};
+  };
+
+  // Should be called before any client connects
+  void setBatchConfig(const BatchConfig& config) {
+    batchConfig_ = config;
+  }
+  const BatchConfig& getBatchConfig() const {
+    return batchConfig_;
+  }
+
   // helper functions.
   void send(const std::string& clientId, TPacket&& packet);
+  void send(const std::string& clientId, TPacketFrame&& packet);
+  // Sends the pending batch of every client
+  void flushBatches();
   bool isClientConnected(const std::string& clientId);
   bool isPortRegistered(const std::string& clientId, const std::string& port);
 
@@ -24,6 +52,8 @@ class PacketStreamService : virtual public PacketStreamSvIf,
   }
   apache::thrift::ServerStream<TPacket> connect(
       std::unique_ptr<std::string> clientId) override;
+  apache::thrift::ServerStream<TPacketBatch> connectBatched(
+      std::unique_ptr<std::string> clientId) override;
   void registerPort(
       std::unique_ptr<std::string> clientId,
       std::unique_ptr<std::string> l2Port) override;
@@ -43,18 +73,46 @@ class PacketStreamService : virtual public PacketStreamSvIf,
   virtual void removePort(
       const std::string& clientId,
       const std::string& l2Port) = 0;
+  // Called when the pending batch of a client gets its first packet
+  virtual void batchStarted(const std::string& /* clientId */) {}
 
  private:
+  struct PendingBatch {
+    TPacketBatch batch;
+    size_t bytes{0};
+  };
   struct ClientInfo {
     explicit ClientInfo(apache::thrift::ServerStreamPublisher<TPacket> pub)
         : publisher_(
               std::make_unique<apache::thrift::ServerStreamPublisher<TPacket>>(
                   std::move(pub))) {}
+    explicit ClientInfo(
+        apache::thrift::ServerStreamPublisher<TPacketBatch> pub)
+        : batchPublisher_(std::make_unique<
+                          apache::thrift::ServerStreamPublisher<TPacketBatch>>(
+              std::move(pub))),
+          pendingBatch_(
+              std::make_unique<folly::Synchronized<PendingBatch>>()) {}
+    void complete();
     std::unordered_set<std::string> portList_;
+    // Only one of the publishers is set, depending on how the client
+    // connected
     std::unique_ptr<apache::thrift::ServerStreamPublisher<TPacket>> publisher_;
+    std::unique_ptr<apache::thrift::ServerStreamPublisher<TPacketBatch>>
+        batchPublisher_;
+    std::unique_ptr<folly::Synchronized<PendingBatch>> pendingBatch_;
   };
   using ClientMap = std::unordered_map<std::string, ClientInfo>;
+
+  template <typename T>
+  apache::thrift::ServerStream<T> connectClient(
+      std::unique_ptr<std::string> clientId);
+  // Returns true if the packet started a new batch
+  bool addToBatch(const ClientInfo& clientInfo, TPacketFrame&& packet);
+  static void flushLocked(const ClientInfo& clientInfo, PendingBatch& pending);
+
   folly::Synchronized<ClientMap> clientMap_;
+  BatchConfig batchConfig_;
 };
 
 } // namespace fboss
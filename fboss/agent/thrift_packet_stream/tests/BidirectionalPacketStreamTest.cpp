@@ -505,6 +505,19 @@ TEST_F(BidirectionalPacketStreamTest, sendParallelMultiplePktsMultiplePorts) {
   sendParallelMultiplePktsMultiplePorts();
 }
 
+TEST_F(BidirectionalPacketStreamTest, BatchesFlushedAfterMaxDelay) {
+  // Only mka asks for batches, so fboss sends them with its default config.
+  // Fewer packets than fill a batch are sent, and nobody calls
+  // flushBatches(), so only the flush timer gets them across.
+  PacketStreamService::BatchConfig config;
+  config.maxDelay = std::chrono::milliseconds(10);
+  mkaServerStream_->enableBatching(config);
+  tryConnect();
+  auto port = "eth0";
+  auto transport = mkaServerStream_->listen(port);
+  sendFbossToMka(5, port, transport);
+}
+
 TEST_F(
     BidirectionalPacketStreamTest,
     sendParallelMultiplePktsMultiplePortsNoOrder) {
@@ -0,0 +1,96 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <thrift/lib/cpp2/util/ScopedServerInterfaceThread.h>
+#include "fboss/agent/thrift_packet_stream/PacketStreamClient.h"
+#include "fboss/agent/thrift_packet_stream/PacketStreamService.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace facebook::fboss;
+
+namespace {
+const std::string kClient = "benchmarkClient";
+const std::string kPort = "eth0";
+constexpr size_t kPayloadSize = 128;
+
+class LoopbackService : public PacketStreamService {
+ public:
+  using PacketStreamService::PacketStreamService;
+
+  void clientConnected(const std::string& /* clientId */) override {}
+  void clientDisconnected(const std::string& /* clientId */) override {}
+  void addPort(
+      const std::string& /* clientId */,
+      const std::string& /* l2Port */) override {}
+  void removePort(
+      const std::string& /* clientId */,
+      const std::string& /* l2Port */) override {}
+};
+
+class LoopbackClient : public PacketStreamClient {
+ public:
+  explicit LoopbackClient(folly::EventBase* evb)
+      : PacketStreamClient(kClient, evb) {}
+
+  void recvPacket(TPacket&& /* packet */) override {
+    ++received;
+  }
+  void recvPacketBatch(TPacketBatch&& batch) override {
+    received += batch.packets_ref()->size();
+  }
+
+  std::atomic<size_t> received{0};
+};
+
+/*
+ * Sends packets from the service to a client over localhost, and waits for
+ * the client to get all of them.
+ */
+void sendOverLoopback(unsigned int iters, bool batched) {
+  folly::BenchmarkSuspender suspender;
+  auto service = std::make_shared<LoopbackService>("PacketStreamBenchmark");
+  apache::thrift::ScopedServerInterfaceThread server(service);
+  folly::ScopedEventBaseThread clientThread;
+  LoopbackClient client(clientThread.getEventBase());
+  client.connectToServer("::1", server.getPort(), batched);
+  while (!client.isConnectedToServer()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  client.registerPortToServer(kPort);
+  std::string payload(kPayloadSize, 'x');
+  suspender.dismiss();
+
+  for (unsigned int i = 0; i < iters; ++i) {
+    TPacket packet;
+    packet.l2Port_ref() = kPort;
+    packet.buf_ref() = payload;
+    service->send(kClient, std::move(packet));
+  }
+  service->flushBatches();
+  while (client.received.load() < iters) {
+    std::this_thread::yield();
+  }
+
+  suspender.rehire();
+}
+} // namespace
+
+#if FOLLY_HAS_COROUTINES
+BENCHMARK(PacketStreamLoopback, iters) {
+  sendOverLoopback(iters, false);
+}
+
+BENCHMARK_RELATIVE(PacketStreamLoopbackBatched, iters) {
+  sendOverLoopback(iters, true);
+}
+#endif
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
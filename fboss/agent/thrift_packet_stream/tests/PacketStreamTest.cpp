@@ -74,8 +74,9 @@ class PacketStreamTest : public Test {
  public:
   void tryConnect(
       std::shared_ptr<folly::Baton<>> baton,
-      DerivedPacketStreamClient& streamClient) {
-    streamClient.connectToServer("::1", server_->getPort());
+      DerivedPacketStreamClient& streamClient,
+      bool batched = false) {
+    streamClient.connectToServer("::1", server_->getPort(), batched);
     auto retry = 15;
     EXPECT_FALSE(baton->try_wait_for(std::chrono::milliseconds(50)));
     while (!streamClient.isConnectedToServer() && retry > 0) {
@@ -164,6 +165,49 @@ TEST_F(PacketStreamTest, PacketSendMultiple) {
   clientReset(std::move(streamClient));
 }
 
+TEST_F(PacketStreamTest, BatchedPacketSend) {
+  std::string port(*g_ports.begin());
+  PacketStreamService::BatchConfig config;
+  config.maxPackets = 4;
+  handler_->setBatchConfig(config);
+  auto baton = std::make_shared<folly::Baton<>>();
+  auto streamClient = std::make_unique<DerivedPacketStreamClient>(
+      g_client, clientThread_.getEventBase(), baton);
+  tryConnect(baton, *streamClient, true /* batched */);
+  EXPECT_NO_THROW(streamClient->registerPortToServer(port));
+  auto packetCnt = streamClient->getPckCnt(port);
+  for (auto i = 0; i < 3; i++) {
+    sendPkt(port);
+  }
+  // Held back until the batch is full
+  EXPECT_FALSE(baton->try_wait_for(std::chrono::milliseconds(50)));
+  EXPECT_EQ(streamClient->getPckCnt(port), packetCnt);
+  sendPkt(port);
+  auto retry = 10;
+  while (streamClient->getPckCnt(port) < packetCnt + 4 && retry-- > 0) {
+    baton->reset();
+    baton->try_wait_for(std::chrono::milliseconds(50));
+  }
+  EXPECT_EQ(streamClient->getPckCnt(port), packetCnt + 4);
+  clientReset(std::move(streamClient));
+}
+
+TEST_F(PacketStreamTest, BatchedPacketFlush) {
+  std::string port(*g_ports.begin());
+  auto baton = std::make_shared<folly::Baton<>>();
+  auto streamClient = std::make_unique<DerivedPacketStreamClient>(
+      g_client, clientThread_.getEventBase(), baton);
+  tryConnect(baton, *streamClient, true /* batched */);
+  EXPECT_NO_THROW(streamClient->registerPortToServer(port));
+  auto packetCnt = streamClient->getPckCnt(port);
+  baton->reset();
+  sendPkt(port);
+  handler_->flushBatches();
+  EXPECT_TRUE(baton->try_wait_for(std::chrono::milliseconds(50)));
+  EXPECT_EQ(streamClient->getPckCnt(port), packetCnt + 1);
+  clientReset(std::move(streamClient));
+}
+
 TEST_F(PacketStreamTest, UnregisterPortToServerFail) {
   std::string port(*g_ports.begin());
   auto baton = std::make_shared<folly::Baton<>>();
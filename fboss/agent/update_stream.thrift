@@ -0,0 +1,72 @@
+#
+# Copyright 2004-present Facebook. All Rights Reserved.
+#
+namespace py neteng.fboss.update_stream
+namespace py3 neteng.fboss
+namespace py.asyncio neteng.fboss.asyncio.update_stream
+namespace cpp2 facebook.fboss.update_stream
+
+include "common/network/if/Address.thrift"
+include "fboss/agent/if/ctrl.thrift"
+include "fboss/agent/switch_config.thrift"
+
+/*
+ * External inputs to the agent, recorded with --update_stream_record_file
+ * so they can be replayed with their original timing.
+ */
+
+enum RouteUpdateType {
+  ADD = 0,
+  DELETE = 1,
+  SYNC_FIB = 2,
+}
+
+struct RouteUpdate {
+  1: i32 vrf
+  2: i16 clientId
+  3: RouteUpdateType type
+  4: list<ctrl.UnicastRoute> toAdd
+  5: list<ctrl.IpPrefix> toDelete
+}
+
+// toDelete is the top labels of the routes deleted
+struct MplsRouteUpdate {
+  1: i16 clientId
+  2: RouteUpdateType type
+  3: list<ctrl.MplsRoute> toAdd
+  4: list<i32> toDelete
+}
+
+struct ConfigApplied {
+  1: switch_config.SwitchConfig config
+}
+
+struct LinkStateChanged {
+  1: i32 port
+  2: bool up
+}
+
+struct NeighborLearnt {
+  1: i32 vlan
+  2: Address.BinaryAddress ip
+  3: string mac
+  4: i32 port
+  5: bool isAggregatePort
+  // ARP opcode, or ICMPv6 type, of the packet the neighbor was learnt from
+  6: i32 type
+  7: i32 flags
+}
+
+union UpdateStreamEvent {
+  1: RouteUpdate routeUpdate
+  2: ConfigApplied configApplied
+  3: LinkStateChanged linkStateChanged
+  4: NeighborLearnt neighborLearnt
+  5: MplsRouteUpdate mplsRouteUpdate
+}
+
+struct UpdateStreamRecord {
+  // Time since the recording started
+  1: i64 timestampUsecs
+  2: UpdateStreamEvent event
+}
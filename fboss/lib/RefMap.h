@@ -14,6 +14,9 @@
 #include <unordered_map>
 
 #include <boost/container/flat_map.hpp>
+#include <folly/container/F14Map.h>
+
+#include "fboss/lib/SlabAllocator.h"
 
 namespace facebook::fboss {
 /*
@@ -35,7 +38,24 @@ using RefMapUMap = std::unordered_map<K, V>;
 template <typename K, typename V>
 using RefMapFlatMap = boost::container::flat_map<K, V>;
 
-template <template <class, class> class M, typename K, typename V>
+/*
+ * Open addressing map with values stored inline. Unlike F14VectorMap,
+ * erasing an entry does not move other entries, so iterators stay valid
+ * across erases triggered by the last reference to a value going away.
+ */
+template <typename K, typename V>
+using RefMapF14ValueMap = folly::F14ValueMap<K, V>;
+
+/*
+ * Alloc is used to allocate both the values and their shared_ptr control
+ * blocks, e.g. SlabAllocator to pack values for high cardinality maps into
+ * slabs rather than making two heap allocations per entry.
+ */
+template <
+    template <class, class> class M,
+    typename K,
+    typename V,
+    typename Alloc = std::allocator<V>>
 class RefMap {
  public:
   // using MapType = std::unordered_map<K, std::weak_ptr<V>>;
@@ -43,7 +63,9 @@ class RefMap {
   using MapType = M<K, std::weak_ptr<V>>;
   using KeyType = K;
   using ValueType = std::weak_ptr<V>;
+  using AllocatorType = Alloc;
   RefMap() {}
+  explicit RefMap(const Alloc& alloc) : alloc_(alloc) {}
   RefMap(const RefMap& other) = delete;
   RefMap& operator=(const RefMap& other) = delete;
 
@@ -121,14 +143,36 @@ class RefMap {
     return map_.clear();
   }
 
+  void reserve(std::size_t count) {
+    map_.reserve(count);
+  }
+
+  const Alloc& getAllocator() const {
+    return alloc_;
+  }
+
  private:
+  using ValueAlloc =
+      typename std::allocator_traits<Alloc>::template rebind_alloc<V>;
+  using ValueAllocTraits = std::allocator_traits<ValueAlloc>;
+
   template <typename... Args>
   std::shared_ptr<V> makeShared(const K& k, Args&&... args) {
-    auto del = [&m = map_, k](V* v) {
+    ValueAlloc valueAlloc(alloc_);
+    auto mem = ValueAllocTraits::allocate(valueAlloc, 1);
+    V* vp;
+    try {
+      vp = new (mem) V{std::forward<Args>(args)...};
+    } catch (...) {
+      ValueAllocTraits::deallocate(valueAlloc, mem, 1);
+      throw;
+    }
+    auto del = [&m = map_, k, valueAlloc](V* v) mutable {
       m.erase(k);
-      std::default_delete<V>()(v);
+      v->~V();
+      ValueAllocTraits::deallocate(valueAlloc, v, 1);
     };
-    return std::shared_ptr<V>(new V{std::forward<Args>(args)...}, del);
+    return std::shared_ptr<V>(vp, std::move(del), alloc_);
   }
 
   template <typename... Args>
@@ -146,6 +190,7 @@ class RefMap {
     return vsp.get();
   }
 
+  Alloc alloc_;
   MapType map_;
 };
 
@@ -155,4 +200,7 @@ using UnorderedRefMap = RefMap<RefMapUMap, K, V>;
 template <typename K, typename V>
 using FlatRefMap = RefMap<RefMapFlatMap, K, V>;
 
+template <typename K, typename V>
+using SlabRefMap = RefMap<RefMapF14ValueMap, K, V, SlabAllocator<V>>;
+
 } // namespace facebook::fboss
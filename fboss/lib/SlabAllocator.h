@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * SlabArena hands out fixed size slots carved from large slabs. Freed slots
+ * go on a per size class free list and are reused by later allocations of
+ * the same size class. Memory is only returned to the system when the arena
+ * itself is destroyed.
+ *
+ * This is meant for containers holding a very large number of small, same
+ * sized objects (e.g. SAI route or neighbor objects together with their
+ * shared_ptr control blocks), where per object malloc overhead and heap
+ * fragmentation dominate memory usage and allocation time.
+ *
+ * SlabArena is NOT thread safe. Users must serialize allocation and
+ * deallocation, as they must for the containers built on top of it.
+ */
+class SlabArena {
+ public:
+  static constexpr size_t kDefaultSlotsPerSlab = 1024;
+  static constexpr size_t kSlotAlignment = alignof(std::max_align_t);
+
+  explicit SlabArena(size_t slotsPerSlab = kDefaultSlotsPerSlab)
+      : slotsPerSlab_(std::max<size_t>(slotsPerSlab, 1)) {}
+  SlabArena(const SlabArena&) = delete;
+  SlabArena& operator=(const SlabArena&) = delete;
+
+  void* allocate(size_t size, size_t align) {
+    if (align > kSlotAlignment) {
+      return ::operator new(size, std::align_val_t(align));
+    }
+    auto& sizeClass = getSizeClass(slotSize(size));
+    if (!sizeClass.freeList) {
+      addSlab(sizeClass);
+    }
+    auto slot = sizeClass.freeList;
+    sizeClass.freeList = slot->next;
+    ++slotsInUse_;
+    return slot;
+  }
+
+  void deallocate(void* ptr, size_t size, size_t align) {
+    if (!ptr) {
+      return;
+    }
+    if (align > kSlotAlignment) {
+      ::operator delete(ptr, std::align_val_t(align));
+      return;
+    }
+    auto& sizeClass = getSizeClass(slotSize(size));
+    auto slot = static_cast<FreeSlot*>(ptr);
+    slot->next = sizeClass.freeList;
+    sizeClass.freeList = slot;
+    --slotsInUse_;
+  }
+
+  size_t slotsInUse() const {
+    return slotsInUse_;
+  }
+
+  size_t bytesReserved() const {
+    size_t bytes = 0;
+    for (const auto& sizeClass : sizeClasses_) {
+      bytes += sizeClass.slabs.size() * sizeClass.slotSize * slotsPerSlab_;
+    }
+    return bytes;
+  }
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+  struct SizeClass {
+    explicit SizeClass(size_t size) : slotSize(size) {}
+    size_t slotSize;
+    FreeSlot* freeList{nullptr};
+    std::vector<std::unique_ptr<std::byte[]>> slabs;
+  };
+
+  static size_t slotSize(size_t size) {
+    size = std::max(size, sizeof(FreeSlot));
+    return (size + kSlotAlignment - 1) / kSlotAlignment * kSlotAlignment;
+  }
+
+  SizeClass& getSizeClass(size_t size) {
+    // Only a handful of distinct sizes (object, shared_ptr control block)
+    // are ever requested from a single arena, so a linear scan is cheapest.
+    for (auto& sizeClass : sizeClasses_) {
+      if (sizeClass.slotSize == size) {
+        return sizeClass;
+      }
+    }
+    return sizeClasses_.emplace_back(size);
+  }
+
+  void addSlab(SizeClass& sizeClass) {
+    // new[] of std::byte is aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+    // which is at least kSlotAlignment
+    auto slab =
+        std::make_unique<std::byte[]>(sizeClass.slotSize * slotsPerSlab_);
+    auto base = slab.get();
+    for (size_t i = slotsPerSlab_; i > 0; --i) {
+      auto slot =
+          reinterpret_cast<FreeSlot*>(base + (i - 1) * sizeClass.slotSize);
+      slot->next = sizeClass.freeList;
+      sizeClass.freeList = slot;
+    }
+    sizeClass.slabs.push_back(std::move(slab));
+  }
+
+  const size_t slotsPerSlab_;
+  size_t slotsInUse_{0};
+  std::vector<SizeClass> sizeClasses_;
+};
+
+/*
+ * Standard allocator adapter over a shared SlabArena. Single object
+ * allocations are served from the arena, array allocations fall back to
+ * the global heap. Copies (including rebound copies) share the arena, and
+ * keep it alive for as long as any copy exists, so objects allocated from
+ * it may safely outlive the container that created them.
+ */
+template <typename T>
+class SlabAllocator {
+ public:
+  using value_type = T;
+
+  SlabAllocator() : arena_(std::make_shared<SlabArena>()) {}
+  explicit SlabAllocator(std::shared_ptr<SlabArena> arena)
+      : arena_(std::move(arena)) {}
+  template <typename U>
+  SlabAllocator(const SlabAllocator<U>& other) : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(arena_->allocate(sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (n != 1) {
+      std::allocator<T>().deallocate(ptr, n);
+      return;
+    }
+    arena_->deallocate(ptr, sizeof(T), alignof(T));
+  }
+
+  const std::shared_ptr<SlabArena>& arena() const {
+    return arena_;
+  }
+
+  template <typename U>
+  bool operator==(const SlabAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const SlabAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  std::shared_ptr<SlabArena> arena_;
+};
+
+} // namespace facebook::fboss
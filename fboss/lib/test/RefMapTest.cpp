@@ -250,3 +250,41 @@ TEST(RefMap, UnorderedRefMapRefCountTest) {
   }
   EXPECT_EQ(refMap.referenceCount(101), 0);
 }
+
+TEST(RefMap, SlabRefMapRefCountTest) {
+  SlabRefMap<int, A> refMap;
+  EXPECT_EQ(refMap.referenceCount(101), 0);
+  refMap.refOrEmplace(101, 1);
+  EXPECT_EQ(refMap.referenceCount(101), 0);
+  {
+    auto x = refMap.refOrEmplace(101, 1);
+    EXPECT_EQ(refMap.referenceCount(101), 1);
+    {
+      auto y = refMap.refOrEmplace(101, 1);
+      EXPECT_EQ(refMap.referenceCount(101), 2);
+    }
+    EXPECT_EQ(refMap.referenceCount(101), 1);
+  }
+  EXPECT_EQ(refMap.referenceCount(101), 0);
+}
+
+TEST(RefMap, SlabRefMapReusesSlots) {
+  SlabRefMap<int, A> refMap;
+  const auto& arena = refMap.getAllocator().arena();
+  std::vector<std::shared_ptr<A>> refs;
+  for (auto i = 0; i < 100; i++) {
+    refs.push_back(refMap.refOrEmplace(i, i).first);
+  }
+  EXPECT_EQ(refMap.size(), 100);
+  // one slot for the value, one for the shared_ptr control block
+  EXPECT_EQ(arena->slotsInUse(), 200);
+  auto reserved = arena->bytesReserved();
+  refs.clear();
+  EXPECT_EQ(refMap.size(), 0);
+  EXPECT_EQ(arena->slotsInUse(), 0);
+  for (auto i = 0; i < 100; i++) {
+    refs.push_back(refMap.refOrEmplace(i, i).first);
+  }
+  EXPECT_EQ(arena->slotsInUse(), 200);
+  EXPECT_EQ(arena->bytesReserved(), reserved);
+}
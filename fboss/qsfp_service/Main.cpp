@@ -53,8 +53,9 @@ int main(int argc, char** argv) {
       std::chrono::seconds(FLAGS_stats_publish_interval),
       "statsPublish");
   scheduler.addFunction(
-      [mgr = handler->getTransceiverManager()]() {
-        mgr->refreshTransceivers();
+      [handler = handler]() {
+        handler->getTransceiverManager()->refreshTransceivers();
+        handler->publishTransceiverChanges();
       },
       std::chrono::seconds(FLAGS_loop_interval),
       "refreshTransceivers");
@@ -45,6 +45,15 @@ QsfpServiceHandler::QsfpServiceHandler(
   XLOG(INFO) << "FbossPhyMacsecService inside QsfpServiceHandler Started";
 }
 
+QsfpServiceHandler::~QsfpServiceHandler() {
+  // Complete outside of the lock, as completing a stream calls back in to
+  // remove its publisher
+  auto publishers = std::move(changeSubscribers_.wlock()->publishers);
+  for (auto& [id, publisher] : publishers) {
+    std::move(*publisher).complete();
+  }
+}
+
 void QsfpServiceHandler::init() {
   // Initialize the I2c bus
   manager_->initTransceiverMap();
@@ -98,6 +107,55 @@ void QsfpServiceHandler::syncPorts(
   manager_->syncPorts(info, std::move(ports));
 }
 
+apache::thrift::ServerStream<TransceiverChanges>
+QsfpServiceHandler::subscribeTransceiverChanges(
+    int64_t aliveSince,
+    int64_t sinceGeneration) {
+  auto log = LOG_THRIFT_CALL(INFO);
+  auto lockedSubscribers = changeSubscribers_.wlock();
+  auto id = lockedSubscribers->nextId++;
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<TransceiverChanges>::createPublisher(
+          [this, id] {
+            XLOG(INFO) << "Transceiver changes subscriber " << id << " left";
+            changeSubscribers_.wlock()->publishers.erase(id);
+          });
+
+  // A subscriber from before a restart has generations of the previous
+  // instance, so it needs everything
+  auto myAliveSince = this->aliveSince();
+  auto changes = lockedSubscribers->tracker.getChangesSince(
+      aliveSince == myAliveSince ? sinceGeneration : 0);
+  changes.aliveSince_ref() = myAliveSince;
+  XLOG(INFO) << "Transceiver changes subscriber " << id << " starts with "
+             << changes.transceivers_ref()->size() << " transceivers";
+  streamAndPublisher.second.next(std::move(changes));
+  lockedSubscribers->publishers.emplace(
+      id,
+      std::make_unique<ChangesPublisher>(
+          std::move(streamAndPublisher.second)));
+  return std::move(streamAndPublisher.first);
+}
+
+void QsfpServiceHandler::publishTransceiverChanges() {
+  std::map<int32_t, TransceiverInfo> infos;
+  manager_->getTransceiversInfo(
+      infos, std::make_unique<std::vector<int32_t>>());
+
+  auto lockedSubscribers = changeSubscribers_.wlock();
+  auto changes = lockedSubscribers->tracker.update(infos);
+  if (changes.transceivers_ref()->empty()) {
+    return;
+  }
+  XLOG(DBG2) << changes.transceivers_ref()->size()
+             << " transceivers changed, generation "
+             << *changes.generation_ref();
+  changes.aliveSince_ref() = this->aliveSince();
+  for (const auto& [id, publisher] : lockedSubscribers->publishers) {
+    publisher->next(changes);
+  }
+}
+
 void QsfpServiceHandler::pauseRemediation(int32_t timeout) {
   auto log = LOG_THRIFT_CALL(INFO);
   manager_->setPauseRemediation(timeout);
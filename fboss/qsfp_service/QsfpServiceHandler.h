@@ -1,12 +1,14 @@
 // Copyright 2004-present Facebook. All Rights Reserved.
 #pragma once
 
+#include <folly/Synchronized.h>
 #include <folly/futures/Future.h>
 
 #include "common/fb303/cpp/FacebookBase2.h"
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/mka_service/handlers/MacsecHandler.h"
+#include "fboss/qsfp_service/TransceiverChangeTracker.h"
 #include "fboss/qsfp_service/TransceiverManager.h"
 #include "fboss/qsfp_service/if/gen-cpp2/QsfpService.h"
 #include "fboss/qsfp_service/platforms/wedge/FbossMacsecHandler.h"
@@ -23,7 +25,7 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
   QsfpServiceHandler(
       std::unique_ptr<TransceiverManager> manager,
       std::shared_ptr<mka::MacsecHandler> handler);
-  ~QsfpServiceHandler() override = default;
+  ~QsfpServiceHandler() override;
 
   void init();
   facebook::fb303::cpp2::fb_status getStatus() override;
@@ -57,6 +59,20 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
       std::map<int32_t, TransceiverInfo>& info,
       std::unique_ptr<std::map<int32_t, PortStatus>> ports) override;
 
+  /*
+   * Stream transceivers as they change, starting with the ones changed
+   * after sinceGeneration.
+   */
+  apache::thrift::ServerStream<TransceiverChanges> subscribeTransceiverChanges(
+      int64_t aliveSince,
+      int64_t sinceGeneration) override;
+
+  /*
+   * Send the transceivers that changed since the last call to all
+   * subscribers. Called after every refresh of the transceivers.
+   */
+  void publishTransceiverChanges();
+
   /*
    * Customise the transceiver based on the speed at which it has
    * been configured to operate at
@@ -142,8 +158,23 @@ class QsfpServiceHandler : public facebook::fboss::QsfpServiceSvIf,
 
   void validateHandler() const;
 
+  using ChangesPublisher =
+      apache::thrift::ServerStreamPublisher<TransceiverChanges>;
+
+  /*
+   * Subscribers and the tracker live under the same lock, so that a new
+   * subscriber gets the changes up to the current generation and then
+   * every later one, without gaps.
+   */
+  struct ChangeSubscribers {
+    TransceiverChangeTracker tracker;
+    std::map<uint64_t, std::unique_ptr<ChangesPublisher>> publishers;
+    uint64_t nextId{0};
+  };
+
   std::unique_ptr<TransceiverManager> manager_{nullptr};
   std::shared_ptr<mka::MacsecHandler> macsecHandler_;
+  folly::Synchronized<ChangeSubscribers> changeSubscribers_;
 };
 } // namespace fboss
 } // namespace facebook
@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/qsfp_service/TransceiverChangeTracker.h"
+
+namespace {
+using facebook::fboss::TransceiverInfo;
+
+TransceiverInfo withoutDomData(TransceiverInfo info) {
+  info.sensor_ref().reset();
+  info.channels_ref()->clear();
+  info.stats_ref().reset();
+  info.signalFlag_ref().reset();
+  info.mediaLaneSignals_ref().reset();
+  info.hostLaneSignals_ref().reset();
+  info.timeCollected_ref().reset();
+  info.vdmDiagsStats_ref().reset();
+  return info;
+}
+} // namespace
+
+namespace facebook {
+namespace fboss {
+
+// static
+bool TransceiverChangeTracker::isChanged(
+    const TransceiverInfo& oldInfo,
+    const TransceiverInfo& newInfo) {
+  return withoutDomData(oldInfo) != withoutDomData(newInfo);
+}
+
+TransceiverChanges TransceiverChangeTracker::update(
+    const std::map<int32_t, TransceiverInfo>& infos) {
+  TransceiverChanges changes;
+  auto& changed = *changes.transceivers_ref();
+  for (const auto& [id, info] : infos) {
+    auto it = transceivers_.find(id);
+    if (it != transceivers_.end() && !isChanged(it->second.info, info)) {
+      // Still keep the latest DOM data for new subscribers
+      it->second.info = info;
+      continue;
+    }
+    if (changed.empty()) {
+      ++generation_;
+    }
+    transceivers_[id] = {info, generation_};
+    changed.emplace(id, info);
+  }
+  changes.generation_ref() = generation_;
+  return changes;
+}
+
+TransceiverChanges TransceiverChangeTracker::getChangesSince(
+    int64_t sinceGeneration) const {
+  TransceiverChanges changes;
+  for (const auto& [id, tracked] : transceivers_) {
+    if (tracked.generation > sinceGeneration) {
+      changes.transceivers_ref()->emplace(id, tracked.info);
+    }
+  }
+  changes.generation_ref() = generation_;
+  return changes;
+}
+
+} // namespace fboss
+} // namespace facebook
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <map>
+
+#include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
+
+namespace facebook {
+namespace fboss {
+
+/*
+ * Keeps the last seen info of every transceiver, and the generation at which
+ * it last changed, so that subscribers only get the transceivers that changed
+ * since the generation they already have.
+ *
+ * Not thread safe, callers need to serialize access.
+ */
+class TransceiverChangeTracker {
+ public:
+  /*
+   * Compares the latest info of the transceivers with what was seen before.
+   * Transceivers that changed move to a new generation, and are returned
+   * tagged with it. Returns no transceivers if nothing changed.
+   */
+  TransceiverChanges update(const std::map<int32_t, TransceiverInfo>& infos);
+
+  // All transceivers that changed after sinceGeneration
+  TransceiverChanges getChangesSince(int64_t sinceGeneration) const;
+
+  int64_t getGeneration() const {
+    return generation_;
+  }
+
+  /*
+   * Whether the two differ in more than the DOM data (sensors, channels,
+   * signals, stats), which is read again on every refresh and would make
+   * every transceiver look changed every time.
+   */
+  static bool isChanged(
+      const TransceiverInfo& oldInfo,
+      const TransceiverInfo& newInfo);
+
+ private:
+  struct TrackedTransceiver {
+    TransceiverInfo info;
+    int64_t generation{0};
+  };
+
+  std::map<int32_t, TrackedTransceiver> transceivers_;
+  int64_t generation_{0};
+};
+
+} // namespace fboss
+} // namespace facebook
@@ -47,6 +47,17 @@ service QsfpService extends fb303.FacebookService {
   map<i32, transceiver.TransceiverInfo> syncPorts(1: map<i32, ctrl.PortStatus> ports)
     throws (1: fboss.FbossBaseError error)
 
+  /*
+   * Stream the transceivers whose info changed, ignoring DOM data that is
+   * read again on every refresh. The first message has every transceiver
+   * changed after sinceGeneration, or all of them if aliveSince does not
+   * match the running qsfp_service.
+   */
+  stream<transceiver.TransceiverChanges> subscribeTransceiverChanges(
+    1: i64 aliveSince,
+    2: i64 sinceGeneration,
+  )
+
   /*
    * Qsfp service has an internal remediation loop and may potentially perform
    * interruptive operation to modules that carry no active(up) link. However
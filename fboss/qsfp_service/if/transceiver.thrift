@@ -325,6 +325,15 @@ struct TransceiverInfo {
   25: optional bool eepromCsumValid,
 }
 
+// Transceivers whose info changed, as streamed by qsfp_service
+struct TransceiverChanges {
+  // aliveSince of the qsfp_service instance that sent the changes
+  1: i64 aliveSince,
+  // Generation of the latest change, to resubscribe from
+  2: i64 generation,
+  3: map<i32, TransceiverInfo> transceivers,
+}
+
 typedef binary (cpp2.type = "folly::IOBuf") IOBuf
 
 struct RawDOMData {
@@ -14,8 +14,15 @@
 #include "fboss/lib/AlertLogger.h"
 
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <chrono>
 
+DEFINE_bool(
+    qsfp_cache_subscribe,
+    false,
+    "Subscribe to transceiver changes from qsfp_service instead of "
+    "fetching all transceivers");
+
 namespace facebook {
 namespace fboss {
 
@@ -37,7 +44,11 @@ void QsfpCache::init(folly::EventBase* evb, const PortMapThrift& ports) {
 
   portsChanged(ports);
 
-  syncAllPresentTransceivers();
+  if (FLAGS_qsfp_cache_subscribe) {
+    folly::via(evb_).thenValue([this](auto&&) { subscribe(); });
+  } else {
+    syncAllPresentTransceivers();
+  }
 
   attachEventBase(evb);
   scheduleTimeout(kLivenessCheckInterval);
@@ -231,6 +242,9 @@ folly::Future<TransceiverInfo> QsfpCache::futureGet(TransceiverID tcvrId) {
 
 void QsfpCache::timeoutExpired() noexcept {
   confirmAlive().then(&QsfpCache::maybeSync, this);
+  if (FLAGS_qsfp_cache_subscribe) {
+    subscribe();
+  }
   scheduleTimeout(kLivenessCheckInterval);
 }
 
@@ -258,17 +272,12 @@ void QsfpCache::syncAllPresentTransceivers() {
         auto options = QsfpClient::getRpcOptions();
         return client->future_getTransceiverInfo(options, ids);
       })
-      .thenValue([this](auto&& tcvrs) mutable {
-        // sync transceivers map with results
-        auto writableTcvrs = this->tcvrs_.wlock();
-        for (auto& [id, info] : tcvrs) {
-          // Only store present transceivers
-          if (*info.present_ref()) {
-            writableTcvrs->emplace(TransceiverID(id), info);
-          }
-        }
-        XLOG(DBG1) << "Got " << writableTcvrs->size()
-                   << " present transceivers from qsfp_service";
+      .thenValue([this](auto&& tcvrs) {
+        // Overwrite what we have, changes we missed may include removals
+        // and updates of transceivers already in the cache
+        XLOG(DBG1) << "Got " << tcvrs.size()
+                   << " transceivers from qsfp_service";
+        updateCache(tcvrs);
       })
       .thenError(folly::tag_t<std::exception>{}, [](const std::exception& e) {
         XLOG(ERR) << PlatformAlert() << "Exception talking to qsfp_service,"
@@ -276,6 +285,98 @@ void QsfpCache::syncAllPresentTransceivers() {
       });
 }
 
+void QsfpCache::subscribe() {
+  CHECK(evb_->isInEventBaseThread());
+
+  if (subscribing_ || (subscriptionActive_ && *subscriptionActive_)) {
+    return;
+  }
+  unsubscribe();
+  subscribing_ = true;
+  auto active = std::make_shared<bool>(true);
+  subscriptionActive_ = active;
+
+  auto onChanges = [this, active](folly::Try<TransceiverChanges>&& changes) {
+    if (!*active) {
+      return;
+    }
+    if (changes.hasValue()) {
+      applyChanges(std::move(changes.value()));
+      return;
+    }
+    *active = false;
+    if (changes.hasException()) {
+      XLOG(ERR) << PlatformAlert() << "Transceiver changes stream failed: "
+                << changes.exception().what();
+    } else {
+      XLOG(ERR) << "qsfp_service ended transceiver changes stream";
+    }
+    // We may have missed changes, so get everything again until we
+    // resubscribe on the next liveness check
+    syncAllPresentTransceivers();
+  };
+
+  QsfpClient::createStreamClient(evb_)
+      .thenValue([this](std::unique_ptr<QsfpServiceAsyncClient> client) {
+        XLOG(DBG1) << "Subscribing to transceiver changes since generation "
+                   << streamGen_;
+        streamClient_ = std::move(client);
+        return streamClient_
+            ->semifuture_subscribeTransceiverChanges(
+                streamAliveSince_, streamGen_)
+            .via(evb_);
+      })
+      .thenValue([this, active, onChanges = std::move(onChanges)](
+                     auto&& stream) mutable {
+        if (!*active) {
+          return;
+        }
+        subscription_ = std::move(stream).subscribeExTry(
+            folly::getKeepAliveToken(evb_), std::move(onChanges));
+      })
+      .thenError(
+          folly::tag_t<std::exception>{},
+          [this, active](const std::exception& e) {
+            XLOG(ERR) << PlatformAlert()
+                      << "Failed to subscribe to transceiver changes: "
+                      << e.what();
+            *active = false;
+            syncAllPresentTransceivers();
+          })
+      .ensure([this]() { subscribing_ = false; });
+}
+
+void QsfpCache::unsubscribe() {
+  CHECK(evb_->isInEventBaseThread());
+
+  if (subscriptionActive_) {
+    *subscriptionActive_ = false;
+  }
+  if (subscription_) {
+    subscription_->cancel();
+    std::move(*subscription_).detach();
+    subscription_.reset();
+  }
+  streamClient_.reset();
+}
+
+void QsfpCache::applyChanges(TransceiverChanges&& changes) {
+  XLOG(DBG1) << "Got " << changes.transceivers_ref()->size()
+             << " changed transceivers from qsfp_service, generation "
+             << *changes.generation_ref();
+  streamAliveSince_ = *changes.aliveSince_ref();
+  streamGen_ = *changes.generation_ref();
+  updateCache(*changes.transceivers_ref());
+}
+
+void QsfpCache::stop() {
+  if (!evb_) {
+    return;
+  }
+  evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [this]() { unsubscribe(); });
+}
+
 AutoInitQsfpCache::AutoInitQsfpCache() {
   init(&evb_);
   thread_.reset(new std::thread([=] { evb_.loopForever(); }));
@@ -283,6 +384,7 @@ AutoInitQsfpCache::AutoInitQsfpCache() {
 
 AutoInitQsfpCache::~AutoInitQsfpCache() {
   if (thread_) {
+    stop();
     evb_.runInEventBaseThread([this] { evb_.terminateLoopSoon(); });
     thread_->join();
   }
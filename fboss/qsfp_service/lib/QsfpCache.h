@@ -20,9 +20,11 @@
 #include <folly/futures/SharedPromise.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
+#include <thrift/lib/cpp2/async/ClientBufferedStream.h>
 
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/types.h"
+#include "fboss/qsfp_service/if/gen-cpp2/QsfpService.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 /*
@@ -60,6 +62,17 @@
  * and store the last aliveSince. If this changes, we reset remoteGen_
  * back to zero so we will re-sync all ports.
  *
+ * Subscribing to transceiver changes
+ * ----------------------------------
+ * With --qsfp_cache_subscribe, instead of fetching all transceivers
+ * once at init, the cache subscribes to subscribeTransceiverChanges
+ * and qsfp_service pushes the transceivers that changed. The cache
+ * remembers the generation of the last change it got, so that on
+ * resubscribing it only gets what it missed. If the stream breaks, or
+ * qsfp_service does not support it, the cache falls back to fetching
+ * all transceivers, and tries to subscribe again on the next liveness
+ * check.
+ *
  * Threading model
  * ---------------
  * All thrift calls to qsfp_service are done on evb_. No guarantee for
@@ -111,6 +124,11 @@ class QsfpCache : private folly::AsyncTimeout {
   // output state of the cache. Useful for debugging
   void dump();
 
+  /* Stops the subscription to transceiver changes, if any. Must be
+   * called before the EventBase stops looping.
+   */
+  void stop();
+
  private:
   // Forbidden copy constructor and assignment operator
   QsfpCache(QsfpCache const&) = delete;
@@ -139,6 +157,13 @@ class QsfpCache : private folly::AsyncTimeout {
 
   void syncAllPresentTransceivers();
 
+  /* Subscribes to transceiver changes from qsfp_service, unless a
+   * subscription is already up.
+   */
+  void subscribe();
+  void unsubscribe();
+  void applyChanges(TransceiverChanges&& changes);
+
   struct PortCacheValue {
     PortStatus port;
     uint32_t generation{0};
@@ -160,6 +185,18 @@ class QsfpCache : private folly::AsyncTimeout {
   int64_t remoteAliveSince_{-1};
 
   std::atomic_bool initialized_{false};
+
+  // Subscription to transceiver changes. Only accessed from evb_.
+  std::unique_ptr<QsfpServiceAsyncClient> streamClient_;
+  std::optional<
+      apache::thrift::ClientBufferedStream<TransceiverChanges>::Subscription>
+      subscription_;
+  // Cleared once the subscription ends, so late callbacks are ignored
+  std::shared_ptr<bool> subscriptionActive_;
+  bool subscribing_{false};
+  // aliveSince and generation of the last changes we got
+  int64_t streamAliveSince_{-1};
+  int64_t streamGen_{0};
 };
 
 class AutoInitQsfpCache : public QsfpCache {
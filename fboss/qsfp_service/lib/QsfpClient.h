@@ -37,6 +37,10 @@ class QsfpClient {
   static folly::Future<std::unique_ptr<QsfpServiceAsyncClient>> createClient(
       folly::EventBase* eb);
 
+  // Client over a transport that supports streaming, for subscriptions
+  static folly::Future<std::unique_ptr<QsfpServiceAsyncClient>>
+  createStreamClient(folly::EventBase* eb);
+
   static apache::thrift::RpcOptions getRpcOptions();
 };
 
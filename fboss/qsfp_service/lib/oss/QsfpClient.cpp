@@ -3,6 +3,7 @@
 #include "fboss/qsfp_service/lib/QsfpClient.h"
 
 #include <folly/io/async/AsyncSocket.h>
+#include <thrift/lib/cpp2/async/RocketClientChannel.h>
 
 DEFINE_string(qsfp_service_host, "::1", "Host running qsfp service");
 DEFINE_int32(qsfp_service_port, 5910, "Port running qsfp service");
@@ -26,4 +27,18 @@ folly::Future<std::unique_ptr<QsfpServiceAsyncClient>> QsfpClient::createClient(
   return folly::via(eb, createClient);
 }
 
+// static
+folly::Future<std::unique_ptr<QsfpServiceAsyncClient>>
+QsfpClient::createStreamClient(folly::EventBase* eb) {
+  auto createClient = [eb]() {
+    folly::SocketAddress addr(FLAGS_qsfp_service_host, FLAGS_qsfp_service_port);
+    auto socket = folly::AsyncSocket::newSocket(eb, addr, kQsfpConnTimeoutMs);
+    socket->setSendTimeout(kQsfpSendTimeoutMs);
+    auto channel =
+        apache::thrift::RocketClientChannel::newChannel(std::move(socket));
+    return std::make_unique<QsfpServiceAsyncClient>(std::move(channel));
+  };
+  return folly::via(eb, createClient);
+}
+
 } // namespace facebook::fboss
@@ -162,11 +162,11 @@ bool QsfpModule::cacheIsValid() const {
 }
 
 TransceiverInfo QsfpModule::getTransceiverInfo() {
-  auto cachedInfo = info_.rlock();
-  if (!cachedInfo->has_value()) {
+  auto cachedInfo = info_.load();
+  if (!cachedInfo) {
     throw QsfpModuleError("Still populating data...");
   }
-  return **cachedInfo;
+  return *cachedInfo;
 }
 
 bool QsfpModule::detectPresence() {
@@ -185,16 +185,16 @@ bool QsfpModule::detectPresenceLocked() {
 
     // If a transceiver went from present to missing, clear the cached data.
     if (!present_) {
-      info_.wlock()->reset();
+      info_.store(nullptr);
     }
     // In the case of an OBO module or an inaccessable present module,
     // we need to fill in the essential info before parsing the DOM data
     // which may not be available.
-    TransceiverInfo info;
-    info.present_ref() = present_;
-    info.transceiver_ref() = type();
-    info.port_ref() = qsfpImpl_->getNum();
-    *info_.wlock() = info;
+    auto info = std::make_shared<TransceiverInfo>();
+    info->present_ref() = present_;
+    info->transceiver_ref() = type();
+    info->port_ref() = qsfpImpl_->getNum();
+    info_.store(std::move(info));
   }
   return currentQsfpStatus;
 }
@@ -534,11 +534,11 @@ void QsfpModule::refreshLocked() {
   }
 
   // assign
-  auto info = parseDataLocked();
+  auto info = std::make_shared<TransceiverInfo>(parseDataLocked());
   phy::LinkSnapshot snapshot;
-  snapshot.transceiverInfo_ref() = info;
+  snapshot.transceiverInfo_ref() = *info;
   snapshots_.wlock()->addSnapshot(snapshot);
-  *info_.wlock() = info;
+  info_.store(std::move(info));
 }
 
 bool QsfpModule::shouldRemediate(time_t cooldown) {
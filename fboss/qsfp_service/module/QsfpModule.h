@@ -17,6 +17,7 @@
 #include "fboss/qsfp_service/module/Transceiver.h"
 
 #include <folly/Synchronized.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
 #include <folly/experimental/FunctionScheduler.h>
 #include <folly/futures/Future.h>
 #include <optional>
@@ -96,6 +97,10 @@ class QsfpModule : public Transceiver {
    */
   TransceiverInfo getTransceiverInfo() override;
 
+  std::shared_ptr<const TransceiverInfo> getCachedTransceiverInfo() override {
+    return info_.load();
+  }
+
   void transceiverPortsChanged(
       const std::map<uint32_t, PortStatus>& ports) override;
 
@@ -265,7 +270,12 @@ class QsfpModule : public Transceiver {
   uint64_t numRemediation_{0};
 
   folly::Synchronized<TransceiverSnapshotCache> snapshots_;
-  folly::Synchronized<std::optional<TransceiverInfo>> info_;
+  /*
+   * TransceiverInfo built by the last refresh. Each refresh builds a new
+   * TransceiverInfo and swaps it in, so readers only ever see a complete
+   * snapshot and never wait on qsfpModuleMutex_ or on a refresh.
+   */
+  folly::atomic_shared_ptr<const TransceiverInfo> info_;
   /*
    * qsfpModuleMutex_ is held around all the read and writes to the qsfpModule
    *
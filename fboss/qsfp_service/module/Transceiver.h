@@ -16,6 +16,8 @@
 
 #include <folly/futures/Future.h>
 
+#include <memory>
+
 namespace facebook {
 namespace fboss {
 
@@ -58,6 +60,13 @@ class Transceiver {
    */
   virtual TransceiverInfo getTransceiverInfo() = 0;
 
+  /*
+   * Return the transceiver information published by the last refresh, or
+   * nullptr if there is none yet. The snapshot is never modified once
+   * published, so readers can hold on to it without any locking.
+   */
+  virtual std::shared_ptr<const TransceiverInfo> getCachedTransceiverInfo() = 0;
+
   /*
    * Return raw page data from the qsfp DOM
    */
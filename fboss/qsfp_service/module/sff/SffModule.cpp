@@ -1183,9 +1183,7 @@ void SffModule::overwriteChannelControlSettings() {
   // However modules from AOI set those as 2dB which causes lower
   // signal quality when working with credo xphy on yamp. Thus as part
   // of the redmediation, we set that value to 0.
-  auto cachedInfo = info_.rlock();
-
-  if (!cachedInfo->has_value()) {
+  if (!info_.load()) {
     return;
   }
 
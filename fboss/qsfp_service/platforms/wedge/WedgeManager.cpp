@@ -207,26 +207,33 @@ void WedgeManager::getTransceiversInfo(
     folly::gen::range(0, getNumQsfpModules()) | folly::gen::appendTo(*ids);
   }
 
-  auto lockedTransceivers = transceivers_.rlock();
-  for (const auto& i : *ids) {
-    if (!isValidTransceiver(i)) {
-      // If the transceiver idx is not valid,
-      // just skip and continue to the next.
-      continue;
-    }
-    TransceiverInfo trans;
-    if (auto it = lockedTransceivers->find(TransceiverID(i));
-        it != lockedTransceivers->end()) {
-      try {
-        trans = it->second->getTransceiverInfo();
-      } catch (const std::exception& ex) {
-        XLOG(ERR) << "Transceiver " << i
-                  << ": Error calling getTransceiverInfo(): " << ex.what();
+  // Only grab the published snapshots while holding the transceivers lock,
+  // and do the copying into the response after releasing it.
+  std::vector<std::pair<int32_t, std::shared_ptr<const TransceiverInfo>>>
+      snapshots;
+  snapshots.reserve(ids->size());
+  {
+    auto lockedTransceivers = transceivers_.rlock();
+    for (const auto& i : *ids) {
+      if (!isValidTransceiver(i)) {
+        // If the transceiver idx is not valid,
+        // just skip and continue to the next.
+        continue;
       }
-    } else {
-      trans.present_ref() = false;
+      std::shared_ptr<const TransceiverInfo> snapshot;
+      if (auto it = lockedTransceivers->find(TransceiverID(i));
+          it != lockedTransceivers->end()) {
+        snapshot = it->second->getCachedTransceiverInfo();
+        if (!snapshot) {
+          XLOG(ERR) << "Transceiver " << i << ": Still populating data...";
+        }
+      }
+      snapshots.emplace_back(i, std::move(snapshot));
     }
-    info[i] = trans;
+  }
+  for (const auto& [i, snapshot] : snapshots) {
+    // Transceivers not present, or without data yet, report as not present
+    info[i] = snapshot ? *snapshot : TransceiverInfo();
   }
 }
 
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/platforms/wedge/tests/MockWedgeManager.h"
+#include "fboss/qsfp_service/test/FakeConfigsHelper.h"
+
+#include <folly/Benchmark.h>
+#include <folly/experimental/TestUtil.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace facebook::fboss;
+using namespace ::testing;
+
+namespace {
+constexpr int kNumModules = 128;
+constexpr int kNumPortsPerModule = 4;
+
+std::unique_ptr<folly::test::TemporaryDirectory> tmpDir;
+std::unique_ptr<NiceMock<MockWedgeManager>> wedgeManager;
+
+void init() {
+  tmpDir = std::make_unique<folly::test::TemporaryDirectory>();
+  auto path = tmpDir->path().string();
+  setupFakeAgentConfig(path + "/fakeAgentConfig");
+  setupFakeQsfpConfig(path + "/fakeQsfpConfig");
+  FLAGS_qsfp_service_volatile_dir = path;
+  // Re-read the DOM data on every refresh, as a busy qsfp_service would
+  gflags::SetCommandLineOptionWithMode(
+      "qsfp_data_refresh_interval", "0", gflags::SET_FLAGS_DEFAULT);
+
+  wedgeManager = std::make_unique<NiceMock<MockWedgeManager>>(
+      kNumModules, kNumPortsPerModule);
+  wedgeManager->initTransceiverMap();
+}
+
+void getAllTransceiversInfo(unsigned int iters, bool concurrentRefresh) {
+  std::atomic<bool> done{false};
+  std::thread refresher;
+  BENCHMARK_SUSPEND {
+    if (concurrentRefresh) {
+      refresher = std::thread([&done] {
+        while (!done) {
+          wedgeManager->refreshTransceivers();
+        }
+      });
+    }
+  }
+
+  for (unsigned int i = 0; i < iters; ++i) {
+    std::map<int32_t, TransceiverInfo> info;
+    wedgeManager->getTransceiversInfo(
+        info, std::make_unique<std::vector<int32_t>>());
+    CHECK_EQ(info.size(), kNumModules);
+    folly::doNotOptimizeAway(info);
+  }
+
+  BENCHMARK_SUSPEND {
+    done = true;
+    if (refresher.joinable()) {
+      refresher.join();
+    }
+  }
+}
+} // namespace
+
+BENCHMARK(GetTransceiversInfo, iters) {
+  getAllTransceiversInfo(iters, false);
+}
+
+BENCHMARK_RELATIVE(GetTransceiversInfoWhileRefreshing, iters) {
+  getAllTransceiversInfo(iters, true);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Creating and refreshing 128 transceivers is expensive, so do it once
+  // before running the benchmark functions.
+  init();
+
+  folly::runBenchmarks();
+
+  wedgeManager.reset();
+  tmpDir.reset();
+  return 0;
+}
@@ -145,6 +145,31 @@ TEST_F(WedgeManagerTest, getTransceiverInfoWithReadExceptions) {
   }
 }
 
+TEST_F(WedgeManagerTest, cachedTransceiverInfoIsSnapshot) {
+  auto getCachedInfo = [this](int id) {
+    auto synchronizedTransceivers =
+        wedgeManager_->getSynchronizedTransceivers().rlock();
+    return synchronizedTransceivers->at(TransceiverID(id))
+        ->getCachedTransceiverInfo();
+  };
+  auto before = getCachedInfo(0);
+  ASSERT_NE(before, nullptr);
+  auto timeCollected = *before->timeCollected_ref();
+  // Reads between refreshes share the same snapshot
+  EXPECT_EQ(getCachedInfo(0), before);
+
+  /* sleep override */
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+  wedgeManager_->refreshTransceivers();
+
+  // A refresh publishes a new snapshot and leaves the old one untouched
+  auto after = getCachedInfo(0);
+  ASSERT_NE(after, nullptr);
+  EXPECT_NE(after, before);
+  EXPECT_EQ(*before->timeCollected_ref(), timeCollected);
+  EXPECT_GT(*after->timeCollected_ref(), timeCollected);
+}
+
 TEST_F(WedgeManagerTest, readTransceiver) {
   std::map<int32_t, ReadResponse> response;
   std::unique_ptr<ReadRequest> request(new ReadRequest);
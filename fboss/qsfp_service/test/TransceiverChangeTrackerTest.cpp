@@ -0,0 +1,70 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#include "fboss/qsfp_service/TransceiverChangeTracker.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+TransceiverInfo makeInfo(bool present, double temp = 30.0) {
+  TransceiverInfo info;
+  info.present_ref() = present;
+  GlobalSensors sensor;
+  sensor.temp_ref()->value_ref() = temp;
+  info.sensor_ref() = sensor;
+  return info;
+}
+
+} // namespace
+
+TEST(TransceiverChangeTrackerTest, onlyChangedTransceivers) {
+  TransceiverChangeTracker tracker;
+  std::map<int32_t, TransceiverInfo> infos = {
+      {0, makeInfo(true)}, {1, makeInfo(false)}};
+
+  auto changes = tracker.update(infos);
+  EXPECT_EQ(changes.transceivers_ref()->size(), 2);
+  EXPECT_EQ(*changes.generation_ref(), 1);
+
+  // Nothing changed, generation stays the same
+  changes = tracker.update(infos);
+  EXPECT_TRUE(changes.transceivers_ref()->empty());
+  EXPECT_EQ(*changes.generation_ref(), 1);
+
+  infos[1] = makeInfo(true);
+  changes = tracker.update(infos);
+  EXPECT_EQ(changes.transceivers_ref()->size(), 1);
+  EXPECT_TRUE(changes.transceivers_ref()->count(1));
+  EXPECT_EQ(*changes.generation_ref(), 2);
+}
+
+TEST(TransceiverChangeTrackerTest, domDataIsNotAChange) {
+  TransceiverChangeTracker tracker;
+  tracker.update({{0, makeInfo(true, 30.0)}});
+
+  auto newInfo = makeInfo(true, 45.0);
+  EXPECT_FALSE(TransceiverChangeTracker::isChanged(makeInfo(true), newInfo));
+  EXPECT_TRUE(tracker.update({{0, newInfo}}).transceivers_ref()->empty());
+
+  // New subscribers still get the latest DOM data
+  auto changes = tracker.getChangesSince(0);
+  EXPECT_EQ(
+      *changes.transceivers_ref()->at(0).sensor_ref()->temp_ref()->value_ref(),
+      45.0);
+}
+
+TEST(TransceiverChangeTrackerTest, getChangesSince) {
+  TransceiverChangeTracker tracker;
+  tracker.update({{0, makeInfo(false)}, {1, makeInfo(false)}});
+  tracker.update({{0, makeInfo(true)}, {1, makeInfo(false)}});
+
+  EXPECT_EQ(tracker.getGeneration(), 2);
+  EXPECT_EQ(tracker.getChangesSince(0).transceivers_ref()->size(), 2);
+  auto changes = tracker.getChangesSince(1);
+  EXPECT_EQ(changes.transceivers_ref()->size(), 1);
+  EXPECT_TRUE(changes.transceivers_ref()->count(0));
+  EXPECT_EQ(*changes.generation_ref(), 2);
+  EXPECT_TRUE(tracker.getChangesSince(2).transceivers_ref()->empty());
+}